@@ -0,0 +1,224 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for AlgorithmRace.
+*/
+
+#include <thread>
+
+#include "Osi2Config.h"
+
+#include "Osi2AlgorithmRace.hpp"
+#include "Osi2SolveCanceller.hpp"
+
+namespace Osi2 {
+
+AlgorithmRace::AlgorithmRace (ControlAPI &ctrl, ClpSimplexAPI &model)
+  : ctrl_(ctrl),
+    model_(model),
+    winner_(-1),
+    stop_(false)
+{ }
+
+/*
+  Destructor. We own the parameter profiles, and must not leave losers
+  running on them.
+*/
+AlgorithmRace::~AlgorithmRace ()
+{
+  settle() ;
+  for (int ndx = 0 ; ndx < entrants_.size() ; ndx++)
+    delete entrants_[ndx].params_ ;
+}
+
+int AlgorithmRace::addEntrant (Algorithm alg, const RunParamsAPI *params)
+{
+  Entrant entrant ;
+  entrant.algorithm_ = alg ;
+  entrant.params_ = (params == nullptr)?nullptr:params->clone() ;
+  entrant.solverObj_ = nullptr ;
+  entrant.solver_ = nullptr ;
+  entrants_.push_back(entrant) ;
+  return (static_cast<int>(entrants_.size())-1) ;
+}
+
+void AlgorithmRace::initResult (int ndx, Result &result) const
+{
+  result.entrant_ = ndx ;
+  result.algorithm_ = entrants_[ndx].algorithm_ ;
+  result.retval_ = -1 ;
+  result.status_ = -1 ;
+  result.secondaryStatus_ = -1 ;
+  result.iterations_ = 0 ;
+  result.objective_ = 0.0 ;
+  result.seconds_ = 0.0 ;
+  result.cancelled_ = false ;
+  result.colSolution_.clear() ;
+  result.rowPrice_.clear() ;
+}
+
+void AlgorithmRace::runEntrant (int ndx, Clock::time_point begin)
+{
+  solveEntrant(ndx,begin) ;
+  std::lock_guard<std::mutex> lock(doneLock_) ;
+  done_[ndx] = true ;
+  doneCond_.notify_all() ;
+}
+
+bool AlgorithmRace::raceOver () const
+{
+  int won = winner_ ;
+  if (won >= 0 && done_[won]) return (true) ;
+  for (int ndx = 0 ; ndx < done_.size() ; ndx++) {
+    if (!done_[ndx]) return (false) ;
+  }
+  return (true) ;
+}
+
+/*
+  Load the model, apply the profile, and solve under a canceller. The first
+  entrant to claim the win raises the stop flag for the others, then copies
+  out its solution; nobody else touches this solver, so there's no hurry.
+*/
+void AlgorithmRace::solveEntrant (int ndx, Clock::time_point begin)
+{
+  Entrant &entrant = entrants_[ndx] ;
+  Result &result = results_[ndx] ;
+  ClpSimplexAPI *solver = entrant.solver_ ;
+
+  model_.loadInto(*solver) ;
+  if (entrant.params_ != nullptr) solver->loadParams(*entrant.params_) ;
+  {
+    SolveCanceller canceller(*solver,stop_) ;
+    switch (entrant.algorithm_) {
+      case Dual: {
+	result.retval_ = solver->initialDualSolve() ;
+	break ;
+      }
+      case Primal: {
+	result.retval_ = solver->initialPrimalSolve() ;
+	break ;
+      }
+      case Barrier: {
+	result.retval_ = solver->initialBarrierSolve() ;
+	break ;
+      }
+      case BarrierNoCross: {
+	result.retval_ = solver->initialBarrierNoCrossSolve() ;
+	break ;
+      }
+      default: {
+	result.retval_ = solver->initialSolve() ;
+	break ;
+      }
+    }
+    result.cancelled_ = canceller.cancelled() ;
+  }
+  std::chrono::duration<double> elapsed = Clock::now()-begin ;
+  result.seconds_ = elapsed.count() ;
+  result.status_ = solver->status() ;
+  result.secondaryStatus_ = solver->secondaryStatus() ;
+  result.iterations_ = solver->numberIterations() ;
+  result.objective_ = solver->objectiveValue() ;
+
+  if (!solver->isProvenOptimal()) return ;
+  int noWinner = -1 ;
+  if (!winner_.compare_exchange_strong(noWinner,ndx)) return ;
+  stop_ = true ;
+  const double *vec = solver->getColSolution() ;
+  result.colSolution_.assign(vec,vec+solver->numberColumns()) ;
+  vec = solver->getRowPrice() ;
+  result.rowPrice_.assign(vec,vec+solver->numberRows()) ;
+}
+
+/*
+  Solver objects are created here, in the calling thread, because object
+  creation goes through the plugin manager, which is not safe to call
+  concurrently. Entrants for which no solver can be created sit out the
+  race.
+*/
+bool AlgorithmRace::run (Result &winner, std::vector<Result> *all)
+{
+  settle() ;
+  int entrantCnt = static_cast<int>(entrants_.size()) ;
+  results_.clear() ;
+  results_.resize(entrantCnt) ;
+  done_.assign(entrantCnt,true) ;
+  threads_.resize(entrantCnt) ;
+  winner_ = -1 ;
+  stop_ = false ;
+
+  for (int ndx = 0 ; ndx < entrantCnt ; ndx++) {
+    Entrant &entrant = entrants_[ndx] ;
+    initResult(ndx,results_[ndx]) ;
+    API *apiObj = nullptr ;
+    int retval = ctrl_.createObject(apiObj,ClpSimplexAPI::getAPIIDString()) ;
+    if (retval != 0 || apiObj == nullptr) continue ;
+    void *tmp = apiObj->getAPIPtr(ClpSimplexAPI::getAPIIDString()) ;
+    if (tmp == nullptr) {
+      ctrl_.destroyObject(apiObj) ;
+      continue ;
+    }
+    entrant.solverObj_ = apiObj ;
+    entrant.solver_ = static_cast<ClpSimplexAPI *>(tmp) ;
+  }
+
+  Clock::time_point begin = Clock::now() ;
+  for (int ndx = 0 ; ndx < entrantCnt ; ndx++) {
+    if (entrants_[ndx].solver_ == nullptr) continue ;
+    done_[ndx] = false ;
+    threads_[ndx] = std::thread(&AlgorithmRace::runEntrant,this,ndx,begin) ;
+  }
+/*
+  Wait for the winner to copy out its solution, or for everyone to give up.
+  Entrants that have finished are joined and their solvers destroyed now.
+  The rest are left running; their results are still being written, so
+  the caller gets a placeholder.
+*/
+  std::vector<bool> done ;
+  {
+    std::unique_lock<std::mutex> lock(doneLock_) ;
+    while (!raceOver()) doneCond_.wait(lock) ;
+    done = done_ ;
+  }
+  std::vector<Result> reported(entrantCnt) ;
+  for (int ndx = 0 ; ndx < entrantCnt ; ndx++) {
+    if (done[ndx]) {
+      if (threads_[ndx].joinable()) threads_[ndx].join() ;
+      Entrant &entrant = entrants_[ndx] ;
+      if (entrant.solverObj_ != nullptr)
+	ctrl_.destroyObject(entrant.solverObj_) ;
+      entrant.solverObj_ = nullptr ;
+      entrant.solver_ = nullptr ;
+      reported[ndx] = results_[ndx] ;
+    } else {
+      initResult(ndx,reported[ndx]) ;
+      reported[ndx].cancelled_ = true ;
+    }
+  }
+
+  int won = winner_ ;
+  if (won >= 0) winner = reported[won] ;
+  if (all != nullptr) all->swap(reported) ;
+
+  return (won >= 0) ;
+}
+
+void AlgorithmRace::settle ()
+{
+  for (int ndx = 0 ; ndx < threads_.size() ; ndx++) {
+    if (!threads_[ndx].joinable()) continue ;
+    threads_[ndx].join() ;
+    Entrant &entrant = entrants_[ndx] ;
+    if (entrant.solverObj_ != nullptr)
+      ctrl_.destroyObject(entrant.solverObj_) ;
+    entrant.solverObj_ = nullptr ;
+    entrant.solver_ = nullptr ;
+  }
+  threads_.clear() ;
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,185 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2AlgorithmRace.hpp
+
+  Defines AlgorithmRace, a utility to solve one model with several
+  algorithms concurrently and keep the first optimal answer.
+*/
+
+#ifndef Osi2AlgorithmRace_HPP
+#define Osi2AlgorithmRace_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Osi2ControlAPI.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2RunParamsAPI.hpp"
+#include "Osi2PackedModel.hpp"
+
+namespace Osi2 {
+
+/*! \brief Race several algorithms on one model
+
+  An AlgorithmRace is constructed from a ControlAPI object, used to create
+  and destroy solver objects, and a ClpSimplexAPI object holding the model.
+  The model is copied once, at construction, into a PackedModel shared by
+  all entrants; the source object is not touched again.
+
+  Entrants are added with #addEntrant, each naming an algorithm and,
+  optionally, a parameter profile. #run gives each entrant its own solver
+  object and thread, loads the model, and starts all of them together. The
+  first entrant to finish with a proven optimal solution wins; the others
+  are told to stop through a SolveCanceller. If no entrant reaches
+  optimality, there is no winner.
+
+  #run returns as soon as the winner has copied out its solution. Losers
+  normally stop within an iteration, but a barrier solve doesn't look at
+  the stop request until crossover, so a loser may run on for as long as
+  its solve would have taken. Rather than hold up the caller, such losers
+  are left running on their own solver objects and reported as cancelled,
+  with no statistics. They are waited for, and their solvers destroyed, by
+  #settle, which is called by the next #run and by the destructor.
+*/
+class AlgorithmRace {
+
+public:
+
+  /// Algorithms that can be entered in a race
+  enum Algorithm { Dual = 0, Primal, Barrier, BarrierNoCross, Default } ;
+
+  /// Outcome for one entrant
+  struct Result {
+    /// Index of the entrant
+    int entrant_ ;
+    /// Algorithm used
+    Algorithm algorithm_ ;
+    /// Return code from the solve; -1 if the solve was not attempted
+    int retval_ ;
+    /// Problem status (ClpSimplexAPI::status)
+    int status_ ;
+    /// Secondary status (ClpSimplexAPI::secondaryStatus)
+    int secondaryStatus_ ;
+    /// Iteration count
+    int iterations_ ;
+    /// Objective value
+    double objective_ ;
+    /// Wall clock time from the start of the race (seconds)
+    double seconds_ ;
+    /*! \brief True if the entrant was stopped because another entrant won
+
+      Also true for an entrant still running when #run returned; its
+      status and statistics are not available.
+    */
+    bool cancelled_ ;
+    /// Primal solution (winner only)
+    std::vector<double> colSolution_ ;
+    /// Dual solution (winner only)
+    std::vector<double> rowPrice_ ;
+  } ;
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /// Constructor; copies the model held by \p model
+  AlgorithmRace(ControlAPI &ctrl, ClpSimplexAPI &model) ;
+  /// Destructor
+  ~AlgorithmRace() ;
+  //@}
+
+  /*! \name Methods to set up and run the race */
+  //@{
+  /*! \brief Add an entrant
+
+    The entrant will solve with algorithm \p alg after applying a copy of
+    \p params, if supplied. Returns the index of the entrant.
+  */
+  int addEntrant(Algorithm alg, const RunParamsAPI *params = nullptr) ;
+
+  /// Number of entrants
+  int getEntrantCnt() const { return (static_cast<int>(entrants_.size())) ; }
+
+  /*! \brief Run the race
+
+    Returns true if some entrant found a proven optimal solution; the
+    result for the winner, including primal and dual solutions, is returned
+    in \p winner. If \p all is supplied, it is filled with the results for
+    all entrants, indexed by entrant.
+  */
+  bool run(Result &winner, std::vector<Result> *all = nullptr) ;
+
+  /*! \brief Wait for losers still running from the last race
+
+    Destroys their solver objects. Must be called from the thread that
+    called #run.
+  */
+  void settle() ;
+
+  /*! \brief True if the losers of the last race have been told to stop
+
+    Raised by the winner, before it copies out its solution; cleared by
+    #run. Always false after a race with no winner.
+  */
+  bool stopRequested() const { return (stop_) ; }
+  //@}
+
+private:
+
+  /// An entrant
+  struct Entrant {
+    Algorithm algorithm_ ;
+    /// Parameter profile (owned); may be null
+    RunParamsAPI *params_ ;
+    /// Solver object, valid from #run until the entrant is settled
+    API *solverObj_ ;
+    ClpSimplexAPI *solver_ ;
+  } ;
+
+  typedef std::chrono::steady_clock Clock ;
+
+  /// Body of the thread for entrant \p ndx; \p begin is the start of the race
+  void runEntrant(int ndx, Clock::time_point begin) ;
+  /// Load and solve for entrant \p ndx and record the result
+  void solveEntrant(int ndx, Clock::time_point begin) ;
+  /// Initialise \p result for entrant \p ndx as not attempted
+  void initResult(int ndx, Result &result) const ;
+  /// True if the winner has finished, or everyone has; needs #doneLock_
+  bool raceOver() const ;
+
+  /// Control object used to create solver objects
+  ControlAPI &ctrl_ ;
+  /// The shared model
+  PackedModel model_ ;
+  /// Entrants
+  std::vector<Entrant> entrants_ ;
+  /// Results, indexed by entrant
+  std::vector<Result> results_ ;
+  /// Index of the winning entrant, -1 until there is one
+  std::atomic<int> winner_ ;
+  /// Raised when the race is decided
+  std::atomic<bool> stop_ ;
+  /// Entrant threads not yet joined, indexed by entrant
+  std::vector<std::thread> threads_ ;
+  /// Guards #done_
+  std::mutex doneLock_ ;
+  /// Signalled when an entrant finishes
+  std::condition_variable doneCond_ ;
+  /// True when the entrant has finished (or never started), by entrant
+  std::vector<bool> done_ ;
+
+  /// Copying is not supported
+  AlgorithmRace(const AlgorithmRace &) ;
+  AlgorithmRace &operator=(const AlgorithmRace &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef Osi2BatchSolveAPI_HPP
+# define Osi2BatchSolveAPI_HPP
+
+/*! \file Osi2BatchSolveAPI.hpp
+
+  Provides an %API to solve a stream of independent problems with a pool of
+  solver objects.
+*/
+
+#include <string>
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ControlAPI.hpp"
+#include "Osi2RunParamsAPI.hpp"
+
+namespace Osi2 {
+
+/*! \brief Solve a batch of independent problems
+
+  A BatchSolveAPI object owns a pool of workers, each with its own
+  ClpSimplex object. Problems are submitted as descriptors (#Job) and solved
+  in whatever order the workers get to them; results are returned in the
+  order the solves complete.
+
+  Typical use:
+  <ul>
+    <li> #start the pool, supplying the ControlAPI object used to create the
+	 solver objects.
+    <li> #submit jobs; each is given a job id.
+    <li> Collect results with #nextResult until all jobs are accounted for.
+    <li> #stop the pool (or let the destructor do it).
+  </ul>
+  Jobs may be submitted while results are being collected.
+*/
+class BatchSolveAPI : public API {
+
+public:
+
+  /// Return the "ident" string for the BatchSolve %API
+  inline static const char *getAPIIDString () { return ("BatchSolve") ; }
+
+  /*! \brief Description of a problem to be solved
+
+    The problem is either read from the MPS file #path_ or loaded from the
+    column-major arrays, following the conventions of
+    ClpSimplexAPI::loadProblem. If #path_ is not empty, the arrays are
+    ignored. The arrays are not copied; they must remain valid and unchanged
+    until the result for the job is returned.
+
+    If #params_ is not null, it's applied with ClpSimplexAPI::loadParams
+    before the solve. The parameter object is copied when the job is
+    submitted.
+  */
+  struct Job {
+    std::string path_ ;
+    int numCols_ ;
+    int numRows_ ;
+    const CoinBigIndex *start_ ;
+    const int *index_ ;
+    const double *value_ ;
+    const double *colLower_ ;
+    const double *colUpper_ ;
+    const double *obj_ ;
+    const double *rowLower_ ;
+    const double *rowUpper_ ;
+    const RunParamsAPI *params_ ;
+    /// If true, the primal and dual solutions are returned with the result
+    bool keepSolution_ ;
+
+    Job ()
+      : numCols_(0), numRows_(0),
+	start_(nullptr), index_(nullptr), value_(nullptr),
+	colLower_(nullptr), colUpper_(nullptr), obj_(nullptr),
+	rowLower_(nullptr), rowUpper_(nullptr),
+	params_(nullptr), keepSolution_(false)
+    { }
+  } ;
+
+  /// Result of a job
+  struct Result {
+    /// Job id, as returned by #submit
+    long jobID_ ;
+    /*! \brief Return code
+
+      From ClpSimplexAPI::initialSolve, or the (nonzero) return code from
+      ClpSimplexAPI::readMps if the problem couldn't be read.
+    */
+    int retval_ ;
+    /// Problem status (ClpSimplexAPI::status)
+    int status_ ;
+    /// Secondary status (ClpSimplexAPI::secondaryStatus)
+    int secondaryStatus_ ;
+    /// Iteration count
+    int iterations_ ;
+    /// Objective value
+    double objective_ ;
+    /// Wall clock time for load and solve (seconds)
+    double seconds_ ;
+    /// Primal solution (only if Job::keepSolution_)
+    std::vector<double> colSolution_ ;
+    /// Dual solution (only if Job::keepSolution_)
+    std::vector<double> rowPrice_ ;
+  } ;
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /// Virtual destructor
+  virtual ~BatchSolveAPI () { }
+  //@}
+
+  /*! \name Pool control */
+  //@{
+  /*! \brief Start the worker pool
+
+    Creates \p workers solver objects using \p ctrl and starts a thread for
+    each. If \p workers is less than 1, the number of hardware threads is
+    used. Returns 0 on success, a negative value if no solver object could
+    be created.
+  */
+  virtual int start(ControlAPI &ctrl, int workers = 0) = 0 ;
+
+  /*! \brief Stop the worker pool
+
+    Jobs not yet started are abandoned (no result is returned for them).
+    Waits for jobs in progress to finish, then destroys the solver objects.
+    Results already produced can still be collected.
+  */
+  virtual void stop() = 0 ;
+
+  /// Number of workers in the pool (0 if not started)
+  virtual int getWorkerCnt() const = 0 ;
+  //@}
+
+  /*! \name Jobs and results */
+  //@{
+  /// Submit a job; returns the job id, or -1 if the pool isn't running
+  virtual long submit(const Job &job) = 0 ;
+
+  /*! \brief Retrieve the next completed result
+
+    Results are returned in completion order. If \p wait is true and no
+    result is ready, block until one is. Returns false if no result is
+    ready and either \p wait is false or there are no jobs outstanding.
+  */
+  virtual bool nextResult(Result &result, bool wait = true) = 0 ;
+
+  /// Number of jobs submitted whose results have not yet been retrieved
+  virtual long outstanding() const = 0 ;
+  //@}
+
+} ;
+
+}  // end namespace Osi2
+
+#endif
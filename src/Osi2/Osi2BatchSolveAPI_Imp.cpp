@@ -0,0 +1,370 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for the Osi2
+  BatchSolve API.
+*/
+
+#include <chrono>
+#include <utility>
+
+#include "Osi2Config.h"
+
+#include "Osi2PluginManager.hpp"
+#include "Osi2BatchSolveAPI_Imp.hpp"
+
+
+namespace {
+
+/*
+  Registration instance for BatchSolveAPI.
+*/
+
+static Osi2::BatchSolveAPI_Imp regObj(Osi2::BatchSolveAPI::getAPIIDString()) ;
+
+/*
+  The plugin management methods. As for RunParamsAPI, create and destroy
+  simply invoke the constructor and destructor, respectively.
+*/
+static void *create (const Osi2::ObjectParams *params)
+{
+  std::string what = reinterpret_cast<const char *>(params->apiStr_) ;
+  void *retval = nullptr ;
+  if (what == Osi2::BatchSolveAPI::getAPIIDString()) {
+    retval = new Osi2::BatchSolveAPI_Imp() ;
+  }
+  return (retval) ;
+}
+
+static int destroy (void *victim, const Osi2::ObjectParams *objParms)
+{
+  std::string what = reinterpret_cast<const char *>(objParms->apiStr_) ;
+  int retval = 1 ;
+  if (what == Osi2::BatchSolveAPI::getAPIIDString()) {
+    Osi2::API *api = static_cast<Osi2::API *>(victim) ;
+    delete api ;
+    retval = 0 ;
+  }
+
+  return (retval) ;
+}
+
+/*
+  Nothing to be done to close out an innate plugin.
+*/
+static int cleanup (const Osi2::PlatformServices *services)
+{
+  return (0) ;
+}
+
+/*
+  Plugin initialisation method.
+*/
+static Osi2::ExitFunc initPlugin (Osi2::PlatformServices *services)
+{
+  services->ctrlObj_ = nullptr ;
+/*
+  Register our API.
+*/
+  Osi2::APIRegInfo reginfo ;
+  reginfo.version_.major_ = 1 ;
+  reginfo.version_.minor_ = 0 ;
+  reginfo.pluginID_ = services->pluginID_ ;
+  reginfo.lang_ = Osi2::Plugin_CPP ;
+  reginfo.ctrlObj_ = nullptr ;
+  reginfo.createFunc_ = create ;
+  reginfo.destroyFunc_ = destroy ;
+  const char *apiName = Osi2::BatchSolveAPI::getAPIIDString() ;
+  int retval =
+    services->registerAPI_(reinterpret_cast<const Osi2::CharString *>(apiName),
+    			   &reginfo) ;
+
+  if (retval < 0) { return (nullptr) ; }
+
+  return (cleanup) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+/*
+  Create the workers. Solver objects are created here, in the calling
+  thread, because object creation goes through the plugin manager, which is
+  not safe to call concurrently. Only then are the threads started.
+*/
+int BatchSolveAPI_Imp::start (ControlAPI &ctrl, int workers)
+{
+  if (workers_.size() > 0) return (0) ;
+  if (workers < 1) {
+    workers = static_cast<int>(std::thread::hardware_concurrency()) ;
+    if (workers < 1) workers = 1 ;
+  }
+  ctrl_ = &ctrl ;
+  for (int ndx = 0 ; ndx < workers ; ndx++) {
+    API *apiObj = nullptr ;
+    int retval = ctrl.createObject(apiObj,ClpSimplexAPI::getAPIIDString()) ;
+    if (retval != 0 || apiObj == nullptr) break ;
+    void *tmp = apiObj->getAPIPtr(ClpSimplexAPI::getAPIIDString()) ;
+    if (tmp == nullptr) {
+      ctrl.destroyObject(apiObj) ;
+      break ;
+    }
+    Worker *worker = new Worker ;
+    worker->solverObj_ = apiObj ;
+    worker->solver_ = static_cast<ClpSimplexAPI *>(tmp) ;
+    worker->dfltParamsObj_ = nullptr ;
+    worker->dfltParams_ = nullptr ;
+    retval = ctrl.createObject(worker->dfltParamsObj_,
+			       RunParamsAPI::getAPIIDString()) ;
+    if (retval == 0 && worker->dfltParamsObj_ != nullptr) {
+      worker->dfltParams_ =
+	dynamic_cast<RunParamsAPI *>(worker->dfltParamsObj_) ;
+      worker->solver_->exposeParams(*worker->dfltParams_) ;
+    }
+    workers_.push_back(worker) ;
+  }
+  if (workers_.size() == 0) return (-1) ;
+
+  stopping_ = false ;
+  for (int ndx = 0 ; ndx < workers_.size() ; ndx++) {
+    workers_[ndx]->thread_ = std::thread(&BatchSolveAPI_Imp::work,this,ndx) ;
+  }
+
+  return (0) ;
+}
+
+/*
+  Tell the workers to quit, wait for them, then throw away any jobs still
+  queued and destroy the solvers. A second call made while the first is
+  still tearing down finds stopping_ set and returns at once; otherwise both
+  would join and delete the same workers.
+*/
+void BatchSolveAPI_Imp::stop ()
+{
+  {
+    std::lock_guard<std::mutex> lock(poolLock_) ;
+    if (workers_.size() == 0 || stopping_) return ;
+    stopping_ = true ;
+  }
+  workAvail_.notify_all() ;
+
+  long abandoned = 0 ;
+  for (int ndx = 0 ; ndx < workers_.size() ; ndx++) {
+    Worker *worker = workers_[ndx] ;
+    worker->thread_.join() ;
+    for (int t = 0 ; t < worker->queue_.size() ; t++) {
+      delete worker->queue_[t].params_ ;
+      abandoned++ ;
+    }
+    if (worker->dfltParamsObj_ != nullptr) {
+      ctrl_->destroyObject(worker->dfltParamsObj_) ;
+    }
+    ctrl_->destroyObject(worker->solverObj_) ;
+    delete worker ;
+  }
+  {
+    std::lock_guard<std::mutex> lock(poolLock_) ;
+    workers_.clear() ;
+    pending_ = 0 ;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(resultLock_) ;
+    outstanding_ -= abandoned ;
+  }
+  resultAvail_.notify_all() ;
+}
+
+/*
+  Copy the parameters (the client is free to change its object as soon as
+  we return), deal the job to the next queue, and only then make it
+  available for reservation. The pool lock is held throughout so that a
+  concurrent stop can't dismantle the workers while we're queueing.
+*/
+long BatchSolveAPI_Imp::submit (const Job &job)
+{
+  std::unique_lock<std::mutex> poolGuard(poolLock_) ;
+  if (workers_.size() == 0 || stopping_) return (-1) ;
+
+  Task task ;
+  task.jobID_ = nextJobID_++ ;
+  task.job_ = job ;
+  task.params_ = (job.params_ == nullptr)?nullptr:job.params_->clone() ;
+  task.job_.params_ = nullptr ;
+  {
+    std::lock_guard<std::mutex> lock(resultLock_) ;
+    outstanding_++ ;
+  }
+  Worker *worker = workers_[nextQueue_++%workers_.size()] ;
+  {
+    std::lock_guard<std::mutex> lock(worker->queueLock_) ;
+    worker->queue_.push_back(task) ;
+  }
+  pending_++ ;
+  poolGuard.unlock() ;
+  workAvail_.notify_one() ;
+
+  return (task.jobID_) ;
+}
+
+/*
+  Own queue first (front), then steal from the others (back), starting with
+  our neighbour so that thieves spread out.
+*/
+bool BatchSolveAPI_Imp::takeTask (int self, Task &task)
+{
+  int workerCnt = static_cast<int>(workers_.size()) ;
+  for (int k = 0 ; k < workerCnt ; k++) {
+    Worker *victim = workers_[(self+k)%workerCnt] ;
+    std::lock_guard<std::mutex> lock(victim->queueLock_) ;
+    if (victim->queue_.empty()) continue ;
+    if (k == 0) {
+      task = victim->queue_.front() ;
+      victim->queue_.pop_front() ;
+    } else {
+      task = victim->queue_.back() ;
+      victim->queue_.pop_back() ;
+    }
+    return (true) ;
+  }
+  return (false) ;
+}
+
+void BatchSolveAPI_Imp::runTask (Worker &worker, Task &task, Result &result)
+{
+  typedef std::chrono::steady_clock Clock ;
+  Clock::time_point begin = Clock::now() ;
+  ClpSimplexAPI *solver = worker.solver_ ;
+  const Job &job = task.job_ ;
+
+  result.jobID_ = task.jobID_ ;
+  result.status_ = -1 ;
+  result.secondaryStatus_ = -1 ;
+  result.iterations_ = 0 ;
+  result.objective_ = 0.0 ;
+
+/*
+  Restore the default parameters before loading the problem; the problem
+  name and objective offset come with the problem and must not be
+  overwritten afterwards.
+*/
+  if (worker.dfltParams_ != nullptr) solver->loadParams(*worker.dfltParams_) ;
+  if (job.path_.empty()) {
+    solver->loadProblem(job.numCols_,job.numRows_,
+			job.start_,job.index_,job.value_,
+			job.colLower_,job.colUpper_,job.obj_,
+			job.rowLower_,job.rowUpper_) ;
+    result.retval_ = 0 ;
+  } else {
+    result.retval_ = solver->readMps(job.path_.c_str()) ;
+  }
+  if (result.retval_ == 0) {
+    if (task.params_ != nullptr) solver->loadParams(*task.params_) ;
+    result.retval_ = solver->initialSolve() ;
+    result.status_ = solver->status() ;
+    result.secondaryStatus_ = solver->secondaryStatus() ;
+    result.iterations_ = solver->numberIterations() ;
+    result.objective_ = solver->objectiveValue() ;
+    if (job.keepSolution_) {
+      const double *vec = solver->getColSolution() ;
+      result.colSolution_.assign(vec,vec+solver->numberColumns()) ;
+      vec = solver->getRowPrice() ;
+      result.rowPrice_.assign(vec,vec+solver->numberRows()) ;
+    }
+  }
+  std::chrono::duration<double> elapsed = Clock::now()-begin ;
+  result.seconds_ = elapsed.count() ;
+}
+
+/*
+  Reserve a job, find it, run it, and post the result. The reservation
+  guarantees that takeTask will find a job, though it may need more than
+  one try if another worker moved it around in the meantime.
+*/
+void BatchSolveAPI_Imp::work (int self)
+{
+  Worker &worker = *workers_[self] ;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(poolLock_) ;
+      while (!stopping_ && pending_ == 0) workAvail_.wait(lock) ;
+      if (stopping_) return ;
+      pending_-- ;
+    }
+    Task task ;
+    while (!takeTask(self,task)) std::this_thread::yield() ;
+
+    Result result ;
+    runTask(worker,task,result) ;
+    delete task.params_ ;
+    {
+      std::lock_guard<std::mutex> lock(resultLock_) ;
+      results_.push_back(std::move(result)) ;
+    }
+    resultAvail_.notify_all() ;
+  }
+}
+
+bool BatchSolveAPI_Imp::nextResult (Result &result, bool wait)
+{
+  std::unique_lock<std::mutex> lock(resultLock_) ;
+  if (wait) {
+    while (results_.empty() && outstanding_ > 0) resultAvail_.wait(lock) ;
+  }
+  if (results_.empty()) return (false) ;
+  result = std::move(results_.front()) ;
+  results_.pop_front() ;
+  outstanding_-- ;
+  return (true) ;
+}
+
+long BatchSolveAPI_Imp::outstanding () const
+{
+  std::lock_guard<std::mutex> lock(resultLock_) ;
+  return (outstanding_) ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+BatchSolveAPI_Imp::BatchSolveAPI_Imp ()
+  : ctrl_(nullptr),
+    pending_(0),
+    stopping_(false),
+    outstanding_(0),
+    nextJobID_(0),
+    nextQueue_(0)
+{ }
+
+/*
+  Registration constructor
+
+  The sole purpose of this constructor is to register the BatchSolve API
+  with the plugin manager during program startup. Use this constructor to
+  construct a static, file local instance that has absolutely no other use.
+*/
+BatchSolveAPI_Imp::BatchSolveAPI_Imp (std::string name)
+  : ctrl_(nullptr),
+    pending_(0),
+    stopping_(false),
+    outstanding_(0),
+    nextJobID_(0),
+    nextQueue_(0)
+{
+  PluginManager *pluginMgr = &PluginManager::getInstance() ;
+
+  pluginMgr->addPreloadLib(name,initPlugin) ;
+}
+
+BatchSolveAPI_Imp::~BatchSolveAPI_Imp ()
+{
+  stop() ;
+}
+
+}  // end namespace Osi2
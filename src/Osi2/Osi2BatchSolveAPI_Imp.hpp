@@ -0,0 +1,128 @@
+#ifndef Osi2BatchSolveAPI_Imp_HPP
+# define Osi2BatchSolveAPI_Imp_HPP
+
+/*! \file Osi2BatchSolveAPI_Imp.hpp
+
+  Provides a class to implement Osi2::BatchSolveAPI.
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Osi2BatchSolveAPI.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+namespace Osi2 {
+
+/*! \brief Implementation class for BatchSolveAPI
+
+  Each worker owns a ClpSimplex object, a thread, and a queue of jobs.
+  #submit deals jobs to the worker queues round robin. A worker takes jobs
+  from the front of its own queue; when that's empty, it steals from the
+  back of another worker's queue. Idle workers sleep until a job is
+  submitted.
+
+  A worker reserves a job (by decrementing the count of queued jobs) before
+  it goes looking for one, so a worker that holds a reservation is
+  guaranteed to find a job in some queue.
+
+  If the RunParams %API is available from the ControlAPI object, the
+  parameters of each solver are captured when the pool starts and restored
+  before every job, so that parameters applied for one job don't leak into
+  the next.
+*/
+class BatchSolveAPI_Imp : public BatchSolveAPI {
+
+public:
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /// Registration constructor
+  BatchSolveAPI_Imp (std::string name) ;
+  /// Default constructor
+  BatchSolveAPI_Imp () ;
+  /// Destructor; stops the pool
+  ~BatchSolveAPI_Imp () ;
+  //@}
+
+  /*! \name Pool control */
+  //@{
+  int start(ControlAPI &ctrl, int workers = 0) ;
+  void stop() ;
+  int getWorkerCnt() const { return (static_cast<int>(workers_.size())) ; }
+  //@}
+
+  /*! \name Jobs and results */
+  //@{
+  long submit(const Job &job) ;
+  bool nextResult(Result &result, bool wait = true) ;
+  long outstanding() const ;
+  //@}
+
+private:
+
+  /// A job waiting in a queue; params_ is a private copy
+  struct Task {
+    long jobID_ ;
+    Job job_ ;
+    RunParamsAPI *params_ ;
+  } ;
+
+  /// A worker: solver, thread, and job queue
+  struct Worker {
+    API *solverObj_ ;
+    ClpSimplexAPI *solver_ ;
+    API *dfltParamsObj_ ;
+    RunParamsAPI *dfltParams_ ;
+    std::mutex queueLock_ ;
+    std::deque<Task> queue_ ;
+    std::thread thread_ ;
+  } ;
+
+  /// Body of the thread for worker \p self
+  void work(int self) ;
+  /// Claim a job, preferring worker \p self's queue; false if none found
+  bool takeTask(int self, Task &task) ;
+  /// Load and solve one job
+  void runTask(Worker &worker, Task &task, Result &result) ;
+
+  /// Control object used to create and destroy solver objects
+  ControlAPI *ctrl_ ;
+  /// The workers
+  std::vector<Worker *> workers_ ;
+
+  /// Guards #pending_ and #stopping_, and #workers_ against #stop
+  std::mutex poolLock_ ;
+  /// Signalled when a job is submitted or the pool is stopping
+  std::condition_variable workAvail_ ;
+  /// Number of queued jobs not yet reserved by a worker
+  long pending_ ;
+  /// True when the pool is stopping
+  bool stopping_ ;
+
+  /// Guards #results_ and #outstanding_
+  mutable std::mutex resultLock_ ;
+  /// Signalled when a result is ready
+  std::condition_variable resultAvail_ ;
+  /// Completed results, in completion order
+  std::deque<Result> results_ ;
+  /// Jobs submitted whose results have not been retrieved
+  long outstanding_ ;
+
+  /// Next job id
+  std::atomic<long> nextJobID_ ;
+  /// Next queue for #submit
+  std::atomic<unsigned> nextQueue_ ;
+
+  /// Copying is not supported
+  BatchSolveAPI_Imp (const BatchSolveAPI_Imp &) ;
+  BatchSolveAPI_Imp &operator= (const BatchSolveAPI_Imp &) ;
+
+} ;
+
+}  // end namespace Osi2
+
+#endif
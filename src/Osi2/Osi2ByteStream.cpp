@@ -0,0 +1,160 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for the byte
+  streams.
+*/
+
+#include "Osi2Config.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Osi2ByteStream.hpp"
+
+namespace Osi2 {
+
+size_t FileInputStream::read (char *buf, size_t len)
+{
+  if (file_ == nullptr) return (0) ;
+  return (std::fread(buf,1,len,file_)) ;
+}
+
+bool FileInputStream::failed () const
+{
+  return (file_ == nullptr || std::ferror(file_) != 0) ;
+}
+
+size_t MemoryInputStream::read (char *buf, size_t len)
+{
+  size_t got = std::min(len,left_) ;
+  std::memcpy(buf,ptr_,got) ;
+  ptr_ += got ;
+  left_ -= got ;
+  return (got) ;
+}
+
+bool FileOutputStream::write (const char *buf, size_t len)
+{
+  if (file_ == nullptr || !ok_) return (false) ;
+  ok_ = (std::fwrite(buf,1,len,file_) == len) ;
+  return (ok_) ;
+}
+
+bool FileOutputStream::close ()
+{
+  if (file_ == nullptr) return (false) ;
+  ok_ = (std::fclose(file_) == 0) && ok_ ;
+  file_ = nullptr ;
+  return (ok_) ;
+}
+
+/*
+  The producer fills whole chunks and waits while the queue is full. An
+  empty chunk is never queued; end of stream is signalled by done_.
+*/
+void PipelinedInputStream::produce ()
+{
+  while (true) {
+    std::vector<char> chunk(chunkSize_) ;
+    size_t got = 0 ;
+    while (got < chunkSize_) {
+      size_t more = source_->read(&chunk[got],chunkSize_-got) ;
+      if (more == 0) break ;
+      got += more ;
+    }
+    chunk.resize(got) ;
+    std::unique_lock<std::mutex> lock(lock_) ;
+    changed_.wait(lock,
+		  [this] { return (stop_ || queue_.size() < depth_) ; }) ;
+    if (stop_) return ;
+    if (got > 0) {
+      queue_.push_back(std::vector<char>()) ;
+      queue_.back().swap(chunk) ;
+    }
+    if (got < chunkSize_) {
+      done_ = true ;
+      failed_ = source_->failed() ;
+    }
+    changed_.notify_all() ;
+    if (done_) return ;
+  }
+}
+
+size_t PipelinedInputStream::read (char *buf, size_t len)
+{
+  size_t got = 0 ;
+  while (got < len) {
+    if (pos_ == current_.size()) {
+      std::unique_lock<std::mutex> lock(lock_) ;
+      changed_.wait(lock,[this] { return (done_ || !queue_.empty()) ; }) ;
+      if (queue_.empty()) break ;
+      current_.swap(queue_.front()) ;
+      queue_.pop_front() ;
+      pos_ = 0 ;
+      changed_.notify_all() ;
+    }
+    size_t take = std::min(len-got,current_.size()-pos_) ;
+    std::memcpy(buf+got,&current_[pos_],take) ;
+    pos_ += take ;
+    got += take ;
+  }
+  return (got) ;
+}
+
+bool PipelinedInputStream::failed () const
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  return (failed_) ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+FileInputStream::FileInputStream (const char *filename)
+  : file_(std::fopen(filename,"rb"))
+{ }
+
+FileInputStream::~FileInputStream ()
+{
+  if (file_ != nullptr) std::fclose(file_) ;
+}
+
+FileOutputStream::FileOutputStream (const char *filename)
+  : file_(std::fopen(filename,"wb")),
+    ok_(true)
+{ }
+
+FileOutputStream::~FileOutputStream ()
+{
+  if (file_ != nullptr) std::fclose(file_) ;
+}
+
+PipelinedInputStream::PipelinedInputStream
+    (std::unique_ptr<InputStream> source, size_t chunkSize, int depth)
+  : source_(std::move(source)),
+    chunkSize_(std::max(chunkSize,static_cast<size_t>(1))),
+    depth_(std::max(depth,1)),
+    pos_(0),
+    done_(false),
+    stop_(false),
+    failed_(false)
+{
+  thread_ = std::thread(&PipelinedInputStream::produce,this) ;
+}
+
+PipelinedInputStream::~PipelinedInputStream ()
+{
+  {
+    std::lock_guard<std::mutex> lock(lock_) ;
+    stop_ = true ;
+  }
+  changed_.notify_all() ;
+  thread_.join() ;
+}
+
+}  // end namespace Osi2
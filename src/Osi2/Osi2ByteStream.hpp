@@ -0,0 +1,193 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ByteStream.hpp
+
+  Defines InputStream and OutputStream, the byte streams used by the model
+  readers and writers, with implementations over files and memory and an
+  input stream that reads ahead on a separate thread.
+*/
+
+#ifndef Osi2ByteStream_HPP
+#define Osi2ByteStream_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Osi2 {
+
+/*! \brief A source of bytes
+
+  #read returns the number of bytes delivered, which is short only at the
+  end of the stream or on error; #failed tells the two apart.
+*/
+class InputStream {
+
+public:
+
+  /// Destructor
+  virtual ~InputStream() { }
+
+  /// Read up to \p len bytes into \p buf
+  virtual size_t read(char *buf, size_t len) = 0 ;
+  /// True if an error has occurred
+  virtual bool failed() const = 0 ;
+
+} ;
+
+/*! \brief A sink for bytes
+
+  Nothing is guaranteed to reach its destination until #close returns
+  true. Destroying a stream that has not been closed abandons the output.
+*/
+class OutputStream {
+
+public:
+
+  /// Destructor
+  virtual ~OutputStream() { }
+
+  /// Write \p len bytes; returns false on error
+  virtual bool write(const char *buf, size_t len) = 0 ;
+  /// Flush and finish the stream; returns false on error
+  virtual bool close() = 0 ;
+
+} ;
+
+/// Input from a file
+class FileInputStream : public InputStream {
+
+public:
+
+  /// Constructor; check #isOpen
+  FileInputStream(const char *filename) ;
+  /// Destructor
+  ~FileInputStream() ;
+
+  /// True if the file was opened
+  bool isOpen() const { return (file_ != nullptr) ; }
+
+  size_t read(char *buf, size_t len) ;
+  bool failed() const ;
+
+private:
+
+  std::FILE *file_ ;
+
+  /// Copying is not supported
+  FileInputStream(const FileInputStream &) ;
+  FileInputStream &operator=(const FileInputStream &) ;
+
+} ;
+
+/// Input from a block of memory owned by someone else
+class MemoryInputStream : public InputStream {
+
+public:
+
+  /// Constructor
+  MemoryInputStream(const char *begin, size_t len)
+    : ptr_(begin), left_(len)
+  { }
+
+  size_t read(char *buf, size_t len) ;
+  bool failed() const { return (false) ; }
+
+private:
+
+  const char *ptr_ ;
+  size_t left_ ;
+
+} ;
+
+/// Output to a file
+class FileOutputStream : public OutputStream {
+
+public:
+
+  /// Constructor; check #isOpen
+  FileOutputStream(const char *filename) ;
+  /// Destructor
+  ~FileOutputStream() ;
+
+  /// True if the file was created
+  bool isOpen() const { return (file_ != nullptr) ; }
+
+  bool write(const char *buf, size_t len) ;
+  bool close() ;
+
+private:
+
+  std::FILE *file_ ;
+  bool ok_ ;
+
+  /// Copying is not supported
+  FileOutputStream(const FileOutputStream &) ;
+  FileOutputStream &operator=(const FileOutputStream &) ;
+
+} ;
+
+/*! \brief Read ahead on a separate thread
+
+  A thread reads chunks from the underlying stream into a bounded queue
+  while the consumer takes them from the other end. When the underlying
+  stream decompresses, decompression and parsing proceed in parallel, and
+  memory use is bounded by the queue.
+*/
+class PipelinedInputStream : public InputStream {
+
+public:
+
+  /*! \brief Constructor
+
+    Takes ownership of \p source. At most \p depth chunks of \p chunkSize
+    bytes are held at once.
+  */
+  PipelinedInputStream(std::unique_ptr<InputStream> source,
+		       size_t chunkSize = 1<<20, int depth = 4) ;
+  /// Destructor; stops the thread
+  ~PipelinedInputStream() ;
+
+  size_t read(char *buf, size_t len) ;
+  bool failed() const ;
+
+private:
+
+  /// Body of the reading thread
+  void produce() ;
+
+  std::unique_ptr<InputStream> source_ ;
+  size_t chunkSize_ ;
+  size_t depth_ ;
+  /// Chunks read and not yet consumed
+  std::deque<std::vector<char> > queue_ ;
+  /// The chunk being consumed and the position in it
+  std::vector<char> current_ ;
+  size_t pos_ ;
+  /// Set by the producer at end of stream, by the consumer to stop it
+  bool done_ ;
+  bool stop_ ;
+  bool failed_ ;
+  mutable std::mutex lock_ ;
+  std::condition_variable changed_ ;
+  std::thread thread_ ;
+
+  /// Copying is not supported
+  PipelinedInputStream(const PipelinedInputStream &) ;
+  PipelinedInputStream &operator=(const PipelinedInputStream &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef Osi2ClpSimplexAPI_HPP
 # define Osi2ClpSimplexAPI_HPP
 
+#include <string>
 #include <vector>
 
 #include "Clp_C_Interface.h"
@@ -79,6 +80,18 @@ public:
     const double *obj,
     const double *rowlb, const double *rowub) = 0 ;
 
+  /*! \brief Load a problem, taking ownership of the arguments
+
+    As #loadProblem, but the arrays become the property of the object and
+    the pointers are set to null on return. The arrays must have been
+    allocated with <code>new[]</code>. An implementation that can't adopt
+    the arrays copies them and frees them before returning.
+  */
+  virtual void assignProblem(const int numcols, const int numrows,
+    CoinBigIndex *&start, int *&index, double *&value,
+    double *&collb, double *&colub, double *&obj,
+    double *&rowlb, double *&rowub) = 0 ;
+
   /// read quadratic part of the objective (the matrix part)
   virtual void loadQuadraticObjective(const int numberColumns,
     const CoinBigIndex *start, const int *index, const double *value) = 0 ;
@@ -113,30 +126,50 @@ public:
   /// Delete columns
   virtual void deleteColumns(int number, const int *which) = 0 ;
 
+  /*! \brief Pending modifications
+
+    An implementation may hold back changes to the bounds, objective,
+    matrix coefficients, and variable status, and pass them to the solver in
+    a single pass before the next solve or the next method that reads the
+    model. Repeated changes to the same element are coalesced; the last one
+    wins. #flush applies pending changes immediately.
+  */
+  virtual void flush() = 0 ;
+
   /// Get row lower bounds
   virtual double *rowLower() const = 0 ;
   /// Change row lower bounds
   virtual void chgRowLower(const double *rowLower) = 0 ;
+  /// Change the lower bound of one row
+  virtual void setRowLower(int iRow, double value) = 0 ;
 
   /// Get row upper bounds
   virtual double *rowUpper() const = 0 ;
   /// Change row upper bounds
   virtual void chgRowUpper(const double *rowUpper) = 0 ;
+  /// Change the upper bound of one row
+  virtual void setRowUpper(int iRow, double value) = 0 ;
 
   /// Get column lower bounds
   virtual double *columnLower() const = 0 ;
   /// Change column lower bounds
   virtual void chgColumnLower(const double *columnLower) = 0 ;
+  /// Change the lower bound of one column
+  virtual void setColumnLower(int iCol, double value) = 0 ;
 
   /// Get column upper bounds
   virtual double *columnUpper() const = 0 ;
   /// Change column upper bounds
   virtual void chgColumnUpper(const double *columnUpper) = 0 ;
+  /// Change the upper bound of one column
+  virtual void setColumnUpper(int iCol, double value) = 0 ;
   
   /// Get objective coefficients
   virtual double *objective() const = 0 ;
   /// Change objective coefficients
   virtual void chgObjCoefficients(const double *objIn) = 0 ;
+  /// Change the objective coefficient of one column
+  virtual void setObjectiveCoefficient(int iCol, double value) = 0 ;
 
   /// Number of elements in matrix
   virtual CoinBigIndex getNumElements() const = 0 ;
@@ -174,6 +207,27 @@ public:
   */
   virtual void setRowStatus(int sequence,
   			    ClpSimplexAPI::Status newStatus) = 0 ;
+  /*! \brief Get status for a range of columns
+
+    Fills \p status with the status of columns \p first through \p last-1.
+    If no status array exists, all columns are reported as isFree.
+  */
+  virtual void getColumnStatus(int first, int last,
+  			       ClpSimplexAPI::Status *status) = 0 ;
+  /*! \brief Set status for a range of columns
+
+    Sets the status of columns \p first through \p last-1 from \p status.
+    Like #copyinStatus, and unlike the single-column method, values are
+    not forced to bounds.
+  */
+  virtual void setColumnStatus(int first, int last,
+  			       const ClpSimplexAPI::Status *status) = 0 ;
+  /// Get status for a range of rows (see the column method)
+  virtual void getRowStatus(int first, int last,
+  			    ClpSimplexAPI::Status *status) = 0 ;
+  /// Set status for a range of rows (see the column method)
+  virtual void setRowStatus(int first, int last,
+  			    const ClpSimplexAPI::Status *status) = 0 ;
 
   /// length of names (0 means no names available)
   virtual int lengthNames() const = 0 ;
@@ -188,6 +242,29 @@ public:
   /// Copy in row & column names
   virtual void copyNames(const char *const *rowNames,
   			 const char *const *columnNames) = 0 ;
+  /*! \brief Get names for a range of rows
+
+    The names of rows \p first through \p last-1 are stored one after
+    another, each null-terminated, in \p arena. On return, \p offsets holds
+    last-first+1 entries: the name of row first+k starts at
+    arena[offsets[k]], and offsets[last-first] is the size of the arena. If
+    no names are available, all names are empty.
+  */
+  virtual void rowNames(int first, int last, std::vector<char> &arena,
+  			std::vector<int> &offsets) const = 0 ;
+  /*! \brief Set names for a range of rows
+
+    The name of row first+k is the null-terminated string starting at
+    arena[offsets[k]], for k from 0 to last-first-1.
+  */
+  virtual void setRowNames(int first, int last, const char *arena,
+  			   const int *offsets) = 0 ;
+  /// Get names for a range of columns (see the row method)
+  virtual void columnNames(int first, int last, std::vector<char> &arena,
+  			   std::vector<int> &offsets) const = 0 ;
+  /// Set names for a range of columns (see the row method)
+  virtual void setColumnNames(int first, int last, const char *arena,
+  			      const int *offsets) = 0 ;
   /// Drop names
   virtual void dropNames() = 0 ;
 
@@ -200,6 +277,37 @@ public:
     bool keepNames = false,
     bool ignoreErrors = false) = 0 ; 
 
+  /*! \brief Defer decoding names read by #readMps
+
+    In lazy mode, #readMps with \p keepNames reads the file with MpsReader
+    and leaves the names in the file (see MappedNames): each is decoded
+    when it's asked for, by #rowName, #columnName, #rowNames, or
+    #columnNames, so a large model read only to be solved costs almost
+    nothing for its names. The first change to the names or to the number
+    of rows or columns hands all the names over to the solver, as does
+    anything that has the solver read its names itself (#writeMps,
+    #saveModel, #writeModel). The model cache is not used for a lazy read.
+    Off by default.
+
+    The file is mapped, not copied, until the names are handed over. If it
+    is truncated or rewritten in place meanwhile, reading a name can kill
+    the process with SIGBUS, so the file must be left unchanged for as
+    long as the names may be read from it.
+  */
+  virtual void setLazyNames(bool lazy) = 0 ;
+  /// True if lazy mode is on (see #setLazyNames)
+  virtual bool lazyNames() const = 0 ;
+
+  /*! \brief Write MPS files with ModelWriter
+
+    By default #writeMps uses clp's own writer. With parallel writing on,
+    the file is formatted by ModelWriter, which lays it out as clp would
+    but formats blocks of columns on several threads. Off by default.
+  */
+  virtual void setParallelWrite(bool parallel) = 0 ;
+  /// True if parallel writing is on (see #setParallelWrite)
+  virtual bool parallelWrite() const = 0 ;
+
   /*! \brief Write an MPS file to the given filename
 
     Format type is 0 = normal, 1 = extra or 2 = hex.
@@ -213,6 +321,19 @@ public:
   virtual int saveModel(const char *fileName) = 0 ;
   /// Restore model from a file
   virtual int restoreModel(const char *fileName) = 0 ;
+
+  /*! \brief Write the model in Osi2 binary format (see ModelImage)
+
+    Integer information and names are included if present. Returns 0 on
+    success.
+  */
+  virtual int writeModel(const char *filename) = 0 ;
+  /*! \brief Read a model written by #writeModel
+
+    Returns 0 on success, -1 if the file can't be opened, -2 if it is not a
+    usable model file.
+  */
+  virtual int readModel(const char *filename) = 0 ;
   //@}
 
   /*! \name Parameter Gets & Sets */
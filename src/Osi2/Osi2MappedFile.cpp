@@ -0,0 +1,136 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for MappedFile.
+*/
+
+#include "Osi2Config.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Osi2MappedFile.hpp"
+#include "Osi2StreamCodec.hpp"
+
+namespace Osi2 {
+
+/*
+  An empty file can't be mapped, so it goes the long way round and ends up
+  with no contents. The fallback buffer is a vector of double to guarantee
+  alignment.
+*/
+bool MappedFile::open (const char *filename)
+{
+  close() ;
+#ifndef _WIN32
+  int fd = ::open(filename,O_RDONLY) ;
+  if (fd < 0) return (false) ;
+  struct stat info ;
+  if (fstat(fd,&info) == 0 && info.st_size > 0) {
+    void *addr = mmap(nullptr,info.st_size,PROT_READ,MAP_PRIVATE,fd,0) ;
+    if (addr != MAP_FAILED) {
+      data_ = static_cast<const char *>(addr) ;
+      len_ = static_cast<size_t>(info.st_size) ;
+      mapped_ = true ;
+      ::close(fd) ;
+      return (decode()) ;
+    }
+  }
+  ::close(fd) ;
+#endif
+  std::FILE *file = std::fopen(filename,"rb") ;
+  if (file == nullptr) return (false) ;
+  std::vector<char> contents ;
+  char chunk[1<<16] ;
+  size_t got ;
+  while ((got = std::fread(chunk,1,sizeof(chunk),file)) > 0)
+    contents.insert(contents.end(),chunk,chunk+got) ;
+  bool ok = (std::ferror(file) == 0) ;
+  std::fclose(file) ;
+  if (!ok) return (false) ;
+  buf_.resize((contents.size()+sizeof(double)-1)/sizeof(double)) ;
+  if (!contents.empty())
+    std::memcpy(buf_.data(),contents.data(),contents.size()) ;
+  data_ = reinterpret_cast<const char *>(buf_.data()) ;
+  len_ = contents.size() ;
+  return (decode()) ;
+}
+
+/*
+  If the contents are compressed, decompress them into the buffer and
+  release the original. The buffer starts at eight times the compressed
+  size and grows by doubling as the output arrives.
+*/
+bool MappedFile::decode ()
+{
+  size_t headLen =
+    (len_ < StreamCodec::headSize)?len_:StreamCodec::headSize ;
+  const StreamCodec *codec =
+    StreamCodec::forContent(reinterpret_cast<const unsigned char *>(data_),
+			    headLen) ;
+  if (codec == nullptr) return (true) ;
+  std::unique_ptr<InputStream> stream =
+    codec->decoder(std::unique_ptr<InputStream>
+		     (new MemoryInputStream(data_,len_))) ;
+  std::vector<double> plain(std::max(len_,static_cast<size_t>(1<<16))) ;
+  size_t used = 0 ;
+  while (true) {
+    size_t room = plain.size()*sizeof(double)-used ;
+    if (room == 0) {
+      plain.resize(2*plain.size()) ;
+      continue ;
+    }
+    size_t got =
+      stream->read(reinterpret_cast<char *>(plain.data())+used,room) ;
+    if (got == 0) break ;
+    used += got ;
+  }
+  bool ok = !stream->failed() ;
+  stream.reset() ;
+  close() ;
+  if (!ok) return (false) ;
+  plain.resize((used+sizeof(double)-1)/sizeof(double)) ;
+  buf_.swap(plain) ;
+  data_ = reinterpret_cast<const char *>(buf_.data()) ;
+  len_ = used ;
+  return (true) ;
+}
+
+void MappedFile::close ()
+{
+#ifndef _WIN32
+  if (mapped_) munmap(const_cast<char *>(data_),len_) ;
+#endif
+  buf_.clear() ;
+  data_ = nullptr ;
+  len_ = 0 ;
+  mapped_ = false ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+MappedFile::MappedFile ()
+  : data_(nullptr),
+    len_(0),
+    mapped_(false)
+{ }
+
+MappedFile::~MappedFile ()
+{
+  close() ;
+}
+
+} // namespace Osi2
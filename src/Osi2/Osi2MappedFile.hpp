@@ -0,0 +1,73 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2MappedFile.hpp
+
+  Defines MappedFile, a read-only view of the contents of a file.
+*/
+
+#ifndef Osi2MappedFile_HPP
+#define Osi2MappedFile_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace Osi2 {
+
+/*! \brief Read-only contents of a file
+
+  The file is mapped into memory where the platform allows, so opening it
+  costs next to nothing and pages are read as they are touched. Otherwise
+  the whole file is read into memory. Either way the contents are available
+  from #begin to #end until the object is closed or destroyed. The start of
+  the contents is aligned at least as well as a double.
+
+  A file compressed in a format known to StreamCodec is decompressed into
+  memory when it is opened, and the contents are those of the original.
+*/
+class MappedFile {
+
+public:
+
+  /// Constructor; nothing is open
+  MappedFile() ;
+  /// Destructor; closes the file
+  ~MappedFile() ;
+
+  /// Open \p filename; returns false if it can't be opened or read
+  bool open(const char *filename) ;
+  /// Release the contents
+  void close() ;
+
+  /// Start of the contents
+  const char *begin() const { return (data_) ; }
+  /// One past the end of the contents
+  const char *end() const { return (data_+len_) ; }
+  /// Size of the contents in bytes
+  size_t size() const { return (len_) ; }
+  /// True if the contents are mapped rather than read
+  bool isMapped() const { return (mapped_) ; }
+
+private:
+
+  /// Replace compressed contents with the decompressed contents
+  bool decode() ;
+
+  const char *data_ ;
+  size_t len_ ;
+  bool mapped_ ;
+  /// Contents, if the file could not be mapped
+  std::vector<double> buf_ ;
+
+  /// Copying is not supported
+  MappedFile(const MappedFile &) ;
+  MappedFile &operator=(const MappedFile &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -0,0 +1,99 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for MappedNames.
+*/
+
+#include "Osi2Config.h"
+
+#include <algorithm>
+
+#include "Osi2MappedFile.hpp"
+#include "Osi2MappedNames.hpp"
+
+namespace {
+
+/*
+  The characters that end a name, as for the tokenizer in MpsReader.
+*/
+inline bool endsName (char c)
+{ return (c == ' ' || c == '\t' || c == '\r' || c == '\n') ; }
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+void MappedNames::add (bool rows, const char *name, int len)
+{
+  starts_[rows].push_back(static_cast<size_t>(name-image_->begin())) ;
+  maxLength_ = std::max(maxLength_,len) ;
+}
+
+/*
+  The name is found again by scanning for its end, which spares storing the
+  length of every name.
+*/
+const char *MappedNames::locate (bool rows, int ndx, size_t &len) const
+{
+  len = 0 ;
+  if (ndx < 0 || ndx >= count(rows)) return (nullptr) ;
+  const char *start = image_->begin()+starts_[rows][ndx] ;
+  const char *p = start ;
+  while (p < image_->end() && !endsName(*p)) p++ ;
+  len = p-start ;
+  return (start) ;
+}
+
+std::string MappedNames::name (bool rows, int ndx) const
+{
+  size_t len ;
+  const char *start = locate(rows,ndx,len) ;
+  if (start == nullptr) return (std::string()) ;
+  return (std::string(start,len)) ;
+}
+
+void MappedNames::copyName (bool rows, int ndx, char *buffer) const
+{
+  size_t len ;
+  const char *start = locate(rows,ndx,len) ;
+  if (start != nullptr) std::copy(start,start+len,buffer) ;
+  buffer[len] = '\0' ;
+}
+
+void MappedNames::names (bool rows, int first, int last,
+			 std::vector<char> &arena,
+			 std::vector<int> &offsets) const
+{
+  arena.clear() ;
+  offsets.clear() ;
+  if (first >= last) {
+    offsets.push_back(0) ;
+    return ;
+  }
+  offsets.reserve(last-first+1) ;
+  for (int ndx = first ; ndx < last ; ndx++) {
+    offsets.push_back(static_cast<int>(arena.size())) ;
+    size_t len ;
+    const char *start = locate(rows,ndx,len) ;
+    if (start != nullptr) arena.insert(arena.end(),start,start+len) ;
+    arena.push_back('\0') ;
+  }
+  offsets.push_back(static_cast<int>(arena.size())) ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+MappedNames::MappedNames (MappedFile *image)
+  : image_(image),
+    maxLength_(0)
+{ }
+
+MappedNames::~MappedNames () { }
+
+} // namespace Osi2
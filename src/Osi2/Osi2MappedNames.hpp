@@ -0,0 +1,91 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2MappedNames.hpp
+
+  Defines MappedNames, row and column names left in the file they were read
+  from.
+*/
+
+#ifndef Osi2MappedNames_HPP
+#define Osi2MappedNames_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Osi2 {
+
+class MappedFile ;
+
+/*! \brief Row and column names held as positions in the source file
+
+  A reader that wants to defer the cost of names hands the file image over
+  to a MappedNames object and records where each name starts. Nothing is
+  copied: a name is decoded from the image when it's asked for, and a name
+  never asked for costs only its position. A name runs from its start to
+  the first blank or line end.
+
+  The image is mapped where the platform allows (see MappedFile), so pages
+  of the file not holding names in use can be dropped from memory. The
+  image of a file that had to be read or decompressed stays in memory as
+  long as the object does.
+*/
+class MappedNames {
+
+public:
+
+  /// Constructor; takes ownership of \p image
+  MappedNames(MappedFile *image) ;
+  /// Destructor
+  ~MappedNames() ;
+
+  /// Record the next row (\p rows true) or column name, of length \p len
+  void add(bool rows, const char *name, int len) ;
+
+  /// Number of row or column names recorded
+  int count(bool rows) const
+  { return (static_cast<int>(starts_[rows].size())) ; }
+  /// Length of the longest name recorded
+  int maxLength() const { return (maxLength_) ; }
+
+  /// Name of row or column \p ndx; empty if out of range
+  std::string name(bool rows, int ndx) const ;
+  /*! \brief Copy the name of row or column \p ndx to \p buffer
+
+    The buffer must hold at least #maxLength()+1 characters.
+  */
+  void copyName(bool rows, int ndx, char *buffer) const ;
+  /*! \brief Names of rows or columns \p first to \p last-1
+
+    The layout is that of ClpSimplexAPI::rowNames. Names out of range are
+    empty.
+  */
+  void names(bool rows, int first, int last, std::vector<char> &arena,
+	     std::vector<int> &offsets) const ;
+
+private:
+
+  /// Start and length of the name of row or column \p ndx
+  const char *locate(bool rows, int ndx, size_t &len) const ;
+
+  /// The file image
+  std::unique_ptr<MappedFile> image_ ;
+  /// Start of each name in #image_, for columns (0) and rows (1)
+  std::vector<size_t> starts_[2] ;
+  /// Length of the longest name
+  int maxLength_ ;
+
+  /// Copying is not supported
+  MappedNames(const MappedNames &) ;
+  MappedNames &operator=(const MappedNames &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -0,0 +1,606 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for ModelBuilder.
+*/
+
+#include "Osi2Config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "Osi2ModelBuilder.hpp"
+
+namespace {
+
+const double infinity = std::numeric_limits<double>::max() ;
+
+/*
+  Chunk sizes for the coefficient arenas, in coefficients. Chunks start
+  small and double up to the maximum; a row or column longer than that gets
+  a chunk of its own.
+*/
+const size_t minChunk = 1<<12 ;
+const size_t maxChunk = 1<<22 ;
+
+/*
+  Below this many coefficients the transpose isn't worth a thread.
+*/
+const size_t minParallel = 1<<16 ;
+
+/*
+  Bounds of 1e30 or more are infinite.
+*/
+inline double clampInfinity (double value)
+{
+  if (value >= 1.0e30) return (infinity) ;
+  if (value <= -1.0e30) return (-infinity) ;
+  return (value) ;
+}
+
+/*
+  FNV-1a over the characters of the name.
+*/
+inline size_t hashName (const char *name)
+{
+  uint64_t hash = 14695981039346656037ULL ;
+  for ( ; *name != '\0' ; name++) {
+    hash ^= static_cast<unsigned char>(*name) ;
+    hash *= 1099511628211ULL ;
+  }
+  return (static_cast<size_t>(hash)) ;
+}
+
+/*
+  Run task(0), ..., task(numTasks-1), each in its own thread. The calling
+  thread takes task 0.
+*/
+template <class Task>
+void runTasks (int numTasks, Task task)
+{
+  std::vector<std::thread> threads ;
+  for (int k = 1 ; k < numTasks ; k++)
+    threads.push_back(std::thread(task,k)) ;
+  if (numTasks > 0) task(0) ;
+  for (size_t ndx = 0 ; ndx < threads.size() ; ndx++) threads[ndx].join() ;
+}
+
+/*
+  assignProblem wants arrays from new[]. The matrix already is; the rim
+  vectors are copied with this.
+*/
+double *newCopy (const std::vector<double> &vec)
+{
+  double *copy = new double[vec.size()] ;
+  std::copy(vec.begin(),vec.end(),copy) ;
+  return (copy) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+/*
+  Coefficients are stored in chunks that are never reallocated. A row or
+  column is always stored contiguously within one chunk.
+*/
+class ModelBuilder::Arena {
+
+public:
+
+  Arena () : used_(0), nextSize_(minChunk) { }
+
+  Span add (int len, const int *indices, const double *elements)
+  { Span span = { 0, 0, len } ;
+    if (len <= 0) {
+      span.len_ = 0 ;
+      return (span) ;
+    }
+    if (sizes_.empty() || used_+static_cast<size_t>(len) > sizes_.back()) {
+      size_t size = std::max(nextSize_,static_cast<size_t>(len)) ;
+      indices_.push_back(std::unique_ptr<int[]>(new int[size])) ;
+      elements_.push_back(std::unique_ptr<double[]>(new double[size])) ;
+      sizes_.push_back(size) ;
+      used_ = 0 ;
+      nextSize_ = std::min(2*nextSize_,maxChunk) ;
+    }
+    span.chunk_ = static_cast<int>(sizes_.size())-1 ;
+    span.pos_ = static_cast<int>(used_) ;
+    std::memcpy(indices_.back().get()+used_,indices,len*sizeof(int)) ;
+    std::memcpy(elements_.back().get()+used_,elements,len*sizeof(double)) ;
+    used_ += len ;
+    return (span) ; }
+
+  const int *indices (const Span &span) const
+  { return (indices_[span.chunk_].get()+span.pos_) ; }
+  const double *elements (const Span &span) const
+  { return (elements_[span.chunk_].get()+span.pos_) ; }
+
+/*
+  Chunks are released as the transpose finishes with them. Spans are handed
+  out in chunk order, so a block of consecutive spans uses a run of chunks,
+  and two blocks can share only the chunk at their boundary. Count the
+  blocks that use each chunk; the last block to finish with a chunk frees
+  it.
+*/
+  void countUsers (const std::vector<Span> &spans,
+		   const std::vector<int> &cuts)
+  { users_.reset(new std::atomic<int>[sizes_.size()]) ;
+    for (size_t c = 0 ; c < sizes_.size() ; c++) users_[c] = 0 ;
+    for (size_t k = 0 ; k+1 < cuts.size() ; k++) {
+      int last = -1 ;
+      for (int ndx = cuts[k] ; ndx < cuts[k+1] ; ndx++) {
+	const Span &span = spans[ndx] ;
+	if (span.len_ == 0 || span.chunk_ == last) continue ;
+	last = span.chunk_ ;
+	users_[last]++ ;
+      }
+    } }
+
+  void release (int chunk)
+  { if (--users_[chunk] > 0) return ;
+    indices_[chunk].reset() ;
+    elements_[chunk].reset() ; }
+
+private:
+
+  std::vector<std::unique_ptr<int[]> > indices_ ;
+  std::vector<std::unique_ptr<double[]> > elements_ ;
+  std::vector<size_t> sizes_ ;
+  /// Coefficients used in the last chunk
+  size_t used_ ;
+  size_t nextSize_ ;
+  /// Blocks still using each chunk, set by countUsers
+  std::unique_ptr<std::atomic<int>[]> users_ ;
+} ;
+
+/*
+  Names are held in the layout of ClpSimplexAPI::setRowNames: an arena of
+  null-terminated strings and an offset for each row or column (-1 until
+  finish if the row or column has no name). The index is an open-addressed
+  hash table of row or column indices, kept at most half full.
+*/
+class ModelBuilder::NameTable {
+
+public:
+
+  NameTable () : numNamed_(0), slots_(16,-1) { }
+
+  void add (const char *name)
+  { int ndx = static_cast<int>(offsets_.size()) ;
+    if (name == nullptr) {
+      offsets_.push_back(-1) ;
+      return ;
+    }
+    offsets_.push_back(static_cast<int>(arena_.size())) ;
+    arena_.insert(arena_.end(),name,name+std::strlen(name)+1) ;
+    numNamed_++ ;
+    if (2*numNamed_ > slots_.size()) rehash() ;
+    insert(ndx) ; }
+
+  int find (const char *name) const
+  { size_t mask = slots_.size()-1 ;
+    for (size_t slot = hashName(name)&mask ; slots_[slot] >= 0 ;
+	 slot = (slot+1)&mask) {
+      if (std::strcmp(get(slots_[slot]),name) == 0) return (slots_[slot]) ;
+    }
+    return (-1) ; }
+
+  bool empty () const { return (numNamed_ == 0) ; }
+
+  const char *get (int ndx) const
+  { return ((offsets_[ndx] < 0)?nullptr:&arena_[offsets_[ndx]]) ; }
+
+  const char *arena () const { return (arena_.data()) ; }
+  const int *offsets () const { return (offsets_.data()) ; }
+
+/*
+  Give names of the form R0000012 to anything unnamed, if anything is
+  named.
+*/
+  void finish (char prefix)
+  { if (numNamed_ == 0) return ;
+    for (size_t ndx = 0 ; ndx < offsets_.size() ; ndx++) {
+      if (offsets_[ndx] >= 0) continue ;
+      char buf[16] ;
+      std::snprintf(buf,sizeof(buf),"%c%07d",prefix,static_cast<int>(ndx)) ;
+      offsets_[ndx] = static_cast<int>(arena_.size()) ;
+      arena_.insert(arena_.end(),buf,buf+std::strlen(buf)+1) ;
+      numNamed_++ ;
+      if (2*numNamed_ > slots_.size()) rehash() ;
+      insert(static_cast<int>(ndx)) ;
+    } }
+
+private:
+
+/*
+  A name already present keeps its first owner.
+*/
+  void insert (int ndx)
+  { size_t mask = slots_.size()-1 ;
+    const char *name = get(ndx) ;
+    size_t slot = hashName(name)&mask ;
+    for ( ; slots_[slot] >= 0 ; slot = (slot+1)&mask) {
+      if (std::strcmp(get(slots_[slot]),name) == 0) return ;
+    }
+    slots_[slot] = ndx ; }
+
+  void rehash ()
+  { std::vector<int> old(2*slots_.size(),-1) ;
+    old.swap(slots_) ;
+    for (size_t ndx = 0 ; ndx < old.size() ; ndx++)
+      if (old[ndx] >= 0) insert(old[ndx]) ; }
+
+  std::vector<char> arena_ ;
+  std::vector<int> offsets_ ;
+  size_t numNamed_ ;
+  std::vector<int> slots_ ;
+} ;
+
+int ModelBuilder::addRow (int numElems, const int *indices,
+			  const double *elements, double rowLower,
+			  double rowUpper, const char *name)
+{
+  int i = getNumRows() ;
+  rowSpans_.push_back(rowArena_->add(numElems,indices,elements)) ;
+  rowLower_.push_back(clampInfinity(rowLower)) ;
+  rowUpper_.push_back(clampInfinity(rowUpper)) ;
+  rowNames_->add(name) ;
+  return (i) ;
+}
+
+int ModelBuilder::addColumn (int numElems, const int *indices,
+			     const double *elements, double colLower,
+			     double colUpper, double obj, const char *name,
+			     bool isInteger)
+{
+  int j = getNumCols() ;
+  colSpans_.push_back(colArena_->add(numElems,indices,elements)) ;
+  colLower_.push_back(clampInfinity(colLower)) ;
+  colUpper_.push_back(clampInfinity(colUpper)) ;
+  obj_.push_back(obj) ;
+  integer_.push_back((isInteger)?1:0) ;
+  colNames_->add(name) ;
+  return (j) ;
+}
+
+void ModelBuilder::addRows (int numRows, const CoinBigIndex *starts,
+			    const int *indices, const double *elements,
+			    const double *rowLower, const double *rowUpper,
+			    const char *const *names)
+{
+  for (int k = 0 ; k < numRows ; k++) {
+    addRow(static_cast<int>(starts[k+1]-starts[k]),
+	   indices+starts[k],elements+starts[k],
+	   (rowLower)?rowLower[k]:-infinity,(rowUpper)?rowUpper[k]:infinity,
+	   (names)?names[k]:nullptr) ;
+  }
+}
+
+void ModelBuilder::addColumns (int numCols, const CoinBigIndex *starts,
+			       const int *indices, const double *elements,
+			       const double *colLower, const double *colUpper,
+			       const double *obj, const char *const *names)
+{
+  for (int k = 0 ; k < numCols ; k++) {
+    addColumn(static_cast<int>(starts[k+1]-starts[k]),
+	      indices+starts[k],elements+starts[k],
+	      (colLower)?colLower[k]:0.0,(colUpper)?colUpper[k]:infinity,
+	      (obj)?obj[k]:0.0,(names)?names[k]:nullptr) ;
+  }
+}
+
+void ModelBuilder::setInteger (int j, bool isInteger)
+{
+  if (j >= 0 && j < getNumCols()) integer_[j] = (isInteger)?1:0 ;
+}
+
+int ModelBuilder::rowIndex (const char *name) const
+{
+  return (rowNames_->find(name)) ;
+}
+
+int ModelBuilder::columnIndex (const char *name) const
+{
+  return (colNames_->find(name)) ;
+}
+
+std::string ModelBuilder::rowName (int i) const
+{
+  const char *name = rowNames_->get(i) ;
+  return ((name)?std::string(name):std::string()) ;
+}
+
+std::string ModelBuilder::columnName (int j) const
+{
+  const char *name = colNames_->get(j) ;
+  return ((name)?std::string(name):std::string()) ;
+}
+
+/*
+  The rows are cut into blocks of about equal numbers of coefficients, one
+  per thread. Each block counts its coefficients by column; together with
+  the column lengths the counts give the column starts, and then each
+  block's starting position within each column. The second pass places the
+  coefficients. A block needs a count for every column, so the number of
+  blocks is limited to keep the counts no larger than the matrix.
+
+  Arena chunks are freed as soon as every block is done with them. Column
+  pieces are copied in column order, so their share of the matrix never
+  coexists with its arena copy. Row pieces scatter across the whole matrix;
+  while they are placed, the arena holds only the rows not yet reached.
+*/
+int ModelBuilder::finalize ()
+{
+  if (finalized_) return (0) ;
+  const int n = getNumCols() ;
+  const int m = getNumRows() ;
+  numCols_ = n ;
+  size_t rowElems = 0 ;
+  for (int i = 0 ; i < m ; i++) rowElems += rowSpans_[i].len_ ;
+  int numBlocks = 1 ;
+  if (rowElems >= minParallel) {
+    size_t limit = 1+rowElems/(static_cast<size_t>(n)+1) ;
+    numBlocks = static_cast<int>(std::min(static_cast<size_t>(numThreads_),
+					  limit)) ;
+  }
+  std::vector<int> rowCuts(1,0) ;
+  size_t perBlock = rowElems/numBlocks+1 ;
+  size_t work = 0 ;
+  for (int i = 0 ; i < m ; i++) {
+    work += rowSpans_[i].len_ ;
+    if (work >= perBlock && static_cast<int>(rowCuts.size()) < numBlocks) {
+      rowCuts.push_back(i+1) ;
+      work = 0 ;
+    }
+  }
+  while (static_cast<int>(rowCuts.size()) <= numBlocks) rowCuts.push_back(m) ;
+  std::vector<int> colCuts(numBlocks+1) ;
+  for (int k = 0 ; k <= numBlocks ; k++)
+    colCuts[k] = static_cast<int>((static_cast<long long>(n)*k)/numBlocks) ;
+  std::vector<int> dropped(numBlocks,0) ;
+/*
+  Count.
+*/
+  std::vector<std::vector<CoinBigIndex> > place(numBlocks) ;
+  runTasks(numBlocks,[&] (int k) {
+    std::vector<CoinBigIndex> &cnt = place[k] ;
+    cnt.assign(n,0) ;
+    for (int i = rowCuts[k] ; i < rowCuts[k+1] ; i++) {
+      const Span &span = rowSpans_[i] ;
+      if (span.len_ == 0) continue ;
+      const int *ndx = rowArena_->indices(span) ;
+      for (int t = 0 ; t < span.len_ ; t++) {
+	if (ndx[t] >= 0 && ndx[t] < n)
+	  cnt[ndx[t]]++ ;
+	else
+	  dropped[k]++ ;
+      }
+    }
+  }) ;
+  starts_.reset(new CoinBigIndex[n+1]) ;
+  starts_[0] = 0 ;
+  std::vector<int> colDropped(numBlocks,0) ;
+  runTasks(numBlocks,[&] (int k) {
+    for (int j = colCuts[k] ; j < colCuts[k+1] ; j++) {
+      const Span &span = colSpans_[j] ;
+      CoinBigIndex len = 0 ;
+      if (span.len_ > 0) {
+	const int *ndx = colArena_->indices(span) ;
+	for (int t = 0 ; t < span.len_ ; t++) {
+	  if (ndx[t] >= 0 && ndx[t] < m)
+	    len++ ;
+	  else
+	    colDropped[k]++ ;
+	}
+      }
+      for (int b = 0 ; b < numBlocks ; b++) len += place[b][j] ;
+      starts_[j+1] = len ;
+    }
+  }) ;
+  for (int j = 0 ; j < n ; j++) starts_[j+1] += starts_[j] ;
+  runTasks(numBlocks,[&] (int k) {
+    for (int j = colCuts[k] ; j < colCuts[k+1] ; j++) {
+      CoinBigIndex pos = starts_[j+1] ;
+      for (int b = numBlocks-1 ; b >= 0 ; b--) {
+	pos -= place[b][j] ;
+	place[b][j] = pos ;
+      }
+    }
+  }) ;
+/*
+  Place.
+*/
+  indices_.reset(new int[starts_[n]]) ;
+  elements_.reset(new double[starts_[n]]) ;
+  colArena_->countUsers(colSpans_,colCuts) ;
+  rowArena_->countUsers(rowSpans_,rowCuts) ;
+  runTasks(numBlocks,[&] (int k) {
+    int chunk = -1 ;
+    for (int j = colCuts[k] ; j < colCuts[k+1] ; j++) {
+      const Span &span = colSpans_[j] ;
+      if (span.len_ == 0) continue ;
+      if (span.chunk_ != chunk) {
+	if (chunk >= 0) colArena_->release(chunk) ;
+	chunk = span.chunk_ ;
+      }
+      const int *ndx = colArena_->indices(span) ;
+      const double *elem = colArena_->elements(span) ;
+      CoinBigIndex pos = starts_[j] ;
+      for (int t = 0 ; t < span.len_ ; t++) {
+	if (ndx[t] >= 0 && ndx[t] < m) {
+	  indices_[pos] = ndx[t] ;
+	  elements_[pos++] = elem[t] ;
+	}
+      }
+    }
+    if (chunk >= 0) colArena_->release(chunk) ;
+    chunk = -1 ;
+    std::vector<CoinBigIndex> &cursor = place[k] ;
+    for (int i = rowCuts[k] ; i < rowCuts[k+1] ; i++) {
+      const Span &span = rowSpans_[i] ;
+      if (span.len_ == 0) continue ;
+      if (span.chunk_ != chunk) {
+	if (chunk >= 0) rowArena_->release(chunk) ;
+	chunk = span.chunk_ ;
+      }
+      const int *ndx = rowArena_->indices(span) ;
+      const double *elem = rowArena_->elements(span) ;
+      for (int t = 0 ; t < span.len_ ; t++) {
+	if (ndx[t] >= 0 && ndx[t] < n) {
+	  CoinBigIndex pos = cursor[ndx[t]]++ ;
+	  indices_[pos] = i ;
+	  elements_[pos] = elem[t] ;
+	}
+      }
+    }
+    if (chunk >= 0) rowArena_->release(chunk) ;
+  }) ;
+  rowArena_.reset(new Arena()) ;
+  colArena_.reset(new Arena()) ;
+  std::vector<Span>().swap(rowSpans_) ;
+  std::vector<Span>().swap(colSpans_) ;
+  rowNames_->finish('R') ;
+  colNames_->finish('C') ;
+  finalized_ = true ;
+  int numDropped = 0 ;
+  for (int k = 0 ; k < numBlocks ; k++)
+    numDropped += dropped[k]+colDropped[k] ;
+  return (numDropped) ;
+}
+
+void ModelBuilder::loadInto (ClpSimplexAPI &solver) const
+{
+  const int m = getNumRows() ;
+  solver.loadProblem(numCols_,m,
+		     starts_.get(),indices_.get(),elements_.get(),
+		     colLower_.data(),colUpper_.data(),obj_.data(),
+		     rowLower_.data(),rowUpper_.data()) ;
+  solver.setObjSense(objSense_) ;
+  solver.setObjectiveOffset(objOffset_) ;
+  solver.setProblemName(probName_) ;
+  if (std::find(integer_.begin(),integer_.end(),1) != integer_.end())
+    solver.copyInIntegerInformation(integer_.data()) ;
+  if (m > 0 && !rowNames_->empty())
+    solver.setRowNames(0,m,rowNames_->arena(),rowNames_->offsets()) ;
+  if (numCols_ > 0 && !colNames_->empty())
+    solver.setColumnNames(0,numCols_,colNames_->arena(),colNames_->offsets()) ;
+}
+
+void ModelBuilder::loadInto (Osi1API &solver) const
+{
+  const int m = getNumRows() ;
+  solver.loadProblem(numCols_,m,
+		     starts_.get(),indices_.get(),elements_.get(),
+		     colLower_.data(),colUpper_.data(),obj_.data(),
+		     rowLower_.data(),rowUpper_.data()) ;
+  solver.setObjSense(objSense_) ;
+  solver.setDblParam(OsiObjOffset,objOffset_) ;
+  solver.setStrParam(OsiProbName,probName_) ;
+  std::vector<int> intCols ;
+  for (int j = 0 ; j < numCols_ ; j++)
+    if (integer_[j]) intCols.push_back(j) ;
+  if (!intCols.empty())
+    solver.setInteger(intCols.data(),static_cast<int>(intCols.size())) ;
+  if (!rowNames_->empty()) {
+    Osi1API::OsiNameVec names(m) ;
+    for (int i = 0 ; i < m ; i++) names[i] = rowName(i) ;
+    solver.setRowNames(names,0,m,0) ;
+  }
+  if (!colNames_->empty()) {
+    Osi1API::OsiNameVec names(numCols_) ;
+    for (int j = 0 ; j < numCols_ ; j++) names[j] = columnName(j) ;
+    solver.setColNames(names,0,numCols_,0) ;
+  }
+}
+
+void ModelBuilder::assignTo (ClpSimplexAPI &solver)
+{
+  const int m = getNumRows() ;
+  CoinBigIndex *start = starts_.release() ;
+  int *index = indices_.release() ;
+  double *value = elements_.release() ;
+  double *collb = newCopy(colLower_) ;
+  double *colub = newCopy(colUpper_) ;
+  double *obj = newCopy(obj_) ;
+  double *rowlb = newCopy(rowLower_) ;
+  double *rowub = newCopy(rowUpper_) ;
+  solver.assignProblem(numCols_,m,start,index,value,
+		       collb,colub,obj,rowlb,rowub) ;
+  solver.setObjSense(objSense_) ;
+  solver.setObjectiveOffset(objOffset_) ;
+  solver.setProblemName(probName_) ;
+  if (std::find(integer_.begin(),integer_.end(),1) != integer_.end())
+    solver.copyInIntegerInformation(integer_.data()) ;
+  if (m > 0 && !rowNames_->empty())
+    solver.setRowNames(0,m,rowNames_->arena(),rowNames_->offsets()) ;
+  if (numCols_ > 0 && !colNames_->empty())
+    solver.setColumnNames(0,numCols_,colNames_->arena(),colNames_->offsets()) ;
+  clear() ;
+}
+
+void ModelBuilder::assignTo (ProbMgmtAPI &solver)
+{
+  CoinBigIndex *start = starts_.release() ;
+  int *index = indices_.release() ;
+  double *value = elements_.release() ;
+  double *collb = newCopy(colLower_) ;
+  double *colub = newCopy(colUpper_) ;
+  double *obj = newCopy(obj_) ;
+  double *rowlb = newCopy(rowLower_) ;
+  double *rowub = newCopy(rowUpper_) ;
+  solver.assignProblem(numCols_,getNumRows(),start,index,value,
+		       collb,colub,obj,rowlb,rowub) ;
+  clear() ;
+}
+
+void ModelBuilder::clear ()
+{
+  finalized_ = false ;
+  rowArena_.reset(new Arena()) ;
+  colArena_.reset(new Arena()) ;
+  std::vector<Span>().swap(rowSpans_) ;
+  std::vector<Span>().swap(colSpans_) ;
+  rowNames_.reset(new NameTable()) ;
+  colNames_.reset(new NameTable()) ;
+  probName_.clear() ;
+  numCols_ = 0 ;
+  starts_.reset() ;
+  indices_.reset() ;
+  elements_.reset() ;
+  colLower_.clear() ;
+  colUpper_.clear() ;
+  obj_.clear() ;
+  rowLower_.clear() ;
+  rowUpper_.clear() ;
+  integer_.clear() ;
+  objSense_ = 1.0 ;
+  objOffset_ = 0.0 ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+ModelBuilder::ModelBuilder (int numThreads)
+  : numThreads_(numThreads)
+{
+  if (numThreads_ < 1) {
+    numThreads_ = static_cast<int>(std::thread::hardware_concurrency()) ;
+    if (numThreads_ < 1) numThreads_ = 1 ;
+  }
+  clear() ;
+}
+
+ModelBuilder::~ModelBuilder () { }
+
+} // namespace Osi2
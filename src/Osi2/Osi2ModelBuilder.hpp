@@ -0,0 +1,246 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ModelBuilder.hpp
+
+  Defines ModelBuilder, which accumulates a problem a row or a column at a
+  time and converts it to column-major form once, at the end.
+*/
+
+#ifndef Osi2ModelBuilder_HPP
+#define Osi2ModelBuilder_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2Osi1API.hpp"
+#include "Osi2ProbMgmtAPI.hpp"
+
+namespace Osi2 {
+
+/*! \brief Incremental construction of a problem
+
+  Rows and columns are added one at a time or in batches, in any mix. The
+  coefficients are copied into arenas made of chunks that are never moved,
+  so adding to a large problem costs no more than adding to a small one;
+  each row or column records where its coefficients lie. Names are
+  interned in a table that also answers lookups by name.
+
+  #finalize builds the constraint matrix in column-major form without gaps.
+  Coefficients of a column come first, in the order given, followed by
+  those given with rows, in row order. The rows are transposed in
+  parallel: each thread counts and then places the coefficients of a range
+  of rows, so the work is two passes over the coefficients and the result
+  is the same whatever the number of threads. The finished problem is held
+  in the same arrays as MpsReader's and goes to a solver the same ways,
+  by copy (#loadInto) or by handing over the arrays (#assignTo).
+
+  A row may refer to columns that are added later, and vice versa; an index
+  that is still out of range at #finalize is an error and the coefficient
+  is dropped. Duplicate coefficients are not detected. Values of 1e30 or
+  more in magnitude are infinite.
+*/
+class ModelBuilder {
+
+public:
+
+  /*! \brief Constructor
+
+    \p numThreads is the number of threads used by #finalize; zero means
+    one per hardware thread.
+  */
+  ModelBuilder(int numThreads = 0) ;
+  /// Destructor
+  ~ModelBuilder() ;
+
+  /*! \name Building the problem */
+  //@{
+  /*! \brief Add a row and return its index
+
+    \p indices are column indices. If \p name is null the row is unnamed;
+    if any row has a name, unnamed rows are given names of the form
+    R0000012 by #finalize.
+  */
+  int addRow(int numElems, const int *indices, const double *elements,
+	     double rowLower, double rowUpper, const char *name = nullptr) ;
+  /*! \brief Add a column and return its index
+
+    \p indices are row indices. Names are treated as for #addRow, with
+    default names of the form C0000012.
+  */
+  int addColumn(int numElems, const int *indices, const double *elements,
+		double colLower, double colUpper, double obj,
+		const char *name = nullptr, bool isInteger = false) ;
+  /*! \brief Add \p numRows rows in row-major form
+
+    Row k has the coefficients in positions starts[k] to starts[k+1]-1 of
+    \p indices and \p elements. Null bound vectors take the defaults of
+    ClpSimplexAPI::loadProblem; \p names may be null.
+  */
+  void addRows(int numRows, const CoinBigIndex *starts, const int *indices,
+	       const double *elements, const double *rowLower,
+	       const double *rowUpper, const char *const *names = nullptr) ;
+  /// Add \p numCols columns in column-major form, as #addRows
+  void addColumns(int numCols, const CoinBigIndex *starts,
+		  const int *indices, const double *elements,
+		  const double *colLower, const double *colUpper,
+		  const double *obj, const char *const *names = nullptr) ;
+  /// Mark column \p j as integer or continuous
+  void setInteger(int j, bool isInteger = true) ;
+  /// Set the objective sense: 1 to minimise, -1 to maximise
+  void setObjSense(double sense) { objSense_ = sense ; }
+  /// Set the objective offset
+  void setObjOffset(double offset) { objOffset_ = offset ; }
+  /// Set the problem name
+  void setProblemName(const std::string &name) { probName_ = name ; }
+
+  /*! \brief Index of the row named \p name, or -1 if there is none
+
+    If several rows have the name, the first is returned.
+  */
+  int rowIndex(const char *name) const ;
+  /// Index of the column named \p name, as #rowIndex
+  int columnIndex(const char *name) const ;
+  //@}
+
+  /*! \brief Build the column-major matrix
+
+    Each arena chunk is freed as soon as its coefficients have been placed,
+    so the builder's footprint stays close to the size of the finished
+    matrix plus the pieces not yet transposed. Returns the number of
+    coefficients dropped because their index was out of range. After
+    finalize the problem can be read and loaded but not added to, and a
+    second call does nothing; #clear starts again.
+  */
+  int finalize() ;
+  /// Drop the problem and start again
+  void clear() ;
+
+  /*! \name Problem access
+
+    The matrix is available only after #finalize.
+  */
+  //@{
+  /// Problem name
+  const std::string &getProblemName() const { return (probName_) ; }
+  /// Number of columns
+  int getNumCols() const { return (static_cast<int>(colLower_.size())) ; }
+  /// Number of rows
+  int getNumRows() const { return (static_cast<int>(rowLower_.size())) ; }
+  /// Number of coefficients in the constraint matrix
+  CoinBigIndex getNumElements() const
+  { return ((starts_) ? starts_[numCols_] : 0) ; }
+  /// Column starts (numCols+1 entries)
+  const CoinBigIndex *getColStarts() const { return (starts_.get()) ; }
+  /// Row indices of coefficients
+  const int *getIndices() const { return (indices_.get()) ; }
+  /// Coefficients
+  const double *getElements() const { return (elements_.get()) ; }
+  /// Column lower bounds
+  const double *getColLower() const { return (colLower_.data()) ; }
+  /// Column upper bounds
+  const double *getColUpper() const { return (colUpper_.data()) ; }
+  /// Objective coefficients
+  const double *getObjective() const { return (obj_.data()) ; }
+  /// Row lower bounds
+  const double *getRowLower() const { return (rowLower_.data()) ; }
+  /// Row upper bounds
+  const double *getRowUpper() const { return (rowUpper_.data()) ; }
+  /// Integer information: 1 for integer, 0 for continuous
+  const char *getIntegerInformation() const { return (integer_.data()) ; }
+  /// Objective sense: 1 to minimise, -1 to maximise
+  double getObjSense() const { return (objSense_) ; }
+  /// Objective offset
+  double getObjOffset() const { return (objOffset_) ; }
+  /// Name of row i; empty if there are no row names
+  std::string rowName(int i) const ;
+  /// Name of column j; empty if there are no column names
+  std::string columnName(int j) const ;
+  //@}
+
+  /*! \name Loading the problem into a solver
+
+    These require #finalize.
+  */
+  //@{
+  /// Load the problem into \p solver, with integer information and names
+  void loadInto(ClpSimplexAPI &solver) const ;
+  /// Load the problem into \p solver, with integer information and names
+  void loadInto(Osi1API &solver) const ;
+  /*! \brief Hand the problem over to \p solver
+
+    The matrix is given to ClpSimplexAPI::assignProblem without copying;
+    bounds, objective, integer information, and names are copied. The
+    builder is empty afterwards.
+  */
+  void assignTo(ClpSimplexAPI &solver) ;
+  /*! \brief Hand the problem over to \p solver
+
+    As MpsReader::assignTo: objective sense and offset, integer
+    information, and names are not part of ProbMgmtAPI and are dropped.
+  */
+  void assignTo(ProbMgmtAPI &solver) ;
+  //@}
+
+private:
+
+  /// Coefficients of one row or column: chunk, position, length
+  struct Span {
+    int chunk_ ;
+    int pos_ ;
+    int len_ ;
+  } ;
+  /// Chunked storage for coefficients
+  class Arena ;
+  /// Interned names with lookup
+  class NameTable ;
+
+  /// Number of threads used by #finalize
+  int numThreads_ ;
+  /// True once #finalize has run
+  bool finalized_ ;
+
+  /*! \name The problem as it is built */
+  //@{
+  std::unique_ptr<Arena> rowArena_ ;
+  std::unique_ptr<Arena> colArena_ ;
+  std::vector<Span> rowSpans_ ;
+  std::vector<Span> colSpans_ ;
+  std::unique_ptr<NameTable> rowNames_ ;
+  std::unique_ptr<NameTable> colNames_ ;
+  //@}
+
+  /*! \name The finished problem */
+  //@{
+  std::string probName_ ;
+  int numCols_ ;
+  std::unique_ptr<CoinBigIndex[]> starts_ ;
+  std::unique_ptr<int[]> indices_ ;
+  std::unique_ptr<double[]> elements_ ;
+  std::vector<double> colLower_ ;
+  std::vector<double> colUpper_ ;
+  std::vector<double> obj_ ;
+  std::vector<double> rowLower_ ;
+  std::vector<double> rowUpper_ ;
+  std::vector<char> integer_ ;
+  double objSense_ ;
+  double objOffset_ ;
+  //@}
+
+  /// Copying is not supported
+  ModelBuilder(const ModelBuilder &) ;
+  ModelBuilder &operator=(const ModelBuilder &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -0,0 +1,322 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for ModelCache.
+*/
+
+#include "Osi2Config.h"
+
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <sys/stat.h>
+
+#include "Osi2MappedFile.hpp"
+#include "Osi2ModelCache.hpp"
+
+namespace {
+
+typedef unsigned long long Word ;
+
+const Word prime1 = 0x9e3779b185ebca87ULL ;
+const Word prime2 = 0xc2b2ae3d27d4eb4fULL ;
+const Word prime3 = 0x165667b19e3779f9ULL ;
+
+inline Word rotl (Word x, int r)
+{
+  return ((x<<r)|(x>>(64-r))) ;
+}
+
+inline Word avalanche (Word x)
+{
+  x ^= x>>33 ;
+  x *= prime2 ;
+  x ^= x>>29 ;
+  x *= prime3 ;
+  x ^= x>>32 ;
+  return (x) ;
+}
+
+/*
+  What we know about a source file: where it is, its size and modification
+  time when last hashed, and the hash.
+*/
+struct Stamp {
+  std::string path_ ;
+  long long size_ ;
+  long long mtimeSec_ ;
+  long long mtimeNsec_ ;
+  Osi2::ModelFingerprint::Digest hash_ ;
+} ;
+
+bool operator== (const Stamp &s1, const Stamp &s2)
+{
+  return (s1.path_ == s2.path_ && s1.size_ == s2.size_ &&
+	  s1.mtimeSec_ == s2.mtimeSec_ && s1.mtimeNsec_ == s2.mtimeNsec_) ;
+}
+
+/*
+  Process-wide state, constructed on first use.
+*/
+struct CacheState {
+  std::mutex lock_ ;
+  std::string dir_ ;
+  std::unordered_map<std::string,Stamp> stamps_ ;
+  long hits_ ;
+  long misses_ ;
+  long hashes_ ;
+  CacheState () : hits_(0), misses_(0), hashes_(0) { }
+} ;
+
+CacheState &state ()
+{
+  static CacheState theState ;
+  return (theState) ;
+}
+
+/*
+  Fill in the path, size, and modification time of a file. The path is
+  made canonical where the platform allows, so that different routes to
+  the same file share a stamp. Sub-second times are used where available.
+*/
+bool statFile (const char *filename, Stamp &stamp)
+{
+  struct stat info ;
+  if (stat(filename,&info) != 0) return (false) ;
+  stamp.size_ = static_cast<long long>(info.st_size) ;
+  stamp.mtimeSec_ = static_cast<long long>(info.st_mtime) ;
+#if defined(__linux__)
+  stamp.mtimeNsec_ = static_cast<long long>(info.st_mtim.tv_nsec) ;
+#elif defined(__APPLE__)
+  stamp.mtimeNsec_ = static_cast<long long>(info.st_mtimespec.tv_nsec) ;
+#else
+  stamp.mtimeNsec_ = 0 ;
+#endif
+  stamp.path_ = filename ;
+#ifndef _WIN32
+  char *canon = realpath(filename,nullptr) ;
+  if (canon != nullptr) {
+    stamp.path_ = canon ;
+    std::free(canon) ;
+  }
+#endif
+  return (true) ;
+}
+
+/*
+  The key file for a path is named for a hash of the path and holds the
+  stamp as text. The path is checked on reading, so a collision between
+  path hashes costs a rehash and nothing more.
+*/
+std::string keyPath (const std::string &dir, const std::string &path)
+{
+  std::ostringstream name ;
+  name << dir << "/" << std::hex << std::hash<std::string>()(path) << ".key" ;
+  return (name.str()) ;
+}
+
+bool readKey (const std::string &dir, Stamp &stamp)
+{
+  std::FILE *file = std::fopen(keyPath(dir,stamp.path_).c_str(),"r") ;
+  if (file == nullptr) return (false) ;
+  Stamp stored ;
+  char path[PATH_MAX+2] ;
+  bool ok = std::fscanf(file,"%lld %lld %lld %llx %llx ",
+			&stored.size_,&stored.mtimeSec_,&stored.mtimeNsec_,
+			&stored.hash_.h1_,&stored.hash_.h2_) == 5 &&
+	    std::fgets(path,sizeof(path),file) != nullptr ;
+  std::fclose(file) ;
+  if (!ok) return (false) ;
+  stored.path_ = path ;
+  if (!stored.path_.empty() && stored.path_.back() == '\n')
+    stored.path_.erase(stored.path_.size()-1) ;
+  if (!(stored == stamp)) return (false) ;
+  stamp.hash_ = stored.hash_ ;
+  return (true) ;
+}
+
+void writeKey (const std::string &dir, const Stamp &stamp)
+{
+  std::string path = keyPath(dir,stamp.path_) ;
+  std::ostringstream suffix ;
+  suffix
+    << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id()) ;
+  std::string tmpPath = path+suffix.str() ;
+  std::FILE *file = std::fopen(tmpPath.c_str(),"w") ;
+  if (file == nullptr) return ;
+  bool ok = std::fprintf(file,"%lld %lld %lld %016llx %016llx\n%s\n",
+			 stamp.size_,stamp.mtimeSec_,stamp.mtimeNsec_,
+			 stamp.hash_.h1_,stamp.hash_.h2_,
+			 stamp.path_.c_str()) > 0 ;
+  ok = (std::fclose(file) == 0) && ok ;
+  if (ok) ok = (std::rename(tmpPath.c_str(),path.c_str()) == 0) ;
+  if (!ok) std::remove(tmpPath.c_str()) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+/*
+  Two independent lanes over 8-byte words, each a multiply-rotate round,
+  finished with the length and an avalanche. The file is mapped, so this
+  runs at memory speed and costs a small fraction of a parse.
+*/
+bool ModelCache::contentHash (const char *filename,
+			      ModelFingerprint::Digest &hash)
+{
+  MappedFile file ;
+  if (!file.open(filename)) return (false) ;
+  const char *p = file.begin() ;
+  size_t len = file.size() ;
+  Word h1 = prime1 ;
+  Word h2 = prime2 ;
+  size_t ndx = 0 ;
+  for ( ; ndx+sizeof(Word) <= len ; ndx += sizeof(Word)) {
+    Word w ;
+    std::memcpy(&w,p+ndx,sizeof(w)) ;
+    h1 = rotl(h1+w*prime2,31)*prime1 ;
+    h2 = rotl(h2^(w*prime3),27)*prime2+prime1 ;
+  }
+  if (ndx < len) {
+    Word w = 0 ;
+    std::memcpy(&w,p+ndx,len-ndx) ;
+    h1 = rotl(h1+w*prime2,31)*prime1 ;
+    h2 = rotl(h2^(w*prime3),27)*prime2+prime1 ;
+  }
+  hash.h1_ = avalanche(h1^static_cast<Word>(len)) ;
+  hash.h2_ = avalanche(h2+static_cast<Word>(len)*prime3) ;
+  std::lock_guard<std::mutex> lock(state().lock_) ;
+  state().hashes_++ ;
+  return (true) ;
+}
+
+/*
+  The stamp is checked in memory, then in the directory; only if both miss
+  is the file hashed. The lock is not held while hashing, so two threads
+  may hash the same file at once; they'll agree.
+*/
+bool ModelCache::lookup (const char *filename, bool keepNames,
+			 std::string &imagePath)
+{
+  imagePath.clear() ;
+  CacheState &st = state() ;
+  std::string dir = getDirectory() ;
+  if (dir.empty()) return (false) ;
+
+  Stamp stamp ;
+  if (!statFile(filename,stamp)) return (false) ;
+  bool known = false ;
+  {
+    std::lock_guard<std::mutex> lock(st.lock_) ;
+    std::unordered_map<std::string,Stamp>::const_iterator iter =
+      st.stamps_.find(stamp.path_) ;
+    if (iter != st.stamps_.end() && iter->second == stamp) {
+      stamp.hash_ = iter->second.hash_ ;
+      known = true ;
+    }
+  }
+  if (!known) {
+    if (!readKey(dir,stamp)) {
+      if (!contentHash(filename,stamp.hash_)) return (false) ;
+      writeKey(dir,stamp) ;
+    }
+    std::lock_guard<std::mutex> lock(st.lock_) ;
+    st.stamps_[stamp.path_] = stamp ;
+  }
+
+  imagePath = dir+"/"+stamp.hash_.toString()+((keepNames)?"-n":"")+
+	      ".osi2mdl" ;
+  struct stat info ;
+  bool found = (stat(imagePath.c_str(),&info) == 0) ;
+  std::lock_guard<std::mutex> lock(st.lock_) ;
+  if (found)
+    st.hits_++ ;
+  else
+    st.misses_++ ;
+  return (found) ;
+}
+
+/*
+  The hash of the current contents is needed to name the images, so take
+  it from a lookup before clearing the stamp away.
+*/
+void ModelCache::forget (const char *filename)
+{
+  std::string imagePath ;
+  lookup(filename,false,imagePath) ;
+  if (imagePath.empty()) return ;
+  CacheState &st = state() ;
+  Stamp stamp ;
+  statFile(filename,stamp) ;
+  {
+    std::lock_guard<std::mutex> lock(st.lock_) ;
+    st.stamps_.erase(stamp.path_) ;
+  }
+  std::string dir = getDirectory() ;
+  std::remove(keyPath(dir,stamp.path_).c_str()) ;
+  std::remove(imagePath.c_str()) ;
+  std::string base = imagePath.substr(0,imagePath.size()-8) ;
+  std::remove((base+"-n.osi2mdl").c_str()) ;
+}
+
+/*
+  Changing the directory forgets the stamps, since they're tied to the
+  key files in the old one.
+*/
+void ModelCache::setDirectory (const std::string &dir)
+{
+  CacheState &st = state() ;
+  std::lock_guard<std::mutex> lock(st.lock_) ;
+  st.dir_ = dir ;
+  while (st.dir_.size() > 1 && st.dir_.back() == '/')
+    st.dir_.erase(st.dir_.size()-1) ;
+  st.stamps_.clear() ;
+}
+
+std::string ModelCache::getDirectory ()
+{
+  std::lock_guard<std::mutex> lock(state().lock_) ;
+  return (state().dir_) ;
+}
+
+long ModelCache::getHitCnt ()
+{
+  std::lock_guard<std::mutex> lock(state().lock_) ;
+  return (state().hits_) ;
+}
+
+long ModelCache::getMissCnt ()
+{
+  std::lock_guard<std::mutex> lock(state().lock_) ;
+  return (state().misses_) ;
+}
+
+long ModelCache::getHashCnt ()
+{
+  std::lock_guard<std::mutex> lock(state().lock_) ;
+  return (state().hashes_) ;
+}
+
+void ModelCache::resetStatistics ()
+{
+  CacheState &st = state() ;
+  std::lock_guard<std::mutex> lock(st.lock_) ;
+  st.hits_ = 0 ;
+  st.misses_ = 0 ;
+  st.hashes_ = 0 ;
+}
+
+}  // end namespace Osi2
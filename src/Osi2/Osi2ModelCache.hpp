@@ -0,0 +1,104 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ModelCache.hpp
+
+  Defines ModelCache, a process-wide cache of parsed MPS files kept in Osi2
+  binary format.
+*/
+
+#ifndef Osi2ModelCache_HPP
+#define Osi2ModelCache_HPP
+
+#include <string>
+
+#include "Osi2ModelFingerprint.hpp"
+
+namespace Osi2 {
+
+/*! \brief A cache of parsed models
+
+  When a cache directory is set, the readMps methods of ClpSimplexAPI and
+  ProbMgmtAPI in the Clp shims consult the cache before parsing (Osi1API
+  readMps does not). Each parsed model is stored as a ModelImage whose
+  name is a hash of the contents of the MPS file, so a file that changes
+  in any way is simply a new entry, and identical files at different paths
+  share one. Whether names were kept is part of the entry name. An image
+  that fails ModelImage::open is ignored; the file is parsed and the image
+  replaced.
+
+  Hashing the contents costs a pass over the file. To avoid it, the hash is
+  remembered against the canonical path, size, and modification time of
+  the file, both in memory and in a small key file in the cache directory
+  so that other processes can use it. If any of these change, the file is
+  hashed again.
+
+  Entries are written to a temporary name and renamed into place, so the
+  directory can be shared by concurrent processes. Images of contents that
+  no longer exist are not removed; clearing them out is left to the user.
+  All methods may be called concurrently from several threads.
+*/
+class ModelCache {
+
+public:
+
+  /*! \brief Set the cache directory
+
+    The directory must exist. An empty string disables the cache, which is
+    the initial state.
+  */
+  static void setDirectory(const std::string &dir) ;
+  /// The cache directory; empty if the cache is disabled
+  static std::string getDirectory() ;
+
+  /*! \brief Find the cached image for an MPS file
+
+    Returns true if there is an image for \p filename, parsed with names if
+    \p keepNames is true, and sets \p imagePath to it. Otherwise returns
+    false and sets \p imagePath to the place the image should be written
+    once the file has been parsed, or to an empty string if the cache is
+    disabled or the file can't be read.
+  */
+  static bool lookup(const char *filename, bool keepNames,
+		     std::string &imagePath) ;
+
+  /*! \brief Drop the entry for an MPS file
+
+    Removes the key file for \p filename and any images of its current
+    contents, so that the next #lookup parses it afresh. Images shared with
+    other files of the same contents go too.
+  */
+  static void forget(const char *filename) ;
+
+  /*! \name Statistics */
+  //@{
+  /// Number of lookups that found an image
+  static long getHitCnt() ;
+  /// Number of lookups that didn't
+  static long getMissCnt() ;
+  /// Number of times an MPS file was hashed
+  static long getHashCnt() ;
+  /// Reset the counts to zero
+  static void resetStatistics() ;
+  //@}
+
+  /*! \brief Hash of the contents of \p filename
+
+    Returns false if the file can't be read.
+  */
+  static bool contentHash(const char *filename,
+			  ModelFingerprint::Digest &hash) ;
+
+private:
+
+  /// Not to be instantiated
+  ModelCache() ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
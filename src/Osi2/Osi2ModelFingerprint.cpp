@@ -0,0 +1,286 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for ModelFingerprint.
+*/
+
+#include <cstdio>
+#include <cstring>
+
+#include "CoinPackedMatrix.hpp"
+
+#include "Osi2Config.h"
+
+#include "Osi2ModelFingerprint.hpp"
+
+namespace {
+
+typedef unsigned long long Word ;
+
+/*
+  The 64-bit finaliser from MurmurHash3. Each input bit affects each output
+  bit with probability close to 1/2.
+*/
+inline Word mix (Word x)
+{
+  x ^= x>>33 ;
+  x *= 0xff51afd7ed558ccdULL ;
+  x ^= x>>33 ;
+  x *= 0xc4ceb9fe1a85ec53ULL ;
+  x ^= x>>33 ;
+  return (x) ;
+}
+
+/*
+  Bit pattern of a double, with -0.0 folded into 0.0.
+*/
+inline Word valBits (double val)
+{
+  if (val == 0.0) return (0) ;
+  Word bits ;
+  std::memcpy(&bits,&val,sizeof(bits)) ;
+  return (bits) ;
+}
+
+/*
+  Per-section seeds, so that (say) a column lower bound and a column upper
+  bound with the same index and value contribute differently. The second
+  lane uses a second set.
+*/
+const Word lane1Seed[] = { 0x9e3779b97f4a7c15ULL, 0xbf58476d1ce4e5b9ULL,
+			   0x94d049bb133111ebULL, 0x2545f4914f6cdd1dULL,
+			   0xd6e8feb86659fd93ULL, 0xa0761d6478bd642fULL } ;
+const Word lane2Seed[] = { 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL,
+			   0x589965cc75374cc3ULL, 0x1d8e4e27c47d124fULL,
+			   0x5851f42d4c957f2dULL, 0x14057b7ef767814fULL } ;
+
+/*
+  The contribution of one entry to each lane. The key identifies the
+  position of the entry within its section.
+*/
+inline Word lane1 (int sect, Word key, Word bits)
+{
+  return (mix(mix(key^lane1Seed[sect])^bits)) ;
+}
+
+inline Word lane2 (int sect, Word key, Word bits)
+{
+  return (mix(mix(key^lane2Seed[sect])+((bits<<29)|(bits>>35)))) ;
+}
+
+/*
+  Key for a coefficient.
+*/
+inline Word coeffKey (int row, int col)
+{
+  return ((static_cast<Word>(static_cast<unsigned int>(col))<<32)|
+	  static_cast<unsigned int>(row)) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+std::string ModelFingerprint::Digest::toString () const
+{
+  char buf[33] ;
+  std::sprintf(buf,"%016llx%016llx",h1_,h2_) ;
+  return (std::string(buf)) ;
+}
+
+/*
+  The loop has no dependence other than the two sums, so the compiler is
+  free to vectorise it.
+*/
+void ModelFingerprint::addVector (Section sect, int len, const double *vals)
+{
+  Word s1 = 0 ;
+  Word s2 = 0 ;
+  for (int ndx = 0 ; ndx < len ; ndx++) {
+    Word bits = valBits(vals[ndx]) ;
+    s1 += lane1(sect,ndx,bits) ;
+    s2 += lane2(sect,ndx,bits) ;
+  }
+  sum_.h1_ += s1 ;
+  sum_.h2_ += s2 ;
+}
+
+void ModelFingerprint::compute (int numCols, int numRows,
+				const CoinBigIndex *starts, const int *lengths,
+				const int *indices, const double *elements,
+				const double *colLower, const double *colUpper,
+				const double *obj,
+				const double *rowLower, const double *rowUpper,
+				double objSense)
+{
+  numCols_ = numCols ;
+  numRows_ = numRows ;
+  objSense_ = objSense ;
+  sum_.h1_ = 0 ;
+  sum_.h2_ = 0 ;
+/*
+  The matrix. Only nonzeros count, and for the structural variant only
+  their position.
+*/
+  bool full = (variant_ == Full) ;
+  Word s1 = 0 ;
+  Word s2 = 0 ;
+  for (int j = 0 ; j < numCols ; j++) {
+    CoinBigIndex end =
+      (lengths == nullptr)?starts[j+1]:starts[j]+lengths[j] ;
+    for (CoinBigIndex k = starts[j] ; k < end ; k++) {
+      if (elements[k] == 0.0) continue ;
+      Word key = coeffKey(indices[k],j) ;
+      Word bits = (full)?valBits(elements[k]):0 ;
+      s1 += lane1(MatrixSect,key,bits) ;
+      s2 += lane2(MatrixSect,key,bits) ;
+    }
+  }
+  sum_.h1_ += s1 ;
+  sum_.h2_ += s2 ;
+  if (!full) return ;
+/*
+  Bounds and objective.
+*/
+  addVector(ColLowerSect,numCols,colLower) ;
+  addVector(ColUpperSect,numCols,colUpper) ;
+  addVector(ObjSect,numCols,obj) ;
+  addVector(RowLowerSect,numRows,rowLower) ;
+  addVector(RowUpperSect,numRows,rowUpper) ;
+}
+
+void ModelFingerprint::compute (ClpSimplexAPI &model)
+{
+  compute(model.numberColumns(),model.numberRows(),
+	  model.getVectorStarts(),model.getVectorLengths(),
+	  model.getIndices(),model.getElements(),
+	  model.columnLower(),model.columnUpper(),model.objective(),
+	  model.rowLower(),model.rowUpper(),model.objSense()) ;
+}
+
+/*
+  Osi keeps the row-major copy up to date as well, but the column-major
+  copy is the one we want.
+*/
+void ModelFingerprint::compute (const Osi1API &model)
+{
+  const CoinPackedMatrix *matrix = model.getMatrixByCol() ;
+  compute(model.getNumCols(),model.getNumRows(),
+	  matrix->getVectorStarts(),matrix->getVectorLengths(),
+	  matrix->getIndices(),matrix->getElements(),
+	  model.getColLower(),model.getColUpper(),model.getObjCoefficients(),
+	  model.getRowLower(),model.getRowUpper(),model.getObjSense()) ;
+}
+
+/*
+  Vector entries are always present, so the old contribution always comes
+  out and the new one always goes in.
+*/
+void ModelFingerprint::replace (Section sect, int ndx,
+				double oldVal, double newVal)
+{
+  if (variant_ != Full) return ;
+  Word oldBits = valBits(oldVal) ;
+  Word newBits = valBits(newVal) ;
+  sum_.h1_ += lane1(sect,ndx,newBits)-lane1(sect,ndx,oldBits) ;
+  sum_.h2_ += lane2(sect,ndx,newBits)-lane2(sect,ndx,oldBits) ;
+}
+
+void ModelFingerprint::chgColLower (int ndx, double oldVal, double newVal)
+{
+  replace(ColLowerSect,ndx,oldVal,newVal) ;
+}
+
+void ModelFingerprint::chgColUpper (int ndx, double oldVal, double newVal)
+{
+  replace(ColUpperSect,ndx,oldVal,newVal) ;
+}
+
+void ModelFingerprint::chgObjCoeff (int ndx, double oldVal, double newVal)
+{
+  replace(ObjSect,ndx,oldVal,newVal) ;
+}
+
+void ModelFingerprint::chgRowLower (int ndx, double oldVal, double newVal)
+{
+  replace(RowLowerSect,ndx,oldVal,newVal) ;
+}
+
+void ModelFingerprint::chgRowUpper (int ndx, double oldVal, double newVal)
+{
+  replace(RowUpperSect,ndx,oldVal,newVal) ;
+}
+
+/*
+  Unlike vector entries, a zero coefficient is absent and contributes
+  nothing.
+*/
+void ModelFingerprint::modifyCoefficient (int row, int col,
+					  double oldVal, double newVal)
+{
+  bool full = (variant_ == Full) ;
+  Word key = coeffKey(row,col) ;
+  if (oldVal != 0.0) {
+    Word bits = (full)?valBits(oldVal):0 ;
+    sum_.h1_ -= lane1(MatrixSect,key,bits) ;
+    sum_.h2_ -= lane2(MatrixSect,key,bits) ;
+  }
+  if (newVal != 0.0) {
+    Word bits = (full)?valBits(newVal):0 ;
+    sum_.h1_ += lane1(MatrixSect,key,bits) ;
+    sum_.h2_ += lane2(MatrixSect,key,bits) ;
+  }
+}
+
+void ModelFingerprint::setObjSense (double objSense)
+{
+  objSense_ = objSense ;
+}
+
+/*
+  Fold in the dimensions and, for the full variant, the objective sense.
+  The final mix ensures the digest of a sum doesn't look like a sum.
+*/
+ModelFingerprint::Digest ModelFingerprint::getDigest () const
+{
+  Word dims = coeffKey(numRows_,numCols_) ;
+  Word sense = (variant_ == Full)?valBits(objSense_):0 ;
+  Digest digest ;
+  digest.h1_ = mix(sum_.h1_^mix(dims^lane1Seed[0])^sense) ;
+  digest.h2_ = mix((sum_.h2_^mix(dims^lane2Seed[0]))+sense) ;
+  return (digest) ;
+}
+
+ModelFingerprint::Digest ModelFingerprint::structure (ClpSimplexAPI &model)
+{
+  ModelFingerprint fp(Structural) ;
+  fp.compute(model) ;
+  return (fp.getDigest()) ;
+}
+
+ModelFingerprint::Digest ModelFingerprint::full (ClpSimplexAPI &model)
+{
+  ModelFingerprint fp(Full) ;
+  fp.compute(model) ;
+  return (fp.getDigest()) ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+ModelFingerprint::ModelFingerprint (Variant variant)
+  : variant_(variant),
+    numCols_(0),
+    numRows_(0),
+    objSense_(1.0)
+{
+  sum_.h1_ = 0 ;
+  sum_.h2_ = 0 ;
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,170 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ModelFingerprint.hpp
+
+  Defines ModelFingerprint, a 128-bit hash of a model that can be updated
+  as the model is edited.
+*/
+
+#ifndef Osi2ModelFingerprint_HPP
+#define Osi2ModelFingerprint_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "CoinTypes.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2Osi1API.hpp"
+
+namespace Osi2 {
+
+/*! \brief Fingerprint of a model
+
+  A ModelFingerprint condenses a model into a 128-bit #Digest suitable as a
+  key for caches and for detecting duplicate models. There are two variants:
+  <ul>
+    <li> Structural: the dimensions and the sparsity pattern of the
+	 constraint matrix. Coefficient values, bounds, and objective are
+	 ignored.
+    <li> Full: the dimensions, the constraint matrix with coefficient
+	 values, the column and row bounds, the objective coefficients, and
+	 the objective sense.
+  </ul>
+  The fingerprint does not depend on the order of the coefficients within a
+  column, or on gaps in the column-major storage. Explicit zero coefficients
+  are treated as absent.
+
+  The digest is built as a sum of independent contributions, one per
+  coefficient, bound, and objective entry. Each contribution mixes the
+  position of the entry with its value, so the loops over the arrays have no
+  carried dependence other than the sum and run at close to memory
+  bandwidth. Because the combination is a sum, a single entry can be
+  replaced by subtracting its old contribution and adding the new one: the
+  update methods (#chgRowLower, #modifyCoefficient, etc.) keep the
+  fingerprint current as the model is edited without rescanning it. The
+  caller supplies the old value.
+
+  Two fingerprints computed from different models collide with probability
+  about 2^-128. Clients that cannot tolerate a collision must compare the
+  models.
+*/
+class ModelFingerprint {
+
+public:
+
+  /// Fingerprint variants
+  enum Variant { Structural = 0, Full } ;
+
+  /// A 128-bit digest
+  struct Digest {
+    unsigned long long h1_ ;
+    unsigned long long h2_ ;
+    bool operator==(const Digest &rhs) const
+    { return (h1_ == rhs.h1_ && h2_ == rhs.h2_) ; }
+    bool operator!=(const Digest &rhs) const { return (!(*this == rhs)) ; }
+    bool operator<(const Digest &rhs) const
+    { return (h1_ < rhs.h1_ || (h1_ == rhs.h1_ && h2_ < rhs.h2_)) ; }
+    /// The digest as 32 hex digits
+    std::string toString() const ;
+  } ;
+
+  /*! \brief Hash functor, for a Digest as a key in unordered containers
+
+    Both halves are mixed in, and the result is folded so that a 32-bit
+    size_t sees all of it.
+  */
+  struct DigestHash {
+    size_t operator()(const Digest &digest) const
+    { unsigned long long h = digest.h1_^(digest.h2_*0x9e3779b97f4a7c15ULL) ;
+      return (static_cast<size_t>(h^(h>>32))) ; }
+  } ;
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /// Constructor; the fingerprint is that of an empty model
+  ModelFingerprint(Variant variant = Full) ;
+  //@}
+
+  /*! \name Compute the fingerprint of a complete model */
+  //@{
+  /*! \brief Fingerprint a model given as arrays
+
+    The constraint matrix is column-major. \p lengths may be null, in which
+    case the columns are taken to be contiguous. For the structural variant,
+    the bound and objective arrays are ignored and may be null.
+  */
+  void compute(int numCols, int numRows,
+	       const CoinBigIndex *starts, const int *lengths,
+	       const int *indices, const double *elements,
+	       const double *colLower, const double *colUpper,
+	       const double *obj,
+	       const double *rowLower, const double *rowUpper,
+	       double objSense = 1.0) ;
+
+  /// Fingerprint the model held by a ClpSimplexAPI object
+  void compute(ClpSimplexAPI &model) ;
+
+  /// Fingerprint the model held by an Osi1API object
+  void compute(const Osi1API &model) ;
+  //@}
+
+  /*! \name Update the fingerprint after an edit
+
+    Each method replaces the contribution of \p oldVal with that of \p
+    newVal. For the structural variant, only changes to the sparsity
+    pattern matter: #modifyCoefficient with \p oldVal or \p newVal zero
+    adds or removes a coefficient; all other updates are ignored.
+  */
+  //@{
+  void chgColLower(int ndx, double oldVal, double newVal) ;
+  void chgColUpper(int ndx, double oldVal, double newVal) ;
+  void chgObjCoeff(int ndx, double oldVal, double newVal) ;
+  void chgRowLower(int ndx, double oldVal, double newVal) ;
+  void chgRowUpper(int ndx, double oldVal, double newVal) ;
+  void modifyCoefficient(int row, int col, double oldVal, double newVal) ;
+  void setObjSense(double objSense) ;
+  //@}
+
+  /*! \name Retrieve the fingerprint */
+  //@{
+  /// The digest
+  Digest getDigest() const ;
+  /// The variant
+  Variant getVariant() const { return (variant_) ; }
+  //@}
+
+  /// Structural fingerprint of the model held by \p model
+  static Digest structure(ClpSimplexAPI &model) ;
+  /// Full fingerprint of the model held by \p model
+  static Digest full(ClpSimplexAPI &model) ;
+
+private:
+
+  /// Sections of the model; each hashes its entries under its own tag
+  enum Section { MatrixSect = 0, ColLowerSect, ColUpperSect, ObjSect,
+		 RowLowerSect, RowUpperSect } ;
+
+  /// Add the contributions of the entries of a vector
+  void addVector(Section sect, int len, const double *vals) ;
+
+  /// Replace the contribution of one entry of a vector
+  void replace(Section sect, int ndx, double oldVal, double newVal) ;
+
+  Variant variant_ ;
+  int numCols_ ;
+  int numRows_ ;
+  double objSense_ ;
+  /// Running sums of the contributions
+  Digest sum_ ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
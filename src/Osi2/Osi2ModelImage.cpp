@@ -0,0 +1,598 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for ModelImage.
+*/
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "Osi2Config.h"
+
+#include "Osi2ModelImage.hpp"
+#include "Osi2StreamCodec.hpp"
+
+namespace {
+
+/*
+  Tag at the head of each model file. Change the version if the layout
+  changes.
+*/
+const char fileMagic[8] = { 'O','S','I','2','M','D','L','\0' } ;
+const uint32_t fileVersion = 1 ;
+const uint32_t byteOrderMark = 0x01020304 ;
+
+/*
+  Arrays start on a boundary of this many bytes.
+*/
+const uint64_t sectionAlign = 64 ;
+
+/*
+  The arrays, in file order.
+*/
+enum SectionID { SecStarts = 0, SecIndices, SecElements,
+		 SecColLower, SecColUpper, SecObj, SecRowLower, SecRowUpper,
+		 SecInteger, SecRowNameOffsets, SecRowNames,
+		 SecColNameOffsets, SecColNames, SecProbName, SecCnt } ;
+
+inline uint64_t alignUp (uint64_t pos)
+{ return ((pos+sectionAlign-1)/sectionAlign*sectionAlign) ; }
+
+/*
+  Sequential output that tracks its position, so sections can be padded
+  out to their recorded offsets.
+*/
+class Writer {
+
+public:
+
+  Writer (Osi2::OutputStream &out) : out_(out), pos_(0), ok_(true) { }
+
+  void put (const void *data, size_t len)
+  { if (!ok_ || len == 0) return ;
+    ok_ = out_.write(static_cast<const char *>(data),len) ;
+    pos_ += len ; }
+  void padTo (uint64_t pos)
+  { static const char zeros[sectionAlign] = { 0 } ;
+    while (ok_ && pos_ < pos)
+      put(zeros,static_cast<size_t>(std::min(pos-pos_,sectionAlign))) ; }
+  bool ok () const { return (ok_) ; }
+
+private:
+
+  Osi2::OutputStream &out_ ;
+  uint64_t pos_ ;
+  bool ok_ ;
+} ;
+
+/*
+  A copy of len entries of src in storage from new[], for assignProblem.
+*/
+template <class T>
+T *copyOf (const T *src, size_t len)
+{
+  T *dst = new T[len] ;
+  if (len > 0) std::copy(src,src+len,dst) ;
+  return (dst) ;
+}
+
+/*
+  Length of the names arena for cnt names given as arena and offsets; zero
+  if there are no names.
+*/
+uint64_t arenaSize (int cnt, const char *arena, const int *offsets)
+{
+  if (arena == nullptr || offsets == nullptr) return (0) ;
+  uint64_t len = 0 ;
+  for (int ndx = 0 ; ndx < cnt ; ndx++)
+    len += std::strlen(arena+offsets[ndx])+1 ;
+  return (len) ;
+}
+
+/*
+  Write the offsets and then the arena for cnt names, packing the names in
+  order.
+*/
+void writeNames (Writer &out, uint64_t offsetPos, uint64_t arenaPos,
+		 int cnt, const char *arena, const int *offsets)
+{
+  std::vector<int> packed(cnt) ;
+  int pos = 0 ;
+  for (int ndx = 0 ; ndx < cnt ; ndx++) {
+    packed[ndx] = pos ;
+    pos += static_cast<int>(std::strlen(arena+offsets[ndx]))+1 ;
+  }
+  out.padTo(offsetPos) ;
+  out.put(packed.data(),cnt*sizeof(int)) ;
+  out.padTo(arenaPos) ;
+  for (int ndx = 0 ; ndx < cnt ; ndx++) {
+    const char *name = arena+offsets[ndx] ;
+    out.put(name,std::strlen(name)+1) ;
+  }
+}
+
+/*
+  Check that cnt name offsets fall inside an arena of length len that ends
+  with a null.
+*/
+bool namesValid (const int *offsets, int cnt, const char *arena,
+		 uint64_t len)
+{
+  if (len == 0 || arena[len-1] != '\0') return (false) ;
+  for (int ndx = 0 ; ndx < cnt ; ndx++) {
+    if (offsets[ndx] < 0 || static_cast<uint64_t>(offsets[ndx]) >= len)
+      return (false) ;
+  }
+  return (true) ;
+}
+
+/*
+  Check a column-major matrix without gaps: starts run from 0 to nnz and
+  never decrease, and every row index lies in [0,m).
+*/
+bool matrixValid (const CoinBigIndex *starts, const int *indices,
+		  int n, int m, CoinBigIndex nnz)
+{
+  if (starts[0] != 0 || starts[n] != nnz) return (false) ;
+  for (int j = 0 ; j < n ; j++) {
+    if (starts[j+1] < starts[j]) return (false) ;
+  }
+  for (CoinBigIndex k = 0 ; k < nnz ; k++) {
+    if (indices[k] < 0 || indices[k] >= m) return (false) ;
+  }
+  return (true) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+/*
+  The header at the start of the file. Fields are fixed-size so the layout
+  doesn't depend on the compiler beyond byte order and the size of
+  CoinBigIndex, both of which are recorded and checked.
+*/
+struct ModelImage::Header {
+  char magic_[8] ;
+  uint32_t version_ ;
+  uint32_t byteOrder_ ;
+  uint32_t indexSize_ ;
+  uint32_t reserved_ ;
+  int64_t numCols_ ;
+  int64_t numRows_ ;
+  int64_t numElements_ ;
+  double objSense_ ;
+  double objOffset_ ;
+  uint64_t digest_[2] ;
+  uint64_t structure_[2] ;
+  uint64_t offset_[SecCnt] ;
+  uint64_t length_[SecCnt] ;
+} ;
+
+ModelImage::Source::Source ()
+  : numCols_(0),
+    numRows_(0),
+    starts_(nullptr),
+    lengths_(nullptr),
+    indices_(nullptr),
+    elements_(nullptr),
+    colLower_(nullptr),
+    colUpper_(nullptr),
+    obj_(nullptr),
+    rowLower_(nullptr),
+    rowUpper_(nullptr),
+    integer_(nullptr),
+    objSense_(1.0),
+    objOffset_(0.0),
+    rowNames_(nullptr),
+    rowNameOffsets_(nullptr),
+    colNames_(nullptr),
+    colNameOffsets_(nullptr)
+{ }
+
+/*
+  Lay out the file, then write the header and each array in turn. A matrix
+  with gaps is packed column by column as it is written.
+*/
+int ModelImage::write (const char *filename, const Source &src)
+{
+  int n = src.numCols_ ;
+  int m = src.numRows_ ;
+  CoinBigIndex nnz = 0 ;
+  for (int j = 0 ; j < n ; j++)
+    nnz += (src.lengths_ != nullptr)?src.lengths_[j]:
+				      src.starts_[j+1]-src.starts_[j] ;
+
+  Header hdr ;
+  std::memset(&hdr,0,sizeof(hdr)) ;
+  std::memcpy(hdr.magic_,fileMagic,sizeof(fileMagic)) ;
+  hdr.version_ = fileVersion ;
+  hdr.byteOrder_ = byteOrderMark ;
+  hdr.indexSize_ = sizeof(CoinBigIndex) ;
+  hdr.numCols_ = n ;
+  hdr.numRows_ = m ;
+  hdr.numElements_ = nnz ;
+  hdr.objSense_ = src.objSense_ ;
+  hdr.objOffset_ = src.objOffset_ ;
+  ModelFingerprint full(ModelFingerprint::Full) ;
+  full.compute(n,m,src.starts_,src.lengths_,src.indices_,src.elements_,
+	       src.colLower_,src.colUpper_,src.obj_,
+	       src.rowLower_,src.rowUpper_,src.objSense_) ;
+  ModelFingerprint::Digest digest = full.getDigest() ;
+  hdr.digest_[0] = digest.h1_ ;
+  hdr.digest_[1] = digest.h2_ ;
+  ModelFingerprint structure(ModelFingerprint::Structural) ;
+  structure.compute(n,m,src.starts_,src.lengths_,src.indices_,src.elements_,
+		    nullptr,nullptr,nullptr,nullptr,nullptr) ;
+  digest = structure.getDigest() ;
+  hdr.structure_[0] = digest.h1_ ;
+  hdr.structure_[1] = digest.h2_ ;
+
+  uint64_t *len = hdr.length_ ;
+  len[SecStarts] = (n+1)*sizeof(CoinBigIndex) ;
+  len[SecIndices] = nnz*sizeof(int) ;
+  len[SecElements] = nnz*sizeof(double) ;
+  len[SecColLower] = len[SecColUpper] = len[SecObj] = n*sizeof(double) ;
+  len[SecRowLower] = len[SecRowUpper] = m*sizeof(double) ;
+  len[SecInteger] = (src.integer_ != nullptr)?n:0 ;
+  len[SecRowNames] = arenaSize(m,src.rowNames_,src.rowNameOffsets_) ;
+  len[SecRowNameOffsets] = (len[SecRowNames] > 0)?m*sizeof(int):0 ;
+  len[SecColNames] = arenaSize(n,src.colNames_,src.colNameOffsets_) ;
+  len[SecColNameOffsets] = (len[SecColNames] > 0)?n*sizeof(int):0 ;
+  len[SecProbName] = src.probName_.size()+1 ;
+  uint64_t pos = alignUp(sizeof(Header)) ;
+  for (int sec = 0 ; sec < SecCnt ; sec++) {
+    hdr.offset_[sec] = pos ;
+    pos = alignUp(pos+len[sec]) ;
+  }
+/*
+  Write to a temporary file and rename it into place. The process id goes
+  into the temporary name as well as the thread, as model files are shared
+  between processes. The output is compressed if the suffix of filename
+  names a codec.
+*/
+  std::ostringstream suffix ;
+  suffix << ".tmp" ;
+#ifndef _WIN32
+  suffix << getpid() << "." ;
+#endif
+  suffix << std::hash<std::thread::id>()(std::this_thread::get_id()) ;
+  std::string tmpPath = std::string(filename)+suffix.str() ;
+  std::unique_ptr<Osi2::OutputStream> file =
+    Osi2::StreamCodec::openOutput(tmpPath.c_str(),filename) ;
+  if (!file) return (-1) ;
+
+  Writer out(*file) ;
+  out.put(&hdr,sizeof(hdr)) ;
+  out.padTo(hdr.offset_[SecStarts]) ;
+  CoinBigIndex start = 0 ;
+  for (int j = 0 ; j < n ; j++) {
+    out.put(&start,sizeof(start)) ;
+    start += (src.lengths_ != nullptr)?src.lengths_[j]:
+				       src.starts_[j+1]-src.starts_[j] ;
+  }
+  out.put(&start,sizeof(start)) ;
+  out.padTo(hdr.offset_[SecIndices]) ;
+  for (int j = 0 ; j < n ; j++) {
+    CoinBigIndex colLen = (src.lengths_ != nullptr)?src.lengths_[j]:
+			    src.starts_[j+1]-src.starts_[j] ;
+    out.put(src.indices_+src.starts_[j],colLen*sizeof(int)) ;
+  }
+  out.padTo(hdr.offset_[SecElements]) ;
+  for (int j = 0 ; j < n ; j++) {
+    CoinBigIndex colLen = (src.lengths_ != nullptr)?src.lengths_[j]:
+			    src.starts_[j+1]-src.starts_[j] ;
+    out.put(src.elements_+src.starts_[j],colLen*sizeof(double)) ;
+  }
+  const double *rim[] = { src.colLower_, src.colUpper_, src.obj_,
+			  src.rowLower_, src.rowUpper_ } ;
+  for (int sec = SecColLower ; sec <= SecRowUpper ; sec++) {
+    out.padTo(hdr.offset_[sec]) ;
+    out.put(rim[sec-SecColLower],len[sec]) ;
+  }
+  out.padTo(hdr.offset_[SecInteger]) ;
+  out.put(src.integer_,len[SecInteger]) ;
+  if (len[SecRowNames] > 0)
+    writeNames(out,hdr.offset_[SecRowNameOffsets],hdr.offset_[SecRowNames],
+	       m,src.rowNames_,src.rowNameOffsets_) ;
+  if (len[SecColNames] > 0)
+    writeNames(out,hdr.offset_[SecColNameOffsets],hdr.offset_[SecColNames],
+	       n,src.colNames_,src.colNameOffsets_) ;
+  out.padTo(hdr.offset_[SecProbName]) ;
+  out.put(src.probName_.c_str(),len[SecProbName]) ;
+  out.padTo(pos) ;
+
+  bool ok = file->close() && out.ok() ;
+  file.reset() ;
+  if (ok) ok = (std::rename(tmpPath.c_str(),filename) == 0) ;
+  if (!ok) std::remove(tmpPath.c_str()) ;
+  return ((ok)?0:-2) ;
+}
+
+/*
+  Check that the header is ours and that every array lies inside the file
+  and has the length the dimensions call for. Then check the contents that
+  loadProblem and the name accessors trust: the column starts run from 0 to
+  the number of coefficients without going backwards, every row index is
+  in range, and every name offset falls inside its arena. Finally, the
+  model must reproduce the digests recorded when it was written, which
+  catches damage to the bounds and coefficients that the other checks
+  can't see. A file that passes can be handed to loadProblem without
+  running off the end of anything.
+*/
+int ModelImage::open (const char *filename)
+{
+  close() ;
+  if (!file_.open(filename)) return (-1) ;
+  const Header *hdr = reinterpret_cast<const Header *>(file_.begin()) ;
+  uint64_t size = file_.size() ;
+  bool ok = (size >= sizeof(Header) &&
+	     std::memcmp(hdr->magic_,fileMagic,sizeof(fileMagic)) == 0 &&
+	     hdr->version_ == fileVersion &&
+	     hdr->byteOrder_ == byteOrderMark &&
+	     hdr->indexSize_ == sizeof(CoinBigIndex) &&
+	     hdr->numCols_ >= 0 && hdr->numCols_ <= INT_MAX &&
+	     hdr->numRows_ >= 0 && hdr->numRows_ <= INT_MAX &&
+	     hdr->numElements_ >= 0) ;
+  if (ok) {
+    uint64_t n = hdr->numCols_ ;
+    uint64_t m = hdr->numRows_ ;
+    uint64_t nnz = hdr->numElements_ ;
+    const uint64_t *len = hdr->length_ ;
+    for (int sec = 0 ; sec < SecCnt && ok ; sec++) {
+      ok = (hdr->offset_[sec]%sectionAlign == 0 &&
+	    hdr->offset_[sec] <= size && len[sec] <= size-hdr->offset_[sec]) ;
+    }
+    ok = ok &&
+	 len[SecStarts] == (n+1)*sizeof(CoinBigIndex) &&
+	 len[SecIndices] == nnz*sizeof(int) &&
+	 len[SecElements] == nnz*sizeof(double) &&
+	 len[SecColLower] == n*sizeof(double) &&
+	 len[SecColUpper] == n*sizeof(double) &&
+	 len[SecObj] == n*sizeof(double) &&
+	 len[SecRowLower] == m*sizeof(double) &&
+	 len[SecRowUpper] == m*sizeof(double) &&
+	 (len[SecInteger] == 0 || len[SecInteger] == n) &&
+	 (len[SecRowNameOffsets] == 0 ||
+	  len[SecRowNameOffsets] == m*sizeof(int)) &&
+	 (len[SecColNameOffsets] == 0 ||
+	  len[SecColNameOffsets] == n*sizeof(int)) &&
+	 len[SecProbName] > 0 &&
+	 file_.begin()[hdr->offset_[SecProbName]+len[SecProbName]-1] == '\0' ;
+    if (ok) {
+      hdr_ = hdr ;
+      ok = matrixValid(getColStarts(),getIndices(),static_cast<int>(n),
+		       static_cast<int>(m),static_cast<CoinBigIndex>(nnz)) ;
+      if (ok && len[SecRowNameOffsets] > 0)
+	ok = namesValid(reinterpret_cast<const int *>
+			  (section(SecRowNameOffsets)),
+			static_cast<int>(m),section(SecRowNames),
+			len[SecRowNames]) ;
+      if (ok && len[SecColNameOffsets] > 0)
+	ok = namesValid(reinterpret_cast<const int *>
+			  (section(SecColNameOffsets)),
+			static_cast<int>(n),section(SecColNames),
+			len[SecColNames]) ;
+      if (ok) {
+	ModelFingerprint full(ModelFingerprint::Full) ;
+	full.compute(getNumCols(),getNumRows(),getColStarts(),nullptr,
+		     getIndices(),getElements(),getColLower(),getColUpper(),
+		     getObjective(),getRowLower(),getRowUpper(),
+		     getObjSense()) ;
+	ModelFingerprint structure(ModelFingerprint::Structural) ;
+	structure.compute(getNumCols(),getNumRows(),getColStarts(),nullptr,
+			  getIndices(),getElements(),
+			  nullptr,nullptr,nullptr,nullptr,nullptr) ;
+	ok = (full.getDigest() == getDigest() &&
+	      structure.getDigest() == getStructure()) ;
+      }
+    }
+  }
+  if (!ok) {
+    close() ;
+    return (-2) ;
+  }
+  return (0) ;
+}
+
+void ModelImage::close ()
+{
+  hdr_ = nullptr ;
+  file_.close() ;
+}
+
+const char *ModelImage::section (int sec) const
+{
+  if (hdr_ == nullptr || hdr_->length_[sec] == 0) return (nullptr) ;
+  return (file_.begin()+hdr_->offset_[sec]) ;
+}
+
+int ModelImage::getNumCols () const
+{ return ((hdr_)?static_cast<int>(hdr_->numCols_):0) ; }
+
+int ModelImage::getNumRows () const
+{ return ((hdr_)?static_cast<int>(hdr_->numRows_):0) ; }
+
+CoinBigIndex ModelImage::getNumElements () const
+{ return ((hdr_)?static_cast<CoinBigIndex>(hdr_->numElements_):0) ; }
+
+const CoinBigIndex *ModelImage::getColStarts () const
+{ return (reinterpret_cast<const CoinBigIndex *>(section(SecStarts))) ; }
+
+const int *ModelImage::getIndices () const
+{ return (reinterpret_cast<const int *>(section(SecIndices))) ; }
+
+const double *ModelImage::getElements () const
+{ return (reinterpret_cast<const double *>(section(SecElements))) ; }
+
+const double *ModelImage::getColLower () const
+{ return (reinterpret_cast<const double *>(section(SecColLower))) ; }
+
+const double *ModelImage::getColUpper () const
+{ return (reinterpret_cast<const double *>(section(SecColUpper))) ; }
+
+const double *ModelImage::getObjective () const
+{ return (reinterpret_cast<const double *>(section(SecObj))) ; }
+
+const double *ModelImage::getRowLower () const
+{ return (reinterpret_cast<const double *>(section(SecRowLower))) ; }
+
+const double *ModelImage::getRowUpper () const
+{ return (reinterpret_cast<const double *>(section(SecRowUpper))) ; }
+
+const char *ModelImage::getIntegerInformation () const
+{ return (section(SecInteger)) ; }
+
+double ModelImage::getObjSense () const
+{ return ((hdr_)?hdr_->objSense_:1.0) ; }
+
+double ModelImage::getObjOffset () const
+{ return ((hdr_)?hdr_->objOffset_:0.0) ; }
+
+std::string ModelImage::getProblemName () const
+{
+  const char *name = section(SecProbName) ;
+  return ((name)?std::string(name):std::string()) ;
+}
+
+bool ModelImage::hasNames () const
+{
+  return (section(SecRowNames) != nullptr ||
+	  section(SecColNames) != nullptr) ;
+}
+
+const char *ModelImage::rowName (int i) const
+{
+  const char *arena = section(SecRowNames) ;
+  if (arena == nullptr || i < 0 || i >= getNumRows()) return (nullptr) ;
+  return (arena+reinterpret_cast<const int *>
+		  (section(SecRowNameOffsets))[i]) ;
+}
+
+const char *ModelImage::columnName (int j) const
+{
+  const char *arena = section(SecColNames) ;
+  if (arena == nullptr || j < 0 || j >= getNumCols()) return (nullptr) ;
+  return (arena+reinterpret_cast<const int *>
+		  (section(SecColNameOffsets))[j]) ;
+}
+
+ModelFingerprint::Digest ModelImage::getDigest () const
+{
+  ModelFingerprint::Digest digest = { 0, 0 } ;
+  if (hdr_ != nullptr) {
+    digest.h1_ = hdr_->digest_[0] ;
+    digest.h2_ = hdr_->digest_[1] ;
+  }
+  return (digest) ;
+}
+
+ModelFingerprint::Digest ModelImage::getStructure () const
+{
+  ModelFingerprint::Digest digest = { 0, 0 } ;
+  if (hdr_ != nullptr) {
+    digest.h1_ = hdr_->structure_[0] ;
+    digest.h2_ = hdr_->structure_[1] ;
+  }
+  return (digest) ;
+}
+
+/*
+  The arrays go to loadProblem straight from the mapped file.
+*/
+void ModelImage::loadInto (ClpSimplexAPI &solver) const
+{
+  int n = getNumCols() ;
+  int m = getNumRows() ;
+  solver.loadProblem(n,m,getColStarts(),getIndices(),getElements(),
+		     getColLower(),getColUpper(),getObjective(),
+		     getRowLower(),getRowUpper()) ;
+  solver.setObjSense(getObjSense()) ;
+  solver.setObjectiveOffset(getObjOffset()) ;
+  solver.setProblemName(getProblemName()) ;
+  if (getIntegerInformation() != nullptr)
+    solver.copyInIntegerInformation(getIntegerInformation()) ;
+  if (m > 0 && section(SecRowNames) != nullptr)
+    solver.setRowNames(0,m,section(SecRowNames),
+		       reinterpret_cast<const int *>
+			 (section(SecRowNameOffsets))) ;
+  if (n > 0 && section(SecColNames) != nullptr)
+    solver.setColumnNames(0,n,section(SecColNames),
+			  reinterpret_cast<const int *>
+			    (section(SecColNameOffsets))) ;
+}
+
+void ModelImage::loadInto (Osi1API &solver) const
+{
+  int n = getNumCols() ;
+  int m = getNumRows() ;
+  solver.loadProblem(n,m,getColStarts(),getIndices(),getElements(),
+		     getColLower(),getColUpper(),getObjective(),
+		     getRowLower(),getRowUpper()) ;
+  solver.setObjSense(getObjSense()) ;
+  solver.setDblParam(OsiObjOffset,getObjOffset()) ;
+  solver.setStrParam(OsiProbName,getProblemName()) ;
+  const char *integer = getIntegerInformation() ;
+  if (integer != nullptr) {
+    std::vector<int> intCols ;
+    for (int j = 0 ; j < n ; j++)
+      if (integer[j]) intCols.push_back(j) ;
+    if (!intCols.empty())
+      solver.setInteger(intCols.data(),static_cast<int>(intCols.size())) ;
+  }
+  if (section(SecRowNames) != nullptr) {
+    Osi1API::OsiNameVec names(m) ;
+    for (int i = 0 ; i < m ; i++) names[i] = rowName(i) ;
+    solver.setRowNames(names,0,m,0) ;
+  }
+  if (section(SecColNames) != nullptr) {
+    Osi1API::OsiNameVec names(n) ;
+    for (int j = 0 ; j < n ; j++) names[j] = columnName(j) ;
+    solver.setColNames(names,0,n,0) ;
+  }
+}
+
+void ModelImage::loadInto (ProbMgmtAPI &solver) const
+{
+  int n = getNumCols() ;
+  int m = getNumRows() ;
+  size_t nnz = static_cast<size_t>(getNumElements()) ;
+  CoinBigIndex *start = copyOf(getColStarts(),n+1) ;
+  int *index = copyOf(getIndices(),nnz) ;
+  double *value = copyOf(getElements(),nnz) ;
+  double *collb = copyOf(getColLower(),n) ;
+  double *colub = copyOf(getColUpper(),n) ;
+  double *obj = copyOf(getObjective(),n) ;
+  double *rowlb = copyOf(getRowLower(),m) ;
+  double *rowub = copyOf(getRowUpper(),m) ;
+  solver.assignProblem(n,m,start,index,value,collb,colub,obj,rowlb,rowub) ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+ModelImage::ModelImage ()
+  : hdr_(nullptr)
+{ }
+
+ModelImage::~ModelImage ()
+{
+  close() ;
+}
+
+} // namespace Osi2
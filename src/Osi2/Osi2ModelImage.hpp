@@ -0,0 +1,207 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ModelImage.hpp
+
+  Defines ModelImage, the Osi2 binary model format, and the methods to
+  write it and to open it in place.
+*/
+
+#ifndef Osi2ModelImage_HPP
+#define Osi2ModelImage_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "CoinTypes.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2Osi1API.hpp"
+#include "Osi2ProbMgmtAPI.hpp"
+#include "Osi2MappedFile.hpp"
+#include "Osi2ModelFingerprint.hpp"
+
+namespace Osi2 {
+
+/*! \brief A model in Osi2 binary format
+
+  The file holds a fixed header followed by the model as arrays, each
+  starting on a 64-byte boundary:
+  <ul>
+    <li> column starts (numCols+1 entries), row indices, and coefficients of
+	 the constraint matrix, column-major without gaps;
+    <li> column bounds, objective, and row bounds;
+    <li> optionally, integer information (one char per column);
+    <li> optionally, row and column names, each as an array of offsets into
+	 an arena of null-terminated strings;
+    <li> the problem name.
+  </ul>
+  The header records the dimensions, objective sense and offset, the full
+  and structural ModelFingerprint digests of the model, and the offset and
+  length of each array.
+
+  #open maps the file, checks the header, and makes one pass over the
+  arrays to check the matrix and names and to recompute the digests, so a
+  damaged file is rejected rather than handed to a solver. There is no
+  parsing and no copying; the accessors point into the mapped file and can
+  be handed straight to loadProblem. The format is native (byte order,
+  word size, size of CoinBigIndex) and a file written on a different kind
+  of machine is rejected.
+*/
+class ModelImage {
+
+public:
+
+  /*! \brief A model to be written
+
+    Dimensions and pointers to the model arrays. The matrix may have gaps
+    between columns, in which case \c lengths_ gives the column lengths;
+    if \c lengths_ is null the columns are contiguous. Integer information
+    and names are optional: leave the pointers null to omit them. Names are
+    given in the layout used by ClpSimplexAPI::setRowNames.
+  */
+  struct Source {
+    int numCols_ ;
+    int numRows_ ;
+    const CoinBigIndex *starts_ ;
+    const int *lengths_ ;
+    const int *indices_ ;
+    const double *elements_ ;
+    const double *colLower_ ;
+    const double *colUpper_ ;
+    const double *obj_ ;
+    const double *rowLower_ ;
+    const double *rowUpper_ ;
+    const char *integer_ ;
+    double objSense_ ;
+    double objOffset_ ;
+    std::string probName_ ;
+    const char *rowNames_ ;
+    const int *rowNameOffsets_ ;
+    const char *colNames_ ;
+    const int *colNameOffsets_ ;
+
+    /// Constructor; an empty model with no optional parts
+    Source() ;
+  } ;
+
+  /*! \brief Write a model to \p filename
+
+    The file is written under a temporary name and renamed into place, so
+    a concurrent reader sees either the old file or the complete new one.
+    If the suffix of \p filename names a StreamCodec (e.g., .gz), the file
+    is compressed; #open then decompresses it into memory rather than
+    mapping it in place. Returns 0 on success, -1 if the file can't be
+    created, -2 on a write error.
+  */
+  static int write(const char *filename, const Source &src) ;
+
+  /// Constructor; nothing is open
+  ModelImage() ;
+  /// Destructor
+  ~ModelImage() ;
+
+  /*! \brief Open a model written by #write
+
+    Returns 0 on success, -1 if the file can't be opened, -2 if it is not a
+    model image for this kind of machine or is damaged. A file is damaged
+    if the matrix is malformed (column starts out of order, row indices out
+    of range), a name lies outside its arena, or the model doesn't match
+    the digests recorded by #write.
+  */
+  int open(const char *filename) ;
+  /// Release the file
+  void close() ;
+  /// True if a model is open
+  bool isOpen() const { return (hdr_ != nullptr) ; }
+
+  /*! \name Model access
+
+    Pointers are into the mapped file and remain valid until the image is
+    closed.
+  */
+  //@{
+  /// Number of columns
+  int getNumCols() const ;
+  /// Number of rows
+  int getNumRows() const ;
+  /// Number of coefficients in the constraint matrix
+  CoinBigIndex getNumElements() const ;
+  /// Column starts (numCols+1 entries)
+  const CoinBigIndex *getColStarts() const ;
+  /// Row indices of coefficients
+  const int *getIndices() const ;
+  /// Coefficients
+  const double *getElements() const ;
+  /// Column lower bounds
+  const double *getColLower() const ;
+  /// Column upper bounds
+  const double *getColUpper() const ;
+  /// Objective coefficients
+  const double *getObjective() const ;
+  /// Row lower bounds
+  const double *getRowLower() const ;
+  /// Row upper bounds
+  const double *getRowUpper() const ;
+  /// Integer information, or null if there is none
+  const char *getIntegerInformation() const ;
+  /// Objective sense: 1 to minimise, -1 to maximise
+  double getObjSense() const ;
+  /// Objective offset
+  double getObjOffset() const ;
+  /// Problem name
+  std::string getProblemName() const ;
+  /// True if row and column names are present
+  bool hasNames() const ;
+  /// Name of row i, or null if there are no names
+  const char *rowName(int i) const ;
+  /// Name of column j, or null if there are no names
+  const char *columnName(int j) const ;
+  /// Full fingerprint of the model, recorded when it was written
+  ModelFingerprint::Digest getDigest() const ;
+  /// Structural fingerprint of the model, recorded when it was written
+  ModelFingerprint::Digest getStructure() const ;
+  //@}
+
+  /*! \name Loading the model into a solver */
+  //@{
+  /// Load the model into \p solver, with integer information and names
+  void loadInto(ClpSimplexAPI &solver) const ;
+  /// Load the model into \p solver, with integer information and names
+  void loadInto(Osi1API &solver) const ;
+  /*! \brief Load the model into \p solver
+
+    ProbMgmtAPI loads only through assignProblem, so the arrays are copied
+    once into storage the solver can adopt. Objective sense and offset,
+    integer information, and names are not part of ProbMgmtAPI and are
+    dropped.
+  */
+  void loadInto(ProbMgmtAPI &solver) const ;
+  //@}
+
+private:
+
+  struct Header ;
+
+  /// Pointer to section \p sec of the file
+  const char *section(int sec) const ;
+
+  /// The file
+  MappedFile file_ ;
+  /// The header, at the start of the file; null if nothing is open
+  const Header *hdr_ ;
+
+  /// Copying is not supported
+  ModelImage(const ModelImage &) ;
+  ModelImage &operator=(const ModelImage &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
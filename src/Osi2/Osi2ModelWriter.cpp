@@ -0,0 +1,937 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for ModelWriter.
+*/
+
+#include "Osi2Config.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "CoinPackedMatrix.hpp"
+#include "CoinMpsIO.hpp"
+
+#include "Osi2ModelWriter.hpp"
+#include "Osi2StreamCodec.hpp"
+
+namespace {
+
+using Osi2::OutputStream ;
+
+/*
+  Values of this magnitude or more are infinite.
+*/
+const double bigValue = 1.0e30 ;
+
+inline bool isPlusInf (double value) { return (value >= bigValue) ; }
+inline bool isMinusInf (double value) { return (value <= -bigValue) ; }
+
+/*
+  Work in a block, counted in lines or matrix entries. Large enough that a
+  thread's start-up cost is lost in the noise.
+*/
+const size_t blockWork = 1<<15 ;
+
+/*
+  Run task(0), ..., task(numTasks-1), each in its own thread. The calling
+  thread takes task 0.
+*/
+template <class Task>
+void runTasks (int numTasks, Task task)
+{
+  std::vector<std::thread> threads ;
+  for (int k = 1 ; k < numTasks ; k++)
+    threads.push_back(std::thread(task,k)) ;
+  if (numTasks > 0) task(0) ;
+  for (size_t ndx = 0 ; ndx < threads.size() ; ndx++) threads[ndx].join() ;
+}
+
+/*
+  Format items [0,numItems) and write them in order. Items are cut into
+  blocks of about blockWork, as measured by weight(i); a group of up to
+  numThreads blocks is formatted concurrently, each by format(begin,end,buf)
+  into its own buffer, and the buffers are written before the next group
+  is cut. The format of an item may depend on its index but not on the
+  block it lands in.
+*/
+template <class Weight, class Format>
+bool writeBlocks (OutputStream &out, int numThreads, int numItems,
+		  Weight weight, Format format)
+{
+  std::vector<std::string> bufs(numThreads) ;
+  std::vector<int> cuts ;
+  int next = 0 ;
+  while (next < numItems) {
+    cuts.assign(1,next) ;
+    for (int k = 0 ; k < numThreads && next < numItems ; k++) {
+      size_t work = 0 ;
+      while (next < numItems && work < blockWork) work += weight(next++) ;
+      cuts.push_back(next) ;
+    }
+    int numBlocks = static_cast<int>(cuts.size())-1 ;
+    runTasks(numBlocks,[&] (int k) {
+      bufs[k].clear() ;
+      format(cuts[k],cuts[k+1],bufs[k]) ;
+    }) ;
+    for (int k = 0 ; k < numBlocks ; k++) {
+      if (!out.write(bufs[k].data(),bufs[k].size())) return (false) ;
+    }
+  }
+  return (true) ;
+}
+
+inline bool writeString (OutputStream &out, const std::string &str)
+{
+  return (out.write(str.data(),str.size())) ;
+}
+
+/*
+  Number conversion. Numbers in MPS files are converted by CoinMpsIO's own
+  CoinConvertDouble; those in LP files are printf's %.Nf, done here.
+
+  scaleRound computes value*10^k rounded to an integer, ties to even, with
+  exact integer arithmetic. The digits of printf's %f conversion are
+  exactly such a rounding (glibc is exact, and so is any conforming
+  implementation for these magnitudes), so the text built from them is the
+  text printf would produce. scaleRound declines when the result or the
+  intermediates would be too large, and the caller falls back to snprintf.
+*/
+const uint64_t pow10u[20] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+  10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+  100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+  100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+  100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+} ;
+
+#ifdef __SIZEOF_INT128__
+
+typedef unsigned __int128 Wide ;
+
+inline Wide pow10w (int k)
+{
+  return ((k <= 19)?Wide(pow10u[k]):Wide(pow10u[19])*pow10u[k-19]) ;
+}
+
+inline int bitLength (Wide x)
+{
+  uint64_t hi = static_cast<uint64_t>(x>>64) ;
+  uint64_t lo = static_cast<uint64_t>(x) ;
+  if (hi != 0) return (128-__builtin_clzll(hi)) ;
+  if (lo != 0) return (64-__builtin_clzll(lo)) ;
+  return (0) ;
+}
+
+/*
+  value = m*2^q exactly, with m < 2^53. value*10^k is formed as num/den,
+  with the power of ten on one side and the power of two on one side.
+*/
+bool scaleRound (double value, int k, uint64_t &result)
+{
+  if (k > 22 || k < -22) return (false) ;
+  int q ;
+  double frac = std::frexp(value,&q) ;
+  Wide num = static_cast<uint64_t>(std::ldexp(frac,53)) ;
+  Wide den = 1 ;
+  q -= 53 ;
+  if (k >= 0)
+    num *= pow10w(k) ;
+  else
+    den = pow10w(-k) ;
+  if (q >= 0) {
+    if (bitLength(num)+q > 127) return (false) ;
+    num <<= q ;
+  } else {
+    if (bitLength(den)-q > 126) return (false) ;
+    den <<= -q ;
+  }
+  Wide quot = num/den ;
+  Wide twiceRem = (num-quot*den)*2 ;
+  if (twiceRem > den || (twiceRem == den && (quot&1) != 0)) quot++ ;
+  if ((quot>>64) != 0) return (false) ;
+  result = static_cast<uint64_t>(quot) ;
+  return (true) ;
+}
+
+#else
+
+bool scaleRound (double, int, uint64_t &) { return (false) ; }
+
+#endif
+
+void putUnsigned (std::string &out, uint64_t value)
+{
+  char buf[20] ;
+  int pos = 20 ;
+  do {
+    buf[--pos] = static_cast<char>('0'+value%10) ;
+    value /= 10 ;
+  } while (value != 0) ;
+  out.append(buf+pos,20-pos) ;
+}
+
+template <class T>
+void putPrintf (std::string &out, const char *fmt, int prec, T value)
+{
+  char buf[64] ;
+  int len = std::snprintf(buf,sizeof(buf),fmt,prec,value) ;
+  if (len < static_cast<int>(sizeof(buf))) {
+    out.append(buf,len) ;
+  } else {
+    std::vector<char> big(len+1) ;
+    std::snprintf(&big[0],big.size(),fmt,prec,value) ;
+    out.append(&big[0],len) ;
+  }
+}
+
+/*
+  As printf("%.*f",decimals,value). printf keeps the sign of a negative
+  value that rounds to zero, and so does this.
+*/
+void putF (std::string &out, double value, int decimals)
+{
+  uint64_t mant ;
+  if (decimals > 19 || !(std::fabs(value) <= bigValue) ||
+      !scaleRound(std::fabs(value),decimals,mant)) {
+    putPrintf(out,"%.*f",decimals,value) ;
+    return ;
+  }
+  if (std::signbit(value)) out += '-' ;
+  putUnsigned(out,mant/pow10u[decimals]) ;
+  if (decimals > 0) {
+    out += '.' ;
+    char buf[20] ;
+    uint64_t frac = mant%pow10u[decimals] ;
+    for (int ndx = decimals-1 ; ndx >= 0 ; ndx--) {
+      buf[ndx] = static_cast<char>('0'+frac%10) ;
+      frac /= 10 ;
+    }
+    out.append(buf,decimals) ;
+  }
+}
+
+/*
+  Append str padded with blanks to width.
+*/
+inline void putPadded (std::string &out, const char *str, size_t width)
+{
+  size_t len = std::strlen(str) ;
+  out.append(str,len) ;
+  if (len < width) out.append(width-len,' ') ;
+}
+
+/*
+  Row or column names, from an arena and offsets or, if there are none,
+  made up as a prefix and the index, padded with zeros to width digits. A
+  made-up name is built in the caller's buffer, which must hold 24 chars.
+*/
+class NameSource {
+
+public:
+
+  NameSource (const char *arena, const int *offsets, const char *prefix,
+	      int width)
+    : arena_((offsets != nullptr)?arena:nullptr), offsets_(offsets),
+      prefix_(prefix), width_(width)
+  { }
+
+  bool haveNames () const { return (arena_ != nullptr) ; }
+
+  void useDefaults () { arena_ = nullptr ; }
+
+  const char *get (int ndx, char *buf) const
+  { if (arena_ != nullptr) return (arena_+offsets_[ndx]) ;
+    return (dfltName(ndx,buf)) ; }
+
+  const char *dfltName (int ndx, char *buf) const
+  { char digits[12] ;
+    int len = 0 ;
+    unsigned val = static_cast<unsigned>(ndx) ;
+    do {
+      digits[len++] = static_cast<char>('0'+val%10) ;
+      val /= 10 ;
+    } while (val != 0) ;
+    int pos = 0 ;
+    for (const char *p = prefix_ ; *p != '\0' ; p++) buf[pos++] = *p ;
+    for (int pad = len ; pad < width_ ; pad++) buf[pos++] = '0' ;
+    while (len > 0) buf[pos++] = digits[--len] ;
+    buf[pos] = '\0' ;
+    return (buf) ; }
+
+private:
+
+  const char *arena_ ;
+  const int *offsets_ ;
+  const char *prefix_ ;
+  int width_ ;
+} ;
+
+/*
+  True if any of the first cnt names is longer than eight characters.
+*/
+bool longNames (const NameSource &names, int cnt)
+{
+  if (!names.haveNames()) return (false) ;
+  char buf[24] ;
+  for (int ndx = 0 ; ndx < cnt ; ndx++)
+    if (std::strlen(names.get(ndx,buf)) > 8) return (true) ;
+  return (false) ;
+}
+
+/*
+  MPS files are laid out as CoinMpsIO lays them out, so that a file written
+  here is the same as one written by clp.
+
+  A row is written with its sense and right-hand side as CoinMpsIO sees
+  them: N for a free row, L, G, or E, and R for a ranged row, which has the
+  upper bound as its right-hand side and is written as an L row.
+*/
+void rowForm (double lo, double up, char &type, double &rhs, double &range)
+{
+  range = 0.0 ;
+  if (!isMinusInf(lo)) {
+    if (!isPlusInf(up)) {
+      rhs = up ;
+      if (lo == up) {
+	type = 'E' ;
+      } else {
+	type = 'R' ;
+	range = up-lo ;
+      }
+    } else {
+      type = 'G' ;
+      rhs = lo ;
+    }
+  } else if (!isPlusInf(up)) {
+    type = 'L' ;
+    rhs = up ;
+  } else {
+    type = 'N' ;
+    rhs = 0.0 ;
+  }
+}
+
+inline int colLength (const Osi2::ModelImage::Source &src, int j)
+{
+  return ((src.lengths_ != nullptr)?src.lengths_[j]:
+	  static_cast<int>(src.starts_[j+1]-src.starts_[j])) ;
+}
+
+/*
+  IEEE format is type 2 on a little-endian machine and 3 otherwise.
+*/
+inline bool bigEndian ()
+{
+  const double one = 1.0 ;
+  unsigned char bytes[sizeof(double)] ;
+  std::memcpy(bytes,&one,sizeof(double)) ;
+  return (bytes[0] != 0) ;
+}
+
+/*
+  One line of an MPS section: a head, a name, and up to two fields, each a
+  row (or column) name and a value converted by CoinConvertDouble. In fixed
+  format each item is padded to its column.
+*/
+struct MpsCard {
+
+  MpsCard (bool freeFormat, const char *head, const char *name)
+    : freeFormat_(freeFormat), head_(head), name_(name), cnt_(0)
+  { }
+
+  void add (const char *row, const char *value)
+  { rows_[cnt_] = row ;
+    std::strcpy(values_[cnt_],value) ;
+    cnt_++ ; }
+
+  void add (const char *row, int section, int formatType, double value)
+  { char text[24] ;
+    CoinConvertDouble(section,formatType,value,text) ;
+    add(row,text) ; }
+
+  /// Append the card to out if it has any fields and start again
+  void flush (std::string &out)
+  { if (cnt_ == 0) return ;
+    out += head_ ;
+    if (freeFormat_) {
+      out += name_ ;
+      for (int ndx = 0 ; ndx < cnt_ ; ndx++) {
+	out += ' ' ;
+	out += rows_[ndx] ;
+	out += ' ' ;
+	out += values_[ndx] ;
+      }
+    } else {
+      putPadded(out,name_,8) ;
+      out += "  " ;
+      for (int ndx = 0 ; ndx < cnt_ ; ndx++) {
+	putPadded(out,rows_[ndx],8) ;
+	out += "  " ;
+	putPadded(out,values_[ndx],12) ;
+	if (ndx < cnt_-1) out += "   " ;
+      }
+    }
+    out += '\n' ;
+    cnt_ = 0 ; }
+
+  bool freeFormat_ ;
+  const char *head_ ;
+  const char *name_ ;
+  int cnt_ ;
+  const char *rows_[2] ;
+  char values_[2][24] ;
+} ;
+
+/*
+  Append the BOUNDS entries for one column. The defaults, 0 and +infinity,
+  are not written.
+*/
+void putMpsBounds (std::string &out, bool freeFormat, int formatType,
+		   const char *name, double lo, double up)
+{
+  const char *setName = "BOUND" ;
+  if (lo == up) {
+    MpsCard card(freeFormat," FX ",setName) ;
+    card.add(name,2,formatType,lo) ;
+    card.flush(out) ;
+  } else if (isMinusInf(lo) && isPlusInf(up)) {
+    MpsCard card(freeFormat," FR ",setName) ;
+    card.add(name,"") ;
+    card.flush(out) ;
+  } else {
+    if (lo != 0.0) {
+      if (isMinusInf(lo)) {
+	MpsCard card(freeFormat," MI ",setName) ;
+	card.add(name,"") ;
+	card.flush(out) ;
+      } else {
+	MpsCard card(freeFormat," LO ",setName) ;
+	card.add(name,2,formatType,lo) ;
+	card.flush(out) ;
+      }
+    }
+    if (!isPlusInf(up)) {
+      MpsCard card(freeFormat," UP ",setName) ;
+      card.add(name,2,formatType,up) ;
+      card.flush(out) ;
+    }
+  }
+}
+
+/*
+  LP files are laid out as CoinLpIO lays them out.
+
+  A coefficient as CoinLpIO writes it: unless print1 is set, a coefficient
+  of 1 is left out and -1 is written as a bare minus. Values within
+  epsilon of an integer are written as integers, others with the given
+  number of decimals.
+*/
+void putLpCoeff (std::string &out, double value, bool print1,
+		 double epsilon, int decimals)
+{
+  if (!print1) {
+    if (std::fabs(value-1.0) < epsilon) return ;
+    if (std::fabs(value+1.0) < epsilon) {
+      out += " -" ;
+      return ;
+    }
+  }
+  out += ' ' ;
+  double frac = value-std::floor(value) ;
+  if (frac < epsilon)
+    putF(out,std::floor(value),0) ;
+  else if (frac > 1.0-epsilon)
+    putF(out,std::floor(value+0.5),0) ;
+  else
+    putF(out,value,decimals) ;
+}
+
+/*
+  Append the next term of a linear expression. Coefficients no larger than
+  epsilon are dropped; cnt counts the terms written and a line is ended
+  after every numberAcross terms.
+*/
+void putLpTerm (std::string &out, double coeff, const char *name, int &cnt,
+		int numberAcross, double epsilon, int decimals)
+{
+  if (std::fabs(coeff) <= epsilon) return ;
+  if (cnt > 0 && coeff > epsilon) out += " +" ;
+  putLpCoeff(out,coeff,false,epsilon,decimals) ;
+  out += ' ' ;
+  out += name ;
+  cnt++ ;
+  if (cnt%numberAcross == 0) out += '\n' ;
+}
+
+/*
+  CoinLpIO accepts a name of up to 100 characters (counting the _low added
+  to the second half of a ranged row) drawn from letters, digits, and
+  !"#$%&()/,.;?@_`'{}|~, not starting with a digit or a period. If any name
+  is unacceptable, all are replaced by defaults.
+*/
+bool lpNameOk (const char *name, bool ranged)
+{
+  static const char *extra = "!\"#$%&()/,.;?@_`'{}|~" ;
+  size_t len = std::strlen(name) ;
+  if (len == 0 || len+((ranged)?4:0) > 100) return (false) ;
+  if (std::isdigit(static_cast<unsigned char>(name[0])) || name[0] == '.')
+    return (false) ;
+  for (size_t ndx = 0 ; ndx < len ; ndx++) {
+    unsigned char c = static_cast<unsigned char>(name[ndx]) ;
+    if (!std::isalnum(c) && std::strchr(extra,c) == nullptr) return (false) ;
+  }
+  return (true) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+void ModelWriter::setModel (const ModelImage::Source &src)
+{
+  src_ = src ;
+}
+
+void ModelWriter::setModel (const Osi1API &model)
+{
+  src_ = ModelImage::Source() ;
+  int n = model.getNumCols() ;
+  int m = model.getNumRows() ;
+  const CoinPackedMatrix *matrix = model.getMatrixByCol() ;
+  src_.numCols_ = n ;
+  src_.numRows_ = m ;
+  src_.starts_ = matrix->getVectorStarts() ;
+  src_.lengths_ = matrix->getVectorLengths() ;
+  src_.indices_ = matrix->getIndices() ;
+  src_.elements_ = matrix->getElements() ;
+  src_.colLower_ = model.getColLower() ;
+  src_.colUpper_ = model.getColUpper() ;
+  src_.obj_ = model.getObjCoefficients() ;
+  src_.rowLower_ = model.getRowLower() ;
+  src_.rowUpper_ = model.getRowUpper() ;
+  integer_.assign(n,0) ;
+  for (int j = 0 ; j < n ; j++) integer_[j] = model.isInteger(j) ;
+  src_.integer_ = integer_.data() ;
+  src_.objSense_ = model.getObjSense() ;
+  model.getDblParam(OsiObjOffset,src_.objOffset_) ;
+  model.getStrParam(OsiProbName,src_.probName_) ;
+  rowNames_.clear() ;
+  rowNameOffsets_.resize(m) ;
+  for (int i = 0 ; i < m ; i++) {
+    rowNameOffsets_[i] = static_cast<int>(rowNames_.size()) ;
+    std::string name = model.getRowName(i) ;
+    rowNames_.insert(rowNames_.end(),name.c_str(),name.c_str()+name.size()+1) ;
+  }
+  colNames_.clear() ;
+  colNameOffsets_.resize(n) ;
+  for (int j = 0 ; j < n ; j++) {
+    colNameOffsets_[j] = static_cast<int>(colNames_.size()) ;
+    std::string name = model.getColName(j) ;
+    colNames_.insert(colNames_.end(),name.c_str(),name.c_str()+name.size()+1) ;
+  }
+  src_.rowNames_ = rowNames_.data() ;
+  src_.rowNameOffsets_ = rowNameOffsets_.data() ;
+  src_.colNames_ = colNames_.data() ;
+  src_.colNameOffsets_ = colNameOffsets_.data() ;
+}
+
+/*
+  The sections are written in the order NAME, ROWS, COLUMNS, RHS, RANGES,
+  BOUNDS. A file with names longer than eight characters, or written with
+  formatType 1, is free format. The right-hand sides and ranges are listed
+  serially first so that entries can be paired by their position in the
+  list.
+*/
+int ModelWriter::writeMps (const char *filename, int formatType,
+			   int numberAcross, double objSense) const
+{
+  std::unique_ptr<OutputStream> out = StreamCodec::openOutput(filename) ;
+  if (!out) return (-1) ;
+  const ModelImage::Source &src = src_ ;
+  const int n = src.numCols_ ;
+  const int m = src.numRows_ ;
+  const int across = (numberAcross != 1)?2:1 ;
+  if (formatType < 0 || formatType > 3) formatType = 0 ;
+  if (formatType == 2 && bigEndian()) formatType = 3 ;
+  const double objMult = (objSense*src.objSense_ < 0.0)?-1.0:1.0 ;
+  const NameSource rowNames(src.rowNames_,src.rowNameOffsets_,"R",7) ;
+  const NameSource colNames(src.colNames_,src.colNameOffsets_,"C",7) ;
+  const char *objName = "OBJROW" ;
+  const bool freeFormat = (formatType == 1 || longNames(rowNames,m) ||
+			   longNames(colNames,n)) ;
+
+  std::string text = "NAME          " ;
+  if (src.probName_.empty())
+    text += "BLANK   " ;
+  else
+    putPadded(text,src.probName_.substr(0,8).c_str(),8) ;
+  if (formatType >= 2)
+    text += "FREEIEEE" ;
+  else if (freeFormat)
+    text += "FREE" ;
+  text += "\nROWS\n N  " ;
+  text += objName ;
+  text += '\n' ;
+  bool ok = writeString(*out,text) ;
+/*
+  ROWS
+*/
+  ok = ok && writeBlocks(*out,numThreads_,m,
+    [] (int) { return (static_cast<size_t>(1)) ; },
+    [&] (int begin, int end, std::string &buf) {
+      char nameBuf[24] ;
+      for (int i = begin ; i < end ; i++) {
+	char type ;
+	double rhs, range ;
+	rowForm(src.rowLower_[i],src.rowUpper_[i],type,rhs,range) ;
+	buf += ' ' ;
+	buf += (type == 'R')?'L':type ;
+	buf += "  " ;
+	buf += rowNames.get(i,nameBuf) ;
+	buf += '\n' ;
+      }
+    }) ;
+/*
+  COLUMNS. Integer columns are bracketed by markers; whether a column opens
+  or closes a bracket depends only on its neighbour. A column with no
+  entries gets an explicit zero objective coefficient so that it exists.
+*/
+  ok = ok && writeString(*out,"COLUMNS\n") ;
+  ok = ok && writeBlocks(*out,numThreads_,n,
+    [&] (int j) { return (static_cast<size_t>(colLength(src,j))+1) ; },
+    [&] (int begin, int end, std::string &buf) {
+      char colBuf[24], rowBuf[2][24] ;
+      const char *intOrg =
+	"    MARKER                 'MARKER'                 'INTORG'\n" ;
+      const char *intEnd =
+	"    MARKER                 'MARKER'                 'INTEND'\n" ;
+      for (int j = begin ; j < end ; j++) {
+	bool intgr = (src.integer_ != nullptr && src.integer_[j] != 0) ;
+	bool prevIntgr = (j > 0 && src.integer_ != nullptr &&
+			  src.integer_[j-1] != 0) ;
+	if (intgr && !prevIntgr) buf += intOrg ;
+	if (!intgr && prevIntgr) buf += intEnd ;
+	MpsCard card(freeFormat,"    ",colNames.get(j,colBuf)) ;
+	CoinBigIndex start = src.starts_[j] ;
+	int len = colLength(src,j) ;
+	double cost = src.obj_[j]*objMult ;
+	if (cost != 0.0 || len == 0) {
+	  card.add(objName,0,formatType,cost) ;
+	  if (card.cnt_ == across) card.flush(buf) ;
+	}
+	for (CoinBigIndex k = start ; k < start+len ; k++) {
+	  card.add(rowNames.get(src.indices_[k],rowBuf[card.cnt_]),
+		   0,formatType,src.elements_[k]) ;
+	  if (card.cnt_ == across) card.flush(buf) ;
+	}
+	card.flush(buf) ;
+	if (intgr && j == n-1) buf += intEnd ;
+      }
+    }) ;
+/*
+  RHS and RANGES. The objective offset goes in as the right-hand side of
+  the objective (entry -1). The RHS section is always written. The work
+  is cut into cards of numberAcross entries.
+*/
+  std::vector<int> rhsRows, rangeRows ;
+  if (src.objOffset_ != 0.0) rhsRows.push_back(-1) ;
+  for (int i = 0 ; i < m ; i++) {
+    char type ;
+    double rhs, range ;
+    rowForm(src.rowLower_[i],src.rowUpper_[i],type,rhs,range) ;
+    if (type != 'N' && rhs != 0.0) rhsRows.push_back(i) ;
+    if (type == 'R') rangeRows.push_back(i) ;
+  }
+  for (int sec = 0 ; sec < 2 && ok ; sec++) {
+    const std::vector<int> &rows = (sec == 0)?rhsRows:rangeRows ;
+    if (sec == 1 && rows.empty()) break ;
+    const char *setName = (sec == 0)?"RHS":"RANGE" ;
+    ok = writeString(*out,(sec == 0)?"RHS\n":"RANGES\n") ;
+    const int cnt = static_cast<int>(rows.size()) ;
+    const int numCards = (cnt+across-1)/across ;
+    ok = ok && writeBlocks(*out,numThreads_,numCards,
+      [] (int) { return (static_cast<size_t>(1)) ; },
+      [&] (int begin, int end, std::string &buf) {
+	char nameBuf[2][24] ;
+	MpsCard card(freeFormat,"    ",setName) ;
+	for (int t = begin*across ; t < end*across && t < cnt ; t++) {
+	  int i = rows[t] ;
+	  if (i < 0) {
+	    card.add(objName,1,formatType,src.objOffset_) ;
+	  } else {
+	    char type ;
+	    double rhs, range ;
+	    rowForm(src.rowLower_[i],src.rowUpper_[i],type,rhs,range) ;
+	    card.add(rowNames.get(i,nameBuf[card.cnt_]),1,formatType,
+		     (sec == 0)?rhs:range) ;
+	  }
+	  if (card.cnt_ == across) card.flush(buf) ;
+	}
+	card.flush(buf) ;
+      }) ;
+  }
+/*
+  BOUNDS
+*/
+  bool anyBounds = false ;
+  for (int j = 0 ; j < n && !anyBounds ; j++)
+    anyBounds = !(src.colLower_[j] == 0.0 && isPlusInf(src.colUpper_[j])) ;
+  if (anyBounds) {
+    ok = ok && writeString(*out,"BOUNDS\n") ;
+    ok = ok && writeBlocks(*out,numThreads_,n,
+      [] (int) { return (static_cast<size_t>(1)) ; },
+      [&] (int begin, int end, std::string &buf) {
+	char nameBuf[24] ;
+	for (int j = begin ; j < end ; j++) {
+	  double lo = src.colLower_[j] ;
+	  double up = src.colUpper_[j] ;
+	  if (lo == 0.0 && isPlusInf(up)) continue ;
+	  putMpsBounds(buf,freeFormat,formatType,colNames.get(j,nameBuf),
+		       lo,up) ;
+	}
+      }) ;
+  }
+  ok = ok && writeString(*out,"ENDATA\n") ;
+  ok = out->close() && ok ;
+  return ((ok)?0:-2) ;
+}
+
+/*
+  The constraints are written by row, so the matrix is transposed first.
+  Entries in a row are in column order. The objective is named OBJROW if
+  the model has names and obj if not; rows without names are cons0, cons1,
+  ..., and columns x0, x1, ....
+*/
+int ModelWriter::writeLp (const char *filename, double epsilon,
+			  int numberAcross, int decimals, double objSense,
+			  bool useRowNames) const
+{
+  std::unique_ptr<OutputStream> out = StreamCodec::openOutput(filename) ;
+  if (!out) return (-1) ;
+  const ModelImage::Source &src = src_ ;
+  const int n = src.numCols_ ;
+  const int m = src.numRows_ ;
+  const int across = (numberAcross > 0)?numberAcross:1 ;
+  const double locSense = (objSense == 0.0)?1.0:objSense ;
+  const double objMult = (src.objSense_*locSense < 0.0)?-1.0:1.0 ;
+  NameSource rowNames(src.rowNames_,src.rowNameOffsets_,"cons",0) ;
+  NameSource colNames(src.colNames_,src.colNameOffsets_,"x",0) ;
+  std::string objName = (rowNames.haveNames())?"OBJROW":"obj" ;
+  {
+    char buf[24] ;
+    for (int i = 0 ; i < m && rowNames.haveNames() ; i++) {
+      bool ranged = (!isMinusInf(src.rowLower_[i]) &&
+		     !isPlusInf(src.rowUpper_[i]) &&
+		     src.rowUpper_[i]-src.rowLower_[i] >= epsilon) ;
+      if (!lpNameOk(rowNames.get(i,buf),ranged)) {
+	rowNames.useDefaults() ;
+	objName = "obj" ;
+      }
+    }
+    for (int j = 0 ; j < n && colNames.haveNames() ; j++) {
+      if (!lpNameOk(colNames.get(j,buf),false)) colNames.useDefaults() ;
+    }
+  }
+
+  std::string text = "\\Problem name: " ;
+  text += src.probName_ ;
+  text += "\n\nMinimize\n" ;
+  if (useRowNames) {
+    text += objName ;
+    text += ':' ;
+  }
+  bool ok = writeString(*out,text) ;
+/*
+  Objective. Terms are numbered so that line breaks fall in the same place
+  whatever the blocking.
+*/
+  std::vector<int> objCols ;
+  for (int j = 0 ; j < n ; j++)
+    if (std::fabs(src.obj_[j]) > epsilon) objCols.push_back(j) ;
+  int numObj = static_cast<int>(objCols.size()) ;
+  ok = ok && writeBlocks(*out,numThreads_,numObj,
+    [] (int) { return (static_cast<size_t>(1)) ; },
+    [&] (int begin, int end, std::string &buf) {
+      char nameBuf[24] ;
+      int cnt = begin ;
+      for (int t = begin ; t < end ; t++) {
+	int j = objCols[t] ;
+	putLpTerm(buf,src.obj_[j]*objMult,colNames.get(j,nameBuf),cnt,
+		  across,epsilon,decimals) ;
+      }
+    }) ;
+  text.clear() ;
+  double constant = -src.objOffset_*objMult ;
+  if (numObj > 0 && constant > epsilon) text += " +" ;
+  if (std::fabs(constant) > epsilon) {
+    putLpCoeff(text,constant,true,epsilon,decimals) ;
+    numObj++ ;
+  }
+  if (numObj == 0 || numObj%across != 0) text += '\n' ;
+  text += "Subject To\n" ;
+  ok = ok && writeString(*out,text) ;
+/*
+  Transpose the matrix.
+*/
+  std::vector<CoinBigIndex> rowStarts(m+1,0) ;
+  for (int j = 0 ; j < n ; j++) {
+    CoinBigIndex start = src.starts_[j] ;
+    CoinBigIndex end = start+colLength(src,j) ;
+    for (CoinBigIndex k = start ; k < end ; k++)
+      rowStarts[src.indices_[k]+1]++ ;
+  }
+  for (int i = 0 ; i < m ; i++) rowStarts[i+1] += rowStarts[i] ;
+  std::vector<int> rowCols(rowStarts[m]) ;
+  std::vector<double> rowElems(rowStarts[m]) ;
+  {
+    std::vector<CoinBigIndex> fill(rowStarts.begin(),rowStarts.end()-1) ;
+    for (int j = 0 ; j < n ; j++) {
+      CoinBigIndex start = src.starts_[j] ;
+      CoinBigIndex end = start+colLength(src,j) ;
+      for (CoinBigIndex k = start ; k < end ; k++) {
+	CoinBigIndex dst = fill[src.indices_[k]]++ ;
+	rowCols[dst] = j ;
+	rowElems[dst] = src.elements_[k] ;
+      }
+    }
+  }
+/*
+  Constraints. A ranged row is written twice, as a <= row under its own
+  name and as a >= row under its name with _low appended.
+*/
+  ok = ok && writeBlocks(*out,numThreads_,m,
+    [&] (int i) {
+      return (static_cast<size_t>(rowStarts[i+1]-rowStarts[i])+1) ; },
+    [&] (int begin, int end, std::string &buf) {
+      char rowBuf[24], colBuf[24] ;
+      for (int i = begin ; i < end ; i++) {
+	double lo = src.rowLower_[i] ;
+	double up = src.rowUpper_[i] ;
+	const char *rowName = rowNames.get(i,rowBuf) ;
+	CoinBigIndex rowStart = rowStarts[i] ;
+	CoinBigIndex rowEnd = rowStarts[i+1] ;
+	for (int half = 0 ; half < 2 ; half++) {
+	  if (useRowNames) {
+	    buf += rowName ;
+	    buf += (half == 0)?": ":"_low:" ;
+	  }
+	  int cnt = 0 ;
+	  for (CoinBigIndex k = rowStart ; k < rowEnd ; k++) {
+	    putLpTerm(buf,rowElems[k],colNames.get(rowCols[k],colBuf),cnt,
+		      across,epsilon,decimals) ;
+	  }
+	  if (half == 1) {
+	    buf += " >=" ;
+	    putLpCoeff(buf,lo,true,epsilon,decimals) ;
+	    buf += '\n' ;
+	  } else if (up-lo < epsilon) {
+	    buf += " =" ;
+	    putLpCoeff(buf,lo,true,epsilon,decimals) ;
+	    buf += '\n' ;
+	  } else if (!isPlusInf(up)) {
+	    buf += " <=" ;
+	    putLpCoeff(buf,up,true,epsilon,decimals) ;
+	    buf += '\n' ;
+	    if (!isMinusInf(lo)) continue ;
+	  } else {
+	    buf += " >=" ;
+	    putLpCoeff(buf,lo,true,epsilon,decimals) ;
+	    buf += '\n' ;
+	  }
+	  break ;
+	}
+      }
+    }) ;
+/*
+  Bounds. The section is always written; the LP default, [0,+infinity),
+  is not.
+*/
+  ok = ok && writeString(*out,"Bounds\n") ;
+  ok = ok && writeBlocks(*out,numThreads_,n,
+    [] (int) { return (static_cast<size_t>(1)) ; },
+    [&] (int begin, int end, std::string &buf) {
+      char nameBuf[24] ;
+      for (int j = begin ; j < end ; j++) {
+	double lo = src.colLower_[j] ;
+	double up = src.colUpper_[j] ;
+	const char *name = colNames.get(j,nameBuf) ;
+	if (!isMinusInf(lo) && !isPlusInf(up)) {
+	  putLpCoeff(buf,lo,true,epsilon,decimals) ;
+	  buf += " <= " ;
+	  buf += name ;
+	  buf += " <=" ;
+	  putLpCoeff(buf,up,true,epsilon,decimals) ;
+	  buf += '\n' ;
+	} else if (isMinusInf(lo) && !isPlusInf(up)) {
+	  buf += name ;
+	  buf += " >= -inf\n" ;
+	  buf += name ;
+	  buf += " <=" ;
+	  putLpCoeff(buf,up,true,epsilon,decimals) ;
+	  buf += '\n' ;
+	} else if (!isMinusInf(lo)) {
+	  if (std::fabs(lo) > epsilon) {
+	    putLpCoeff(buf,lo,true,epsilon,decimals) ;
+	    buf += " <= " ;
+	    buf += name ;
+	    buf += '\n' ;
+	  }
+	} else {
+	  buf += ' ' ;
+	  buf += name ;
+	  buf += " Free\n" ;
+	}
+      }
+    }) ;
+/*
+  Integer columns
+*/
+  std::vector<int> intCols ;
+  for (int j = 0 ; j < n ; j++)
+    if (src.integer_ != nullptr && src.integer_[j] != 0) intCols.push_back(j) ;
+  if (!intCols.empty()) {
+    const int numInt = static_cast<int>(intCols.size()) ;
+    ok = ok && writeString(*out,"Integers\n") ;
+    ok = ok && writeBlocks(*out,numThreads_,numInt,
+      [] (int) { return (static_cast<size_t>(1)) ; },
+      [&] (int begin, int end, std::string &buf) {
+	char nameBuf[24] ;
+	for (int t = begin ; t < end ; t++) {
+	  buf += colNames.get(intCols[t],nameBuf) ;
+	  buf += ' ' ;
+	  if ((t+1)%across == 0) buf += '\n' ;
+	}
+      }) ;
+    if (numInt%across != 0) ok = ok && writeString(*out,"\n") ;
+  }
+  ok = ok && writeString(*out,"End\n") ;
+  ok = out->close() && ok ;
+  return ((ok)?0:-2) ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+ModelWriter::ModelWriter (int numThreads)
+  : numThreads_(numThreads)
+{
+  if (numThreads_ < 1) {
+    numThreads_ = static_cast<int>(std::thread::hardware_concurrency()) ;
+    if (numThreads_ < 1) numThreads_ = 1 ;
+  }
+}
+
+ModelWriter::~ModelWriter () { }
+
+} // namespace Osi2
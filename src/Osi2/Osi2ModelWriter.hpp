@@ -0,0 +1,130 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ModelWriter.hpp
+
+  Defines ModelWriter, a native writer for MPS and LP files that formats
+  the model in parallel.
+*/
+
+#ifndef Osi2ModelWriter_HPP
+#define Osi2ModelWriter_HPP
+
+#include <string>
+#include <vector>
+
+#include "Osi2ModelImage.hpp"
+#include "Osi2Osi1API.hpp"
+
+namespace Osi2 {
+
+/*! \brief A parallel writer for MPS and LP files
+
+  Each section of the file is cut into blocks of columns or rows. A group
+  of blocks, one per thread, is formatted concurrently into per-thread
+  buffers and the buffers are written in order before the next group is
+  started, so memory use is bounded and the output is the same whatever
+  the number of threads.
+
+  The layout follows CoinMpsIO and CoinLpIO, the writers used by clp and
+  Osi, and MPS numbers are converted by CoinMpsIO's CoinConvertDouble, so
+  a file written here should be the same as one written by
+  ClpSimplexAPI::writeMps or Osi1API::writeLp with the same parameters.
+  The writer is not used by default; a client opts in with
+  ClpSimplexAPI::setParallelWrite, or by handing an Osi1API object to
+  #setModel and calling #writeMps or #writeLp directly.
+
+  The file is compressed if its name ends in the suffix of a StreamCodec.
+  Values of 1e30 or more in magnitude are infinite. Return codes are 0 on
+  success, -1 if the file can't be created, and -2 on a write error.
+*/
+class ModelWriter {
+
+public:
+
+  /*! \brief Constructor
+
+    \p numThreads is the number of threads used to format each section;
+    zero means one per hardware thread.
+  */
+  ModelWriter(int numThreads = 0) ;
+  /// Destructor
+  ~ModelWriter() ;
+
+  /*! \name The model to write */
+  //@{
+  /*! \brief Write the model described by \p src
+
+    The arrays are referenced, not copied, and must outlive the writer or
+    the next call to setModel.
+  */
+  void setModel(const ModelImage::Source &src) ;
+  /*! \brief Write the model held by \p model
+
+    The matrix and bounds are referenced; names and integer information are
+    copied. \p model must not be changed while the writer uses it.
+  */
+  void setModel(const Osi1API &model) ;
+  //@}
+
+  /*! \name Writing files */
+  //@{
+  /*! \brief Write an MPS file
+
+    As ClpSimplexAPI::writeMps. \p formatType is 0 for normal precision,
+    1 for extra precision (free format), or 2 for IEEE hexadecimal; names
+    longer than eight characters also make the file free format.
+    \p numberAcross is 1 or 2 entries per line. The objective is negated
+    if \p objSense and the sense of the model differ in sign; the file is
+    always a minimisation. Rows and columns without names are written
+    with names of the form R0000012 and C0000012.
+  */
+  int writeMps(const char *filename, int formatType = 0,
+	       int numberAcross = 2, double objSense = 0.0) const ;
+  /*! \brief Write an LP file
+
+    As Osi1API::writeLp. Coefficients no larger than \p epsilon are
+    dropped; those less than \p epsilon away from an integer are written
+    as integers, and others with \p decimals digits after the decimal
+    point. A line is ended after every \p numberAcross terms.
+
+    The file is always a minimisation. The objective is negated if the
+    sense of the model and \p objSense (0.0 counts as 1.0) differ in
+    sign. Row names are written as constraint labels only if
+    \p useRowNames is true. If any row or column name is not a legal LP
+    name, the default names are used for all rows or columns. A ranged row
+    is written as two constraints.
+  */
+  int writeLp(const char *filename, double epsilon = 1e-5,
+	      int numberAcross = 10, int decimals = 5, double objSense = 0.0,
+	      bool useRowNames = true) const ;
+  //@}
+
+private:
+
+  /// Number of threads used to format each section
+  int numThreads_ ;
+  /// The model
+  ModelImage::Source src_ ;
+
+  /*! \name Storage for a model taken from an Osi1API object */
+  //@{
+  std::vector<char> integer_ ;
+  std::vector<char> rowNames_ ;
+  std::vector<int> rowNameOffsets_ ;
+  std::vector<char> colNames_ ;
+  std::vector<int> colNameOffsets_ ;
+  //@}
+
+  /// Copying is not supported
+  ModelWriter(const ModelWriter &) ;
+  ModelWriter &operator=(const ModelWriter &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
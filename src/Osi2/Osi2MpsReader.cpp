@@ -0,0 +1,946 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for MpsReader.
+*/
+
+#include "Osi2Config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "Osi2MappedFile.hpp"
+#include "Osi2MappedNames.hpp"
+#include "Osi2NumberParser.hpp"
+#include "Osi2MpsReader.hpp"
+
+namespace {
+
+const double infinity = std::numeric_limits<double>::max() ;
+
+/*
+  Blocks smaller than this aren't worth a thread of their own.
+*/
+const size_t dfltMinBlockSize = 1<<20 ;
+
+/*
+  Tokens kept per line; no legal line has more than six.
+*/
+const int maxTokens = 8 ;
+
+/*
+  Error messages kept per read.
+*/
+const size_t maxMessages = 100 ;
+
+/*
+  Codes in the row name index for rows that are not constraints: the
+  objective, and any further N rows, which are discarded.
+*/
+const int objRow = -1 ;
+const int freeRow = -2 ;
+
+/*
+  Integer state of a column declared before the first MARKER in a block of
+  the COLUMNS section. The state is set by an earlier block.
+*/
+const char inherit = 2 ;
+
+/*
+  A token is a reference into the file image.
+*/
+struct Name {
+  const char *ptr_ ;
+  int len_ ;
+
+  bool operator== (const Name &rhs) const
+  { return (len_ == rhs.len_ && std::memcmp(ptr_,rhs.ptr_,len_) == 0) ; }
+  bool operator!= (const Name &rhs) const { return (!(*this == rhs)) ; }
+  bool is (const char *str) const
+  { return (std::strlen(str) == static_cast<size_t>(len_) &&
+	    std::memcmp(ptr_,str,len_) == 0) ; }
+  std::string str () const { return (std::string(ptr_,len_)) ; }
+} ;
+
+/*
+  FNV-1a over the characters of the name.
+*/
+struct NameHash {
+  size_t operator() (const Name &name) const
+  { uint64_t hash = 14695981039346656037ULL ;
+    for (int ndx = 0 ; ndx < name.len_ ; ndx++) {
+      hash ^= static_cast<unsigned char>(name.ptr_[ndx]) ;
+      hash *= 1099511628211ULL ;
+    }
+    return (static_cast<size_t>(hash)) ; }
+} ;
+
+typedef std::unordered_map<Name,int,NameHash> NameMap ;
+
+/*
+  Errors found while parsing. Every error is counted; only the first few
+  messages are kept.
+*/
+struct ErrorLog {
+  int count_ ;
+  std::vector<std::string> msgs_ ;
+
+  ErrorLog () : count_(0) { }
+  void add (const std::string &msg)
+  { count_++ ;
+    if (msgs_.size() < maxMessages) msgs_.push_back(msg) ; }
+  void add (const char *what, const Name &name)
+  { count_++ ;
+    if (msgs_.size() < maxMessages)
+      msgs_.push_back(std::string(what)+" \""+name.str()+"\"") ; }
+  void append (const ErrorLog &other)
+  { count_ += other.count_ ;
+    for (size_t ndx = 0 ; ndx < other.msgs_.size() ; ndx++) {
+      if (msgs_.size() >= maxMessages) break ;
+      msgs_.push_back(other.msgs_[ndx]) ;
+    } }
+} ;
+
+inline bool isBlank (char c)
+{ return (c == ' ' || c == '\t' || c == '\r') ; }
+
+inline bool isDigit (char c)
+{ return (static_cast<unsigned>(c-'0') < 10) ; }
+
+/*
+  Split the line starting at p into blank-separated tokens and return the
+  start of the next line. cnt is the number of tokens on the line; only the
+  first maxTokens are stored. Comment lines have no tokens.
+*/
+const char *tokenize (const char *p, const char *end, Name *toks, int &cnt)
+{
+  const char *eol =
+      static_cast<const char *>(std::memchr(p,'\n',end-p)) ;
+  if (eol == nullptr) eol = end ;
+  cnt = 0 ;
+  if (*p != '*') {
+    while (true) {
+      while (p < eol && isBlank(*p)) p++ ;
+      if (p >= eol) break ;
+      const char *start = p ;
+      while (p < eol && !isBlank(*p)) p++ ;
+      if (cnt < maxTokens) {
+	toks[cnt].ptr_ = start ;
+	toks[cnt].len_ = static_cast<int>(p-start) ;
+      }
+      cnt++ ;
+    }
+  }
+  return ((eol < end)?eol+1:end) ;
+}
+
+/*
+  Convert a token to a double.
+*/
+inline bool parseNumber (const Name &tok, double &value)
+{
+  return (Osi2::NumberParser::toDouble(tok.ptr_,tok.ptr_+tok.len_,value)) ;
+}
+
+/*
+  Bounds, right-hand sides, and ranges of 1e30 or more are infinite.
+*/
+inline double clampInfinity (double value)
+{
+  if (value >= 1.0e30) return (infinity) ;
+  if (value <= -1.0e30) return (-infinity) ;
+  return (value) ;
+}
+
+/*
+  Run task(0), ..., task(numTasks-1), each in its own thread. The calling
+  thread takes task 0.
+*/
+template <class Task>
+void runTasks (int numTasks, Task task)
+{
+  std::vector<std::thread> threads ;
+  for (int k = 1 ; k < numTasks ; k++)
+    threads.push_back(std::thread(task,k)) ;
+  if (numTasks > 0) task(0) ;
+  for (size_t ndx = 0 ; ndx < threads.size() ; ndx++) threads[ndx].join() ;
+}
+
+/*
+  Cut [begin,end) into at most maxBlocks blocks of whole lines, none
+  smaller than minBlockSize, and return the boundaries, one more than the
+  number of blocks. A range too small to be worth splitting is a single
+  block.
+*/
+std::vector<const char *> splitLines (const char *begin, const char *end,
+				      int maxBlocks, size_t minBlockSize)
+{
+  size_t len = end-begin ;
+  size_t numBlocks = std::min(len/minBlockSize,
+			      static_cast<size_t>(maxBlocks)) ;
+  if (numBlocks < 1) numBlocks = 1 ;
+  std::vector<const char *> bounds(1,begin) ;
+  for (size_t k = 1 ; k < numBlocks ; k++) {
+    const char *p = std::max(begin+k*(len/numBlocks),bounds.back()) ;
+    const char *eol = (p > begin)?
+      static_cast<const char *>(std::memchr(p-1,'\n',end-(p-1))):nullptr ;
+    if (p > begin && eol == nullptr) p = end ;
+    else if (p > begin) p = eol+1 ;
+    bounds.push_back(p) ;
+  }
+  bounds.push_back(end) ;
+  return (bounds) ;
+}
+
+/*
+  Collect the section header lines (lines that don't start with a blank or
+  a comment) in [p,end).
+*/
+void findHeaders (const char *p, const char *end,
+		  std::vector<const char *> &headers)
+{
+  while (p < end) {
+    if (!isBlank(*p) && *p != '*' && *p != '\n') headers.push_back(p) ;
+    const char *eol =
+	static_cast<const char *>(std::memchr(p,'\n',end-p)) ;
+    p = (eol == nullptr)?end:eol+1 ;
+  }
+}
+
+/*
+  The sections we know about, and where they are in the file.
+*/
+enum SectionID { SecRows = 0, SecColumns, SecRhs, SecRanges, SecBounds,
+		 SecObjSense, SecCnt } ;
+const char *sectionNames[SecCnt] = { "ROWS", "COLUMNS", "RHS", "RANGES",
+				     "BOUNDS", "OBJSENSE" } ;
+
+struct Section {
+  const char *begin_ ;
+  const char *end_ ;
+  bool present_ ;
+} ;
+
+/*
+  The part of the COLUMNS section parsed by one thread. Columns are numbered
+  locally, in the order they appear; the first may continue the last column
+  of the previous block.
+*/
+struct ColumnBlock {
+  std::vector<Name> names_ ;
+  std::vector<CoinBigIndex> starts_ ;
+  std::vector<char> intState_ ;
+  char endState_ ;
+  std::vector<int> indices_ ;
+  std::vector<double> elements_ ;
+  std::vector<std::pair<int,double> > obj_ ;
+  ErrorLog log_ ;
+} ;
+
+void parseColumns (const char *p, const char *end, const NameMap &rowMap,
+		   ColumnBlock &blk)
+{
+  Name toks[maxTokens] ;
+  int cnt ;
+  char state = inherit ;
+  while (p < end) {
+    p = tokenize(p,end,toks,cnt) ;
+    if (cnt == 0) continue ;
+    if (cnt >= 3 && toks[1].is("'MARKER'")) {
+      if (toks[2].is("'INTORG'"))
+	state = 1 ;
+      else if (toks[2].is("'INTEND'"))
+	state = 0 ;
+      else
+	blk.log_.add("COLUMNS: unknown marker",toks[2]) ;
+      continue ;
+    }
+    if (cnt != 3 && cnt != 5) {
+      blk.log_.add("COLUMNS: bad entry for column",toks[0]) ;
+      continue ;
+    }
+    if (blk.names_.empty() || blk.names_.back() != toks[0]) {
+      blk.names_.push_back(toks[0]) ;
+      blk.starts_.push_back(static_cast<CoinBigIndex>(blk.indices_.size())) ;
+      blk.intState_.push_back(state) ;
+    }
+    int col = static_cast<int>(blk.names_.size())-1 ;
+    for (int t = 1 ; t < cnt ; t += 2) {
+      NameMap::const_iterator row = rowMap.find(toks[t]) ;
+      double value ;
+      if (row == rowMap.end()) {
+	blk.log_.add("COLUMNS: unknown row",toks[t]) ;
+      } else if (!parseNumber(toks[t+1],value)) {
+	blk.log_.add("COLUMNS: bad number",toks[t+1]) ;
+      } else if (row->second >= 0) {
+	blk.indices_.push_back(row->second) ;
+	blk.elements_.push_back(value) ;
+      } else if (row->second == objRow) {
+	blk.obj_.push_back(std::make_pair(col,value)) ;
+      }
+    }
+  }
+  blk.endState_ = state ;
+}
+
+/*
+  The part of an RHS or RANGES section parsed by one thread: (row, value)
+  pairs in file order, with objRow standing for the objective.
+*/
+struct PairBlock {
+  std::vector<std::pair<int,double> > entries_ ;
+  ErrorLog log_ ;
+} ;
+
+/*
+  Lines have an odd number of tokens if the set name is given. Only the set
+  named on the first line is used.
+*/
+void parsePairs (const char *p, const char *end, const NameMap &rowMap,
+		 const Name &setName, const char *what, PairBlock &blk)
+{
+  Name toks[maxTokens] ;
+  int cnt ;
+  while (p < end) {
+    p = tokenize(p,end,toks,cnt) ;
+    if (cnt == 0) continue ;
+    if (cnt < 2 || cnt > 5) {
+      blk.log_.add(std::string(what)+": bad entry \""+toks[0].str()+"\"") ;
+      continue ;
+    }
+    int first = cnt%2 ;
+    if (first == 1 && setName.len_ > 0 && toks[0] != setName) continue ;
+    for (int t = first ; t < cnt ; t += 2) {
+      NameMap::const_iterator row = rowMap.find(toks[t]) ;
+      double value ;
+      if (row == rowMap.end()) {
+	blk.log_.add(std::string(what)+": unknown row \""+
+		     toks[t].str()+"\"") ;
+      } else if (!parseNumber(toks[t+1],value)) {
+	blk.log_.add(std::string(what)+": bad number \""+
+		     toks[t+1].str()+"\"") ;
+      } else if (row->second != freeRow) {
+	blk.entries_.push_back(std::make_pair(row->second,value)) ;
+      }
+    }
+  }
+}
+
+/*
+  Bound types, and whether each needs a value.
+*/
+enum BoundType { BndUP = 0, BndLO, BndFX, BndFR, BndMI, BndPL, BndBV,
+		 BndLI, BndUI, BndCnt } ;
+const char *boundNames[BndCnt] = { "UP", "LO", "FX", "FR", "MI", "PL", "BV",
+				   "LI", "UI" } ;
+const bool boundNeedsValue[BndCnt] = { true, true, true, false, false,
+				       false, false, true, true } ;
+
+struct Bound {
+  int col_ ;
+  int type_ ;
+  double value_ ;
+} ;
+
+struct BoundBlock {
+  std::vector<Bound> bounds_ ;
+  ErrorLog log_ ;
+} ;
+
+/*
+  Work out the layout of a BOUNDS line. The set name is optional, and so is
+  the value for bound types that don't need one, which makes a three-token
+  line ambiguous; it's read as type, set, column if the last token is a
+  column name. Returns the bound type, or -1 if the line is malformed.
+*/
+int boundLayout (const Name *toks, int cnt, const NameMap &colMap,
+		 const Name *&set, const Name *&col, const Name *&value)
+{
+  if (cnt < 2 || cnt > 4) return (-1) ;
+  int type = 0 ;
+  while (type < BndCnt && !toks[0].is(boundNames[type])) type++ ;
+  if (type >= BndCnt) return (-1) ;
+  set = nullptr ;
+  value = nullptr ;
+  if (cnt == 4) {
+    set = &toks[1] ;
+    col = &toks[2] ;
+    value = &toks[3] ;
+  } else if (cnt == 2) {
+    col = &toks[1] ;
+  } else if (boundNeedsValue[type] || colMap.find(toks[2]) == colMap.end()) {
+    col = &toks[1] ;
+    value = &toks[2] ;
+  } else {
+    set = &toks[1] ;
+    col = &toks[2] ;
+  }
+  if (boundNeedsValue[type] && value == nullptr) return (-1) ;
+  return (type) ;
+}
+
+void parseBounds (const char *p, const char *end, const NameMap &colMap,
+		  const Name &setName, BoundBlock &blk)
+{
+  Name toks[maxTokens] ;
+  int cnt ;
+  while (p < end) {
+    p = tokenize(p,end,toks,cnt) ;
+    if (cnt == 0) continue ;
+    const Name *set, *col, *value ;
+    Bound bnd ;
+    bnd.type_ = boundLayout(toks,cnt,colMap,set,col,value) ;
+    if (bnd.type_ < 0) {
+      blk.log_.add("BOUNDS: bad entry",toks[0]) ;
+      continue ;
+    }
+    if (set != nullptr && setName.len_ > 0 && *set != setName) continue ;
+    NameMap::const_iterator colIter = colMap.find(*col) ;
+    if (colIter == colMap.end()) {
+      blk.log_.add("BOUNDS: unknown column",*col) ;
+      continue ;
+    }
+    bnd.col_ = colIter->second ;
+    bnd.value_ = 0.0 ;
+    if (boundNeedsValue[bnd.type_] && !parseNumber(*value,bnd.value_)) {
+      blk.log_.add("BOUNDS: bad number",*value) ;
+      continue ;
+    }
+    bnd.value_ = clampInfinity(bnd.value_) ;
+    blk.bounds_.push_back(bnd) ;
+  }
+}
+
+/*
+  The first data line in [p,end), as tokens; cnt is zero if there is none.
+*/
+void firstLine (const char *p, const char *end, Name *toks, int &cnt)
+{
+  cnt = 0 ;
+  while (p < end && cnt == 0) p = tokenize(p,end,toks,cnt) ;
+}
+
+/*
+  Append a name to a name arena.
+*/
+void addName (const Name &name, std::vector<char> &arena,
+	      std::vector<int> &offsets)
+{
+  offsets.push_back(static_cast<int>(arena.size())) ;
+  arena.insert(arena.end(),name.ptr_,name.ptr_+name.len_) ;
+  arena.push_back('\0') ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+/*
+  The file is read in phases:
+    * locate the section headers (in parallel);
+    * read the ROWS section and build the row name index;
+    * parse COLUMNS in blocks (in parallel), then number the columns, lay
+      out the column starts, and copy each block's coefficients into place
+      (in parallel);
+    * parse RHS, RANGES, and BOUNDS in blocks (in parallel), then apply the
+      entries in file order, so the last entry for a row or column wins;
+    * copy out names, if wanted, before the file is released.
+
+  For lazy names the file image is handed to a MappedNames object at the
+  start, and the names are recorded as they're met instead of copied.
+*/
+int MpsReader::readMps (const char *filename, bool keepNames,
+			bool lazyNames)
+{
+  clear() ;
+  std::unique_ptr<MappedFile> image(new MappedFile) ;
+  if (!image->open(filename)) return (-1) ;
+  const char *fileBegin = image->begin() ;
+  const char *fileEnd = image->end() ;
+  MappedNames *lazy = nullptr ;
+  if (keepNames && lazyNames) {
+    mappedNames_.reset(new MappedNames(image.release())) ;
+    lazy = mappedNames_.get() ;
+  }
+  ErrorLog log ;
+  Name toks[maxTokens] ;
+  int cnt ;
+/*
+  Find the section headers, then the extent of each section. Anything after
+  ENDATA is ignored.
+*/
+  std::vector<const char *> bounds =
+      splitLines(fileBegin,fileEnd,numThreads_,minBlockSize_) ;
+  int numBlocks = static_cast<int>(bounds.size())-1 ;
+  std::vector<std::vector<const char *> > blockHeaders(numBlocks) ;
+  runTasks(numBlocks,[&] (int k) {
+    findHeaders(bounds[k],bounds[k+1],blockHeaders[k]) ;
+  }) ;
+  std::vector<const char *> headers ;
+  for (int k = 0 ; k < numBlocks ; k++)
+    headers.insert(headers.end(),
+		   blockHeaders[k].begin(),blockHeaders[k].end()) ;
+  Section sections[SecCnt] ;
+  for (int sec = 0 ; sec < SecCnt ; sec++) sections[sec].present_ = false ;
+  std::vector<Name> senseToks ;
+  for (size_t ndx = 0 ; ndx < headers.size() ; ndx++) {
+    const char *body = tokenize(headers[ndx],fileEnd,toks,cnt) ;
+    const char *bodyEnd =
+	(ndx+1 < headers.size())?headers[ndx+1]:fileEnd ;
+    if (toks[0].is("ENDATA")) break ;
+    if (toks[0].is("NAME")) {
+      if (cnt > 1) probName_ = toks[1].str() ;
+      continue ;
+    }
+    int sec = 0 ;
+    while (sec < SecCnt && !toks[0].is(sectionNames[sec])) sec++ ;
+    if (sec >= SecCnt) {
+      log.add("unsupported section",toks[0]) ;
+      continue ;
+    }
+    if (sections[sec].present_) {
+      log.add("repeated section",toks[0]) ;
+      continue ;
+    }
+    sections[sec].begin_ = body ;
+    sections[sec].end_ = bodyEnd ;
+    sections[sec].present_ = true ;
+    if (sec == SecObjSense && cnt > 1) senseToks.push_back(toks[1]) ;
+  }
+  if (!sections[SecRows].present_) log.add("no ROWS section") ;
+/*
+  Objective sense, from the OBJSENSE header or the line after it.
+*/
+  if (sections[SecObjSense].present_) {
+    firstLine(sections[SecObjSense].begin_,sections[SecObjSense].end_,
+	      toks,cnt) ;
+    if (cnt > 0) senseToks.push_back(toks[0]) ;
+    for (size_t ndx = 0 ; ndx < senseToks.size() ; ndx++) {
+      if (senseToks[ndx].is("MAX") || senseToks[ndx].is("MAXIMIZE"))
+	objSense_ = -1.0 ;
+      else if (senseToks[ndx].is("MIN") || senseToks[ndx].is("MINIMIZE"))
+	objSense_ = 1.0 ;
+      else
+	log.add("OBJSENSE: unknown sense",senseToks[ndx]) ;
+    }
+  }
+/*
+  ROWS. The first N row is the objective; any others are dropped.
+*/
+  NameMap rowMap ;
+  std::vector<char> rowTypes ;
+  std::vector<Name> rowNameRefs ;
+  bool haveObj = false ;
+  if (sections[SecRows].present_) {
+    const char *p = sections[SecRows].begin_ ;
+    while (p < sections[SecRows].end_) {
+      p = tokenize(p,sections[SecRows].end_,toks,cnt) ;
+      if (cnt == 0) continue ;
+      char type = (toks[0].len_ == 1)?toks[0].ptr_[0]:'?' ;
+      if (cnt != 2 || std::strchr("NELG",type) == nullptr) {
+	log.add("ROWS: bad entry",toks[0]) ;
+	continue ;
+      }
+      int ndx ;
+      if (type != 'N') {
+	ndx = static_cast<int>(rowTypes.size()) ;
+      } else {
+	ndx = (haveObj)?freeRow:objRow ;
+	haveObj = true ;
+      }
+      if (!rowMap.insert(std::make_pair(toks[1],ndx)).second) {
+	log.add("ROWS: duplicate row",toks[1]) ;
+	continue ;
+      }
+      if (ndx >= 0) {
+	rowTypes.push_back(type) ;
+	if (lazy != nullptr)
+	  lazy->add(true,toks[1].ptr_,toks[1].len_) ;
+	else if (keepNames)
+	  rowNameRefs.push_back(toks[1]) ;
+      }
+    }
+  }
+  int m = static_cast<int>(rowTypes.size()) ;
+  numRows_ = m ;
+/*
+  COLUMNS. Parse the blocks, then stitch them together. A block whose first
+  column has the same name as the last column of the previous nonempty
+  block continues that column.
+*/
+  std::vector<ColumnBlock> colBlocks ;
+  if (sections[SecColumns].present_) {
+    bounds = splitLines(sections[SecColumns].begin_,
+			sections[SecColumns].end_,numThreads_,minBlockSize_) ;
+    numBlocks = static_cast<int>(bounds.size())-1 ;
+    colBlocks.resize(numBlocks) ;
+    runTasks(numBlocks,[&] (int k) {
+      parseColumns(bounds[k],bounds[k+1],rowMap,colBlocks[k]) ;
+    }) ;
+  }
+  numBlocks = static_cast<int>(colBlocks.size()) ;
+  std::vector<int> firstCol(numBlocks) ;
+  std::vector<int> continues(numBlocks,0) ;
+  std::vector<CoinBigIndex> elemOffset(numBlocks+1,0) ;
+  int n = 0 ;
+  const Name *lastName = nullptr ;
+  for (int k = 0 ; k < numBlocks ; k++) {
+    const ColumnBlock &blk = colBlocks[k] ;
+    log.append(blk.log_) ;
+    elemOffset[k+1] =
+	elemOffset[k]+static_cast<CoinBigIndex>(blk.indices_.size()) ;
+    if (blk.names_.empty()) {
+      firstCol[k] = n ;
+      continue ;
+    }
+    if (lastName != nullptr && *lastName == blk.names_[0]) continues[k] = 1 ;
+    firstCol[k] = n-continues[k] ;
+    n += static_cast<int>(blk.names_.size())-continues[k] ;
+    lastName = &blk.names_.back() ;
+  }
+  numCols_ = n ;
+  CoinBigIndex nnz = elemOffset[numBlocks] ;
+  starts_.reset(new CoinBigIndex[n+1]) ;
+  indices_.reset(new int[nnz]) ;
+  elements_.reset(new double[nnz]) ;
+  obj_.reset(new double[n]) ;
+  std::fill(obj_.get(),obj_.get()+n,0.0) ;
+  integer_.assign(n,0) ;
+  NameMap colMap ;
+  colMap.reserve(n) ;
+  char intState = 0 ;
+  for (int k = 0 ; k < numBlocks ; k++) {
+    const ColumnBlock &blk = colBlocks[k] ;
+    for (int c = continues[k] ; c < static_cast<int>(blk.names_.size()) ;
+	 c++) {
+      int j = firstCol[k]+c ;
+      starts_[j] = elemOffset[k]+blk.starts_[c] ;
+      integer_[j] = (blk.intState_[c] == inherit)?intState:blk.intState_[c] ;
+      if (!colMap.insert(std::make_pair(blk.names_[c],j)).second)
+	log.add("COLUMNS: column appears more than once",blk.names_[c]) ;
+      if (lazy != nullptr)
+	lazy->add(false,blk.names_[c].ptr_,blk.names_[c].len_) ;
+      else if (keepNames)
+	addName(blk.names_[c],colNames_,colNameOffsets_) ;
+    }
+    if (blk.endState_ != inherit) intState = blk.endState_ ;
+    for (size_t ndx = 0 ; ndx < blk.obj_.size() ; ndx++)
+      obj_[firstCol[k]+blk.obj_[ndx].first] = blk.obj_[ndx].second ;
+  }
+  starts_[n] = nnz ;
+  runTasks(numBlocks,[&] (int k) {
+    const ColumnBlock &blk = colBlocks[k] ;
+    std::copy(blk.indices_.begin(),blk.indices_.end(),
+	      indices_.get()+elemOffset[k]) ;
+    std::copy(blk.elements_.begin(),blk.elements_.end(),
+	      elements_.get()+elemOffset[k]) ;
+  }) ;
+  colBlocks.clear() ;
+/*
+  RHS and RANGES. The set name, if any, comes from the first line. An RHS
+  entry for the objective row is the objective offset.
+*/
+  std::vector<double> rhs(m,0.0) ;
+  std::vector<double> range(m,0.0) ;
+  std::vector<char> hasRange(m,0) ;
+  for (int sec = SecRhs ; sec <= SecRanges ; sec++) {
+    if (!sections[sec].present_) continue ;
+    firstLine(sections[sec].begin_,sections[sec].end_,toks,cnt) ;
+    Name setName = { nullptr, 0 } ;
+    if (cnt%2 == 1) setName = toks[0] ;
+    bounds = splitLines(sections[sec].begin_,sections[sec].end_,
+			numThreads_,minBlockSize_) ;
+    numBlocks = static_cast<int>(bounds.size())-1 ;
+    std::vector<PairBlock> blocks(numBlocks) ;
+    runTasks(numBlocks,[&] (int k) {
+      parsePairs(bounds[k],bounds[k+1],rowMap,setName,
+		 sectionNames[sec],blocks[k]) ;
+    }) ;
+    for (int k = 0 ; k < numBlocks ; k++) {
+      log.append(blocks[k].log_) ;
+      const std::vector<std::pair<int,double> > &entries =
+	  blocks[k].entries_ ;
+      for (size_t ndx = 0 ; ndx < entries.size() ; ndx++) {
+	int i = entries[ndx].first ;
+	double value = clampInfinity(entries[ndx].second) ;
+	if (sec == SecRhs) {
+	  if (i == objRow)
+	    objOffset_ = value ;
+	  else
+	    rhs[i] = value ;
+	} else if (i != objRow) {
+	  range[i] = value ;
+	  hasRange[i] = 1 ;
+	}
+      }
+    }
+  }
+/*
+  Row bounds from type, right-hand side, and range.
+*/
+  rowLower_.reset(new double[m]) ;
+  rowUpper_.reset(new double[m]) ;
+  for (int i = 0 ; i < m ; i++) {
+    double lo = -infinity ;
+    double up = infinity ;
+    double r = std::fabs(range[i]) ;
+    switch (rowTypes[i]) {
+      case 'E': {
+	lo = rhs[i] ;
+	up = rhs[i] ;
+	if (hasRange[i] && range[i] > 0.0) up = rhs[i]+r ;
+	if (hasRange[i] && range[i] < 0.0) lo = rhs[i]-r ;
+	break ;
+      }
+      case 'L': {
+	up = rhs[i] ;
+	if (hasRange[i]) lo = rhs[i]-r ;
+	break ;
+      }
+      case 'G': {
+	lo = rhs[i] ;
+	if (hasRange[i]) up = rhs[i]+r ;
+	break ;
+      }
+    }
+    rowLower_[i] = lo ;
+    rowUpper_[i] = up ;
+  }
+/*
+  BOUNDS. Columns default to [0,+inf). An upper bound less than zero on a
+  column whose lower bound is zero makes the lower bound -inf. Integer
+  columns untouched by the BOUNDS section are binary.
+*/
+  colLower_.reset(new double[n]) ;
+  colUpper_.reset(new double[n]) ;
+  std::fill(colLower_.get(),colLower_.get()+n,0.0) ;
+  std::fill(colUpper_.get(),colUpper_.get()+n,infinity) ;
+  std::vector<char> bounded(n,0) ;
+  if (sections[SecBounds].present_) {
+    firstLine(sections[SecBounds].begin_,sections[SecBounds].end_,toks,cnt) ;
+    Name setName = { nullptr, 0 } ;
+    const Name *set, *col, *value ;
+    if (boundLayout(toks,cnt,colMap,set,col,value) >= 0 && set != nullptr)
+      setName = *set ;
+    bounds = splitLines(sections[SecBounds].begin_,sections[SecBounds].end_,
+			numThreads_,minBlockSize_) ;
+    numBlocks = static_cast<int>(bounds.size())-1 ;
+    std::vector<BoundBlock> blocks(numBlocks) ;
+    runTasks(numBlocks,[&] (int k) {
+      parseBounds(bounds[k],bounds[k+1],colMap,setName,blocks[k]) ;
+    }) ;
+    for (int k = 0 ; k < numBlocks ; k++) {
+      log.append(blocks[k].log_) ;
+      for (size_t ndx = 0 ; ndx < blocks[k].bounds_.size() ; ndx++) {
+	const Bound &bnd = blocks[k].bounds_[ndx] ;
+	int j = bnd.col_ ;
+	double v = bnd.value_ ;
+	bounded[j] = 1 ;
+	switch (bnd.type_) {
+	  case BndUP:
+	  case BndUI: {
+	    if (v < 0.0 && colLower_[j] == 0.0) colLower_[j] = -infinity ;
+	    colUpper_[j] = v ;
+	    break ;
+	  }
+	  case BndLO:
+	  case BndLI: {
+	    colLower_[j] = v ;
+	    break ;
+	  }
+	  case BndFX: {
+	    colLower_[j] = v ;
+	    colUpper_[j] = v ;
+	    break ;
+	  }
+	  case BndFR: {
+	    colLower_[j] = -infinity ;
+	    colUpper_[j] = infinity ;
+	    break ;
+	  }
+	  case BndMI: {
+	    colLower_[j] = -infinity ;
+	    break ;
+	  }
+	  case BndPL: {
+	    colUpper_[j] = infinity ;
+	    break ;
+	  }
+	  case BndBV: {
+	    colLower_[j] = 0.0 ;
+	    colUpper_[j] = 1.0 ;
+	    break ;
+	  }
+	}
+	if (bnd.type_ == BndBV || bnd.type_ == BndLI || bnd.type_ == BndUI)
+	  integer_[j] = 1 ;
+      }
+    }
+  }
+  for (int j = 0 ; j < n ; j++) {
+    if (integer_[j] && !bounded[j]) colUpper_[j] = 1.0 ;
+  }
+/*
+  Row names must be copied out before the file image goes away; column
+  names were copied as the columns were numbered.
+*/
+  for (size_t ndx = 0 ; ndx < rowNameRefs.size() ; ndx++)
+    addName(rowNameRefs[ndx],rowNames_,rowNameOffsets_) ;
+
+  numErrors_ = log.count_ ;
+  errors_.swap(log.msgs_) ;
+  return (numErrors_) ;
+}
+
+std::string MpsReader::rowName (int i) const
+{
+  if (mappedNames_) return (mappedNames_->name(true,i)) ;
+  if (i < 0 || i >= static_cast<int>(rowNameOffsets_.size()))
+    return (std::string()) ;
+  return (std::string(&rowNames_[rowNameOffsets_[i]])) ;
+}
+
+std::string MpsReader::columnName (int j) const
+{
+  if (mappedNames_) return (mappedNames_->name(false,j)) ;
+  if (j < 0 || j >= static_cast<int>(colNameOffsets_.size()))
+    return (std::string()) ;
+  return (std::string(&colNames_[colNameOffsets_[j]])) ;
+}
+
+std::unique_ptr<MappedNames> MpsReader::releaseNames ()
+{
+  return (std::move(mappedNames_)) ;
+}
+
+/*
+  Integer information and names are installed only if there are any. Lazy
+  names are decoded here, since the solver wants them in an arena.
+*/
+void MpsReader::loadInto (ClpSimplexAPI &solver) const
+{
+  solver.loadProblem(numCols_,numRows_,
+		     starts_.get(),indices_.get(),elements_.get(),
+		     colLower_.get(),colUpper_.get(),obj_.get(),
+		     rowLower_.get(),rowUpper_.get()) ;
+  solver.setObjSense(objSense_) ;
+  solver.setObjectiveOffset(objOffset_) ;
+  solver.setProblemName(probName_) ;
+  if (std::find(integer_.begin(),integer_.end(),1) != integer_.end())
+    solver.copyInIntegerInformation(integer_.data()) ;
+  if (mappedNames_) {
+    std::vector<char> arena ;
+    std::vector<int> offsets ;
+    if (numRows_ > 0 && mappedNames_->count(true) > 0) {
+      mappedNames_->names(true,0,numRows_,arena,offsets) ;
+      solver.setRowNames(0,numRows_,arena.data(),offsets.data()) ;
+    }
+    if (numCols_ > 0 && mappedNames_->count(false) > 0) {
+      mappedNames_->names(false,0,numCols_,arena,offsets) ;
+      solver.setColumnNames(0,numCols_,arena.data(),offsets.data()) ;
+    }
+    return ;
+  }
+  if (numRows_ > 0 && !rowNameOffsets_.empty())
+    solver.setRowNames(0,numRows_,rowNames_.data(),rowNameOffsets_.data()) ;
+  if (numCols_ > 0 && !colNameOffsets_.empty())
+    solver.setColumnNames(0,numCols_,
+			  colNames_.data(),colNameOffsets_.data()) ;
+}
+
+void MpsReader::loadInto (Osi1API &solver) const
+{
+  solver.loadProblem(numCols_,numRows_,
+		     starts_.get(),indices_.get(),elements_.get(),
+		     colLower_.get(),colUpper_.get(),obj_.get(),
+		     rowLower_.get(),rowUpper_.get()) ;
+  solver.setObjSense(objSense_) ;
+  solver.setDblParam(OsiObjOffset,objOffset_) ;
+  solver.setStrParam(OsiProbName,probName_) ;
+  std::vector<int> intCols ;
+  for (int j = 0 ; j < numCols_ ; j++)
+    if (integer_[j]) intCols.push_back(j) ;
+  if (!intCols.empty())
+    solver.setInteger(intCols.data(),static_cast<int>(intCols.size())) ;
+  bool lazy = (mappedNames_ != nullptr) ;
+  if (!rowNameOffsets_.empty() || (lazy && mappedNames_->count(true) > 0)) {
+    Osi1API::OsiNameVec names(numRows_) ;
+    for (int i = 0 ; i < numRows_ ; i++) names[i] = rowName(i) ;
+    solver.setRowNames(names,0,numRows_,0) ;
+  }
+  if (!colNameOffsets_.empty() || (lazy && mappedNames_->count(false) > 0)) {
+    Osi1API::OsiNameVec names(numCols_) ;
+    for (int j = 0 ; j < numCols_ ; j++) names[j] = columnName(j) ;
+    solver.setColNames(names,0,numCols_,0) ;
+  }
+}
+
+void MpsReader::assignTo (ProbMgmtAPI &solver)
+{
+  CoinBigIndex *start = starts_.release() ;
+  int *index = indices_.release() ;
+  double *value = elements_.release() ;
+  double *collb = colLower_.release() ;
+  double *colub = colUpper_.release() ;
+  double *obj = obj_.release() ;
+  double *rowlb = rowLower_.release() ;
+  double *rowub = rowUpper_.release() ;
+  solver.assignProblem(numCols_,numRows_,start,index,value,
+		       collb,colub,obj,rowlb,rowub) ;
+  clear() ;
+}
+
+void MpsReader::clear ()
+{
+  numErrors_ = 0 ;
+  errors_.clear() ;
+  probName_.clear() ;
+  numCols_ = 0 ;
+  numRows_ = 0 ;
+  starts_.reset() ;
+  indices_.reset() ;
+  elements_.reset() ;
+  colLower_.reset() ;
+  colUpper_.reset() ;
+  obj_.reset() ;
+  rowLower_.reset() ;
+  rowUpper_.reset() ;
+  integer_.clear() ;
+  objSense_ = 1.0 ;
+  objOffset_ = 0.0 ;
+  rowNames_.clear() ;
+  rowNameOffsets_.clear() ;
+  colNames_.clear() ;
+  colNameOffsets_.clear() ;
+  mappedNames_.reset() ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+MpsReader::MpsReader (int numThreads)
+  : numThreads_(numThreads),
+    minBlockSize_(dfltMinBlockSize)
+{
+  if (numThreads_ < 1) {
+    numThreads_ = static_cast<int>(std::thread::hardware_concurrency()) ;
+    if (numThreads_ < 1) numThreads_ = 1 ;
+  }
+  clear() ;
+}
+
+MpsReader::~MpsReader () { }
+
+} // namespace Osi2
@@ -0,0 +1,204 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2MpsReader.hpp
+
+  Defines MpsReader, a native reader for MPS files that builds the problem
+  directly in column-major form.
+*/
+
+#ifndef Osi2MpsReader_HPP
+#define Osi2MpsReader_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2Osi1API.hpp"
+#include "Osi2ProbMgmtAPI.hpp"
+
+namespace Osi2 {
+
+class MappedNames ;
+
+/*! \brief A parallel reader for MPS files
+
+  The file is mapped into memory and parsed in place; a compressed file
+  (see StreamCodec) is first decompressed into memory. The ROWS section is
+  read by a single thread to build the index of row names. The COLUMNS,
+  RHS, RANGES, and BOUNDS sections are cut into blocks of whole lines and
+  the blocks are parsed concurrently, then stitched together in file order.
+  Numbers with at most 19 significant digits and a modest exponent are
+  converted exactly without calling strtod.
+
+  The result is the constraint matrix in column-major form without gaps,
+  with bounds, objective, objective sense and offset, and integer
+  information, held in arrays that go straight to loadProblem. The same
+  arrays are loaded into each of the problem APIs, so a file reads the same
+  way whatever the backend.
+
+  Free and fixed format files are accepted, provided names do not contain
+  blanks. As with CoinMpsIO, only the first objective (N) row and the first
+  RHS, RANGES, and BOUNDS sets are used. Integer columns declared by MARKER
+  lines for which the BOUNDS section says nothing get an upper bound of 1.
+  Quadratic, SOS, and other extended sections are reported as errors.
+*/
+class MpsReader {
+
+public:
+
+  /*! \brief Constructor
+
+    \p numThreads is the number of threads used to parse each section; zero
+    means one per hardware thread.
+  */
+  MpsReader(int numThreads = 0) ;
+  /// Destructor
+  ~MpsReader() ;
+
+  /*! \brief Set the smallest block, in bytes, worth a thread of its own
+
+    The default, 1MB, leaves most small files in a single block. A small
+    value makes even a small file split into one block per thread, which
+    is mainly useful to test the stitching of blocks. Values less than 1
+    are taken as 1.
+  */
+  void setMinBlockSize(size_t bytes)
+  { minBlockSize_ = (bytes < 1)?1:bytes ; }
+
+  /*! \brief Read a problem from an MPS file
+
+    Returns -1 if the file can't be opened, otherwise the number of errors
+    found. Lines in error are skipped and the rest of the problem is kept.
+    Names are retained only if \p keepNames is true.
+
+    If \p lazyNames is also true, names are not copied out of the file.
+    The file stays open and only the position of each name is recorded
+    (see MappedNames); a name is decoded when it's asked for. The names can
+    be handed on to a solver with #releaseNames.
+  */
+  int readMps(const char *filename, bool keepNames = false,
+	      bool lazyNames = false) ;
+
+  /// Messages for the first errors found by the last call to #readMps
+  const std::vector<std::string> &getErrors() const { return (errors_) ; }
+
+  /*! \name Problem access */
+  //@{
+  /// Problem name from the NAME line
+  const std::string &getProblemName() const { return (probName_) ; }
+  /// Number of columns
+  int getNumCols() const { return (numCols_) ; }
+  /// Number of rows, not counting the objective
+  int getNumRows() const { return (numRows_) ; }
+  /// Number of coefficients in the constraint matrix
+  CoinBigIndex getNumElements() const
+  { return ((starts_) ? starts_[numCols_] : 0) ; }
+  /// Column starts (numCols+1 entries)
+  const CoinBigIndex *getColStarts() const { return (starts_.get()) ; }
+  /// Row indices of coefficients
+  const int *getIndices() const { return (indices_.get()) ; }
+  /// Coefficients
+  const double *getElements() const { return (elements_.get()) ; }
+  /// Column lower bounds
+  const double *getColLower() const { return (colLower_.get()) ; }
+  /// Column upper bounds
+  const double *getColUpper() const { return (colUpper_.get()) ; }
+  /// Objective coefficients
+  const double *getObjective() const { return (obj_.get()) ; }
+  /// Row lower bounds
+  const double *getRowLower() const { return (rowLower_.get()) ; }
+  /// Row upper bounds
+  const double *getRowUpper() const { return (rowUpper_.get()) ; }
+  /// Integer information: 1 for integer, 0 for continuous
+  const char *getIntegerInformation() const { return (integer_.data()) ; }
+  /// Objective sense: 1 to minimise, -1 to maximise
+  double getObjSense() const { return (objSense_) ; }
+  /// Objective offset (the RHS entry for the objective row)
+  double getObjOffset() const { return (objOffset_) ; }
+  /// Name of row i; empty if names were not kept
+  std::string rowName(int i) const ;
+  /// Name of column j; empty if names were not kept
+  std::string columnName(int j) const ;
+  /*! \brief Hand over the names kept by a lazy read
+
+    Returns null if the last read did not keep lazy names. The reader has
+    no names afterwards.
+  */
+  std::unique_ptr<MappedNames> releaseNames() ;
+  //@}
+
+  /*! \name Loading the problem into a solver */
+  //@{
+  /// Load the problem into \p solver, with integer information and names
+  void loadInto(ClpSimplexAPI &solver) const ;
+  /// Load the problem into \p solver, with integer information and names
+  void loadInto(Osi1API &solver) const ;
+  /*! \brief Hand the problem over to \p solver
+
+    The arrays are given to ProbMgmtAPI::assignProblem without copying, so
+    the reader is empty afterwards. Objective sense and offset, integer
+    information, and names are not part of ProbMgmtAPI and are dropped.
+  */
+  void assignTo(ProbMgmtAPI &solver) ;
+  //@}
+
+private:
+
+  /// Drop the problem and error messages
+  void clear() ;
+
+  /// Number of threads used for each section
+  int numThreads_ ;
+  /// Smallest block worth a thread of its own
+  size_t minBlockSize_ ;
+
+  /// Number of errors found by the last read
+  int numErrors_ ;
+  /// Messages for the first of them
+  std::vector<std::string> errors_ ;
+
+  std::string probName_ ;
+  int numCols_ ;
+  int numRows_ ;
+  std::unique_ptr<CoinBigIndex[]> starts_ ;
+  std::unique_ptr<int[]> indices_ ;
+  std::unique_ptr<double[]> elements_ ;
+  std::unique_ptr<double[]> colLower_ ;
+  std::unique_ptr<double[]> colUpper_ ;
+  std::unique_ptr<double[]> obj_ ;
+  std::unique_ptr<double[]> rowLower_ ;
+  std::unique_ptr<double[]> rowUpper_ ;
+  std::vector<char> integer_ ;
+  double objSense_ ;
+  double objOffset_ ;
+
+  /*! \brief Names, if kept
+
+    The name of row i is the null-terminated string starting at
+    rowNames_[rowNameOffsets_[i]], and similarly for columns. This is the
+    layout used by ClpSimplexAPI::setRowNames.
+  */
+  std::vector<char> rowNames_ ;
+  std::vector<int> rowNameOffsets_ ;
+  std::vector<char> colNames_ ;
+  std::vector<int> colNameOffsets_ ;
+  /// Names, if kept lazily
+  std::unique_ptr<MappedNames> mappedNames_ ;
+
+  /// Copying is not supported
+  MpsReader(const MpsReader &) ;
+  MpsReader &operator=(const MpsReader &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -0,0 +1,214 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for NameIndex.
+*/
+
+#include "Osi2Config.h"
+
+#include <cstring>
+#include <string>
+
+#include "Osi2NameIndex.hpp"
+
+namespace {
+
+/*
+  The hash table never has fewer slots than this, and is kept at most half
+  full.
+*/
+const size_t minSlots = 16 ;
+
+/*
+  FNV-1a over the characters of the name.
+*/
+inline uint32_t hashName (const char *name)
+{
+  uint32_t hash = 2166136261u ;
+  for ( ; *name != '\0' ; name++) {
+    hash ^= static_cast<unsigned char>(*name) ;
+    hash *= 16777619u ;
+  }
+  return (hash) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+int NameIndex::find (const char *name) const
+{
+  if (name == nullptr || *name == '\0') return (-1) ;
+  uint32_t hash = hashName(name) ;
+  size_t mask = slots_.size()-1 ;
+  int best = -1 ;
+  for (size_t pos = hash&mask ; slots_[pos].ndx_ >= 0 ; pos = (pos+1)&mask) {
+    const Slot &slot = slots_[pos] ;
+    if (slot.hash_ == hash && (best < 0 || slot.ndx_ < best) &&
+	std::strcmp(&arena_[offsets_[slot.ndx_]],name) == 0)
+      best = slot.ndx_ ;
+  }
+  return (best) ;
+}
+
+void NameIndex::append (const char *name)
+{
+  offsets_.push_back(-1) ;
+  set(size()-1,name) ;
+}
+
+/*
+  The old name stays in the arena as garbage until there's enough of it to
+  be worth a compaction. The new name may itself point into the arena (the
+  caller passed back what #name returned), and the insertion below may
+  reallocate the arena or compact it, so take a copy first.
+*/
+void NameIndex::set (int ndx, const char *name)
+{
+  std::string copy((name)?name:"") ;
+  if (offsets_[ndx] >= 0) {
+    remove(ndx) ;
+    garbage_ += std::strlen(&arena_[offsets_[ndx]])+1 ;
+    offsets_[ndx] = -1 ;
+    numNamed_-- ;
+  }
+  if (!copy.empty()) {
+    offsets_[ndx] = static_cast<int>(arena_.size()) ;
+    arena_.insert(arena_.end(),copy.c_str(),copy.c_str()+copy.size()+1) ;
+    numNamed_++ ;
+    if (2*numNamed_ > slots_.size()) rehash(2*slots_.size()) ;
+    insert(ndx,hashName(copy.c_str())) ;
+  }
+  if (garbage_ > arena_.size()/2) compact() ;
+}
+
+/*
+  Every entry after the first one erased changes its index, so the hash
+  table is rebuilt from the old one with the new indices. The stored hashes
+  spare hashing the names again.
+*/
+void NameIndex::erase (int num, const int *which)
+{
+  int n = size() ;
+  std::vector<int> newNdx(n,0) ;
+  int erased = 0 ;
+  for (int k = 0 ; k < num ; k++) {
+    int ndx = which[k] ;
+    if (ndx < 0 || ndx >= n || newNdx[ndx] < 0) continue ;
+    newNdx[ndx] = -1 ;
+    erased++ ;
+  }
+  if (erased == 0) return ;
+  int next = 0 ;
+  for (int ndx = 0 ; ndx < n ; ndx++) {
+    if (newNdx[ndx] < 0) {
+      if (offsets_[ndx] >= 0) {
+	garbage_ += std::strlen(&arena_[offsets_[ndx]])+1 ;
+	numNamed_-- ;
+      }
+    } else {
+      newNdx[ndx] = next ;
+      offsets_[next++] = offsets_[ndx] ;
+    }
+  }
+  offsets_.resize(next) ;
+
+  std::vector<Slot> old ;
+  old.swap(slots_) ;
+  size_t numSlots = minSlots ;
+  while (2*numNamed_ > numSlots) numSlots *= 2 ;
+  Slot unused = { -1, 0 } ;
+  slots_.assign(numSlots,unused) ;
+  for (size_t pos = 0 ; pos < old.size() ; pos++) {
+    if (old[pos].ndx_ >= 0 && newNdx[old[pos].ndx_] >= 0)
+      insert(newNdx[old[pos].ndx_],old[pos].hash_) ;
+  }
+  if (garbage_ > arena_.size()/2) compact() ;
+}
+
+void NameIndex::clear ()
+{
+  std::vector<char>().swap(arena_) ;
+  std::vector<int>().swap(offsets_) ;
+  garbage_ = 0 ;
+  numNamed_ = 0 ;
+  Slot unused = { -1, 0 } ;
+  std::vector<Slot>(minSlots,unused).swap(slots_) ;
+}
+
+/*
+  Linear probing. Duplicate names each get a slot; #find sorts them out.
+*/
+void NameIndex::insert (int ndx, uint32_t hash)
+{
+  size_t mask = slots_.size()-1 ;
+  size_t pos = hash&mask ;
+  while (slots_[pos].ndx_ >= 0) pos = (pos+1)&mask ;
+  slots_[pos].ndx_ = ndx ;
+  slots_[pos].hash_ = hash ;
+}
+
+/*
+  Deletion without tombstones: after the slot is freed, each later entry of
+  the cluster whose home slot doesn't lie between the hole and its own
+  position moves back into the hole, which moves on to where it was.
+*/
+void NameIndex::remove (int ndx)
+{
+  size_t mask = slots_.size()-1 ;
+  size_t hole = hashName(&arena_[offsets_[ndx]])&mask ;
+  while (slots_[hole].ndx_ != ndx) hole = (hole+1)&mask ;
+  for (size_t pos = (hole+1)&mask ; slots_[pos].ndx_ >= 0 ;
+       pos = (pos+1)&mask) {
+    size_t home = slots_[pos].hash_&mask ;
+    bool stays = (hole < pos)?(hole < home && home <= pos):
+			      (hole < home || home <= pos) ;
+    if (stays) continue ;
+    slots_[hole] = slots_[pos] ;
+    hole = pos ;
+  }
+  slots_[hole].ndx_ = -1 ;
+}
+
+void NameIndex::rehash (size_t numSlots)
+{
+  std::vector<Slot> old ;
+  old.swap(slots_) ;
+  Slot unused = { -1, 0 } ;
+  slots_.assign(numSlots,unused) ;
+  for (size_t pos = 0 ; pos < old.size() ; pos++) {
+    if (old[pos].ndx_ >= 0) insert(old[pos].ndx_,old[pos].hash_) ;
+  }
+}
+
+void NameIndex::compact ()
+{
+  std::vector<char> fresh ;
+  fresh.reserve(arena_.size()-garbage_) ;
+  for (size_t ndx = 0 ; ndx < offsets_.size() ; ndx++) {
+    if (offsets_[ndx] < 0) continue ;
+    const char *name = &arena_[offsets_[ndx]] ;
+    offsets_[ndx] = static_cast<int>(fresh.size()) ;
+    fresh.insert(fresh.end(),name,name+std::strlen(name)+1) ;
+  }
+  arena_.swap(fresh) ;
+  garbage_ = 0 ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+NameIndex::NameIndex ()
+{
+  clear() ;
+}
+
+NameIndex::~NameIndex ()
+{ }
+
+} // namespace Osi2
@@ -0,0 +1,104 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2NameIndex.hpp
+
+  Defines NameIndex, a table of row or column names that answers lookups
+  by name.
+*/
+
+#ifndef Osi2NameIndex_HPP
+#define Osi2NameIndex_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Osi2 {
+
+/*! \brief Names of a sequence of rows or columns, with lookup by name
+
+  Entry k of the table is the name of row or column k. The names are held
+  one after another in a single arena, and a hash table with open
+  addressing maps each name to its entry; each slot holds an index and the
+  hash of the name, so the table can be grown or rebuilt without hashing
+  the names again. The whole index costs a few bytes per entry beyond the
+  characters of the names.
+
+  Entries can be appended, renamed, and erased, which renumbers the
+  entries that follow as a solver does when rows or columns are deleted.
+  The space of names that are replaced or erased is reclaimed once it
+  exceeds the space in use. An empty name (or null) marks an unnamed entry;
+  unnamed entries are not found by #find.
+*/
+class NameIndex {
+
+public:
+
+  /// Constructor
+  NameIndex() ;
+  /// Destructor
+  ~NameIndex() ;
+
+  /// Number of entries
+  int size() const { return (static_cast<int>(offsets_.size())) ; }
+  /// Name of entry \p ndx; empty if the entry is unnamed
+  const char *name(int ndx) const
+  { return ((offsets_[ndx] < 0)?"":&arena_[offsets_[ndx]]) ; }
+
+  /*! \brief Index of the entry named \p name, or -1 if there is none
+
+    If several entries have the name, the lowest index is returned.
+  */
+  int find(const char *name) const ;
+
+  /// Add an entry at the end
+  void append(const char *name) ;
+  /// Rename entry \p ndx; \p name may come from #name
+  void set(int ndx, const char *name) ;
+  /*! \brief Erase \p num entries
+
+    The entries listed in \p which are removed and the remaining entries
+    move down to close the gaps. Indices out of range are ignored, as are
+    repeats.
+  */
+  void erase(int num, const int *which) ;
+  /// Remove all entries
+  void clear() ;
+
+private:
+
+  /// A slot of the hash table: entry index (-1 if free) and name hash
+  struct Slot {
+    int ndx_ ;
+    uint32_t hash_ ;
+  } ;
+
+  /// Put entry \p ndx, whose name has hash \p hash, in the hash table
+  void insert(int ndx, uint32_t hash) ;
+  /// Take entry \p ndx out of the hash table
+  void remove(int ndx) ;
+  /// Rebuild the hash table with \p numSlots slots (a power of two)
+  void rehash(size_t numSlots) ;
+  /// Copy the names in use to a fresh arena
+  void compact() ;
+
+  /// Names, each null-terminated
+  std::vector<char> arena_ ;
+  /// Start of the name of each entry in #arena_; -1 if unnamed
+  std::vector<int> offsets_ ;
+  /// Bytes of #arena_ no longer in use
+  size_t garbage_ ;
+  /// Number of named entries
+  size_t numNamed_ ;
+  /// The hash table
+  std::vector<Slot> slots_ ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
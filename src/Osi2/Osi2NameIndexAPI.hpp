@@ -0,0 +1,59 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+#ifndef Osi2NameIndexAPI_HPP
+# define Osi2NameIndexAPI_HPP
+
+/*! \file Osi2NameIndexAPI.hpp
+
+  Provides an %API to find a row or column from its name.
+*/
+
+#include "Osi2API.hpp"
+
+namespace Osi2 {
+
+/*! \brief Look up rows and columns by name
+
+  A NameIndex object is obtained from a solver object with
+  <code>getAPIPtr(NameIndexAPI::getAPIIDString())</code> and answers for
+  that solver's problem. The index is built from the solver's names at the
+  first lookup and kept up to date as names are set, rows and columns are
+  added or deleted, and problems are loaded through the solver object's
+  own methods, so a lookup costs about the same on a large problem as on a
+  small one. A change made some other way (directly to the underlying
+  solver, say) calls for #invalidate.
+
+  Lookups may update the index, so an index must not be used from several
+  threads at once, any more than its solver.
+*/
+class NameIndexAPI : public API {
+
+public:
+
+  /// Return the "ident" string for the NameIndex %API
+  inline static const char *getAPIIDString () { return ("NameIndex") ; }
+
+  /// Virtual destructor
+  virtual ~NameIndexAPI() { }
+
+  /*! \brief Index of the row named \p name, or -1 if there is none
+
+    If several rows have the name, the lowest index is returned.
+  */
+  virtual int rowIndex(const char *name) = 0 ;
+
+  /// Index of the column named \p name, as #rowIndex
+  virtual int columnIndex(const char *name) = 0 ;
+
+  /// Discard the index; it is built again at the next lookup
+  virtual void invalidate() = 0 ;
+
+} ;
+
+}  // end namespace Osi2
+
+#endif
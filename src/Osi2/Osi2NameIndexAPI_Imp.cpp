@@ -0,0 +1,118 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for NameIndexAPI_Imp.
+*/
+
+#include "Osi2Config.h"
+
+#include <algorithm>
+
+#include "Osi2NameIndexAPI_Imp.hpp"
+
+namespace {
+
+/*
+  Names are read from the source this many at a time, to bound the size of
+  the transfer arena.
+*/
+const int fetchBlock = 1<<16 ;
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+/*
+  Bring the index up to date with the number of rows or columns, then look
+  up the name.
+*/
+int NameIndexAPI_Imp::lookup (bool rows, const char *name)
+{
+  NameIndex &names = names_[rows] ;
+  int count = source_->nameCount(rows) ;
+  if (!built_[rows] || count < names.size()) {
+    names.clear() ;
+    built_[rows] = true ;
+  }
+  if (names.size() < count) fetch(rows,names.size(),count) ;
+  return (names.find(name)) ;
+}
+
+void NameIndexAPI_Imp::invalidate ()
+{
+  for (int which = 0 ; which < 2 ; which++) {
+    names_[which].clear() ;
+    built_[which] = false ;
+  }
+}
+
+void NameIndexAPI_Imp::namesChanged (bool rows, int first, int last)
+{
+  if (!built_[rows]) return ;
+  first = std::max(first,0) ;
+  last = std::min(last,names_[rows].size()) ;
+  if (first < last) fetch(rows,first,last) ;
+}
+
+void NameIndexAPI_Imp::namesDeleted (bool rows, int num, const int *which)
+{
+  if (!built_[rows]) return ;
+  names_[rows].erase(num,which) ;
+}
+
+void NameIndexAPI_Imp::rangeDeleted (bool rows, int first, int last)
+{
+  if (!built_[rows] || first >= last) return ;
+  std::vector<int> which ;
+  which.reserve(last-first) ;
+  for (int ndx = first ; ndx < last ; ndx++) which.push_back(ndx) ;
+  names_[rows].erase(static_cast<int>(which.size()),&which[0]) ;
+}
+
+/*
+  Entries already in the index are renamed; the rest are appended.
+*/
+void NameIndexAPI_Imp::fetch (bool rows, int first, int last)
+{
+  NameIndex &names = names_[rows] ;
+  std::vector<char> arena ;
+  std::vector<int> offsets ;
+  for (int blk = first ; blk < last ; ) {
+    int end = blk+std::min(fetchBlock,last-blk) ;
+    arena.clear() ;
+    offsets.clear() ;
+    source_->nameRange(rows,blk,end,arena,offsets) ;
+    for (int ndx = blk ; ndx < end ; ndx++) {
+      size_t k = ndx-blk ;
+      const char *name = nullptr ;
+      if (k < offsets.size() &&
+	  static_cast<size_t>(offsets[k]) < arena.size())
+	name = &arena[offsets[k]] ;
+      if (ndx < names.size())
+	names.set(ndx,name) ;
+      else
+	names.append(name) ;
+    }
+    blk = end ;
+  }
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+NameIndexAPI_Imp::NameIndexAPI_Imp (NameSource *source)
+  : source_(source)
+{
+  built_[0] = false ;
+  built_[1] = false ;
+}
+
+NameIndexAPI_Imp::~NameIndexAPI_Imp ()
+{ }
+
+}  // end namespace Osi2
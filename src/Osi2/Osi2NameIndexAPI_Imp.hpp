@@ -0,0 +1,106 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+#ifndef Osi2NameIndexAPI_Imp_HPP
+# define Osi2NameIndexAPI_Imp_HPP
+
+/*! \file Osi2NameIndexAPI_Imp.hpp
+
+  Provides a class to implement Osi2::NameIndexAPI.
+*/
+
+#include <vector>
+
+#include "Osi2NameIndexAPI.hpp"
+#include "Osi2NameIndex.hpp"
+
+namespace Osi2 {
+
+/*! \brief Implementation class for NameIndexAPI
+
+  The index is a member of the solver object it serves. It reads names
+  from the solver through the NameSource interface, which the solver
+  object implements, and holds a NameIndex each for rows and columns.
+
+  Nothing is read until the first lookup. At each lookup the number of
+  rows or columns is checked: names of rows or columns added since the
+  last lookup are read and appended, and if there are fewer than before
+  the index is built again. The solver object reports other changes with
+  #namesChanged, #namesDeleted, #rangeDeleted, and #invalidate; renaming
+  and deleting are applied to the index directly, without reading the
+  other names.
+*/
+class NameIndexAPI_Imp : public NameIndexAPI {
+
+public:
+
+  /// Where the names come from
+  class NameSource {
+  public:
+    virtual ~NameSource() { }
+    /// Number of rows if \p rows is true, else number of columns
+    virtual int nameCount(bool rows) = 0 ;
+    /*! \brief Names of rows or columns \p first to \p last-1
+
+      The layout is that of ClpSimplexAPI::rowNames. An empty name means
+      the row or column is unnamed.
+    */
+    virtual void nameRange(bool rows, int first, int last,
+			   std::vector<char> &arena,
+			   std::vector<int> &offsets) = 0 ;
+  } ;
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /// Constructor; names come from \p source
+  NameIndexAPI_Imp (NameSource *source) ;
+  /// Destructor
+  ~NameIndexAPI_Imp () ;
+  //@}
+
+  /*! \name Lookup */
+  //@{
+  int rowIndex(const char *name) { return (lookup(true,name)) ; }
+  int columnIndex(const char *name) { return (lookup(false,name)) ; }
+  void invalidate() ;
+  //@}
+
+  /*! \name Changes reported by the solver object
+
+    These do nothing to an index that hasn't been built yet.
+  */
+  //@{
+  /// Rows or columns \p first to \p last-1 have been renamed
+  void namesChanged(bool rows, int first, int last) ;
+  /// The \p num rows or columns listed in \p which have been deleted
+  void namesDeleted(bool rows, int num, const int *which) ;
+  /// Rows or columns \p first to \p last-1 have been deleted
+  void rangeDeleted(bool rows, int first, int last) ;
+  //@}
+
+private:
+
+  /// Bring the index up to date and look up \p name
+  int lookup(bool rows, const char *name) ;
+  /// Read names \p first to \p last-1 from the source into the index
+  void fetch(bool rows, int first, int last) ;
+
+  /// The source of names
+  NameSource *source_ ;
+  /// Column names (0) and row names (1)
+  NameIndex names_[2] ;
+  /// True once the column (0) or row (1) index has been built
+  bool built_[2] ;
+
+  /// Copying is not supported
+  NameIndexAPI_Imp(const NameIndexAPI_Imp &) ;
+  NameIndexAPI_Imp &operator=(const NameIndexAPI_Imp &) ;
+
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -0,0 +1,138 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for NumberParser.
+*/
+
+#include "Osi2Config.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "Osi2NumberParser.hpp"
+
+namespace {
+
+inline bool isDigit (char c)
+{ return (static_cast<unsigned>(c-'0') < 10) ; }
+
+/*
+  Anything that doesn't fit the fast path of toDouble ends up here. strtod
+  needs a terminated string; the text in a file image isn't.
+*/
+bool slowNumber (const char *begin, const char *end, double &value)
+{
+  char buf[64] ;
+  size_t len = end-begin ;
+  if (begin >= end || len >= sizeof(buf)) return (false) ;
+  std::memcpy(buf,begin,len) ;
+  buf[len] = '\0' ;
+  char *stop ;
+  value = std::strtod(buf,&stop) ;
+  return (stop == buf+len) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+/*
+  Up to 19 significant digits are accumulated in an integer. If that
+  integer is at most 2^53 and the decimal exponent is at most 22 in
+  magnitude, both are exact doubles and a single multiply or divide gives
+  the correctly rounded result.
+*/
+bool NumberParser::toDouble (const char *begin, const char *end,
+			     double &value)
+{
+  static const double powersOf10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  } ;
+  const char *p = begin ;
+  bool negative = false ;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-') ;
+    p++ ;
+  }
+  uint64_t mantissa = 0 ;
+  int digits = 0 ;
+  int exponent = 0 ;
+  bool seen = false ;
+  bool exact = true ;
+  for ( ; p < end && isDigit(*p) ; p++) {
+    seen = true ;
+    if (digits < 19) {
+      mantissa = 10*mantissa+(*p-'0') ;
+      if (mantissa != 0) digits++ ;
+    } else {
+      exponent++ ;
+      if (*p != '0') exact = false ;
+    }
+  }
+  if (p < end && *p == '.') {
+    for (p++ ; p < end && isDigit(*p) ; p++) {
+      seen = true ;
+      if (digits < 19) {
+	mantissa = 10*mantissa+(*p-'0') ;
+	if (mantissa != 0) digits++ ;
+	exponent-- ;
+      } else if (*p != '0') {
+	exact = false ;
+      }
+    }
+  }
+  if (!seen) return (slowNumber(begin,end,value)) ;
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    p++ ;
+    bool negExp = false ;
+    if (p < end && (*p == '-' || *p == '+')) {
+      negExp = (*p == '-') ;
+      p++ ;
+    }
+    if (p == end) return (false) ;
+    int expVal = 0 ;
+    for ( ; p < end && isDigit(*p) ; p++)
+      if (expVal < 10000) expVal = 10*expVal+(*p-'0') ;
+    exponent += (negExp)?-expVal:expVal ;
+  }
+  if (p != end) return (false) ;
+  if (!exact || mantissa > (static_cast<uint64_t>(1)<<53) ||
+      exponent < -22 || exponent > 22)
+    return (slowNumber(begin,end,value)) ;
+  double result = static_cast<double>(mantissa) ;
+  if (exponent < 0)
+    result /= powersOf10[-exponent] ;
+  else
+    result *= powersOf10[exponent] ;
+  value = (negative)?-result:result ;
+  return (true) ;
+}
+
+bool NumberParser::toInteger (const char *begin, const char *end,
+			      long long &value)
+{
+  const char *p = begin ;
+  bool negative = false ;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-') ;
+    p++ ;
+  }
+  if (p == end) return (false) ;
+  uint64_t result = 0 ;
+  for ( ; p < end ; p++) {
+    if (!isDigit(*p)) return (false) ;
+    result = 10*result+(*p-'0') ;
+    if (result > (static_cast<uint64_t>(1)<<62)) return (false) ;
+  }
+  value = (negative)?-static_cast<long long>(result):
+		     static_cast<long long>(result) ;
+  return (true) ;
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,53 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2NumberParser.hpp
+
+  Defines NumberParser, conversion of numbers in model files without a
+  terminating null.
+*/
+
+#ifndef Osi2NumberParser_HPP
+#define Osi2NumberParser_HPP
+
+namespace Osi2 {
+
+/*! \brief Conversion of numbers held in a file image
+
+  The text to convert is given as a range [begin,end) with no terminating
+  null and no surrounding blanks. The conversion must use the whole range.
+*/
+class NumberParser {
+
+public:
+
+  /*! \brief Convert a floating point number
+
+    Up to 19 significant digits with a decimal exponent of at most 22 in
+    magnitude are converted exactly without calling strtod; anything else
+    (more digits, large exponents, inf, nan) goes to strtod. Returns false
+    if the text is not a number.
+  */
+  static bool toDouble(const char *begin, const char *end, double &value) ;
+
+  /*! \brief Convert an integer
+
+    Returns false if the text is not an integer or it doesn't fit in a long
+    long.
+  */
+  static bool toInteger(const char *begin, const char *end,
+			long long &value) ;
+
+private:
+
+  /// Not to be instantiated
+  NumberParser() ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
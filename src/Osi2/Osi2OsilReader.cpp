@@ -0,0 +1,1085 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for OsilReader.
+*/
+
+#include "Osi2Config.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "Osi2NumberParser.hpp"
+#include "Osi2OsilReader.hpp"
+#include "Osi2StreamCodec.hpp"
+
+namespace {
+
+using Osi2::InputStream ;
+
+const double infinity = std::numeric_limits<double>::max() ;
+
+/*
+  Bytes read from the file at a time.
+*/
+const size_t chunkSize = 1<<18 ;
+
+/*
+  Error messages kept per read.
+*/
+const size_t maxMessages = 100 ;
+
+/*
+  A range of characters in the scanner's buffer. It is valid until the
+  scanner is next advanced.
+*/
+struct Text {
+  const char *ptr_ ;
+  const char *end_ ;
+
+  Text () : ptr_(nullptr), end_(nullptr) { }
+  bool is (const char *str) const
+  { size_t len = std::strlen(str) ;
+    return (static_cast<size_t>(end_-ptr_) == len &&
+	    std::memcmp(ptr_,str,len) == 0) ; }
+  bool empty () const { return (ptr_ == end_) ; }
+  std::string str () const { return (std::string(ptr_,end_)) ; }
+} ;
+
+inline bool isSpace (char c)
+{ return (c == ' ' || c == '\t' || c == '\n' || c == '\r') ; }
+
+Text trim (Text text)
+{
+  while (text.ptr_ < text.end_ && isSpace(*text.ptr_)) text.ptr_++ ;
+  while (text.end_ > text.ptr_ && isSpace(*(text.end_-1))) text.end_-- ;
+  return (text) ;
+}
+
+/*
+  Replace the predefined and numeric character entities. Only names and
+  the problem name need this; numbers never contain an ampersand.
+*/
+std::string unescape (const Text &text)
+{
+  std::string result ;
+  const char *p = text.ptr_ ;
+  while (p < text.end_) {
+    if (*p != '&') {
+      result += *p++ ;
+      continue ;
+    }
+    const char *semi = std::find(p,text.end_,';') ;
+    std::string ent(p+1,semi) ;
+    if (semi == text.end_) {
+      result.append(p,semi) ;
+    } else if (ent == "amp") {
+      result += '&' ;
+    } else if (ent == "lt") {
+      result += '<' ;
+    } else if (ent == "gt") {
+      result += '>' ;
+    } else if (ent == "quot") {
+      result += '"' ;
+    } else if (ent == "apos") {
+      result += '\'' ;
+    } else if (ent.size() > 1 && ent[0] == '#') {
+      long code = (ent[1] == 'x')?std::strtol(ent.c_str()+2,nullptr,16):
+				  std::strtol(ent.c_str()+1,nullptr,10) ;
+      if (code > 0 && code < 128) result += static_cast<char>(code) ;
+    } else {
+      result.append(p,semi+1) ;
+    }
+    p = (semi < text.end_)?semi+1:semi ;
+  }
+  return (result) ;
+}
+
+/*
+  A forward-only XML scanner over a stream read in chunks. Each call to next
+  moves to the next tag and makes available its name and attributes and the
+  text between it and the previous tag. Comments, processing instructions,
+  and declarations are passed over. The buffer holds only the current tag
+  and the text before it, growing only if a single tag is longer than a
+  chunk.
+*/
+class XmlScanner {
+
+public:
+
+  enum Kind { Start, Empty, End, Eof } ;
+
+  XmlScanner (InputStream &in)
+    : in_(in), buf_(2*chunkSize), pos_(0), len_(0)
+  { }
+
+  Kind next () ;
+  const Text &name () const { return (name_) ; }
+  const Text &text () const { return (text_) ; }
+  bool attr (const char *name, Text &value) const ;
+
+private:
+
+  bool more () ;
+  bool find (size_t &ndx, const char *pat) ;
+
+  InputStream &in_ ;
+  std::vector<char> buf_ ;
+  size_t pos_ ;
+  size_t len_ ;
+  Text name_ ;
+  Text attrs_ ;
+  Text text_ ;
+} ;
+
+/*
+  Read another chunk onto the end of the buffer, growing it if it's full.
+*/
+bool XmlScanner::more ()
+{
+  if (buf_.size()-len_ < chunkSize) buf_.resize(buf_.size()+2*chunkSize) ;
+  size_t got = in_.read(&buf_[len_],chunkSize) ;
+  len_ += got ;
+  return (got > 0) ;
+}
+
+/*
+  Advance ndx to the start of the next occurrence of pat, reading as
+  necessary. Returns false at end of file.
+*/
+bool XmlScanner::find (size_t &ndx, const char *pat)
+{
+  size_t patLen = std::strlen(pat) ;
+  while (true) {
+    while (ndx+patLen <= len_) {
+      const char *hit = static_cast<const char *>
+	  (std::memchr(&buf_[ndx],pat[0],len_-ndx-patLen+1)) ;
+      if (hit == nullptr) {
+	ndx = len_-patLen+1 ;
+	break ;
+      }
+      ndx = hit-&buf_[0] ;
+      if (std::memcmp(hit,pat,patLen) == 0) return (true) ;
+      ndx++ ;
+    }
+    if (!more()) return (false) ;
+  }
+}
+
+XmlScanner::Kind XmlScanner::next ()
+{
+/*
+  Everything before pos_ has been consumed. Slide the rest down once it is
+  worth the copy.
+*/
+  if (pos_ >= chunkSize) {
+    std::memmove(&buf_[0],&buf_[pos_],len_-pos_) ;
+    len_ -= pos_ ;
+    pos_ = 0 ;
+  }
+  size_t textStart = pos_ ;
+  size_t lt = pos_ ;
+  size_t gt ;
+  while (true) {
+    if (!find(lt,"<")) {
+      pos_ = len_ ;
+      return (Eof) ;
+    }
+    while (len_ < lt+4 && more()) ;
+    if (len_ >= lt+4 && std::memcmp(&buf_[lt],"<!--",4) == 0) {
+      size_t close = lt+4 ;
+      if (!find(close,"-->")) {
+	pos_ = len_ ;
+	return (Eof) ;
+      }
+      lt = close+3 ;
+      textStart = lt ;
+      continue ;
+    }
+/*
+  Find the closing '>' of the tag, allowing for quoted attribute values.
+*/
+    char quote = '\0' ;
+    gt = lt+1 ;
+    while (true) {
+      if (gt >= len_ && !more()) {
+	pos_ = len_ ;
+	return (Eof) ;
+      }
+      char c = buf_[gt] ;
+      if (quote != '\0') {
+	if (c == quote) quote = '\0' ;
+      } else if (c == '"' || c == '\'') {
+	quote = c ;
+      } else if (c == '>') {
+	break ;
+      }
+      gt++ ;
+    }
+    if (buf_[lt+1] == '?' || buf_[lt+1] == '!') {
+      lt = gt+1 ;
+      textStart = lt ;
+      continue ;
+    }
+    break ;
+  }
+/*
+  A real tag. The buffer won't move again until the next call, so the
+  pointers can be set.
+*/
+  const char *base = &buf_[0] ;
+  Kind kind = Start ;
+  const char *p = base+lt+1 ;
+  const char *tagEnd = base+gt ;
+  if (*p == '/') {
+    kind = End ;
+    p++ ;
+  } else if (*(tagEnd-1) == '/') {
+    kind = Empty ;
+    tagEnd-- ;
+  }
+  name_.ptr_ = p ;
+  while (p < tagEnd && !isSpace(*p) && *p != '/') p++ ;
+  name_.end_ = p ;
+  attrs_.ptr_ = p ;
+  attrs_.end_ = tagEnd ;
+  text_.ptr_ = base+textStart ;
+  text_.end_ = base+lt ;
+  pos_ = gt+1 ;
+  return (kind) ;
+}
+
+/*
+  Attributes are looked for by a linear scan; tags in OSiL have few.
+*/
+bool XmlScanner::attr (const char *name, Text &value) const
+{
+  size_t nameLen = std::strlen(name) ;
+  const char *p = attrs_.ptr_ ;
+  const char *end = attrs_.end_ ;
+  while (p < end) {
+    while (p < end && isSpace(*p)) p++ ;
+    const char *nameStart = p ;
+    while (p < end && *p != '=' && !isSpace(*p)) p++ ;
+    const char *nameEnd = p ;
+    while (p < end && isSpace(*p)) p++ ;
+    if (p >= end || *p != '=') return (false) ;
+    p++ ;
+    while (p < end && isSpace(*p)) p++ ;
+    if (p >= end || (*p != '"' && *p != '\'')) return (false) ;
+    char quote = *p++ ;
+    const char *valStart = p ;
+    while (p < end && *p != quote) p++ ;
+    if (p >= end) return (false) ;
+    if (static_cast<size_t>(nameEnd-nameStart) == nameLen &&
+	std::memcmp(nameStart,name,nameLen) == 0) {
+      value.ptr_ = valStart ;
+      value.end_ = p ;
+      return (true) ;
+    }
+    p++ ;
+  }
+  return (false) ;
+}
+
+/*
+  Errors found while parsing. Every error is counted; only the first few
+  messages are kept.
+*/
+struct ErrorLog {
+  int count_ ;
+  std::vector<std::string> msgs_ ;
+
+  ErrorLog () : count_(0) { }
+  void add (const std::string &msg)
+  { count_++ ;
+    if (msgs_.size() < maxMessages) msgs_.push_back(msg) ; }
+} ;
+
+/*
+  Conversion of array elements, by type: integers of any width, or
+  doubles. Bounds and right-hand sides of 1e30 or more are infinite, but
+  coefficients are not clamped.
+*/
+bool convert (const Text &text, double &value)
+{
+  return (Osi2::NumberParser::toDouble(text.ptr_,text.end_,value)) ;
+}
+
+template <class T>
+bool convert (const Text &text, T &value)
+{
+  long long val ;
+  if (!Osi2::NumberParser::toInteger(text.ptr_,text.end_,val) ||
+      val > static_cast<long long>(std::numeric_limits<T>::max()) ||
+      val < static_cast<long long>(std::numeric_limits<T>::min()))
+    return (false) ;
+  value = static_cast<T>(val) ;
+  return (true) ;
+}
+
+inline double clampInfinity (double value)
+{
+  if (value >= 1.0e30) return (infinity) ;
+  if (value <= -1.0e30) return (-infinity) ;
+  return (value) ;
+}
+
+/*
+  Decode base64 text into bytes, ignoring white space. Returns false on a
+  character outside the alphabet.
+*/
+bool decodeBase64 (const Text &text, std::vector<unsigned char> &bytes)
+{
+  static signed char table[256] ;
+  static bool ready = false ;
+  if (!ready) {
+    const char *alphabet =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" ;
+    std::memset(table,-1,sizeof(table)) ;
+    for (int ndx = 0 ; ndx < 64 ; ndx++)
+      table[static_cast<unsigned char>(alphabet[ndx])] =
+	static_cast<signed char>(ndx) ;
+    ready = true ;
+  }
+  bytes.clear() ;
+  bytes.reserve((text.end_-text.ptr_)*3/4) ;
+  unsigned int acc = 0 ;
+  int bits = 0 ;
+  for (const char *p = text.ptr_ ; p < text.end_ ; p++) {
+    unsigned char c = static_cast<unsigned char>(*p) ;
+    if (isSpace(c)) continue ;
+    if (c == '=') break ;
+    if (table[c] < 0) return (false) ;
+    acc = (acc<<6)|table[c] ;
+    bits += 6 ;
+    if (bits >= 8) {
+      bits -= 8 ;
+      bytes.push_back(static_cast<unsigned char>((acc>>bits)&0xff)) ;
+    }
+  }
+  return (true) ;
+}
+
+/*
+  The parse proper. Each section method is called just after the start tag
+  of its section and consumes everything up to and including the end tag.
+*/
+class OsilParser {
+
+public:
+
+  OsilParser (InputStream &in, bool keepNames)
+    : scan_(in), keepNames_(keepNames),
+      numCols_(-1), numRows_(-1), numValues_(-1),
+      objSense_(1.0), objOffset_(0.0), haveObj_(false),
+      startCnt_(0), indexCnt_(0), valueCnt_(0), rowMajor_(false),
+      haveIndex_(false)
+  { }
+
+  void run () ;
+
+  XmlScanner scan_ ;
+  bool keepNames_ ;
+  ErrorLog log_ ;
+
+  std::string probName_ ;
+  int numCols_ ;
+  int numRows_ ;
+  int numValues_ ;
+  std::vector<double> colLower_ ;
+  std::vector<double> colUpper_ ;
+  std::vector<double> obj_ ;
+  std::vector<char> integer_ ;
+  std::vector<double> rowLower_ ;
+  std::vector<double> rowUpper_ ;
+  std::vector<std::string> colNames_ ;
+  std::vector<std::string> rowNames_ ;
+  double objSense_ ;
+  double objOffset_ ;
+  bool haveObj_ ;
+
+  std::vector<CoinBigIndex> start_ ;
+  std::vector<int> index_ ;
+  std::vector<double> value_ ;
+  size_t startCnt_ ;
+  size_t indexCnt_ ;
+  size_t valueCnt_ ;
+  bool rowMajor_ ;
+  bool haveIndex_ ;
+
+private:
+
+  int skip () ;
+  bool elementText (Text &text) ;
+  int count (const char *attrName) ;
+  bool number (const Text &text, double &value, const char *what) ;
+  void header () ;
+  void data () ;
+  void variables (XmlScanner::Kind kind) ;
+  void objectives (XmlScanner::Kind kind) ;
+  void objective (XmlScanner::Kind kind) ;
+  void constraints (XmlScanner::Kind kind) ;
+  void coefficients (XmlScanner::Kind kind) ;
+  template <class T>
+  void array (std::vector<T> &dst, size_t &cnt, const char *what) ;
+} ;
+
+/*
+  Consume the content and end tag of the element just started. Returns the
+  number of child elements, so that the caller can tell an empty section
+  from one with content.
+*/
+int OsilParser::skip ()
+{
+  int depth = 1 ;
+  int children = 0 ;
+  while (depth > 0) {
+    XmlScanner::Kind kind = scan_.next() ;
+    if (kind == XmlScanner::Eof) return (children) ;
+    if (kind == XmlScanner::Start) {
+      if (depth == 1) children++ ;
+      depth++ ;
+    } else if (kind == XmlScanner::Empty) {
+      if (depth == 1) children++ ;
+    } else {
+      depth-- ;
+    }
+  }
+  return (children) ;
+}
+
+/*
+  The text of a simple element such as <el>3</el>, called after the start
+  tag. Element content is not allowed.
+*/
+bool OsilParser::elementText (Text &text)
+{
+  XmlScanner::Kind kind = scan_.next() ;
+  if (kind == XmlScanner::End) {
+    text = trim(scan_.text()) ;
+    return (true) ;
+  }
+  if (kind == XmlScanner::Eof) return (false) ;
+  log_.add("unexpected <"+scan_.name().str()+"> in element content") ;
+  if (kind == XmlScanner::Start) skip() ;
+  skip() ;
+  return (false) ;
+}
+
+/*
+  A count attribute of the current tag; -1 if it is absent or bad.
+*/
+int OsilParser::count (const char *attrName)
+{
+  Text text ;
+  int cnt = -1 ;
+  if (!scan_.attr(attrName,text)) return (-1) ;
+  if (!convert(trim(text),cnt) || cnt < 0) {
+    log_.add(std::string("bad ")+attrName+" \""+text.str()+"\"") ;
+    return (-1) ;
+  }
+  return (cnt) ;
+}
+
+bool OsilParser::number (const Text &text, double &value, const char *what)
+{
+  if (convert(trim(text),value)) return (true) ;
+  log_.add(std::string("bad ")+what+" \""+text.str()+"\"") ;
+  return (false) ;
+}
+
+/*
+  The sections stop quietly at end of file; a missing </osil> is the sign
+  that the file was cut short.
+*/
+void OsilParser::run ()
+{
+  bool closed = false ;
+  while (true) {
+    XmlScanner::Kind kind = scan_.next() ;
+    if (kind == XmlScanner::Eof) break ;
+    if (kind == XmlScanner::End && scan_.name().is("osil")) closed = true ;
+    if (kind != XmlScanner::Start) continue ;
+    const Text &name = scan_.name() ;
+    if (name.is("osil")) {
+      continue ;
+    } else if (name.is("instanceHeader")) {
+      header() ;
+    } else if (name.is("instanceData")) {
+      data() ;
+    } else {
+      skip() ;
+    }
+  }
+  if (!closed) log_.add("unexpected end of file") ;
+}
+
+void OsilParser::header ()
+{
+  while (true) {
+    XmlScanner::Kind kind = scan_.next() ;
+    if (kind == XmlScanner::Eof || kind == XmlScanner::End) return ;
+    if (kind == XmlScanner::Start) {
+      if (scan_.name().is("name")) {
+	Text text ;
+	if (elementText(text)) probName_ = unescape(text) ;
+      } else {
+	skip() ;
+      }
+    }
+  }
+}
+
+void OsilParser::data ()
+{
+  while (true) {
+    XmlScanner::Kind kind = scan_.next() ;
+    if (kind == XmlScanner::Eof || kind == XmlScanner::End) return ;
+    const Text &name = scan_.name() ;
+    if (name.is("variables")) {
+      variables(kind) ;
+    } else if (name.is("objectives")) {
+      objectives(kind) ;
+    } else if (name.is("constraints")) {
+      constraints(kind) ;
+    } else if (name.is("linearConstraintCoefficients")) {
+      coefficients(kind) ;
+    } else if (kind == XmlScanner::Start) {
+      std::string section = name.str() ;
+      if (skip() > 0) log_.add("unsupported section <"+section+">") ;
+    }
+  }
+}
+
+/*
+  A var with a mult attribute stands for that many consecutive variables
+  with the same attributes. Only the first gets the name.
+*/
+void OsilParser::variables (XmlScanner::Kind kind)
+{
+  numCols_ = count("numberOfVariables") ;
+  if (numCols_ < 0) {
+    log_.add("missing numberOfVariables") ;
+    numCols_ = 0 ;
+  }
+  colLower_.assign(numCols_,0.0) ;
+  colUpper_.assign(numCols_,infinity) ;
+  obj_.assign(numCols_,0.0) ;
+  integer_.assign(numCols_,0) ;
+  if (keepNames_) colNames_.assign(numCols_,std::string()) ;
+  if (kind == XmlScanner::Empty) return ;
+  int cnt = 0 ;
+  while (true) {
+    kind = scan_.next() ;
+    if (kind == XmlScanner::Eof || kind == XmlScanner::End) break ;
+    if (!scan_.name().is("var")) {
+      if (kind == XmlScanner::Start) skip() ;
+      continue ;
+    }
+    int mult = count("mult") ;
+    if (mult < 0) mult = 1 ;
+    double lb = 0.0 ;
+    double ub = infinity ;
+    char isInt = 0 ;
+    Text text ;
+    if (scan_.attr("type",text)) {
+      text = trim(text) ;
+      if (text.is("B")) {
+	isInt = 1 ;
+	ub = 1.0 ;
+      } else if (text.is("I")) {
+	isInt = 1 ;
+      } else if (!text.is("C")) {
+	log_.add("unsupported variable type \""+text.str()+"\"") ;
+      }
+    }
+    if (scan_.attr("lb",text) && number(text,lb,"lb")) lb = clampInfinity(lb) ;
+    if (scan_.attr("ub",text) && number(text,ub,"ub")) ub = clampInfinity(ub) ;
+    std::string name ;
+    if (keepNames_ && scan_.attr("name",text)) name = unescape(text) ;
+    if (cnt+mult > numCols_) {
+      log_.add("more variables than numberOfVariables") ;
+      mult = std::max(numCols_-cnt,0) ;
+    }
+    for (int j = cnt ; j < cnt+mult ; j++) {
+      colLower_[j] = lb ;
+      colUpper_[j] = ub ;
+      integer_[j] = isInt ;
+    }
+    if (keepNames_ && mult > 0) colNames_[cnt] = name ;
+    cnt += mult ;
+    if (kind == XmlScanner::Start) skip() ;
+  }
+  if (cnt < numCols_) log_.add("fewer variables than numberOfVariables") ;
+}
+
+void OsilParser::objectives (XmlScanner::Kind kind)
+{
+  if (kind == XmlScanner::Empty) return ;
+  while (true) {
+    kind = scan_.next() ;
+    if (kind == XmlScanner::Eof || kind == XmlScanner::End) break ;
+    if (scan_.name().is("obj") && !haveObj_) {
+      objective(kind) ;
+    } else if (kind == XmlScanner::Start) {
+      skip() ;
+    }
+  }
+}
+
+/*
+  The first objective. OSiL adds the constant; Clp subtracts the offset.
+*/
+void OsilParser::objective (XmlScanner::Kind kind)
+{
+  haveObj_ = true ;
+  Text text ;
+  if (scan_.attr("maxOrMin",text)) {
+    text = trim(text) ;
+    if (text.is("max"))
+      objSense_ = -1.0 ;
+    else if (!text.is("min"))
+      log_.add("bad maxOrMin \""+text.str()+"\"") ;
+  }
+  double constant = 0.0 ;
+  if (scan_.attr("constant",text) && number(text,constant,"constant"))
+    objOffset_ = -constant ;
+  if (kind == XmlScanner::Empty) return ;
+  if (numCols_ < 0) {
+    log_.add("objective coefficients before variables") ;
+    skip() ;
+    return ;
+  }
+  while (true) {
+    kind = scan_.next() ;
+    if (kind == XmlScanner::Eof || kind == XmlScanner::End) break ;
+    if (kind != XmlScanner::Start || !scan_.name().is("coef")) {
+      if (kind == XmlScanner::Start) skip() ;
+      continue ;
+    }
+    int idx = count("idx") ;
+    double value ;
+    if (!elementText(text)) continue ;
+    if (idx < 0 || idx >= numCols_) {
+      log_.add("objective coefficient with bad idx") ;
+    } else if (number(text,value,"objective coefficient")) {
+      obj_[idx] = value ;
+    }
+  }
+}
+
+/*
+  A con stands for mult constraints, like var. OSiL adds the constant to
+  the row activity; it's moved to the bounds.
+*/
+void OsilParser::constraints (XmlScanner::Kind kind)
+{
+  numRows_ = count("numberOfConstraints") ;
+  if (numRows_ < 0) {
+    log_.add("missing numberOfConstraints") ;
+    numRows_ = 0 ;
+  }
+  rowLower_.assign(numRows_,-infinity) ;
+  rowUpper_.assign(numRows_,infinity) ;
+  if (keepNames_) rowNames_.assign(numRows_,std::string()) ;
+  if (kind == XmlScanner::Empty) return ;
+  int cnt = 0 ;
+  while (true) {
+    kind = scan_.next() ;
+    if (kind == XmlScanner::Eof || kind == XmlScanner::End) break ;
+    if (!scan_.name().is("con")) {
+      if (kind == XmlScanner::Start) skip() ;
+      continue ;
+    }
+    int mult = count("mult") ;
+    if (mult < 0) mult = 1 ;
+    double lb = -infinity ;
+    double ub = infinity ;
+    double constant = 0.0 ;
+    Text text ;
+    if (scan_.attr("lb",text) && number(text,lb,"lb")) lb = clampInfinity(lb) ;
+    if (scan_.attr("ub",text) && number(text,ub,"ub")) ub = clampInfinity(ub) ;
+    if (scan_.attr("constant",text)) number(text,constant,"constant") ;
+    if (constant != 0.0) {
+      if (lb > -infinity) lb -= constant ;
+      if (ub < infinity) ub -= constant ;
+    }
+    std::string name ;
+    if (keepNames_ && scan_.attr("name",text)) name = unescape(text) ;
+    if (cnt+mult > numRows_) {
+      log_.add("more constraints than numberOfConstraints") ;
+      mult = std::max(numRows_-cnt,0) ;
+    }
+    for (int i = cnt ; i < cnt+mult ; i++) {
+      rowLower_[i] = lb ;
+      rowUpper_[i] = ub ;
+    }
+    if (keepNames_ && mult > 0) rowNames_[cnt] = name ;
+    cnt += mult ;
+    if (kind == XmlScanner::Start) skip() ;
+  }
+  if (cnt < numRows_) log_.add("fewer constraints than numberOfConstraints") ;
+}
+
+/*
+  The start array has one more entry than the major dimension, which isn't
+  known until rowIdx or colIdx is seen, so it's sized for the larger.
+*/
+void OsilParser::coefficients (XmlScanner::Kind kind)
+{
+  numValues_ = count("numberOfValues") ;
+  if (numValues_ < 0) {
+    log_.add("missing numberOfValues") ;
+    numValues_ = 0 ;
+  }
+  if (kind == XmlScanner::Empty) return ;
+  start_.assign(std::max(std::max(numCols_,numRows_),0)+1,0) ;
+  index_.assign(numValues_,0) ;
+  value_.assign(numValues_,0.0) ;
+  while (true) {
+    kind = scan_.next() ;
+    if (kind == XmlScanner::Eof || kind == XmlScanner::End) break ;
+    const Text &name = scan_.name() ;
+    if (kind == XmlScanner::Empty) continue ;
+    if (name.is("start")) {
+      array(start_,startCnt_,"start") ;
+    } else if (name.is("rowIdx") || name.is("colIdx")) {
+      if (haveIndex_) log_.add("both rowIdx and colIdx") ;
+      rowMajor_ = name.is("colIdx") ;
+      haveIndex_ = true ;
+      array(index_,indexCnt_,"index") ;
+    } else if (name.is("value")) {
+      array(value_,valueCnt_,"value") ;
+    } else {
+      std::string section = name.str() ;
+      if (skip() > 0) log_.add("unsupported element <"+section+">") ;
+    }
+  }
+}
+
+/*
+  An array of el or base64BinaryData children. An el with mult stands for
+  mult entries, each incr more than the last. Entries beyond the capacity
+  of dst are counted but not stored, so the caller can report the mismatch.
+*/
+template <class T>
+void OsilParser::array (std::vector<T> &dst, size_t &cnt, const char *what)
+{
+  size_t cap = dst.size() ;
+  std::vector<unsigned char> bytes ;
+  while (true) {
+    XmlScanner::Kind kind = scan_.next() ;
+    if (kind == XmlScanner::Eof || kind == XmlScanner::End) break ;
+    if (kind != XmlScanner::Start) continue ;
+    const Text &name = scan_.name() ;
+    if (name.is("el")) {
+      int mult = count("mult") ;
+      if (mult < 0) mult = 1 ;
+      T incr = 0 ;
+      Text text ;
+      if (scan_.attr("incr",text) && !convert(trim(text),incr))
+	log_.add(std::string("bad incr in ")+what) ;
+      T value ;
+      if (!elementText(text)) continue ;
+      if (!convert(text,value)) {
+	log_.add(std::string("bad ")+what+" \""+text.str()+"\"") ;
+	value = 0 ;
+      }
+      for (int k = 0 ; k < mult ; k++, cnt++) {
+	if (cnt < cap) dst[cnt] = value ;
+	value += incr ;
+      }
+    } else if (name.is("base64BinaryData")) {
+      int sizeOf = count("sizeOf") ;
+      Text text ;
+      if (!elementText(text)) continue ;
+      if (sizeOf != static_cast<int>(sizeof(T))) {
+	log_.add(std::string("unsupported sizeOf in ")+what) ;
+	continue ;
+      }
+      if (!decodeBase64(text,bytes) || bytes.size()%sizeof(T) != 0) {
+	log_.add(std::string("bad base64BinaryData in ")+what) ;
+	continue ;
+      }
+      size_t num = bytes.size()/sizeof(T) ;
+      if (cnt < cap)
+	std::memcpy(&dst[cnt],bytes.data(),std::min(num,cap-cnt)*sizeof(T)) ;
+      cnt += num ;
+    } else {
+      std::string elem = name.str() ;
+      log_.add("unexpected <"+elem+"> in "+what) ;
+      skip() ;
+    }
+  }
+}
+
+void addName (const std::string &name, std::vector<char> &arena,
+	      std::vector<int> &offsets)
+{
+  offsets.push_back(static_cast<int>(arena.size())) ;
+  arena.insert(arena.end(),name.begin(),name.end()) ;
+  arena.push_back('\0') ;
+}
+
+std::string defaultName (char prefix, int ndx)
+{
+  char buf[16] ;
+  std::snprintf(buf,sizeof(buf),"%c%07d",prefix,ndx) ;
+  return (std::string(buf)) ;
+}
+
+template <class T>
+std::unique_ptr<T[]> arrayOf (const std::vector<T> &vec, size_t len)
+{
+  std::unique_ptr<T[]> arr(new T[std::max(len,static_cast<size_t>(1))]) ;
+  std::copy(vec.begin(),vec.begin()+std::min(len,vec.size()),arr.get()) ;
+  return (arr) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+int OsilReader::readOsil (const char *filename, bool keepNames)
+{
+  clear() ;
+  std::unique_ptr<InputStream> in = StreamCodec::openInput(filename) ;
+  if (!in) return (-1) ;
+  OsilParser parse(*in,keepNames) ;
+  parse.run() ;
+  ErrorLog &log = parse.log_ ;
+  if (in->failed()) log.add("error reading the file") ;
+  in.reset() ;
+
+  int n = std::max(parse.numCols_,0) ;
+  int m = std::max(parse.numRows_,0) ;
+  if (parse.numCols_ < 0) {
+    parse.colLower_.clear() ;
+    parse.colUpper_.clear() ;
+    parse.obj_.clear() ;
+    parse.integer_.clear() ;
+  }
+  if (parse.numRows_ < 0) {
+    parse.rowLower_.clear() ;
+    parse.rowUpper_.clear() ;
+  }
+/*
+  Check the matrix. Any inconsistency drops it, since a bad start or index
+  would take loadProblem out of bounds.
+*/
+  size_t nnz = std::max(parse.numValues_,0) ;
+  int major = (parse.rowMajor_)?m:n ;
+  int minor = (parse.rowMajor_)?n:m ;
+  const std::vector<CoinBigIndex> &start = parse.start_ ;
+  const std::vector<int> &index = parse.index_ ;
+  bool ok = true ;
+  if (nnz > 0) {
+    if (parse.startCnt_ != static_cast<size_t>(major)+1) {
+      log.add("start has the wrong number of entries") ;
+      ok = false ;
+    } else if (!parse.haveIndex_ || parse.indexCnt_ != nnz ||
+	       parse.valueCnt_ != nnz) {
+      log.add("index or value count differs from numberOfValues") ;
+      ok = false ;
+    } else if (start[0] != 0 ||
+	       start[major] != static_cast<CoinBigIndex>(nnz)) {
+      log.add("start does not run from 0 to numberOfValues") ;
+      ok = false ;
+    }
+    for (int k = 0 ; ok && k < major ; k++) {
+      if (start[k+1] < start[k]) {
+	log.add("start is not increasing") ;
+	ok = false ;
+      }
+    }
+    for (size_t k = 0 ; ok && k < nnz ; k++) {
+      if (index[k] < 0 || index[k] >= minor) {
+	log.add("coefficient index out of range") ;
+	ok = false ;
+      }
+    }
+  }
+  if (!ok) nnz = 0 ;
+
+  numCols_ = n ;
+  numRows_ = m ;
+  starts_.reset(new CoinBigIndex[n+1]) ;
+  indices_.reset(new int[std::max(nnz,static_cast<size_t>(1))]) ;
+  elements_.reset(new double[std::max(nnz,static_cast<size_t>(1))]) ;
+  if (nnz == 0) {
+    std::fill(starts_.get(),starts_.get()+n+1,0) ;
+  } else if (!parse.rowMajor_) {
+    std::copy(start.begin(),start.begin()+n+1,starts_.get()) ;
+    std::copy(index.begin(),index.begin()+nnz,indices_.get()) ;
+    std::copy(parse.value_.begin(),parse.value_.begin()+nnz,
+	      elements_.get()) ;
+  } else {
+/*
+  Transpose: count the entries in each column, turn the counts into starts,
+  then drop each row's entries into place. Row order within a column is
+  preserved.
+*/
+    CoinBigIndex *colStart = starts_.get() ;
+    std::fill(colStart,colStart+n+1,0) ;
+    for (size_t k = 0 ; k < nnz ; k++) colStart[index[k]+1]++ ;
+    for (int j = 0 ; j < n ; j++) colStart[j+1] += colStart[j] ;
+    std::vector<CoinBigIndex> fill(colStart,colStart+n) ;
+    for (int i = 0 ; i < m ; i++) {
+      for (CoinBigIndex k = start[i] ; k < start[i+1] ; k++) {
+	CoinBigIndex dst = fill[index[k]]++ ;
+	indices_[dst] = i ;
+	elements_[dst] = parse.value_[k] ;
+      }
+    }
+  }
+  colLower_ = arrayOf(parse.colLower_,n) ;
+  colUpper_ = arrayOf(parse.colUpper_,n) ;
+  obj_ = arrayOf(parse.obj_,n) ;
+  rowLower_ = arrayOf(parse.rowLower_,m) ;
+  rowUpper_ = arrayOf(parse.rowUpper_,m) ;
+  integer_.swap(parse.integer_) ;
+  integer_.resize(n,0) ;
+  objSense_ = parse.objSense_ ;
+  objOffset_ = parse.objOffset_ ;
+  probName_ = parse.probName_ ;
+
+  if (keepNames) {
+    parse.colNames_.resize(n) ;
+    parse.rowNames_.resize(m) ;
+    for (int j = 0 ; j < n ; j++) {
+      if (parse.colNames_[j].empty()) parse.colNames_[j] = defaultName('C',j) ;
+      addName(parse.colNames_[j],colNames_,colNameOffsets_) ;
+    }
+    for (int i = 0 ; i < m ; i++) {
+      if (parse.rowNames_[i].empty()) parse.rowNames_[i] = defaultName('R',i) ;
+      addName(parse.rowNames_[i],rowNames_,rowNameOffsets_) ;
+    }
+  }
+
+  numErrors_ = log.count_ ;
+  errors_.swap(log.msgs_) ;
+  return (numErrors_) ;
+}
+
+std::string OsilReader::rowName (int i) const
+{
+  if (i < 0 || i >= static_cast<int>(rowNameOffsets_.size()))
+    return (std::string()) ;
+  return (std::string(&rowNames_[rowNameOffsets_[i]])) ;
+}
+
+std::string OsilReader::columnName (int j) const
+{
+  if (j < 0 || j >= static_cast<int>(colNameOffsets_.size()))
+    return (std::string()) ;
+  return (std::string(&colNames_[colNameOffsets_[j]])) ;
+}
+
+/*
+  Integer information and names are installed only if there are any.
+*/
+void OsilReader::loadInto (ClpSimplexAPI &solver) const
+{
+  solver.loadProblem(numCols_,numRows_,
+		     starts_.get(),indices_.get(),elements_.get(),
+		     colLower_.get(),colUpper_.get(),obj_.get(),
+		     rowLower_.get(),rowUpper_.get()) ;
+  solver.setObjSense(objSense_) ;
+  solver.setObjectiveOffset(objOffset_) ;
+  solver.setProblemName(probName_) ;
+  if (std::find(integer_.begin(),integer_.end(),1) != integer_.end())
+    solver.copyInIntegerInformation(integer_.data()) ;
+  if (numRows_ > 0 && !rowNameOffsets_.empty())
+    solver.setRowNames(0,numRows_,rowNames_.data(),rowNameOffsets_.data()) ;
+  if (numCols_ > 0 && !colNameOffsets_.empty())
+    solver.setColumnNames(0,numCols_,
+			  colNames_.data(),colNameOffsets_.data()) ;
+}
+
+void OsilReader::loadInto (Osi1API &solver) const
+{
+  solver.loadProblem(numCols_,numRows_,
+		     starts_.get(),indices_.get(),elements_.get(),
+		     colLower_.get(),colUpper_.get(),obj_.get(),
+		     rowLower_.get(),rowUpper_.get()) ;
+  solver.setObjSense(objSense_) ;
+  solver.setDblParam(OsiObjOffset,objOffset_) ;
+  solver.setStrParam(OsiProbName,probName_) ;
+  std::vector<int> intCols ;
+  for (int j = 0 ; j < numCols_ ; j++)
+    if (integer_[j]) intCols.push_back(j) ;
+  if (!intCols.empty())
+    solver.setInteger(intCols.data(),static_cast<int>(intCols.size())) ;
+  if (!rowNameOffsets_.empty()) {
+    Osi1API::OsiNameVec names(numRows_) ;
+    for (int i = 0 ; i < numRows_ ; i++) names[i] = rowName(i) ;
+    solver.setRowNames(names,0,numRows_,0) ;
+  }
+  if (!colNameOffsets_.empty()) {
+    Osi1API::OsiNameVec names(numCols_) ;
+    for (int j = 0 ; j < numCols_ ; j++) names[j] = columnName(j) ;
+    solver.setColNames(names,0,numCols_,0) ;
+  }
+}
+
+void OsilReader::assignTo (ProbMgmtAPI &solver)
+{
+  CoinBigIndex *start = starts_.release() ;
+  int *index = indices_.release() ;
+  double *value = elements_.release() ;
+  double *collb = colLower_.release() ;
+  double *colub = colUpper_.release() ;
+  double *obj = obj_.release() ;
+  double *rowlb = rowLower_.release() ;
+  double *rowub = rowUpper_.release() ;
+  solver.assignProblem(numCols_,numRows_,start,index,value,
+		       collb,colub,obj,rowlb,rowub) ;
+  clear() ;
+}
+
+void OsilReader::clear ()
+{
+  numErrors_ = 0 ;
+  errors_.clear() ;
+  probName_.clear() ;
+  numCols_ = 0 ;
+  numRows_ = 0 ;
+  starts_.reset() ;
+  indices_.reset() ;
+  elements_.reset() ;
+  colLower_.reset() ;
+  colUpper_.reset() ;
+  obj_.reset() ;
+  rowLower_.reset() ;
+  rowUpper_.reset() ;
+  integer_.clear() ;
+  objSense_ = 1.0 ;
+  objOffset_ = 0.0 ;
+  rowNames_.clear() ;
+  rowNameOffsets_.clear() ;
+  colNames_.clear() ;
+  colNameOffsets_.clear() ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+OsilReader::OsilReader ()
+{
+  clear() ;
+}
+
+OsilReader::~OsilReader () { }
+
+} // namespace Osi2
@@ -0,0 +1,174 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2OsilReader.hpp
+
+  Defines OsilReader, a streaming reader for linear models in OSiL that
+  builds the problem directly in column-major form.
+*/
+
+#ifndef Osi2OsilReader_HPP
+#define Osi2OsilReader_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2Osi1API.hpp"
+#include "Osi2ProbMgmtAPI.hpp"
+
+namespace Osi2 {
+
+/*! \brief A streaming reader for OSiL files
+
+  The file is read in fixed-size chunks and scanned one tag at a time, so
+  no document tree is built and the memory used beyond the model itself is
+  bounded by the longest tag. Values go straight into the arrays handed to
+  loadProblem. The arrays are the same as those built by MpsReader and are
+  loaded into the problem APIs the same way. A compressed file (see
+  StreamCodec) is decompressed on a separate thread while it is parsed.
+
+  The linear part of OSiL is understood: the problem name from the
+  instance header, \c variables, the first objective in \c objectives,
+  \c constraints, and \c linearConstraintCoefficients given by \c start and
+  either \c rowIdx or \c colIdx, with \c value. Array elements may use the
+  \c mult and \c incr attributes, and arrays may be given as
+  \c base64BinaryData in native byte order. A row-major matrix is
+  transposed once it has been read. Any other section of \c instanceData
+  that has content (quadratic or nonlinear terms, cones, and so on) is
+  reported as an error and skipped.
+
+  Variables of type B are integer with default bounds 0 and 1; variables of
+  type I are integer. Semicontinuous, semi-integer, and string variables
+  are reported as errors and read as continuous. Unnamed rows and columns
+  get names of the form R0000012 and C0000012.
+*/
+class OsilReader {
+
+public:
+
+  /// Constructor
+  OsilReader() ;
+  /// Destructor
+  ~OsilReader() ;
+
+  /*! \brief Read a problem from an OSiL file
+
+    Returns -1 if the file can't be opened, otherwise the number of errors
+    found. Elements in error are skipped and the rest of the problem is
+    kept; if the matrix is inconsistent, it is dropped. Names are retained
+    only if \p keepNames is true.
+  */
+  int readOsil(const char *filename, bool keepNames = false) ;
+
+  /// Messages for the first errors found by the last call to #readOsil
+  const std::vector<std::string> &getErrors() const { return (errors_) ; }
+
+  /*! \name Problem access */
+  //@{
+  /// Problem name from the instance header
+  const std::string &getProblemName() const { return (probName_) ; }
+  /// Number of columns
+  int getNumCols() const { return (numCols_) ; }
+  /// Number of rows
+  int getNumRows() const { return (numRows_) ; }
+  /// Number of coefficients in the constraint matrix
+  CoinBigIndex getNumElements() const
+  { return ((starts_) ? starts_[numCols_] : 0) ; }
+  /// Column starts (numCols+1 entries)
+  const CoinBigIndex *getColStarts() const { return (starts_.get()) ; }
+  /// Row indices of coefficients
+  const int *getIndices() const { return (indices_.get()) ; }
+  /// Coefficients
+  const double *getElements() const { return (elements_.get()) ; }
+  /// Column lower bounds
+  const double *getColLower() const { return (colLower_.get()) ; }
+  /// Column upper bounds
+  const double *getColUpper() const { return (colUpper_.get()) ; }
+  /// Objective coefficients
+  const double *getObjective() const { return (obj_.get()) ; }
+  /// Row lower bounds
+  const double *getRowLower() const { return (rowLower_.get()) ; }
+  /// Row upper bounds
+  const double *getRowUpper() const { return (rowUpper_.get()) ; }
+  /// Integer information: 1 for integer, 0 for continuous
+  const char *getIntegerInformation() const { return (integer_.data()) ; }
+  /// Objective sense: 1 to minimise, -1 to maximise
+  double getObjSense() const { return (objSense_) ; }
+  /*! \brief Objective offset
+
+    As Clp defines it: the objective is c'x minus the offset, so this is
+    the negative of the \c constant attribute of the objective.
+  */
+  double getObjOffset() const { return (objOffset_) ; }
+  /// Name of row i; empty if names were not kept
+  std::string rowName(int i) const ;
+  /// Name of column j; empty if names were not kept
+  std::string columnName(int j) const ;
+  //@}
+
+  /*! \name Loading the problem into a solver */
+  //@{
+  /// Load the problem into \p solver, with integer information and names
+  void loadInto(ClpSimplexAPI &solver) const ;
+  /// Load the problem into \p solver, with integer information and names
+  void loadInto(Osi1API &solver) const ;
+  /*! \brief Hand the problem over to \p solver
+
+    The arrays are given to ProbMgmtAPI::assignProblem without copying, so
+    the reader is empty afterwards. Objective sense and offset, integer
+    information, and names are not part of ProbMgmtAPI and are dropped.
+  */
+  void assignTo(ProbMgmtAPI &solver) ;
+  //@}
+
+private:
+
+  /// Drop the problem and error messages
+  void clear() ;
+
+  /// Number of errors found by the last read
+  int numErrors_ ;
+  /// Messages for the first of them
+  std::vector<std::string> errors_ ;
+
+  std::string probName_ ;
+  int numCols_ ;
+  int numRows_ ;
+  std::unique_ptr<CoinBigIndex[]> starts_ ;
+  std::unique_ptr<int[]> indices_ ;
+  std::unique_ptr<double[]> elements_ ;
+  std::unique_ptr<double[]> colLower_ ;
+  std::unique_ptr<double[]> colUpper_ ;
+  std::unique_ptr<double[]> obj_ ;
+  std::unique_ptr<double[]> rowLower_ ;
+  std::unique_ptr<double[]> rowUpper_ ;
+  std::vector<char> integer_ ;
+  double objSense_ ;
+  double objOffset_ ;
+
+  /*! \brief Names, if kept
+
+    In the layout used by ClpSimplexAPI::setRowNames, as for MpsReader.
+  */
+  std::vector<char> rowNames_ ;
+  std::vector<int> rowNameOffsets_ ;
+  std::vector<char> colNames_ ;
+  std::vector<int> colNameOffsets_ ;
+
+  /// Copying is not supported
+  OsilReader(const OsilReader &) ;
+  OsilReader &operator=(const OsilReader &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -0,0 +1,180 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for PackedModel.
+*/
+
+#include "Osi2Config.h"
+
+#include "Osi2PackedModel.hpp"
+
+namespace {
+
+/*
+  Bytes between the current position and the end of the file; 0 if the file
+  can't be positioned.
+*/
+size_t bytesLeft (std::FILE *file)
+{
+  long here = std::ftell(file) ;
+  if (here < 0 || std::fseek(file,0,SEEK_END) != 0) return (0) ;
+  long end = std::ftell(file) ;
+  if (std::fseek(file,here,SEEK_SET) != 0 || end < here) return (0) ;
+  return (static_cast<size_t>(end-here)) ;
+}
+
+/*
+  Length-prefixed vector I/O for write and read. A length that claims more
+  data than the file holds marks a damaged file; it's rejected before any
+  space is allocated.
+*/
+template <class T>
+bool writeVec (std::FILE *file, const std::vector<T> &vec)
+{
+  size_t len = vec.size() ;
+  if (std::fwrite(&len,sizeof(len),1,file) != 1) return (false) ;
+  if (len == 0) return (true) ;
+  return (std::fwrite(vec.data(),sizeof(T),len,file) == len) ;
+}
+
+template <class T>
+bool readVec (std::FILE *file, std::vector<T> &vec)
+{
+  size_t len = 0 ;
+  if (std::fread(&len,sizeof(len),1,file) != 1) return (false) ;
+  if (len > bytesLeft(file)/sizeof(T)) return (false) ;
+  vec.resize(len) ;
+  if (len == 0) return (true) ;
+  return (std::fread(vec.data(),sizeof(T),len,file) == len) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+PackedModel::PackedModel ()
+  : numCols_(0),
+    numRows_(0),
+    starts_(1,0),
+    objSense_(1.0),
+    objOffset_(0.0)
+{ }
+
+/*
+  The matrix held by the solver may have gaps between columns, so pack it as
+  we go. After this, the source object is not used again.
+*/
+PackedModel::PackedModel (ClpSimplexAPI &model)
+{
+  int n = model.numberColumns() ;
+  int m = model.numberRows() ;
+  numCols_ = n ;
+  numRows_ = m ;
+
+  const CoinBigIndex *starts = model.getVectorStarts() ;
+  const int *lengths = model.getVectorLengths() ;
+  const int *indices = model.getIndices() ;
+  const double *elements = model.getElements() ;
+  starts_.resize(n+1) ;
+  indices_.reserve(model.getNumElements()) ;
+  elements_.reserve(model.getNumElements()) ;
+  for (int j = 0 ; j < n ; j++) {
+    starts_[j] = static_cast<CoinBigIndex>(indices_.size()) ;
+    for (CoinBigIndex k = starts[j] ; k < starts[j]+lengths[j] ; k++) {
+      indices_.push_back(indices[k]) ;
+      elements_.push_back(elements[k]) ;
+    }
+  }
+  starts_[n] = static_cast<CoinBigIndex>(indices_.size()) ;
+
+  const double *vec = model.columnLower() ;
+  colLower_.assign(vec,vec+n) ;
+  vec = model.columnUpper() ;
+  colUpper_.assign(vec,vec+n) ;
+  vec = model.objective() ;
+  obj_.assign(vec,vec+n) ;
+  vec = model.rowLower() ;
+  rowLower_.assign(vec,vec+m) ;
+  vec = model.rowUpper() ;
+  rowUpper_.assign(vec,vec+m) ;
+  objSense_ = model.objSense() ;
+  objOffset_ = model.objectiveOffset() ;
+}
+
+/*
+  The objective sense and offset are not part of the matrix, so set them
+  after loading.
+*/
+void PackedModel::loadInto (ClpSimplexAPI &solver) const
+{
+  solver.loadProblem(numCols_,numRows_,
+		     starts_.data(),indices_.data(),elements_.data(),
+		     colLower_.data(),colUpper_.data(),obj_.data(),
+		     rowLower_.data(),rowUpper_.data()) ;
+  solver.setObjSense(objSense_) ;
+  solver.setObjectiveOffset(objOffset_) ;
+}
+
+bool PackedModel::operator== (const PackedModel &rhs) const
+{
+  return (numCols_ == rhs.numCols_ && numRows_ == rhs.numRows_ &&
+	  objSense_ == rhs.objSense_ && objOffset_ == rhs.objOffset_ &&
+	  starts_ == rhs.starts_ && indices_ == rhs.indices_ &&
+	  elements_ == rhs.elements_ &&
+	  colLower_ == rhs.colLower_ && colUpper_ == rhs.colUpper_ &&
+	  obj_ == rhs.obj_ &&
+	  rowLower_ == rhs.rowLower_ && rowUpper_ == rhs.rowUpper_) ;
+}
+
+size_t PackedModel::size () const
+{
+  return (sizeof(CoinBigIndex)*starts_.size()+sizeof(int)*indices_.size()+
+	  sizeof(double)*(elements_.size()+3*numCols_+2*numRows_)) ;
+}
+
+bool PackedModel::write (std::FILE *file) const
+{
+  int dims[2] = { numCols_, numRows_ } ;
+  double objInfo[2] = { objSense_, objOffset_ } ;
+  return (std::fwrite(dims,sizeof(int),2,file) == 2 &&
+	  std::fwrite(objInfo,sizeof(double),2,file) == 2 &&
+	  writeVec(file,starts_) && writeVec(file,indices_) &&
+	  writeVec(file,elements_) &&
+	  writeVec(file,colLower_) && writeVec(file,colUpper_) &&
+	  writeVec(file,obj_) &&
+	  writeVec(file,rowLower_) && writeVec(file,rowUpper_)) ;
+}
+
+/*
+  Check that the array lengths are consistent with the dimensions, so that a
+  truncated or damaged file can't lead loadInto astray.
+*/
+bool PackedModel::read (std::FILE *file)
+{
+  int dims[2] ;
+  double objInfo[2] ;
+  if (std::fread(dims,sizeof(int),2,file) != 2 ||
+      std::fread(objInfo,sizeof(double),2,file) != 2) return (false) ;
+  if (!(readVec(file,starts_) && readVec(file,indices_) &&
+	readVec(file,elements_) &&
+	readVec(file,colLower_) && readVec(file,colUpper_) &&
+	readVec(file,obj_) &&
+	readVec(file,rowLower_) && readVec(file,rowUpper_))) return (false) ;
+  numCols_ = dims[0] ;
+  numRows_ = dims[1] ;
+  objSense_ = objInfo[0] ;
+  objOffset_ = objInfo[1] ;
+  size_t n = static_cast<size_t>(numCols_) ;
+  size_t m = static_cast<size_t>(numRows_) ;
+  return (starts_.size() == n+1 &&
+	  static_cast<size_t>(starts_[n]) == indices_.size() &&
+	  elements_.size() == indices_.size() &&
+	  colLower_.size() == n && colUpper_.size() == n && obj_.size() == n &&
+	  rowLower_.size() == m && rowUpper_.size() == m) ;
+}
+
+} // namespace Osi2
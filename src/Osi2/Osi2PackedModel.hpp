@@ -0,0 +1,85 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2PackedModel.hpp
+
+  Defines PackedModel, a read-only copy of the problem held by a
+  ClpSimplexAPI object.
+*/
+
+#ifndef Osi2PackedModel_HPP
+#define Osi2PackedModel_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+namespace Osi2 {
+
+/*! \brief A packed copy of a problem
+
+  Holds the constraint matrix (column-major, without gaps), bounds,
+  objective, and objective sense and offset of the problem held by a
+  ClpSimplexAPI object. Once constructed, a PackedModel is never modified,
+  so any number of threads can load it into their own solvers concurrently.
+*/
+class PackedModel {
+
+public:
+
+  /// Default constructor; an empty problem
+  PackedModel() ;
+  /// Constructor; copies the problem held by \p model
+  PackedModel(ClpSimplexAPI &model) ;
+
+  /// Load the problem into \p solver, including objective sense and offset
+  void loadInto(ClpSimplexAPI &solver) const ;
+
+  /// Number of columns
+  int getNumCols() const { return (numCols_) ; }
+  /// Number of rows
+  int getNumRows() const { return (numRows_) ; }
+
+  /// True if the two problems are identical, value for value
+  bool operator==(const PackedModel &rhs) const ;
+
+  /// Memory used by the arrays, in bytes
+  size_t size() const ;
+
+  /*! \brief Write the problem to \p file in binary form
+
+    The format is native (byte order, word size) and intended for caches
+    local to one machine. Returns false on a write error.
+  */
+  bool write(std::FILE *file) const ;
+  /// Read a problem written by #write; returns false on error
+  bool read(std::FILE *file) ;
+
+private:
+
+  int numCols_ ;
+  int numRows_ ;
+  std::vector<CoinBigIndex> starts_ ;
+  std::vector<int> indices_ ;
+  std::vector<double> elements_ ;
+  std::vector<double> colLower_ ;
+  std::vector<double> colUpper_ ;
+  std::vector<double> obj_ ;
+  std::vector<double> rowLower_ ;
+  std::vector<double> rowUpper_ ;
+  double objSense_ ;
+  double objOffset_ ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
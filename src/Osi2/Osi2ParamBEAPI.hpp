@@ -43,6 +43,15 @@ public:
   /// Return the "ident" string for the parameter management back-end %API.
   inline static const char *getAPIIDString () { return ("ParamBEAPI") ; }
 
+  /*! \brief Parameter value types
+
+    The value types that parameter management can copy without help from the
+    user. A parameter of any other type is reported as OpaqueKind; its blob
+    is passed through #get and #set but only the implementor knows its
+    contents.
+  */
+  enum ParamKind { IntKind = 0, DblKind, StrKind, OpaqueKind } ;
+
 /*! \name Backend parameter reporting and manipulation methods.
 
   These methods are implemented by an API that supports parameter management.
@@ -75,6 +84,13 @@ public:
     false means the parameter was not set.
   */
   virtual bool set(const char *ident, const void *&blob) = 0 ;
+
+  /*! Report the value type of the requested parameter
+
+    For IntKind, DblKind, and StrKind, the blob for #get and #set is a
+    pointer to an int, double, or std::string, respectively.
+  */
+  virtual ParamKind getKind(const char *ident) = 0 ;
 //@}
 
 } ;
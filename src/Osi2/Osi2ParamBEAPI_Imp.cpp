@@ -59,6 +59,21 @@ bool ParamBEAPI_Imp<Client>::set (const char *paramID, const void *&blob)
   return (true) ;
 }
 
+/*
+  Report the parameter's value type. Use find here rather than operator[]; an
+  unknown parameter shouldn't acquire a null entry.
+*/
+template<class Client>
+ParamBEAPI::ParamKind ParamBEAPI_Imp<Client>::getKind (const char *paramID)
+{
+  typename EntryForParamMap::const_iterator iter =
+      entryForParam_.find(paramID) ;
+  if (iter == entryForParam_.end() || iter->second == nullptr) {
+    return (OpaqueKind) ;
+  }
+  return (iter->second->getKind()) ;
+}
+
 /*
   Boilerplate: Constructors, destructors, & such like
 */
@@ -24,6 +24,23 @@
 
 namespace Osi2 {
 
+/*! \brief Map a parameter value type to a ParamBEAPI::ParamKind
+
+  Types other than int, double, and std::string are opaque.
+*/
+template<class ValType>
+struct ParamKindOf
+{ static const ParamBEAPI::ParamKind kind = ParamBEAPI::OpaqueKind ; } ;
+template<>
+struct ParamKindOf<int>
+{ static const ParamBEAPI::ParamKind kind = ParamBEAPI::IntKind ; } ;
+template<>
+struct ParamKindOf<double>
+{ static const ParamBEAPI::ParamKind kind = ParamBEAPI::DblKind ; } ;
+template<>
+struct ParamKindOf<std::string>
+{ static const ParamBEAPI::ParamKind kind = ParamBEAPI::StrKind ; } ;
+
 /*! \brief An implementation of the parameter management back end.
 
   This class implements the ParamBEAPI methods that must be supplied by
@@ -135,6 +152,12 @@ public:
     false means the parameter was not set.
   */
   bool set(const char *ident, const void *&blob) ;
+
+  /*! \brief Report the value type of the requested parameter
+
+    An unknown parameter is reported as OpaqueKind.
+  */
+  ParamKind getKind(const char *ident) ;
 //@}
 
 /*! \name Utilities for use by the client object
@@ -218,6 +241,8 @@ public:
     virtual bool get (Client *obj, void *&blob) = 0 ;
     /// Interface to the set method
     virtual bool set (Client *obj, const void *&blob) = 0 ;
+    /// Value type of the parameter
+    virtual ParamKind getKind () const = 0 ;
   } ;
 
   /*! \brief Parameter list entry (specific get/set)
@@ -276,6 +301,9 @@ public:
       return (true) ;
     }
 
+    /// Value type of the parameter
+    ParamKind getKind () const { return (ParamKindOf<ValType>::kind) ; }
+
     private:
 
     /// Pointer-to-member get function in the client class
@@ -343,6 +371,9 @@ public:
       return (true) ;
     }
 
+    /// Value type of the parameter
+    ParamKind getKind () const { return (ParamKindOf<ValType>::kind) ; }
+
     private:
 
     /// Parameter specifier
@@ -406,6 +437,9 @@ public:
       return (true) ;
     }
 
+    /// Value type of the parameter (always opaque)
+    ParamKind getKind () const { return (OpaqueKind) ; }
+
     private:
 
     /// Pointer-to-member get function in the client class
@@ -16,14 +16,16 @@
 
 #include "Osi2ParamFEAPI.hpp"
 #include "Osi2ParamBEAPI.hpp"
+#include "Osi2ParamSnapshot.hpp"
 
 namespace Osi2 {
 
 /*! \brief OSI2 Parameter Management %API
 
   This class defines the interface for the OSI2 parameter management %API.
-  It's a trivial extension of the basic interface defined in ParamFEAPI,
-  adding virtual constructors, a destructor, and log control.
+  It extends the basic interface defined in ParamFEAPI with virtual
+  constructors, a destructor, log control, and methods to capture and
+  reapply all parameters of an object in one pass.
 
   \todo
   This class is really unnecessary. Its main purpose in life is to provide a
@@ -61,6 +63,43 @@ public:
 
 //@}
 
+/*! \name Parameter snapshots
+
+  Capture the values of all parameters exported by an enrolled object and
+  reapply them later, to the same object or to another object enrolled with
+  the same set of parameters. Parameters of opaque type are not captured.
+*/
+//@{
+
+  /*! \brief Capture the parameter values of an enrolled object
+
+    Returns an empty snapshot if \p ident is not registered.
+  */
+  virtual ParamSnapshot snapshot(std::string ident) = 0 ;
+
+  /// Apply all values in \p snap to the object enrolled as \p ident
+  virtual bool restore(std::string ident, const ParamSnapshot &snap) = 0 ;
+
+  /*! \brief Apply selected values in \p snap to the object enrolled as
+	     \p ident
+
+    Only the parameters named in \p which are applied. Typically \p which is
+    the result of #diff, so that only the parameters that changed are pushed
+    to the object.
+  */
+  virtual bool restore(std::string ident, const ParamSnapshot &snap,
+		       const std::vector<std::string> &which) = 0 ;
+
+  /*! \brief List the parameters whose values differ between two snapshots
+
+    Returns the ids of the entries of \p after that are absent from
+    \p before or hold a different value.
+  */
+  virtual std::vector<std::string> diff(const ParamSnapshot &before,
+					const ParamSnapshot &after) const = 0 ;
+
+//@}
+
 } ;
 
 } // namespace Osi2 ;
@@ -49,6 +49,8 @@ static OneParamMgmtAPIMessage us_english[] = {
     // Information: 0 -- 2999
 
     { PMMGAPI_INIT, 0, 7, "Parameter Management API constructor (%s)." },
+    { PMMGAPI_OPAQUE, 1, 5,
+      "Ident \"%s\": parameter \"%s\" has opaque type; not captured." },
 
     // Warning: 3000 -- 5999
 
@@ -62,6 +64,8 @@ static OneParamMgmtAPIMessage us_english[] = {
       "Ident \"%s\": parameter \"%s\" not registered." },
     { PMMGAPI_OPFAIL, 6003, 3,
       "Ident \"%s\": %s failed for parameter \"%s\"." },
+    { PMMGAPI_KINDMISMATCH, 6004, 3,
+      "Ident \"%s\": snapshot type for parameter \"%s\" does not match." },
 
     // Fatal Error: 9000 -- 9999
 
@@ -21,11 +21,13 @@ namespace Osi2 {
 
 enum ParamMgmtAPIMsg {
     PMMGAPI_INIT,
+    PMMGAPI_OPAQUE,
     PMMGAPI_NOSUPPORT,
     PMMGAPI_DUPIDENT,
     PMMGAPI_UNREG,
     PMMGAPI_PARMUNREG,
     PMMGAPI_OPFAIL,
+    PMMGAPI_KINDMISMATCH,
     PMMGAPI_NOPLUGMGR,
     PMMGAPI_DUMMY_END
 };
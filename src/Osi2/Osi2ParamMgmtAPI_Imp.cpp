@@ -6,6 +6,7 @@
   Managememt API.
 */
 
+#include <algorithm>
 #include <cstring>
 
 #include "Osi2Config.h"
@@ -231,6 +232,208 @@ bool ParamMgmtAPI_Imp::set (std::string objIdent, std::string param,
   return (true) ;
 }
 
+/*
+  Capture all parameters exported by an enrolled object. We walk the list of
+  exported parameters once, asking the back end for the type of each and
+  then for its value. Opaque parameters can't be captured; they're noted and
+  skipped.
+*/
+ParamSnapshot ParamMgmtAPI_Imp::snapshot (std::string objIdent)
+{
+  ParamSnapshot snap ;
+/*
+  Check that the prefix is registered and complain if it isn't.
+*/
+  IndexMap::iterator iter = indexMap_.find(objIdent) ;
+  if (iter == indexMap_.end()) {
+    msgHandler_->message(PMMGAPI_UNREG, msgs_)
+        << objIdent << CoinMessageEol ;
+    return (snap) ;
+  }
+  const ObjData &objData = iter->second ;
+  ParamBEAPI *hdlr = objData.paramHandler_ ;
+/*
+  Walk the exported parameters and capture the value of each.
+*/
+  snap.reserve(static_cast<int>(objData.paramNames_.size())) ;
+  for (int ndx = 0 ; ndx < objData.paramNames_.size() ; ndx++) {
+    const char *param = objData.paramNames_[ndx] ;
+    bool ok = true ;
+    switch (hdlr->getKind(param)) {
+      case ParamBEAPI::IntKind: {
+	int val = 0 ;
+	void *blob = &val ;
+	ok = hdlr->get(param,blob) ;
+	if (ok) snap.addInt(param,val) ;
+	break ;
+      }
+      case ParamBEAPI::DblKind: {
+	double val = 0.0 ;
+	void *blob = &val ;
+	ok = hdlr->get(param,blob) ;
+	if (ok) snap.addDbl(param,val) ;
+	break ;
+      }
+      case ParamBEAPI::StrKind: {
+	std::string val ;
+	void *blob = &val ;
+	ok = hdlr->get(param,blob) ;
+	if (ok) snap.addStr(param,val) ;
+	break ;
+      }
+      default: {
+	msgHandler_->message(PMMGAPI_OPAQUE,msgs_)
+	  << objIdent << param << CoinMessageEol ;
+	break ;
+      }
+    }
+    if (!ok) {
+      msgHandler_->message(PMMGAPI_OPFAIL,msgs_)
+	<< objIdent << "snapshot" << param << CoinMessageEol ;
+    }
+  }
+
+  snap.sortIndex() ;
+
+  return (snap) ;
+}
+
+/*
+  Apply one entry of a snapshot. The back end must agree on the type of the
+  parameter; that also catches parameters it doesn't know.
+*/
+bool ParamMgmtAPI_Imp::restoreOne (const std::string &objIdent,
+				   ParamBEAPI *hdlr,
+				   const ParamSnapshot &snap, int ndx)
+{
+  const char *param = snap.getId(ndx).c_str() ;
+  ParamBEAPI::ParamKind kind = snap.getKind(ndx) ;
+  if (hdlr->getKind(param) != kind) {
+    msgHandler_->message(PMMGAPI_KINDMISMATCH,msgs_)
+      << objIdent << param << CoinMessageEol ;
+    return (false) ;
+  }
+  bool ok = false ;
+  switch (kind) {
+    case ParamBEAPI::IntKind: {
+      int val = snap.getInt(ndx) ;
+      const void *blob = &val ;
+      ok = hdlr->set(param,blob) ;
+      break ;
+    }
+    case ParamBEAPI::DblKind: {
+      double val = snap.getDbl(ndx) ;
+      const void *blob = &val ;
+      ok = hdlr->set(param,blob) ;
+      break ;
+    }
+    case ParamBEAPI::StrKind: {
+      std::string val = snap.getStr(ndx) ;
+      const void *blob = &val ;
+      ok = hdlr->set(param,blob) ;
+      break ;
+    }
+    default: {
+      break ;
+    }
+  }
+  if (!ok) {
+    msgHandler_->message(PMMGAPI_OPFAIL,msgs_)
+      << objIdent << "restore" << param << CoinMessageEol ;
+  }
+  return (ok) ;
+}
+
+/*
+  Reapply a snapshot in one pass. We carry on past failures so that as much
+  of the snapshot as possible is applied, and report overall success.
+*/
+bool ParamMgmtAPI_Imp::restore (std::string objIdent,
+				const ParamSnapshot &snap)
+{
+  IndexMap::iterator iter = indexMap_.find(objIdent) ;
+  if (iter == indexMap_.end()) {
+    msgHandler_->message(PMMGAPI_UNREG, msgs_)
+        << objIdent << CoinMessageEol ;
+    return (false) ;
+  }
+  ParamBEAPI *hdlr = iter->second.paramHandler_ ;
+
+  bool retval = true ;
+  for (int ndx = 0 ; ndx < snap.size() ; ndx++) {
+    if (!restoreOne(objIdent,hdlr,snap,ndx)) retval = false ;
+  }
+  return (retval) ;
+}
+
+/*
+  As above, but apply only the parameters named in which. The names are
+  sorted and merged against the snapshot's index by id, so the cost is one
+  pass over the snapshot rather than a search per name. The matches are
+  applied in snapshot order, as a full restore would apply them.
+*/
+bool ParamMgmtAPI_Imp::restore (std::string objIdent,
+				const ParamSnapshot &snap,
+				const std::vector<std::string> &which)
+{
+  IndexMap::iterator iter = indexMap_.find(objIdent) ;
+  if (iter == indexMap_.end()) {
+    msgHandler_->message(PMMGAPI_UNREG, msgs_)
+        << objIdent << CoinMessageEol ;
+    return (false) ;
+  }
+  ParamBEAPI *hdlr = iter->second.paramHandler_ ;
+
+  std::vector<std::string> wanted(which) ;
+  std::sort(wanted.begin(),wanted.end()) ;
+  wanted.erase(std::unique(wanted.begin(),wanted.end()),wanted.end()) ;
+  std::vector<int> scratch ;
+  const std::vector<int> &order = snap.byId(scratch) ;
+
+  bool retval = true ;
+  std::vector<int> found ;
+  found.reserve(wanted.size()) ;
+  int pos = 0 ;
+  for (int ndx = 0 ; ndx < wanted.size() ; ndx++) {
+    while (pos < order.size() && snap.getId(order[pos]) < wanted[ndx]) pos++ ;
+    if (pos < order.size() && snap.getId(order[pos]) == wanted[ndx]) {
+      found.push_back(order[pos]) ;
+    } else {
+      msgHandler_->message(PMMGAPI_PARMUNREG,msgs_)
+	<< objIdent << wanted[ndx] << CoinMessageEol ;
+      retval = false ;
+    }
+  }
+  std::sort(found.begin(),found.end()) ;
+  for (int ndx = 0 ; ndx < found.size() ; ndx++) {
+    if (!restoreOne(objIdent,hdlr,snap,found[ndx])) retval = false ;
+  }
+  return (retval) ;
+}
+
+/*
+  List the entries of after that are new or changed relative to before.
+  Snapshots of objects with the same parameter set hold their entries in the
+  same order, so check the matching position first and search only if the
+  ids disagree.
+*/
+std::vector<std::string> ParamMgmtAPI_Imp::diff (const ParamSnapshot &before,
+						 const ParamSnapshot &after)
+  const
+{
+  std::vector<std::string> changed ;
+  for (int ndx = 0 ; ndx < after.size() ; ndx++) {
+    int beforeNdx = ndx ;
+    if (ndx >= before.size() || before.getId(ndx) != after.getId(ndx)) {
+      beforeNdx = before.find(after.getId(ndx)) ;
+    }
+    if (beforeNdx < 0 || !after.sameValue(ndx,before,beforeNdx)) {
+      changed.push_back(after.getId(ndx)) ;
+    }
+  }
+  return (changed) ;
+}
+
 /*
   Boilerplate: Constructors, destructors, & such like
 */
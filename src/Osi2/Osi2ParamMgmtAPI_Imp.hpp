@@ -75,6 +75,25 @@ public:
 
 //@}
 
+/*! \name Parameter snapshots */
+//@{
+
+  /// Capture the parameter values of an enrolled object
+  ParamSnapshot snapshot(std::string ident) ;
+
+  /// Apply all values in a snapshot to an enrolled object
+  bool restore(std::string ident, const ParamSnapshot &snap) ;
+
+  /// Apply selected values in a snapshot to an enrolled object
+  bool restore(std::string ident, const ParamSnapshot &snap,
+	       const std::vector<std::string> &which) ;
+
+  /// List the parameters whose values differ between two snapshots
+  std::vector<std::string> diff(const ParamSnapshot &before,
+				const ParamSnapshot &after) const ;
+
+//@}
+
 
 /*! \name ParamMgmt API control methods
 
@@ -133,6 +152,10 @@ private:
   /// Index map to track enrolled objects
   IndexMap indexMap_ ;
 
+  /// Apply entry \p ndx of \p snap through \p hdlr
+  bool restoreOne(const std::string &ident, ParamBEAPI *hdlr,
+		  const ParamSnapshot &snap, int ndx) ;
+
   /// Indicator; false if the message handler belongs to the client
   bool dfltHandler_ ;
   /// Message handler
@@ -0,0 +1,174 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ParamSnapshot.hpp
+
+  Defines ParamSnapshot, a compact record of the parameter values of an
+  object enrolled with the parameter manager.
+*/
+
+#ifndef Osi2ParamSnapshot_HPP
+#define Osi2ParamSnapshot_HPP
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Osi2ParamBEAPI.hpp"
+
+namespace Osi2 {
+
+/*! \brief A snapshot of an object's parameter values
+
+  Created by ParamMgmtAPI::snapshot and consumed by ParamMgmtAPI::restore.
+  Entries are held in parallel arrays (id, kind, value) in the order the
+  parameters were captured. Integer and double values live in the value slot;
+  string values are packed end to end in a single character buffer and the
+  value slot records their offset and length. An index of the entries in
+  order of id (#sortIndex) lets a list of ids be matched in one pass; it
+  goes stale when an entry is added.
+
+  Only parameters of kind IntKind, DblKind, and StrKind can be captured.
+*/
+class ParamSnapshot {
+
+public:
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /// Default constructor (empty snapshot)
+  ParamSnapshot () { }
+  /// Destructor
+  ~ParamSnapshot () { }
+  //@}
+
+  /*! \name Methods to build a snapshot */
+  //@{
+  /// Reserve space for \p cnt entries
+  void reserve (int cnt)
+  { ids_.reserve(cnt) ; kinds_.reserve(cnt) ; vals_.reserve(cnt) ; }
+
+  /// Add an integer parameter value
+  void addInt (const char *ident, int val)
+  { Slot slot ; slot.int_ = val ; append(ident,ParamBEAPI::IntKind,slot) ; }
+
+  /// Add a double parameter value
+  void addDbl (const char *ident, double val)
+  { Slot slot ; slot.dbl_ = val ; append(ident,ParamBEAPI::DblKind,slot) ; }
+
+  /// Add a string parameter value
+  void addStr (const char *ident, const std::string &val)
+  { Slot slot ;
+    slot.str_.off_ = chars_.size() ;
+    slot.str_.len_ = val.size() ;
+    chars_.append(val) ;
+    append(ident,ParamBEAPI::StrKind,slot) ; }
+
+  /// Remove all entries
+  void clear ()
+  { ids_.clear() ; kinds_.clear() ; vals_.clear() ; chars_.clear() ;
+    order_.clear() ; }
+
+  /// Build the index of entries in order of id
+  void sortIndex () { order_ = sortedOrder() ; }
+  //@}
+
+  /*! \name Methods to examine a snapshot */
+  //@{
+  /// Number of entries
+  int size () const { return (static_cast<int>(ids_.size())) ; }
+
+  /// Parameter id of entry \p ndx
+  const std::string &getId (int ndx) const { return (ids_[ndx]) ; }
+
+  /// Value type of entry \p ndx
+  ParamBEAPI::ParamKind getKind (int ndx) const
+  { return (static_cast<ParamBEAPI::ParamKind>(kinds_[ndx])) ; }
+
+  /// Value of integer entry \p ndx
+  int getInt (int ndx) const { return (vals_[ndx].int_) ; }
+
+  /// Value of double entry \p ndx
+  double getDbl (int ndx) const { return (vals_[ndx].dbl_) ; }
+
+  /// Value of string entry \p ndx
+  std::string getStr (int ndx) const
+  { return (chars_.substr(vals_[ndx].str_.off_,vals_[ndx].str_.len_)) ; }
+
+  /// Index of the entry for parameter \p ident, or -1 if absent
+  int find (const std::string &ident) const
+  { for (int ndx = 0 ; ndx < size() ; ndx++) {
+      if (ids_[ndx] == ident) return (ndx) ;
+    }
+    return (-1) ; }
+
+  /*! \brief Entry indices in order of id
+
+    Returns the index built by #sortIndex if it covers every entry;
+    otherwise sorts into \p scratch and returns that.
+  */
+  const std::vector<int> &byId (std::vector<int> &scratch) const
+  { if (order_.size() == ids_.size()) return (order_) ;
+    scratch = sortedOrder() ;
+    return (scratch) ; }
+
+  /// True if entry \p ndx here and entry \p rhsNdx in \p rhs hold equal values
+  bool sameValue (int ndx, const ParamSnapshot &rhs, int rhsNdx) const
+  { if (kinds_[ndx] != rhs.kinds_[rhsNdx]) return (false) ;
+    const Slot &lval = vals_[ndx] ;
+    const Slot &rval = rhs.vals_[rhsNdx] ;
+    switch (getKind(ndx)) {
+      case ParamBEAPI::IntKind: { return (lval.int_ == rval.int_) ; }
+      case ParamBEAPI::DblKind: { return (lval.dbl_ == rval.dbl_) ; }
+      case ParamBEAPI::StrKind: {
+	return (lval.str_.len_ == rval.str_.len_ &&
+		chars_.compare(lval.str_.off_,lval.str_.len_,
+			       rhs.chars_,rval.str_.off_,rval.str_.len_) == 0) ;
+      }
+      default: { return (false) ; }
+    }
+  }
+  //@}
+
+private:
+
+  /// Value slot; a string value is an (offset, length) pair in #chars_
+  union Slot {
+    int int_ ;
+    double dbl_ ;
+    struct { size_t off_ ; size_t len_ ; } str_ ;
+  } ;
+
+  /// Entry indices sorted by id
+  std::vector<int> sortedOrder () const
+  { std::vector<int> order(ids_.size()) ;
+    for (int ndx = 0 ; ndx < size() ; ndx++) order[ndx] = ndx ;
+    std::stable_sort(order.begin(),order.end(),
+		     [this] (int a, int b) { return (ids_[a] < ids_[b]) ; }) ;
+    return (order) ; }
+
+  /// Append an entry
+  void append (const char *ident, ParamBEAPI::ParamKind kind, const Slot &val)
+  { ids_.push_back(ident) ;
+    kinds_.push_back(static_cast<char>(kind)) ;
+    vals_.push_back(val) ; }
+
+  /// Parameter ids
+  std::vector<std::string> ids_ ;
+  /// Parameter value types
+  std::vector<char> kinds_ ;
+  /// Parameter values
+  std::vector<Slot> vals_ ;
+  /// String values, packed end to end
+  std::string chars_ ;
+  /// Entry indices in order of id; current only if it covers every entry
+  std::vector<int> order_ ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
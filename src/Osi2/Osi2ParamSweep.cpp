@@ -0,0 +1,232 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for ParamSweep.
+*/
+
+#include <chrono>
+#include <thread>
+
+#include "Osi2Config.h"
+
+#include "Osi2ParamSweep.hpp"
+
+namespace Osi2 {
+
+ParamSweep::ParamSweep (ControlAPI &ctrl, ClpSimplexAPI &model)
+  : ctrl_(ctrl),
+    model_(model),
+    next_(0)
+{ }
+
+/*
+  Destructor. We own the profiles.
+*/
+ParamSweep::~ParamSweep ()
+{
+  clearProfiles() ;
+}
+
+void ParamSweep::clearProfiles ()
+{
+  for (int ndx = 0 ; ndx < profiles_.size() ; ndx++) {
+    delete profiles_[ndx] ;
+  }
+  profiles_.clear() ;
+  results_.clear() ;
+}
+
+void ParamSweep::addProfile (const RunParamsAPI &profile)
+{
+  profiles_.push_back(profile.clone()) ;
+}
+
+void ParamSweep::addIntAxis (const std::string &id,
+			     const std::vector<int> &vals)
+{
+  Axis axis ;
+  axis.id_ = id ;
+  axis.kind_ = IntAxis ;
+  axis.ints_ = vals ;
+  axes_.push_back(axis) ;
+}
+
+void ParamSweep::addDblAxis (const std::string &id,
+			     const std::vector<double> &vals)
+{
+  Axis axis ;
+  axis.id_ = id ;
+  axis.kind_ = DblAxis ;
+  axis.dbls_ = vals ;
+  axes_.push_back(axis) ;
+}
+
+void ParamSweep::addStrAxis (const std::string &id,
+			     const std::vector<std::string> &vals)
+{
+  Axis axis ;
+  axis.id_ = id ;
+  axis.kind_ = StrAxis ;
+  axis.strs_ = vals ;
+  axes_.push_back(axis) ;
+}
+
+int ParamSweep::Axis::size () const
+{
+  switch (kind_) {
+    case IntAxis: { return (static_cast<int>(ints_.size())) ; }
+    case DblAxis: { return (static_cast<int>(dbls_.size())) ; }
+    default: { return (static_cast<int>(strs_.size())) ; }
+  }
+}
+
+/*
+  Use add rather than set: set is a no-op for a parameter that isn't in the
+  base, and the grid point would silently collapse onto the base values.
+*/
+void ParamSweep::Axis::apply (RunParamsAPI &profile, int ndx) const
+{
+  switch (kind_) {
+    case IntAxis: { profile.addIntParam(id_,ints_[ndx]) ; break ; }
+    case DblAxis: { profile.addDblParam(id_,dbls_[ndx]) ; break ; }
+    default: { profile.addStrParam(id_,strs_[ndx]) ; break ; }
+  }
+}
+
+/*
+  Walk the grid as an odometer: pos[k] is the position on axis k, and the
+  last axis turns fastest. Clones of base share its parameter store until
+  the axis values are applied, so this is cheap.
+*/
+int ParamSweep::buildGrid (const RunParamsAPI &base)
+{
+  int axisCnt = static_cast<int>(axes_.size()) ;
+  for (int k = 0 ; k < axisCnt ; k++) {
+    if (axes_[k].size() == 0) {
+      axes_.clear() ;
+      return (0) ;
+    }
+  }
+  std::vector<int> pos(axisCnt,0) ;
+  int added = 0 ;
+  while (true) {
+    RunParamsAPI *profile = base.clone() ;
+    for (int k = 0 ; k < axisCnt ; k++) {
+      axes_[k].apply(*profile,pos[k]) ;
+    }
+    profiles_.push_back(profile) ;
+    added++ ;
+
+    int k = axisCnt-1 ;
+    while (k >= 0 && ++pos[k] >= axes_[k].size()) {
+      pos[k] = 0 ;
+      k-- ;
+    }
+    if (k < 0) break ;
+  }
+  axes_.clear() ;
+
+  return (added) ;
+}
+
+/*
+  Load the shared model into the solver, apply the profile, and solve. The
+  model sets the objective sense and offset; the profile can override them.
+*/
+void ParamSweep::solveOne (ClpSimplexAPI *solver, int ndx)
+{
+  typedef std::chrono::steady_clock Clock ;
+  Result &result = results_[ndx] ;
+  Clock::time_point start = Clock::now() ;
+
+  model_.loadInto(*solver) ;
+  solver->loadParams(*profiles_[ndx]) ;
+  result.retval_ = solver->initialSolve() ;
+
+  std::chrono::duration<double> elapsed = Clock::now()-start ;
+  result.seconds_ = elapsed.count() ;
+  result.status_ = solver->status() ;
+  result.secondaryStatus_ = solver->secondaryStatus() ;
+  result.iterations_ = solver->numberIterations() ;
+  result.objective_ = solver->objectiveValue() ;
+}
+
+/*
+  Claim profiles until there are none left. Each profile is claimed by
+  exactly one worker, and each worker writes only its own entries in
+  results_, so no further locking is needed.
+*/
+void ParamSweep::work (ClpSimplexAPI *solver)
+{
+  int profileCnt = getProfileCnt() ;
+  for (int ndx = next_++ ; ndx < profileCnt ; ndx = next_++) {
+    solveOne(solver,ndx) ;
+  }
+}
+
+/*
+  Create the solver objects here, in the calling thread; object creation
+  goes through the plugin manager, which is not safe to call concurrently.
+  Then start a thread for each solver and wait for them all to finish.
+*/
+int ParamSweep::run (int workers)
+{
+  int profileCnt = getProfileCnt() ;
+  Result notRun = { -1, -1, -1, 0, 0.0, 0.0 } ;
+  results_.assign(profileCnt,notRun) ;
+  if (profileCnt == 0) return (0) ;
+
+  if (workers < 1) {
+    workers = static_cast<int>(std::thread::hardware_concurrency()) ;
+    if (workers < 1) workers = 1 ;
+  }
+  if (workers > profileCnt) workers = profileCnt ;
+
+  std::vector<API *> apiObjs ;
+  std::vector<ClpSimplexAPI *> solvers ;
+  for (int ndx = 0 ; ndx < workers ; ndx++) {
+    API *apiObj = nullptr ;
+    int retval =
+      ctrl_.createObject(apiObj,ClpSimplexAPI::getAPIIDString()) ;
+    if (retval != 0 || apiObj == nullptr) break ;
+    void *tmp = apiObj->getAPIPtr(ClpSimplexAPI::getAPIIDString()) ;
+    if (tmp == nullptr) {
+      ctrl_.destroyObject(apiObj) ;
+      break ;
+    }
+    apiObjs.push_back(apiObj) ;
+    solvers.push_back(static_cast<ClpSimplexAPI *>(tmp)) ;
+  }
+  if (solvers.size() == 0) return (-1) ;
+/*
+  Run the workers. With only one solver, there's no point in starting a
+  thread.
+*/
+  next_ = 0 ;
+  if (solvers.size() == 1) {
+    work(solvers[0]) ;
+  } else {
+    std::vector<std::thread> threads ;
+    for (int ndx = 0 ; ndx < solvers.size() ; ndx++) {
+      threads.push_back(std::thread(&ParamSweep::work,this,solvers[ndx])) ;
+    }
+    for (int ndx = 0 ; ndx < threads.size() ; ndx++) {
+      threads[ndx].join() ;
+    }
+  }
+
+  for (int ndx = 0 ; ndx < apiObjs.size() ; ndx++) {
+    ctrl_.destroyObject(apiObjs[ndx]) ;
+  }
+
+  int failures = 0 ;
+  for (int ndx = 0 ; ndx < profileCnt ; ndx++) {
+    if (results_[ndx].retval_ != 0) failures++ ;
+  }
+  return (failures) ;
+}
+
+} // namespace Osi2
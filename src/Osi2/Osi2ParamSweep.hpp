@@ -0,0 +1,163 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ParamSweep.hpp
+
+  Defines ParamSweep, a utility to solve one model under many parameter
+  profiles in parallel.
+*/
+
+#ifndef Osi2ParamSweep_HPP
+#define Osi2ParamSweep_HPP
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "Osi2ControlAPI.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2RunParamsAPI.hpp"
+#include "Osi2PackedModel.hpp"
+
+namespace Osi2 {
+
+/*! \brief Solve a model under a set of parameter profiles
+
+  A ParamSweep is constructed from a ControlAPI object, used to create and
+  destroy solver objects, and a ClpSimplexAPI object holding the model. The
+  model is copied once, at construction, into a PackedModel that is shared
+  by all workers; the source object is not touched again.
+
+  Profiles (RunParamsAPI objects) are added one at a time with #addProfile
+  or generated as the cartesian product of a set of axes with #buildGrid.
+  #run then solves the model once for each profile, using a pool of workers.
+  Each worker owns a solver object; for each profile it takes, it loads the
+  shared model, applies the profile with ClpSimplexAPI::loadParams, and calls
+  ClpSimplexAPI::initialSolve.
+
+  Results are reported in a table indexed by profile.
+*/
+class ParamSweep {
+
+public:
+
+  /// Result of solving the model under one profile
+  struct Result {
+    /// Return code from initialSolve; -1 if the solve was not attempted
+    int retval_ ;
+    /// Problem status (ClpSimplexAPI::status)
+    int status_ ;
+    /// Secondary status (ClpSimplexAPI::secondaryStatus)
+    int secondaryStatus_ ;
+    /// Iteration count
+    int iterations_ ;
+    /// Objective value
+    double objective_ ;
+    /// Wall clock time for load, parameter application, and solve (seconds)
+    double seconds_ ;
+  } ;
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /// Constructor; copies the model held by \p model
+  ParamSweep(ControlAPI &ctrl, ClpSimplexAPI &model) ;
+  /// Destructor
+  ~ParamSweep() ;
+  //@}
+
+  /*! \name Methods to define the profiles */
+  //@{
+  /// Add a copy of \p profile to the list of profiles
+  void addProfile(const RunParamsAPI &profile) ;
+
+  /// Add an axis of integer values for parameter \p id
+  void addIntAxis(const std::string &id, const std::vector<int> &vals) ;
+  /// Add an axis of double values for parameter \p id
+  void addDblAxis(const std::string &id, const std::vector<double> &vals) ;
+  /// Add an axis of string values for parameter \p id
+  void addStrAxis(const std::string &id,
+		  const std::vector<std::string> &vals) ;
+
+  /*! \brief Add one profile for each point of the grid defined by the axes
+
+    Each profile is a copy of \p base with the axis parameters set to the
+    values for the grid point; an axis parameter that isn't in \p base is
+    added. The axes are cleared. Returns the number of
+    profiles added.
+  */
+  int buildGrid(const RunParamsAPI &base) ;
+
+  /// Remove all profiles and results
+  void clearProfiles() ;
+
+  /// Number of profiles
+  int getProfileCnt() const { return (static_cast<int>(profiles_.size())) ; }
+
+  /// Profile \p ndx
+  const RunParamsAPI *getProfile(int ndx) const { return (profiles_[ndx]) ; }
+  //@}
+
+  /*! \name Methods to run the sweep and retrieve results */
+  //@{
+  /*! \brief Solve the model under each profile
+
+    Uses \p workers solver objects, each run in its own thread. If \p workers
+    is less than 1, the number of hardware threads is used. Returns the
+    number of profiles for which the solve could not be attempted or
+    returned a nonzero code, or -1 if no solver object could be created.
+  */
+  int run(int workers = 0) ;
+
+  /// Results of the most recent #run, indexed by profile
+  const std::vector<Result> &getResults() const { return (results_) ; }
+  //@}
+
+private:
+
+  /// Value types for an axis
+  enum AxisKind { IntAxis = 0, DblAxis, StrAxis } ;
+
+  /// An axis of the grid
+  struct Axis {
+    std::string id_ ;
+    AxisKind kind_ ;
+    std::vector<int> ints_ ;
+    std::vector<double> dbls_ ;
+    std::vector<std::string> strs_ ;
+    /// Number of values on the axis
+    int size() const ;
+    /// Set parameter id_ in \p profile to value \p ndx
+    void apply(RunParamsAPI &profile, int ndx) const ;
+  } ;
+
+  /// Solve the model under profile \p ndx with \p solver
+  void solveOne(ClpSimplexAPI *solver, int ndx) ;
+
+  /// Body of a worker thread
+  void work(ClpSimplexAPI *solver) ;
+
+  /// Control object used to create solver objects
+  ControlAPI &ctrl_ ;
+  /// The shared model
+  PackedModel model_ ;
+  /// Profiles (owned)
+  std::vector<RunParamsAPI *> profiles_ ;
+  /// Axes awaiting #buildGrid
+  std::vector<Axis> axes_ ;
+  /// Results, indexed by profile
+  std::vector<Result> results_ ;
+  /// Index of the next profile to be claimed by a worker
+  std::atomic<int> next_ ;
+
+  /// Copying is not supported
+  ParamSweep(const ParamSweep &) ;
+  ParamSweep &operator=(const ParamSweep &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -0,0 +1,441 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for ParamTuner.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+
+#include "Osi2Config.h"
+
+#include "Osi2ParamTuner.hpp"
+#include "Osi2ParamSweep.hpp"
+
+namespace {
+
+/*
+  Split a line of the profile file into tab-separated fields.
+*/
+std::vector<std::string> splitFields (const std::string &line)
+{
+  std::vector<std::string> fields ;
+  std::string::size_type start = 0 ;
+  while (true) {
+    std::string::size_type tab = line.find('\t',start) ;
+    if (tab == std::string::npos) {
+      fields.push_back(line.substr(start)) ;
+      break ;
+    }
+    fields.push_back(line.substr(start,tab-start)) ;
+    start = tab+1 ;
+  }
+  return (fields) ;
+}
+
+/*
+  Order candidates by score, lowest first.
+*/
+struct ScoreLess {
+  const std::vector<double> &score_ ;
+  ScoreLess (const std::vector<double> &score) : score_(score) { }
+  bool operator() (int ndx1, int ndx2) const
+  { return (score_[ndx1] < score_[ndx2]) ; }
+} ;
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+const double ParamTuner::unsolvedPenalty = 10.0 ;
+
+ParamTuner::ParamTuner (ControlAPI &ctrl)
+  : ctrl_(ctrl),
+    firstIters_(1000),
+    maxRounds_(4),
+    workers_(0)
+{ }
+
+ParamTuner::~ParamTuner ()
+{ }
+
+/*
+  Walk the packed columns once, accumulating column lengths directly and
+  row lengths by counting row indices.
+*/
+ParamTuner::Fingerprint ParamTuner::fingerprint (ClpSimplexAPI &model)
+{
+  Fingerprint fp ;
+  int n = model.numberColumns() ;
+  int m = model.numberRows() ;
+  fp.numCols_ = n ;
+  fp.numRows_ = m ;
+  fp.numElems_ = 0 ;
+  fp.maxColLen_ = 0 ;
+  fp.maxRowLen_ = 0 ;
+  fp.colLenDev_ = 0.0 ;
+  fp.rowLenDev_ = 0.0 ;
+
+  const CoinBigIndex *starts = model.getVectorStarts() ;
+  const int *lengths = model.getVectorLengths() ;
+  const int *indices = model.getIndices() ;
+  std::vector<int> rowLens(m,0) ;
+  double colSumSq = 0.0 ;
+  for (int j = 0 ; j < n ; j++) {
+    int len = lengths[j] ;
+    fp.numElems_ += len ;
+    if (len > fp.maxColLen_) fp.maxColLen_ = len ;
+    colSumSq += static_cast<double>(len)*len ;
+    for (CoinBigIndex k = starts[j] ; k < starts[j]+len ; k++) {
+      rowLens[indices[k]]++ ;
+    }
+  }
+  double rowSumSq = 0.0 ;
+  for (int i = 0 ; i < m ; i++) {
+    int len = rowLens[i] ;
+    if (len > fp.maxRowLen_) fp.maxRowLen_ = len ;
+    rowSumSq += static_cast<double>(len)*len ;
+  }
+  double nnz = static_cast<double>(fp.numElems_) ;
+  if (n > 0) {
+    double mean = nnz/n ;
+    fp.colLenDev_ = std::sqrt(std::max(0.0,colSumSq/n-mean*mean)) ;
+  }
+  if (m > 0) {
+    double mean = nnz/m ;
+    fp.rowLenDev_ = std::sqrt(std::max(0.0,rowSumSq/m-mean*mean)) ;
+  }
+
+  return (fp) ;
+}
+
+double ParamTuner::distance (const Fingerprint &fp1, const Fingerprint &fp2)
+{
+  double feat1[7] = { double(fp1.numRows_), double(fp1.numCols_),
+		      double(fp1.numElems_), double(fp1.maxColLen_),
+		      double(fp1.maxRowLen_), fp1.colLenDev_, fp1.rowLenDev_ } ;
+  double feat2[7] = { double(fp2.numRows_), double(fp2.numCols_),
+		      double(fp2.numElems_), double(fp2.maxColLen_),
+		      double(fp2.maxRowLen_), fp2.colLenDev_, fp2.rowLenDev_ } ;
+  double dist = 0.0 ;
+  for (int k = 0 ; k < 7 ; k++) {
+    dist += std::fabs(std::log1p(feat1[k])-std::log1p(feat2[k])) ;
+  }
+  return (dist) ;
+}
+
+void ParamTuner::addIntAxis (const std::string &id,
+			     const std::vector<int> &vals)
+{
+  Axis axis ;
+  axis.id_ = id ;
+  axis.kind_ = IntSetting ;
+  axis.ints_ = vals ;
+  axes_.push_back(axis) ;
+}
+
+void ParamTuner::addDblAxis (const std::string &id,
+			     const std::vector<double> &vals)
+{
+  Axis axis ;
+  axis.id_ = id ;
+  axis.kind_ = DblSetting ;
+  axis.dbls_ = vals ;
+  axes_.push_back(axis) ;
+}
+
+void ParamTuner::addStrAxis (const std::string &id,
+			     const std::vector<std::string> &vals)
+{
+  Axis axis ;
+  axis.id_ = id ;
+  axis.kind_ = StrSetting ;
+  axis.strs_ = vals ;
+  axes_.push_back(axis) ;
+}
+
+/*
+  Successive halving. Each model gets its own ParamSweep, so each model is
+  copied once for the whole search. The first sweep also serves to expand
+  the grid into candidate profiles.
+*/
+bool ParamTuner::tune (std::vector<ClpSimplexAPI *> &models,
+		       const RunParamsAPI &base)
+{
+  if (models.size() == 0 || axes_.size() == 0) return (false) ;
+
+  std::vector<ParamSweep *> sweeps ;
+  for (int m = 0 ; m < models.size() ; m++) {
+    sweeps.push_back(new ParamSweep(ctrl_,*models[m])) ;
+  }
+  ParamSweep &gridSweep = *sweeps[0] ;
+  for (int k = 0 ; k < axes_.size() ; k++) {
+    const Axis &axis = axes_[k] ;
+    switch (axis.kind_) {
+      case IntSetting: { gridSweep.addIntAxis(axis.id_,axis.ints_) ; break ; }
+      case DblSetting: { gridSweep.addDblAxis(axis.id_,axis.dbls_) ; break ; }
+      default: { gridSweep.addStrAxis(axis.id_,axis.strs_) ; break ; }
+    }
+  }
+  gridSweep.buildGrid(base) ;
+  std::vector<RunParamsAPI *> cands ;
+  for (int c = 0 ; c < gridSweep.getProfileCnt() ; c++) {
+    cands.push_back(gridSweep.getProfile(c)->clone()) ;
+  }
+  gridSweep.clearProfiles() ;
+/*
+  Run the rounds. Each round solves every surviving candidate on every
+  model, scores the candidates, and keeps the better half (rounded up).
+  Sorting leaves the best candidate first, so if we run out of rounds
+  before we're down to one candidate, cands[0] is still the winner.
+*/
+  int iters = firstIters_ ;
+  for (int round = 0 ; cands.size() > 1 && round < maxRounds_ ; round++) {
+    std::vector<double> score(cands.size(),0.0) ;
+    for (int m = 0 ; m < sweeps.size() ; m++) {
+      ParamSweep &sweep = *sweeps[m] ;
+      sweep.clearProfiles() ;
+      for (int c = 0 ; c < cands.size() ; c++) {
+	if (iters > 0) {
+	  RunParamsAPI *limited = cands[c]->clone() ;
+	  limited->addIntParam("iter max",iters) ;
+	  sweep.addProfile(*limited) ;
+	  delete limited ;
+	} else {
+	  sweep.addProfile(*cands[c]) ;
+	}
+      }
+      sweep.run(workers_) ;
+      const std::vector<ParamSweep::Result> &results = sweep.getResults() ;
+      double best = -1.0 ;
+      for (int c = 0 ; c < results.size() ; c++) {
+	if (results[c].status_ == 0 &&
+	    (best < 0.0 || results[c].seconds_ < best)) {
+	  best = results[c].seconds_ ;
+	}
+      }
+      for (int c = 0 ; c < results.size() ; c++) {
+	if (results[c].status_ != 0) {
+	  score[c] += unsolvedPenalty ;
+	} else if (best > 0.0) {
+	  score[c] += results[c].seconds_/best ;
+	} else {
+	  score[c] += 1.0 ;
+	}
+      }
+    }
+    std::vector<int> order(cands.size()) ;
+    for (int c = 0 ; c < order.size() ; c++) order[c] = c ;
+    std::stable_sort(order.begin(),order.end(),ScoreLess(score)) ;
+    int keep = static_cast<int>((cands.size()+1)/2) ;
+    std::vector<RunParamsAPI *> survivors ;
+    for (int c = 0 ; c < order.size() ; c++) {
+      if (c < keep) {
+	survivors.push_back(cands[order[c]]) ;
+      } else {
+	delete cands[order[c]] ;
+      }
+    }
+    cands = survivors ;
+    if (iters > 0) iters *= 2 ;
+  }
+  for (int m = 0 ; m < sweeps.size() ; m++) delete sweeps[m] ;
+  if (cands.size() == 0) return (false) ;
+/*
+  Record the winning settings under the fingerprint of each model.
+*/
+  const RunParamsAPI &winner = *cands[0] ;
+  Profile profile ;
+  for (int k = 0 ; k < axes_.size() ; k++) {
+    Setting setting ;
+    setting.kind_ = axes_[k].kind_ ;
+    setting.id_ = axes_[k].id_ ;
+    setting.int_ = 0 ;
+    setting.dbl_ = 0.0 ;
+    switch (setting.kind_) {
+      case IntSetting: {
+	setting.int_ = winner.getIntParam(setting.id_) ;
+	break ;
+      }
+      case DblSetting: {
+	setting.dbl_ = winner.getDblParam(setting.id_) ;
+	break ;
+      }
+      default: {
+	setting.str_ = winner.getStrParam(setting.id_) ;
+	break ;
+      }
+    }
+    profile.settings_.push_back(setting) ;
+  }
+  for (int c = 0 ; c < cands.size() ; c++) delete cands[c] ;
+  for (int m = 0 ; m < models.size() ; m++) {
+    profile.fp_ = fingerprint(*models[m]) ;
+    addProfile(profile) ;
+  }
+
+  return (true) ;
+}
+
+void ParamTuner::addProfile (const Profile &profile)
+{
+  for (int ndx = 0 ; ndx < profiles_.size() ; ndx++) {
+    if (distance(profiles_[ndx].fp_,profile.fp_) == 0.0) {
+      profiles_[ndx] = profile ;
+      return ;
+    }
+  }
+  profiles_.push_back(profile) ;
+}
+
+int ParamTuner::lookup (const Fingerprint &fp, double maxDist) const
+{
+  int bestNdx = -1 ;
+  double bestDist = 0.0 ;
+  for (int ndx = 0 ; ndx < profiles_.size() ; ndx++) {
+    double dist = distance(profiles_[ndx].fp_,fp) ;
+    if (bestNdx < 0 || dist < bestDist) {
+      bestNdx = ndx ;
+      bestDist = dist ;
+    }
+  }
+  if (bestNdx >= 0 && maxDist >= 0.0 && bestDist > maxDist) bestNdx = -1 ;
+  return (bestNdx) ;
+}
+
+/*
+  The settings are added rather than set, so that a parameter runParams
+  doesn't already hold is created instead of being silently dropped.
+*/
+bool ParamTuner::apply (ClpSimplexAPI &model, RunParamsAPI &runParams,
+			double maxDist) const
+{
+  int ndx = lookup(fingerprint(model),maxDist) ;
+  if (ndx < 0) return (false) ;
+  const std::vector<Setting> &settings = profiles_[ndx].settings_ ;
+  for (int k = 0 ; k < settings.size() ; k++) {
+    const Setting &setting = settings[k] ;
+    switch (setting.kind_) {
+      case IntSetting: {
+	runParams.addIntParam(setting.id_,setting.int_) ;
+	break ;
+      }
+      case DblSetting: {
+	runParams.addDblParam(setting.id_,setting.dbl_) ;
+	break ;
+      }
+      default: {
+	runParams.addStrParam(setting.id_,setting.str_) ;
+	break ;
+      }
+    }
+  }
+  model.loadParams(runParams) ;
+  return (true) ;
+}
+
+/*
+  The file is plain text, one field per tab-separated column:
+
+    profile <rows> <cols> <nnz> <max col len> <max row len> <col dev> <row dev>
+    int <id> <value>
+    dbl <id> <value>
+    str <id> <value>
+    end
+
+  Lines starting with `#' are comments.
+*/
+bool ParamTuner::save (const std::string &path) const
+{
+  std::ofstream out(path.c_str()) ;
+  if (!out) return (false) ;
+  out << std::setprecision(17) ;
+  out << "# Osi2 ParamTuner profiles" << std::endl ;
+  for (int ndx = 0 ; ndx < profiles_.size() ; ndx++) {
+    const Profile &profile = profiles_[ndx] ;
+    const Fingerprint &fp = profile.fp_ ;
+    out
+      << "profile\t" << fp.numRows_ << '\t' << fp.numCols_ << '\t'
+      << fp.numElems_ << '\t' << fp.maxColLen_ << '\t' << fp.maxRowLen_
+      << '\t' << fp.colLenDev_ << '\t' << fp.rowLenDev_ << std::endl ;
+    for (int k = 0 ; k < profile.settings_.size() ; k++) {
+      const Setting &setting = profile.settings_[k] ;
+      switch (setting.kind_) {
+	case IntSetting: {
+	  out << "int\t" << setting.id_ << '\t' << setting.int_ << std::endl ;
+	  break ;
+	}
+	case DblSetting: {
+	  out << "dbl\t" << setting.id_ << '\t' << setting.dbl_ << std::endl ;
+	  break ;
+	}
+	default: {
+	  out << "str\t" << setting.id_ << '\t' << setting.str_ << std::endl ;
+	  break ;
+	}
+      }
+    }
+    out << "end" << std::endl ;
+  }
+  return (static_cast<bool>(out)) ;
+}
+
+bool ParamTuner::load (const std::string &path)
+{
+  std::ifstream in(path.c_str()) ;
+  if (!in) return (false) ;
+  std::string line ;
+  Profile profile ;
+  bool inProfile = false ;
+  while (std::getline(in,line)) {
+    if (line.empty() || line[0] == '#') continue ;
+    std::vector<std::string> fields = splitFields(line) ;
+    const std::string &tag = fields[0] ;
+    if (tag == "profile" && fields.size() == 8 && !inProfile) {
+      Fingerprint &fp = profile.fp_ ;
+      fp.numRows_ = std::atoi(fields[1].c_str()) ;
+      fp.numCols_ = std::atoi(fields[2].c_str()) ;
+      fp.numElems_ =
+	static_cast<CoinBigIndex>(std::atol(fields[3].c_str())) ;
+      fp.maxColLen_ = std::atoi(fields[4].c_str()) ;
+      fp.maxRowLen_ = std::atoi(fields[5].c_str()) ;
+      fp.colLenDev_ = std::atof(fields[6].c_str()) ;
+      fp.rowLenDev_ = std::atof(fields[7].c_str()) ;
+      profile.settings_.clear() ;
+      inProfile = true ;
+    } else if (tag == "end" && inProfile) {
+      addProfile(profile) ;
+      inProfile = false ;
+    } else if (fields.size() == 3 && inProfile) {
+      Setting setting ;
+      setting.id_ = fields[1] ;
+      setting.int_ = 0 ;
+      setting.dbl_ = 0.0 ;
+      if (tag == "int") {
+	setting.kind_ = IntSetting ;
+	setting.int_ = std::atoi(fields[2].c_str()) ;
+      } else if (tag == "dbl") {
+	setting.kind_ = DblSetting ;
+	setting.dbl_ = std::atof(fields[2].c_str()) ;
+      } else if (tag == "str") {
+	setting.kind_ = StrSetting ;
+	setting.str_ = fields[2] ;
+      } else {
+	return (false) ;
+      }
+      profile.settings_.push_back(setting) ;
+    } else {
+      return (false) ;
+    }
+  }
+  return (!inProfile) ;
+}
+
+} // namespace Osi2
@@ -0,0 +1,207 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ParamTuner.hpp
+
+  Defines ParamTuner, a utility to search for good solver parameters for a
+  family of problems and to reapply them to later problems of the family.
+*/
+
+#ifndef Osi2ParamTuner_HPP
+#define Osi2ParamTuner_HPP
+
+#include <string>
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2ControlAPI.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2RunParamsAPI.hpp"
+
+namespace Osi2 {
+
+/*! \brief Tune solver parameters for a family of problems
+
+  #tune runs a budgeted search over the grid defined by the axes (see
+  #addIntAxis, etc.) for a set of representative models. The search is
+  successive halving: every surviving candidate profile is solved on every
+  model with an iteration limit ("iter max"), the better half is kept, and
+  the limit is doubled for the next round. A candidate's score is the mean,
+  over models, of its solve time relative to the best time for that model;
+  a solve that doesn't finish with status 0 scores #unsolvedPenalty.
+
+  The winning settings are recorded as a profile keyed by the structural
+  fingerprint of each model. Profiles can be saved to and loaded from a
+  file. #apply computes the fingerprint of a new model, finds the closest
+  profile, and loads its settings into the solver with
+  ClpSimplexAPI::loadParams.
+*/
+class ParamTuner {
+
+public:
+
+  /*! \brief Structural fingerprint of a model
+
+    Dimensions, coefficient count, and column and row length statistics.
+    Enough to tell problem families apart; it says nothing about the
+    coefficient values.
+  */
+  struct Fingerprint {
+    int numRows_ ;
+    int numCols_ ;
+    CoinBigIndex numElems_ ;
+    int maxColLen_ ;
+    int maxRowLen_ ;
+    /// Standard deviation of column lengths
+    double colLenDev_ ;
+    /// Standard deviation of row lengths
+    double rowLenDev_ ;
+  } ;
+
+  /// Penalty score for a solve that doesn't finish with status 0
+  static const double unsolvedPenalty ;
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /// Constructor
+  ParamTuner(ControlAPI &ctrl) ;
+  /// Destructor
+  ~ParamTuner() ;
+  //@}
+
+  /*! \name Fingerprints */
+  //@{
+  /// Compute the structural fingerprint of a model
+  static Fingerprint fingerprint(ClpSimplexAPI &model) ;
+
+  /*! \brief Distance between fingerprints
+
+    The sum over the features of the absolute difference of log(1+x).
+  */
+  static double distance(const Fingerprint &fp1, const Fingerprint &fp2) ;
+  //@}
+
+  /*! \name Tuning */
+  //@{
+  /// Add an axis of integer values for parameter \p id
+  void addIntAxis(const std::string &id, const std::vector<int> &vals) ;
+  /// Add an axis of double values for parameter \p id
+  void addDblAxis(const std::string &id, const std::vector<double> &vals) ;
+  /// Add an axis of string values for parameter \p id
+  void addStrAxis(const std::string &id,
+		  const std::vector<std::string> &vals) ;
+
+  /*! \brief Set the search budget
+
+    \p firstIters is the iteration limit for the first round; it's doubled
+    each round. If \p firstIters is less than 1, solves are not limited.
+    The limit is added to each candidate profile as "iter max" if the base
+    profile doesn't already have it.
+    \p maxRounds bounds the number of halving rounds.
+  */
+  void setBudget(int firstIters, int maxRounds)
+  { firstIters_ = firstIters ; maxRounds_ = maxRounds ; }
+
+  /// Set the number of workers for each round (0 for all hardware threads)
+  void setWorkers(int workers) { workers_ = workers ; }
+
+  /*! \brief Search for the best profile for \p models
+
+    Candidates are \p base with the axis parameters set to each point of
+    the grid. On success, the winning settings are recorded as a profile for
+    each model and true is returned. The axes are retained, so that the same
+    search can be run for another family.
+  */
+  bool tune(std::vector<ClpSimplexAPI *> &models, const RunParamsAPI &base) ;
+  //@}
+
+  /*! \name Profiles */
+  //@{
+  /// Number of profiles
+  int getProfileCnt() const { return (static_cast<int>(profiles_.size())) ; }
+
+  /*! \brief Find the profile closest to \p fp
+
+    Returns -1 if there are no profiles, or if \p maxDist is not negative and
+    the closest profile is further away than \p maxDist.
+  */
+  int lookup(const Fingerprint &fp, double maxDist = -1.0) const ;
+
+  /*! \brief Apply the closest profile to \p model
+
+    The settings of the profile are written into \p runParams (added if
+    not already present), which is then loaded into \p model. Returns false
+    if no profile is within \p maxDist.
+  */
+  bool apply(ClpSimplexAPI &model, RunParamsAPI &runParams,
+	     double maxDist = -1.0) const ;
+
+  /// Write the profiles to the file \p path
+  bool save(const std::string &path) const ;
+
+  /*! \brief Read profiles from the file \p path
+
+    Profiles are added to those already held; a profile with the same
+    fingerprint as an existing one replaces it.
+  */
+  bool load(const std::string &path) ;
+  //@}
+
+private:
+
+  /// Value types for settings
+  enum SettingKind { IntSetting = 0, DblSetting, StrSetting } ;
+
+  /// A parameter setting
+  struct Setting {
+    SettingKind kind_ ;
+    std::string id_ ;
+    int int_ ;
+    double dbl_ ;
+    std::string str_ ;
+  } ;
+
+  /// A tuned profile: the settings that won for a model with fingerprint fp_
+  struct Profile {
+    Fingerprint fp_ ;
+    std::vector<Setting> settings_ ;
+  } ;
+
+  /// An axis of the search grid
+  struct Axis {
+    std::string id_ ;
+    SettingKind kind_ ;
+    std::vector<int> ints_ ;
+    std::vector<double> dbls_ ;
+    std::vector<std::string> strs_ ;
+  } ;
+
+  /// Add \p profile, replacing any profile with the same fingerprint
+  void addProfile(const Profile &profile) ;
+
+  /// Control object used to create solver objects
+  ControlAPI &ctrl_ ;
+  /// Search axes
+  std::vector<Axis> axes_ ;
+  /// Iteration limit for the first round
+  int firstIters_ ;
+  /// Maximum number of rounds
+  int maxRounds_ ;
+  /// Number of workers
+  int workers_ ;
+  /// Tuned profiles
+  std::vector<Profile> profiles_ ;
+
+  /// Copying is not supported
+  ParamTuner(const ParamTuner &) ;
+  ParamTuner &operator=(const ParamTuner &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -8,6 +8,8 @@
 #ifndef Osi2ProbMgmtAPI_HPP
 #define Osi2ProbMgmtAPI_HPP
 
+#include "CoinTypes.h"
+
 #include "Osi2API.hpp"
 
 /*! \brief Proof of concept API.
@@ -31,6 +33,74 @@ public:
   int readMps(const char *filename, bool keepNames = false,
               bool ignoreErrors = false) = 0 ;
 
+  /*! \brief Load a problem, taking ownership of the arguments
+
+    The matrix is given in column major format (starts, indices, values),
+    without gaps, and the rows by lower and upper bounds. A null bound or
+    objective vector takes the usual default (see
+    ClpSimplexAPI::loadProblem). The arrays must have been allocated with
+    <code>new[]</code>; they become the property of the object and the
+    pointers are set to null on return. An implementation that can't adopt
+    the arrays copies them and frees them before returning.
+  */
+  virtual void assignProblem(const int numcols, const int numrows,
+    CoinBigIndex *&start, int *&index, double *&value,
+    double *&collb, double *&colub, double *&obj,
+    double *&rowlb, double *&rowub) = 0 ;
+
+  /*! \name Streamed loading
+
+    A problem can be delivered in pieces as it arrives: #beginModel, then
+    any number of #appendRows and #appendColumns in any mix, then
+    #endModel, which loads the problem in place of the current one. Each
+    piece is copied out of the caller's arrays before the call returns, so
+    the buffer for one piece can be reused for the next, and the pieces
+    are kept in their compact form (see ModelBuilder) until #endModel
+    builds the matrix. Peak memory is about twice the size of the finished
+    matrix.
+
+    The arguments are those of ModelBuilder::addRows and
+    ModelBuilder::addColumns: piece k of \p indices and \p elements lies
+    in positions starts[k] to starts[k+1]-1, and a null bound or objective
+    vector takes the usual default. Indices are global; a row may refer to
+    columns still to come, and vice versa. Pieces appended without
+    #beginModel are ignored.
+  */
+  //@{
+  /// Start a new problem, discarding any pieces not yet loaded
+  virtual void beginModel() = 0 ;
+
+  /// Append \p numRows rows in row-major form
+  virtual void appendRows(int numRows, const CoinBigIndex *starts,
+    const int *indices, const double *elements,
+    const double *rowLower, const double *rowUpper) = 0 ;
+
+  /// Append \p numCols columns in column-major form
+  virtual void appendColumns(int numCols, const CoinBigIndex *starts,
+    const int *indices, const double *elements,
+    const double *colLower, const double *colUpper, const double *obj) = 0 ;
+
+  /*! \brief Build the matrix and load the problem
+
+    Returns the number of coefficients dropped because their index was out
+    of range, or -1 if #beginModel was not called.
+  */
+  virtual int endModel() = 0 ;
+  //@}
+
+  /*! \brief Write the problem in Osi2 binary format (see ModelImage)
+
+    Returns 0 on success.
+  */
+  virtual int writeModel(const char *filename) = 0 ;
+
+  /*! \brief Read a problem written by #writeModel
+
+    Returns 0 on success, -1 if the file can't be opened, -2 if it is not a
+    usable model file.
+  */
+  virtual int readModel(const char *filename) = 0 ;
+
   /// Solve an lp
   virtual int initialSolve() = 0 ;
 
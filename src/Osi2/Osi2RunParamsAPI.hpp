@@ -29,6 +29,11 @@ namespace Osi2 {
   into a RunParamsAPI object, and a set of methods that can be used to
   return the set of parameters. Parameters are grouped by data type.
   Supported data types are int, double, std::string, and void*
+
+  Each parameter carries a generation stamp, updated whenever its value
+  changes. An object applying the parameter set can remember the generation
+  it last applied (#getGeneration) and later ask only for the parameters
+  changed since then.
 */
 class RunParamsAPI : public API {
 
@@ -37,37 +42,51 @@ public:
   /// Return the "ident" string for the RunParams %API
   inline static const char *getAPIIDString () { return ("RunParams") ; }
 
+  /*! \name Constructors and Destructors */
+  //@{
+  /*! \brief Virtual copy constructor
+
+    The copy holds the same parameters and values as the original. Note that
+    the copy was not created by ControlAPI::createObject; delete it directly.
+  */
+  virtual RunParamsAPI *clone() const = 0 ;
+
+  /// Virtual destructor
+  virtual ~RunParamsAPI () { }
+  //@}
+
   /*! \name Methods to work with individual parameters */
   //@{
 
   /// Add an integer parameter, default value 0
-  virtual void addIntParam(std::string id, int val = 0) = 0 ;
+  virtual void addIntParam(const std::string &id, int val = 0) = 0 ;
   /// Set the value of an existing integer parameter
-  virtual void setIntParam(std::string id, int val) = 0 ;
+  virtual void setIntParam(const std::string &id, int val) = 0 ;
   /// Retrieve the value of an integer parameter
-  virtual int getIntParam(std::string id) const = 0 ;
+  virtual int getIntParam(const std::string &id) const = 0 ;
 
   /// Add a double parameter, default value 0.0
-  virtual void addDblParam(std::string id, double val = 0.0) = 0 ;
+  virtual void addDblParam(const std::string &id, double val = 0.0) = 0 ;
   /// Set the value of an existing double parameter
-  virtual void setDblParam(std::string id, double val) = 0 ;
+  virtual void setDblParam(const std::string &id, double val) = 0 ;
   /// Retrieve the value of a double parameter
-  virtual double getDblParam(std::string id) const = 0 ;
+  virtual double getDblParam(const std::string &id) const = 0 ;
 
   /// Add a string parameter, default value string()
-  virtual void addStrParam(std::string id,
-  			   std::string val = std::string()) = 0 ;
+  virtual void addStrParam(const std::string &id,
+  			   const std::string &val = std::string()) = 0 ;
   /// Set the value of an existing string parameter
-  virtual void setStrParam(std::string id, std::string val) = 0 ;
+  virtual void setStrParam(const std::string &id,
+  			   const std::string &val) = 0 ;
   /// Retrieve the value of a double parameter
-  virtual std::string getStrParam(std::string id) const = 0 ;
+  virtual std::string getStrParam(const std::string &id) const = 0 ;
 
   /// Add a void* parameter, default value nullptr
-  virtual void addVoidParam(std::string id, void *val = nullptr) = 0 ;
+  virtual void addVoidParam(const std::string &id, void *val = nullptr) = 0 ;
   /// Set the value of an existing void* parameter
-  virtual void setVoidParam(std::string id, void *val) = 0 ;
+  virtual void setVoidParam(const std::string &id, void *val) = 0 ;
   /// Retrieve the value of a double parameter
-  virtual void *getVoidParam(std::string id) const = 0 ;
+  virtual void *getVoidParam(const std::string &id) const = 0 ;
 
   //@}
 
@@ -85,11 +104,32 @@ public:
 
   //@}
 
-protected:
+  /*! \name Methods to track changes to a parameter set
 
-  /// Virtual destructor
+    Generation stamps are drawn from a single counter shared by all
+    RunParamsAPI objects and increase monotonically. A stamp of 0 precedes
+    all changes, so asking for the parameters changed since generation 0
+    returns the full set.
+  */
+  //@{
 
-  ~RunParamsAPI () { } ;
+  /// Return the generation of the most recent change to the parameter set
+  virtual unsigned long getGeneration() const = 0 ;
+
+  /// Return the names of integer parameters changed after generation \p since
+  virtual std::vector<std::string>
+    getIntParamIds(unsigned long since) const = 0 ;
+  /// Return the names of double parameters changed after generation \p since
+  virtual std::vector<std::string>
+    getDblParamIds(unsigned long since) const = 0 ;
+  /// Return the names of string parameters changed after generation \p since
+  virtual std::vector<std::string>
+    getStrParamIds(unsigned long since) const = 0 ;
+  /// Return the names of void* parameters changed after generation \p since
+  virtual std::vector<std::string>
+    getVoidParamIds(unsigned long since) const = 0 ;
+
+  //@}
 
 } ;
 
@@ -5,11 +5,16 @@
 */
 
 #include <string>
-#include <map>
+#include <vector>
 
 
 #ifndef Provide_RunParamsAPI_TemplateMethodDefs
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+
 #include "Osi2PluginManager.hpp"
 #include "Osi2RunParamsAPI_Imp.hpp"
 
@@ -102,14 +107,19 @@ static Osi2::ExitFunc initPlugin (Osi2::PlatformServices *services)
 namespace Osi2 {
 
 /*
-  Default constructor. All we need to do is initialise empty maps.
+  Default constructor. Start with an empty store, with room for a typical
+  parameter set.
 */
 RunParamsAPI_Imp::RunParamsAPI_Imp ()
-  : intParams_(),
-    dblParams_(),
-    strParams_(),
-    voidParams_()
-{ /* nothing more to do */ }
+  : store_(std::make_shared<ParamStore>()),
+    generation_(0),
+    baseGen_(0)
+{
+  store_->keys_.reserve(initialCapacity) ;
+  store_->kinds_.reserve(initialCapacity) ;
+  store_->gens_.reserve(initialCapacity) ;
+  store_->vals_.reserve(initialCapacity) ;
+}
 
 /*
   Registration constructor
@@ -120,15 +130,158 @@ RunParamsAPI_Imp::RunParamsAPI_Imp ()
   to construct a static, file local instance that has absolutely no other use.
 */
 RunParamsAPI_Imp::RunParamsAPI_Imp (std::string name)
+  : store_(std::make_shared<ParamStore>()),
+    generation_(0),
+    baseGen_(0)
 {
   PluginManager *pluginMgr = &PluginManager::getInstance() ;
 
   pluginMgr->addPreloadLib(name,initPlugin) ;
 }
 
+/*
+  Copy constructor. Share the store; a private copy is made only when one
+  of the objects changes a parameter. The stamps in the store belong to the
+  original, so the copy takes a fresh generation as the floor for all of
+  them instead of restamping (which would force a private copy).
+*/
+RunParamsAPI_Imp::RunParamsAPI_Imp (const RunParamsAPI_Imp &rhs)
+  : RunParamsAPI(rhs),
+    store_(rhs.store_),
+    generation_(nextGeneration()),
+    baseGen_(generation_)
+{ /* nothing more to do */ }
+
 RunParamsAPI_Imp::~RunParamsAPI_Imp ()
 { /* nothing more to do */ }
 
+/*
+  The generation counter is shared by all RunParamsAPI_Imp objects so that
+  stamps never repeat, even across objects. A client that remembers the
+  generation it last applied can't be fooled by a different object (perhaps
+  allocated at the same address) with an older, unrelated history.
+*/
+unsigned long RunParamsAPI_Imp::nextGeneration ()
+{
+  static std::atomic<unsigned long> counter(0) ;
+  return (++counter) ;
+}
+
+/*
+  Key interning. The table is shared by all objects and only grows. Elements
+  of an unordered_set are never relocated, so the address of the interned
+  string is a stable key. The table is consulted only when a parameter is
+  added; everything else finds keys in the object's own store.
+*/
+namespace {
+
+std::mutex &keyTableLock ()
+{
+  static std::mutex lock ;
+  return (lock) ;
+}
+
+std::unordered_set<std::string> &keyTable ()
+{
+  static std::unordered_set<std::string> table ;
+  return (table) ;
+}
+
+}  // end file-local namespace
+
+RunParamsAPI_Imp::ParamKey RunParamsAPI_Imp::internKey (const std::string &id)
+{
+  std::lock_guard<std::mutex> guard(keyTableLock()) ;
+  return (&*keyTable().insert(id).first) ;
+}
+
+/*
+  Binary search on (key, kind). Keys are ordered alphabetically. The search
+  compares strings rather than interned keys so that it needs nothing from
+  the shared table.
+*/
+int RunParamsAPI_Imp::lowerBound (const std::string &id,
+				  ParamKind kind) const
+{
+  const std::vector<ParamKey> &keys = store_->keys_ ;
+  const std::vector<char> &kinds = store_->kinds_ ;
+  int lo = 0 ;
+  int hi = static_cast<int>(keys.size()) ;
+  while (lo < hi) {
+    int mid = (lo+hi)/2 ;
+    int cmp = keys[mid]->compare(id) ;
+    if (cmp < 0 || (cmp == 0 && kinds[mid] < kind)) {
+      lo = mid+1 ;
+    } else {
+      hi = mid ;
+    }
+  }
+  return (lo) ;
+}
+
+int RunParamsAPI_Imp::findParam (const std::string &id, ParamKind kind) const
+{
+  int ndx = lowerBound(id,kind) ;
+  if (ndx < static_cast<int>(store_->keys_.size()) &&
+      store_->kinds_[ndx] == kind && *store_->keys_[ndx] == id) {
+    return (ndx) ;
+  }
+  return (-1) ;
+}
+
+/*
+  Open up a slot at the proper position in each array. A string parameter
+  gets a fresh entry at the end of the string array; since string values are
+  referenced by index, they never need to move.
+*/
+int RunParamsAPI_Imp::insertParam (ParamKey key, ParamKind kind)
+{
+  int ndx = lowerBound(*key,kind) ;
+  ParamSlot slot ;
+  slot.dbl_ = 0.0 ;
+  if (kind == StrParam) {
+    slot.str_ = store_->strs_.size() ;
+    store_->strs_.push_back(std::string()) ;
+  }
+  store_->keys_.insert(store_->keys_.begin()+ndx,key) ;
+  store_->kinds_.insert(store_->kinds_.begin()+ndx,static_cast<char>(kind)) ;
+  store_->gens_.insert(store_->gens_.begin()+ndx,0) ;
+  store_->vals_.insert(store_->vals_.begin()+ndx,slot) ;
+  return (ndx) ;
+}
+
+void RunParamsAPI_Imp::detach ()
+{
+  if (store_.use_count() > 1) {
+    store_ = std::make_shared<ParamStore>(*store_) ;
+  }
+}
+
+void RunParamsAPI_Imp::stamp (int ndx)
+{
+  generation_ = nextGeneration() ;
+  store_->gens_[ndx] = generation_ ;
+}
+
+/*
+  Return the ids of parameters changed after generation since. The default
+  (since = 0) returns all parameters. In a copy, no entry is older than the
+  copy itself.
+*/
+std::vector<std::string> RunParamsAPI_Imp::getParamIds (ParamKind kind,
+						unsigned long since) const
+{
+  std::vector<std::string> ids ;
+  const ParamStore &store = *store_ ;
+  int cnt = static_cast<int>(store.keys_.size()) ;
+  for (int ndx = 0 ; ndx < cnt ; ndx++) {
+    if (store.kinds_[ndx] == kind &&
+	std::max(store.gens_[ndx],baseGen_) > since)
+    { ids.push_back(*store.keys_[ndx]) ; }
+  }
+  return (ids) ;
+}
+
 }  // end namespace Osi2
 
 #endif  // Provide_RunParamsAPI_TemplateMethodDefs not defined
@@ -141,50 +294,52 @@ RunParamsAPI_Imp::~RunParamsAPI_Imp ()
   included within namespace Osi2, so don't wrap them again here.
 */
 
+/*
+  Adding or setting a parameter draws a new generation stamp only if the
+  value actually changes. Re-adding an existing parameter with the same value
+  (e.g., a repeated exposeParams) is not a change, and doesn't force a
+  private copy of a shared store. The key is interned only for a new entry.
+*/
 template <class ParamType>
-void RunParamsAPI_Imp::addParam (ParamMap<ParamType> &paramMap,
-			    std::string id, ParamType val)
+void RunParamsAPI_Imp::addParam (ParamKind kind,
+			    const std::string &id, const ParamType &val)
 {
-  paramMap[id] = val ;
+  int ndx = findParam(id,kind) ;
+  if (ndx >= 0) {
+    ParamType oldVal ;
+    fetchVal(ndx,oldVal) ;
+    if (oldVal == val) return ;
+  }
+  detach() ;
+  if (ndx < 0) ndx = insertParam(internKey(id),kind) ;
+  storeVal(ndx,val) ;
+  stamp(ndx) ;
   return ;
 }
 
 template <class ParamType>
-void RunParamsAPI_Imp::setParam (ParamMap<ParamType> &paramMap,
-			    std::string id, ParamType val)
+void RunParamsAPI_Imp::setParam (ParamKind kind,
+			    const std::string &id, const ParamType &val)
 {
-  typename ParamMap<ParamType>::iterator paramIter ;
-  paramIter = paramMap.find(id) ;
-  if (paramIter != paramMap.end()) {
-    paramIter->second = val ;
-  }
+  int ndx = findParam(id,kind) ;
+  if (ndx < 0) return ;
+  ParamType oldVal ;
+  fetchVal(ndx,oldVal) ;
+  if (oldVal == val) return ;
+  detach() ;
+  storeVal(ndx,val) ;
+  stamp(ndx) ;
   return ;
 }
 
 template <class ParamType>
-ParamType RunParamsAPI_Imp::getParam (const ParamMap<ParamType> &paramMap,
-				      std::string id) const
-{
-  typename ParamMap<ParamType>::const_iterator paramIter ;
-  paramIter = paramMap.find(id) ;
-  if (paramIter != paramMap.end()) {
-    return (paramIter->second) ;
-  } else {
-    return (ParamType()) ;
-  }
-}
-
-template <class ParamType>
-std::vector<std::string> RunParamsAPI_Imp::getParamIds
-  (const ParamMap<ParamType> &paramMap) const
+ParamType RunParamsAPI_Imp::getParam (ParamKind kind,
+				      const std::string &id) const
 {
-  std::vector<std::string> ids ;
-  for (typename ParamMap<ParamType>::const_iterator paramIter =
-  							paramMap.begin() ;
-       paramIter != paramMap.end() ;
-       paramIter++)
-  { ids.push_back(paramIter->first) ; }
-  return (ids) ;
+  ParamType val = ParamType() ;
+  int ndx = findParam(id,kind) ;
+  if (ndx >= 0) fetchVal(ndx,val) ;
+  return (val) ;
 }
 
 #endif    // Provide_RunParamsAPI_TemplateMethodDefs defined
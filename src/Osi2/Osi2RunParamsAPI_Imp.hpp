@@ -7,7 +7,8 @@
 */
 
 #include <string>
-#include <map>
+#include <vector>
+#include <memory>
 
 #include "Osi2RunParamsAPI.hpp"
 
@@ -17,51 +18,76 @@ namespace Osi2 {
 
   Implements the abstract interface using wrappers around templated function
   invocation, to hide the templating from the user.
+
+  Parameters of all types are held in a single flat store, sorted by key and
+  organised as parallel arrays (key, type, generation, value). Keys are
+  interned in a table shared by all RunParamsAPI_Imp objects, so each key is
+  held once. Lookups search the store itself and never touch the shared
+  table; only adding a key not seen before takes the table's lock, so
+  objects in different threads don't contend to get or set parameters. The
+  store is kept in alphabetical order of key, so ids come back in the same
+  order as they did from the old map-based store. String values live in a
+  side array indexed from the value slot.
+
+  The store is shared copy-on-write. A copy (#clone) simply shares the store
+  of the original; the first change to either object gives it a private
+  copy. The original must not be modified while it's being cloned. A copy
+  starts from a fresh generation, and every parameter counts as changed at
+  that generation, so a client that remembers a generation of the original
+  (or of an object that once lived at the same address) reloads everything.
 */
 class RunParamsAPI_Imp : public RunParamsAPI {
 
 public:
 
+  /*! \name Constructors, destructor, etc. */
+  //@{
   /// Registration constructor
   RunParamsAPI_Imp (std::string name) ;
   /// Default constructor
   RunParamsAPI_Imp () ;
+  /// Copy constructor (shares the parameter store)
+  RunParamsAPI_Imp(const RunParamsAPI_Imp &rhs) ;
   /// Destructor
   ~RunParamsAPI_Imp() ;
 
-  template <class ParamType>
-  using ParamMap = std::map<std::string,ParamType> ;
+  /// Virtual constructor
+  RunParamsAPI *create() const { return (new RunParamsAPI_Imp()) ; }
+  /// Virtual copy constructor
+  RunParamsAPI *clone() const { return (new RunParamsAPI_Imp(*this)) ; }
+  //@}
 
   /*! \name Methods to work with individual parameters */
   //@{
 
-  void addIntParam(std::string id, int val = 0)
-  { addParam<int>(intParams_,id,val) ; }
-  void setIntParam(std::string id, int val)
-  { setParam<int>(intParams_,id,val) ; }
-  int getIntParam(std::string id) const
-  { return (getParam<int>(intParams_,id)) ; }
-
-  void addDblParam(std::string id, double val = 0.0)
-  { addParam<double>(dblParams_,id,val) ; }
-  void setDblParam(std::string id, double val)
-  { setParam<double>(dblParams_,id,val) ; }
-  double getDblParam(std::string id) const
-  { return (getParam<double>(dblParams_,id)) ; }
-
-  void addStrParam(std::string id, std::string val = std::string())
-  { addParam<std::string>(strParams_,id,val) ; }
-  void setStrParam(std::string id, std::string val)
-  { setParam<std::string>(strParams_,id,val) ; }
-  std::string getStrParam(std::string id) const
-  { return (getParam<std::string>(strParams_,id)) ; }
-
-  void addVoidParam(std::string id, void *val = nullptr)
-  { addParam<void *>(voidParams_,id,val) ; }
-  void setVoidParam(std::string id, void *val)
-  { setParam<void *>(voidParams_,id,val) ; }
-  void *getVoidParam(std::string id) const
-  { return(getParam<void *>(voidParams_,id)) ; }
+  void addIntParam(const std::string &id, int val = 0)
+  { addParam<int>(IntParam,id,val) ; }
+  void setIntParam(const std::string &id, int val)
+  { setParam<int>(IntParam,id,val) ; }
+  int getIntParam(const std::string &id) const
+  { return (getParam<int>(IntParam,id)) ; }
+
+  void addDblParam(const std::string &id, double val = 0.0)
+  { addParam<double>(DblParam,id,val) ; }
+  void setDblParam(const std::string &id, double val)
+  { setParam<double>(DblParam,id,val) ; }
+  double getDblParam(const std::string &id) const
+  { return (getParam<double>(DblParam,id)) ; }
+
+  void addStrParam(const std::string &id,
+  		   const std::string &val = std::string())
+  { addParam<std::string>(StrParam,id,val) ; }
+  void setStrParam(const std::string &id, const std::string &val)
+  { setParam<std::string>(StrParam,id,val) ; }
+  std::string getStrParam(const std::string &id) const
+  { return (getParam<std::string>(StrParam,id)) ; }
+
+  void addVoidParam(const std::string &id, void *val = nullptr)
+  { addParam<void *>(VoidParam,id,val) ; }
+  void setVoidParam(const std::string &id, void *val)
+  { setParam<void *>(VoidParam,id,val) ; }
+  void *getVoidParam(const std::string &id) const
+  { return(getParam<void *>(VoidParam,id)) ; }
 
   //@}
 
@@ -70,60 +96,137 @@ public:
 
   // Return the names of integer parameters
   std::vector<std::string> getIntParamIds() const
-  { return (getParamIds<int>(intParams_)) ; }
+  { return (getParamIds(IntParam)) ; }
   // Return the names of double parameters
   std::vector<std::string> getDblParamIds() const
-  { return (getParamIds<double>(dblParams_)) ; }
+  { return (getParamIds(DblParam)) ; }
   // Return the names of std::string parameters
   std::vector<std::string> getStrParamIds() const
-  { return (getParamIds<std::string>(strParams_)) ; }
+  { return (getParamIds(StrParam)) ; }
   // Return the names of void* parameters
   std::vector<std::string> getVoidParamIds() const
-  { return (getParamIds<void *>(voidParams_)) ; }
+  { return (getParamIds(VoidParam)) ; }
 
   //@}
 
-private:
-
-  /*! \name Constructors, destructor, etc. */
+  /*! \name Methods to track changes to the parameter set */
   //@{
-  /// Copy constructor
-  RunParamsAPI_Imp(RunParamsAPI_Imp &rhs) ;
 
-  /// Virtual constructor
-  RunParamsAPI *create() { return (new RunParamsAPI_Imp()) ; }
-  /// Virtual copy constructor
-  RunParamsAPI *clone(RunParamsAPI *rhs)
-  { RunParamsAPI_Imp *tmp = dynamic_cast<RunParamsAPI_Imp *>(rhs) ;
-    if (tmp != nullptr) {
-      return (new RunParamsAPI_Imp(*tmp)) ;
-    } else {
-      return (new RunParamsAPI_Imp()) ;
-    }
-  }
+  /// Return the generation of the most recent change
+  unsigned long getGeneration() const { return (generation_) ; }
+
+  // Return the names of integer parameters changed after since
+  std::vector<std::string> getIntParamIds(unsigned long since) const
+  { return (getParamIds(IntParam,since)) ; }
+  // Return the names of double parameters changed after since
+  std::vector<std::string> getDblParamIds(unsigned long since) const
+  { return (getParamIds(DblParam,since)) ; }
+  // Return the names of std::string parameters changed after since
+  std::vector<std::string> getStrParamIds(unsigned long since) const
+  { return (getParamIds(StrParam,since)) ; }
+  // Return the names of void* parameters changed after since
+  std::vector<std::string> getVoidParamIds(unsigned long since) const
+  { return (getParamIds(VoidParam,since)) ; }
 
   //@}
 
-  /*! \brief Underlying template functions */
+private:
+
+  /*! \name Parameter store */
+  //@{
+  /// Parameter data types
+  enum ParamKind { IntParam = 0, DblParam, StrParam, VoidParam } ;
+
+  /// Interned key; the address of the single copy of the key string
+  typedef const std::string *ParamKey ;
+
+  /// Value slot; a string value is held as an index into ParamStore::strs_
+  union ParamSlot {
+    int int_ ;
+    double dbl_ ;
+    void *void_ ;
+    size_t str_ ;
+  } ;
+
+  /*! \brief Flat parameter store
+
+    Entries are sorted by (key, kind); entry i is described by keys_[i],
+    kinds_[i], gens_[i], and vals_[i].
+  */
+  struct ParamStore {
+    std::vector<ParamKey> keys_ ;
+    std::vector<char> kinds_ ;
+    std::vector<unsigned long> gens_ ;
+    std::vector<ParamSlot> vals_ ;
+    std::vector<std::string> strs_ ;
+  } ;
+
+  /// Room reserved in a new store; enough for a typical solver's parameters
+  static const int initialCapacity = 16 ;
+
+  /// The parameter store, shared copy-on-write
+  std::shared_ptr<ParamStore> store_ ;
+
+  /// Generation of the most recent change to any parameter
+  unsigned long generation_ ;
+
+  /*! \brief Generation at which this object was created as a copy
+
+    Zero for an object that isn't a copy. An entry whose stamp is older
+    counts as changed at this generation.
+  */
+  unsigned long baseGen_ ;
+  //@}
+
+  /*! \name Underlying template functions */
   //@{
   template <class ParamType>
-  void addParam(ParamMap<ParamType> &paramMap, std::string id, ParamType val) ;
-  template <class ParamType>
-  void setParam(ParamMap<ParamType> &paramMap, std::string id, ParamType val) ;
+  void addParam(ParamKind kind, const std::string &id, const ParamType &val) ;
   template <class ParamType>
-  ParamType getParam(const ParamMap<ParamType> &paramMap,
-  		     std::string id) const ;
+  void setParam(ParamKind kind, const std::string &id, const ParamType &val) ;
   template <class ParamType>
-  std::vector<std::string> getParamIds(const ParamMap<ParamType> &paramMap)
-  				       		const ;
+  ParamType getParam(ParamKind kind, const std::string &id) const ;
   //@}
 
-  /*! \brief Parameter maps */
+  /*! \name Store management */
   //@{
-  ParamMap<int> intParams_ ;
-  ParamMap<double> dblParams_ ;
-  ParamMap<std::string> strParams_ ;
-  ParamMap<void *> voidParams_ ;
+  /// Return the interned key for \p id, adding it if necessary
+  static ParamKey internKey(const std::string &id) ;
+  /// Draw the next stamp from the generation counter shared by all objects
+  static unsigned long nextGeneration() ;
+
+  /// Position of the first entry not less than (id, kind)
+  int lowerBound(const std::string &id, ParamKind kind) const ;
+  /// Index of the entry (id, kind), or -1 if absent
+  int findParam(const std::string &id, ParamKind kind) const ;
+  /// Insert an entry for (key, kind) and return its index
+  int insertParam(ParamKey key, ParamKind kind) ;
+  /// Acquire a private copy of the store if it's shared
+  void detach() ;
+  /// Record a change to the entry at \p ndx
+  void stamp(int ndx) ;
+
+  /// Return the names of parameters of \p kind changed after \p since
+  std::vector<std::string> getParamIds(ParamKind kind,
+  				       unsigned long since = 0) const ;
+
+  /// Move values in and out of a value slot
+  inline void storeVal (int ndx, int val)
+  { store_->vals_[ndx].int_ = val ; }
+  inline void storeVal (int ndx, double val)
+  { store_->vals_[ndx].dbl_ = val ; }
+  inline void storeVal (int ndx, void *val)
+  { store_->vals_[ndx].void_ = val ; }
+  inline void storeVal (int ndx, const std::string &val)
+  { store_->strs_[store_->vals_[ndx].str_] = val ; }
+  inline void fetchVal (int ndx, int &val) const
+  { val = store_->vals_[ndx].int_ ; }
+  inline void fetchVal (int ndx, double &val) const
+  { val = store_->vals_[ndx].dbl_ ; }
+  inline void fetchVal (int ndx, void *&val) const
+  { val = store_->vals_[ndx].void_ ; }
+  inline void fetchVal (int ndx, std::string &val) const
+  { val = store_->strs_[store_->vals_[ndx].str_] ; }
   //@}
 
 } ;
@@ -138,4 +241,3 @@ private:
 }  // end namespace Osi2
 
 #endif
-
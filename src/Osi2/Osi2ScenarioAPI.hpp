@@ -0,0 +1,163 @@
+#ifndef Osi2ScenarioAPI_HPP
+# define Osi2ScenarioAPI_HPP
+
+/*! \file Osi2ScenarioAPI.hpp
+
+  Provides an %API to solve many small variations (scenarios) of one base
+  problem with a pool of solver objects.
+*/
+
+#include <vector>
+
+#include "Osi2API.hpp"
+#include "Osi2ControlAPI.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2RunParamsAPI.hpp"
+
+namespace Osi2 {
+
+/*! \brief Solve scenarios of a base problem
+
+  A ScenarioAPI object holds a base problem and a pool of workers, each
+  with its own ClpSimplex object loaded with the base problem. The base
+  problem is solved once, when the pool starts, and its optimal basis is
+  kept. A scenario is a sparse set of changes to the bounds and objective
+  of the base problem (#Scenario). To solve a scenario, a worker applies the
+  changes, installs the base basis as a warm start, reoptimises with dual
+  simplex, and then undoes the changes, leaving its solver ready for the
+  next scenario. The base problem is never reloaded.
+
+  Typical use:
+  <ul>
+    <li> #start the pool, supplying the ControlAPI object used to create the
+	 solver objects and a ClpSimplexAPI object holding the base problem.
+    <li> #submit scenarios; each is given a scenario id.
+    <li> Collect results with #nextResult as they are produced.
+    <li> #stop the pool (or let the destructor do it).
+  </ul>
+  Scenarios may be submitted while results are being collected.
+*/
+class ScenarioAPI : public API {
+
+public:
+
+  /// Return the "ident" string for the Scenario %API
+  inline static const char *getAPIIDString () { return ("Scenario") ; }
+
+  /// The vectors a scenario can change
+  enum Target { ColLower = 0, ColUpper, RowLower, RowUpper, Objective } ;
+
+  /// One change: entry #ndx_ of vector #target_ becomes #val_
+  struct Change {
+    Target target_ ;
+    int ndx_ ;
+    double val_ ;
+  } ;
+
+  /*! \brief A scenario
+
+    A list of changes to the base problem. If an entry is changed more than
+    once, the last change wins.
+  */
+  struct Scenario {
+    std::vector<Change> changes_ ;
+    /// If true, the primal and dual solutions are returned with the result
+    bool keepSolution_ ;
+
+    Scenario () : keepSolution_(false) { }
+
+    void chgColLower (int ndx, double val) { add(ColLower,ndx,val) ; }
+    void chgColUpper (int ndx, double val) { add(ColUpper,ndx,val) ; }
+    void chgRowLower (int ndx, double val) { add(RowLower,ndx,val) ; }
+    void chgRowUpper (int ndx, double val) { add(RowUpper,ndx,val) ; }
+    void chgObjCoefficient (int ndx, double val) { add(Objective,ndx,val) ; }
+
+    void add (Target target, int ndx, double val)
+    { Change chg ;
+      chg.target_ = target ;
+      chg.ndx_ = ndx ;
+      chg.val_ = val ;
+      changes_.push_back(chg) ; }
+  } ;
+
+  /// Result of a scenario
+  struct Result {
+    /// Scenario id, as returned by #submit; -1 for the base problem
+    long scenarioID_ ;
+    /// Return code from the solve; -1 if a change was out of range
+    int retval_ ;
+    /// Problem status (ClpSimplexAPI::status)
+    int status_ ;
+    /// Secondary status (ClpSimplexAPI::secondaryStatus)
+    int secondaryStatus_ ;
+    /// Iteration count
+    int iterations_ ;
+    /// Objective value
+    double objective_ ;
+    /// Wall clock time to apply the changes and solve (seconds)
+    double seconds_ ;
+    /// Primal solution (only if Scenario::keepSolution_)
+    std::vector<double> colSolution_ ;
+    /// Dual solution (only if Scenario::keepSolution_)
+    std::vector<double> rowPrice_ ;
+  } ;
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /// Virtual destructor
+  virtual ~ScenarioAPI () { }
+  //@}
+
+  /*! \name Pool control */
+  //@{
+  /*! \brief Start the worker pool
+
+    Copies the problem held by \p base, creates \p workers solver objects
+    using \p ctrl, loads the base problem into each, applies \p params if
+    supplied, and solves the base problem. Then starts a thread for each
+    worker. If \p workers is less than 1, the number of hardware threads is
+    used. Returns 0 on success, a negative value if no solver object could
+    be created. If the base problem is not solved to optimality, scenarios
+    are solved without a warm start.
+  */
+  virtual int start(ControlAPI &ctrl, ClpSimplexAPI &base, int workers = 0,
+		    const RunParamsAPI *params = nullptr) = 0 ;
+
+  /*! \brief Stop the worker pool
+
+    Scenarios not yet started are abandoned (no result is returned for
+    them). Waits for scenarios in progress to finish, then destroys the
+    solver objects. Results already produced can still be collected.
+  */
+  virtual void stop() = 0 ;
+
+  /// Number of workers in the pool (0 if not started)
+  virtual int getWorkerCnt() const = 0 ;
+
+  /// Result of the solve of the base problem (always with solutions)
+  virtual const Result &getBaseResult() const = 0 ;
+  //@}
+
+  /*! \name Scenarios and results */
+  //@{
+  /// Submit a scenario; returns its id, or -1 if the pool isn't running
+  virtual long submit(const Scenario &scenario) = 0 ;
+
+  /*! \brief Retrieve the next completed result
+
+    Results are returned in completion order. If \p wait is true and no
+    result is ready, block until one is. Returns false if no result is
+    ready and either \p wait is false or there are no scenarios
+    outstanding.
+  */
+  virtual bool nextResult(Result &result, bool wait = true) = 0 ;
+
+  /// Number of scenarios submitted whose results have not been retrieved
+  virtual long outstanding() const = 0 ;
+  //@}
+
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -0,0 +1,394 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for the Osi2
+  Scenario API.
+*/
+
+#include <chrono>
+#include <utility>
+
+#include "Osi2Config.h"
+
+#include "Osi2PluginManager.hpp"
+#include "Osi2ScenarioAPI_Imp.hpp"
+
+
+namespace {
+
+/*
+  Registration instance for ScenarioAPI.
+*/
+
+static Osi2::ScenarioAPI_Imp regObj(Osi2::ScenarioAPI::getAPIIDString()) ;
+
+/*
+  The plugin management methods. As for RunParamsAPI, create and destroy
+  simply invoke the constructor and destructor, respectively.
+*/
+static void *create (const Osi2::ObjectParams *params)
+{
+  std::string what = reinterpret_cast<const char *>(params->apiStr_) ;
+  void *retval = nullptr ;
+  if (what == Osi2::ScenarioAPI::getAPIIDString()) {
+    retval = new Osi2::ScenarioAPI_Imp() ;
+  }
+  return (retval) ;
+}
+
+static int destroy (void *victim, const Osi2::ObjectParams *objParms)
+{
+  std::string what = reinterpret_cast<const char *>(objParms->apiStr_) ;
+  int retval = 1 ;
+  if (what == Osi2::ScenarioAPI::getAPIIDString()) {
+    Osi2::API *api = static_cast<Osi2::API *>(victim) ;
+    delete api ;
+    retval = 0 ;
+  }
+
+  return (retval) ;
+}
+
+/*
+  Nothing to be done to close out an innate plugin.
+*/
+static int cleanup (const Osi2::PlatformServices *services)
+{
+  return (0) ;
+}
+
+/*
+  Plugin initialisation method.
+*/
+static Osi2::ExitFunc initPlugin (Osi2::PlatformServices *services)
+{
+  services->ctrlObj_ = nullptr ;
+/*
+  Register our API.
+*/
+  Osi2::APIRegInfo reginfo ;
+  reginfo.version_.major_ = 1 ;
+  reginfo.version_.minor_ = 0 ;
+  reginfo.pluginID_ = services->pluginID_ ;
+  reginfo.lang_ = Osi2::Plugin_CPP ;
+  reginfo.ctrlObj_ = nullptr ;
+  reginfo.createFunc_ = create ;
+  reginfo.destroyFunc_ = destroy ;
+  const char *apiName = Osi2::ScenarioAPI::getAPIIDString() ;
+  int retval =
+    services->registerAPI_(reinterpret_cast<const Osi2::CharString *>(apiName),
+    			   &reginfo) ;
+
+  if (retval < 0) { return (nullptr) ; }
+
+  return (cleanup) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+void ScenarioAPI_Imp::collect (ClpSimplexAPI &solver, bool keepSolution,
+			       Result &result)
+{
+  result.status_ = solver.status() ;
+  result.secondaryStatus_ = solver.secondaryStatus() ;
+  result.iterations_ = solver.numberIterations() ;
+  result.objective_ = solver.objectiveValue() ;
+  if (keepSolution) {
+    const double *vec = solver.getColSolution() ;
+    result.colSolution_.assign(vec,vec+solver.numberColumns()) ;
+    vec = solver.getRowPrice() ;
+    result.rowPrice_.assign(vec,vec+solver.numberRows()) ;
+  }
+}
+
+/*
+  Copy the base problem, create the workers and load them, and solve the
+  base problem with the first worker. Solver objects are created here, in
+  the calling thread, because object creation goes through the plugin
+  manager, which is not safe to call concurrently. Only then are the
+  threads started.
+*/
+int ScenarioAPI_Imp::start (ControlAPI &ctrl, ClpSimplexAPI &base,
+			    int workers, const RunParamsAPI *params)
+{
+  if (workers_.size() > 0) return (0) ;
+  if (workers < 1) {
+    workers = static_cast<int>(std::thread::hardware_concurrency()) ;
+    if (workers < 1) workers = 1 ;
+  }
+  ctrl_ = &ctrl ;
+  base_ = PackedModel(base) ;
+  int n = base.numberColumns() ;
+  int m = base.numberRows() ;
+  baseVecs_[ColLower].assign(base.columnLower(),base.columnLower()+n) ;
+  baseVecs_[ColUpper].assign(base.columnUpper(),base.columnUpper()+n) ;
+  baseVecs_[RowLower].assign(base.rowLower(),base.rowLower()+m) ;
+  baseVecs_[RowUpper].assign(base.rowUpper(),base.rowUpper()+m) ;
+  baseVecs_[Objective].assign(base.objective(),base.objective()+n) ;
+  RunParamsAPI *profile = (params == nullptr)?nullptr:params->clone() ;
+
+  for (int ndx = 0 ; ndx < workers ; ndx++) {
+    API *apiObj = nullptr ;
+    int retval = ctrl.createObject(apiObj,ClpSimplexAPI::getAPIIDString()) ;
+    if (retval != 0 || apiObj == nullptr) break ;
+    void *tmp = apiObj->getAPIPtr(ClpSimplexAPI::getAPIIDString()) ;
+    if (tmp == nullptr) {
+      ctrl.destroyObject(apiObj) ;
+      break ;
+    }
+    Worker *worker = new Worker ;
+    worker->solverObj_ = apiObj ;
+    worker->solver_ = static_cast<ClpSimplexAPI *>(tmp) ;
+    base_.loadInto(*worker->solver_) ;
+    if (profile != nullptr) worker->solver_->loadParams(*profile) ;
+    workers_.push_back(worker) ;
+  }
+  delete profile ;
+  if (workers_.size() == 0) return (-1) ;
+/*
+  Solve the base problem and keep the basis if it's optimal.
+*/
+  typedef std::chrono::steady_clock Clock ;
+  Clock::time_point begin = Clock::now() ;
+  ClpSimplexAPI *solver = workers_[0]->solver_ ;
+  baseResult_.scenarioID_ = -1 ;
+  baseResult_.retval_ = solver->initialSolve() ;
+  collect(*solver,true,baseResult_) ;
+  std::chrono::duration<double> elapsed = Clock::now()-begin ;
+  baseResult_.seconds_ = elapsed.count() ;
+  baseBasis_.clear() ;
+  const unsigned char *status = solver->statusArray() ;
+  if (solver->isProvenOptimal() && status != nullptr)
+    baseBasis_.assign(status,status+n+m) ;
+
+  stopping_ = false ;
+  for (int ndx = 0 ; ndx < workers_.size() ; ndx++) {
+    workers_[ndx]->thread_ = std::thread(&ScenarioAPI_Imp::work,this,ndx) ;
+  }
+
+  return (0) ;
+}
+
+/*
+  Tell the workers to quit, wait for them, then throw away any scenarios
+  still queued and destroy the solvers. A second call made while the first
+  is still tearing down finds stopping_ set and returns at once.
+*/
+void ScenarioAPI_Imp::stop ()
+{
+  {
+    std::lock_guard<std::mutex> lock(poolLock_) ;
+    if (workers_.size() == 0 || stopping_) return ;
+    stopping_ = true ;
+  }
+  workAvail_.notify_all() ;
+
+  for (int ndx = 0 ; ndx < workers_.size() ; ndx++) {
+    Worker *worker = workers_[ndx] ;
+    worker->thread_.join() ;
+    ctrl_->destroyObject(worker->solverObj_) ;
+    delete worker ;
+  }
+  long abandoned ;
+  {
+    std::lock_guard<std::mutex> lock(poolLock_) ;
+    workers_.clear() ;
+    abandoned = static_cast<long>(queue_.size()) ;
+    queue_.clear() ;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(resultLock_) ;
+    outstanding_ -= abandoned ;
+  }
+  resultAvail_.notify_all() ;
+}
+
+/*
+  The pool lock is held throughout so that a concurrent stop can't
+  dismantle the workers while we're queueing.
+*/
+long ScenarioAPI_Imp::submit (const Scenario &scenario)
+{
+  std::unique_lock<std::mutex> poolGuard(poolLock_) ;
+  if (workers_.size() == 0 || stopping_) return (-1) ;
+
+  long scenarioID = nextScenarioID_++ ;
+  Task task ;
+  task.scenarioID_ = scenarioID ;
+  task.scenario_ = scenario ;
+  {
+    std::lock_guard<std::mutex> lock(resultLock_) ;
+    outstanding_++ ;
+  }
+  queue_.push_back(std::move(task)) ;
+  poolGuard.unlock() ;
+  workAvail_.notify_one() ;
+
+  return (scenarioID) ;
+}
+
+/*
+  Single-entry setters only. The solver's journal merges them, so a scenario
+  that changes k entries costs O(k) here rather than a copy of each vector.
+*/
+void ScenarioAPI_Imp::pushElem (Worker &worker, int target, int ndx,
+				double val)
+{
+  ClpSimplexAPI *solver = worker.solver_ ;
+  switch (target) {
+    case ColLower: {
+      solver->setColumnLower(ndx,val) ;
+      break ;
+    }
+    case ColUpper: {
+      solver->setColumnUpper(ndx,val) ;
+      break ;
+    }
+    case RowLower: {
+      solver->setRowLower(ndx,val) ;
+      break ;
+    }
+    case RowUpper: {
+      solver->setRowUpper(ndx,val) ;
+      break ;
+    }
+    default: {
+      solver->setObjectiveCoefficient(ndx,val) ;
+      break ;
+    }
+  }
+}
+
+/*
+  Put back the base values of the entries the previous scenario changed,
+  push this scenario's changes one entry at a time, install the base basis,
+  and reoptimise. The changed indices are remembered so that the next
+  scenario can undo them the same way. Changes are pushed in order, so if
+  an entry appears twice the last value wins.
+*/
+void ScenarioAPI_Imp::runTask (Worker &worker, const Task &task,
+			       Result &result)
+{
+  typedef std::chrono::steady_clock Clock ;
+  Clock::time_point begin = Clock::now() ;
+  ClpSimplexAPI *solver = worker.solver_ ;
+  const std::vector<Change> &changes = task.scenario_.changes_ ;
+
+  result.scenarioID_ = task.scenarioID_ ;
+  result.retval_ = -1 ;
+  result.status_ = -1 ;
+  result.secondaryStatus_ = -1 ;
+  result.iterations_ = 0 ;
+  result.objective_ = 0.0 ;
+
+  bool valid = true ;
+  for (int k = 0 ; k < changes.size() && valid ; k++) {
+    const Change &chg = changes[k] ;
+    valid = (chg.target_ >= 0 && chg.target_ < targetCnt &&
+	     chg.ndx_ >= 0 &&
+	     static_cast<size_t>(chg.ndx_) < baseVecs_[chg.target_].size()) ;
+  }
+  if (valid) {
+    for (int t = 0 ; t < targetCnt ; t++) {
+      std::vector<int> &touched = worker.touched_[t] ;
+      for (int k = 0 ; k < touched.size() ; k++) {
+	pushElem(worker,t,touched[k],baseVecs_[t][touched[k]]) ;
+      }
+      touched.clear() ;
+    }
+    for (int k = 0 ; k < changes.size() ; k++) {
+      const Change &chg = changes[k] ;
+      pushElem(worker,chg.target_,chg.ndx_,chg.val_) ;
+      worker.touched_[chg.target_].push_back(chg.ndx_) ;
+    }
+    if (baseBasis_.size() > 0) solver->copyinStatus(baseBasis_.data()) ;
+    result.retval_ = solver->dual() ;
+    collect(*solver,task.scenario_.keepSolution_,result) ;
+  }
+  std::chrono::duration<double> elapsed = Clock::now()-begin ;
+  result.seconds_ = elapsed.count() ;
+}
+
+void ScenarioAPI_Imp::work (int self)
+{
+  Worker &worker = *workers_[self] ;
+  while (true) {
+    Task task ;
+    {
+      std::unique_lock<std::mutex> lock(poolLock_) ;
+      while (!stopping_ && queue_.empty()) workAvail_.wait(lock) ;
+      if (stopping_) return ;
+      task = std::move(queue_.front()) ;
+      queue_.pop_front() ;
+    }
+    Result result ;
+    runTask(worker,task,result) ;
+    {
+      std::lock_guard<std::mutex> lock(resultLock_) ;
+      results_.push_back(std::move(result)) ;
+    }
+    resultAvail_.notify_all() ;
+  }
+}
+
+bool ScenarioAPI_Imp::nextResult (Result &result, bool wait)
+{
+  std::unique_lock<std::mutex> lock(resultLock_) ;
+  if (wait) {
+    while (results_.empty() && outstanding_ > 0) resultAvail_.wait(lock) ;
+  }
+  if (results_.empty()) return (false) ;
+  result = std::move(results_.front()) ;
+  results_.pop_front() ;
+  outstanding_-- ;
+  return (true) ;
+}
+
+long ScenarioAPI_Imp::outstanding () const
+{
+  std::lock_guard<std::mutex> lock(resultLock_) ;
+  return (outstanding_) ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+ScenarioAPI_Imp::ScenarioAPI_Imp ()
+  : ctrl_(nullptr),
+    stopping_(false),
+    outstanding_(0),
+    nextScenarioID_(0)
+{ }
+
+/*
+  Registration constructor
+
+  The sole purpose of this constructor is to register the Scenario API with
+  the plugin manager during program startup. Use this constructor to
+  construct a static, file local instance that has absolutely no other use.
+*/
+ScenarioAPI_Imp::ScenarioAPI_Imp (std::string name)
+  : ctrl_(nullptr),
+    stopping_(false),
+    outstanding_(0),
+    nextScenarioID_(0)
+{
+  PluginManager *pluginMgr = &PluginManager::getInstance() ;
+
+  pluginMgr->addPreloadLib(name,initPlugin) ;
+}
+
+ScenarioAPI_Imp::~ScenarioAPI_Imp ()
+{
+  stop() ;
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,137 @@
+#ifndef Osi2ScenarioAPI_Imp_HPP
+# define Osi2ScenarioAPI_Imp_HPP
+
+/*! \file Osi2ScenarioAPI_Imp.hpp
+
+  Provides a class to implement Osi2::ScenarioAPI.
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Osi2ScenarioAPI.hpp"
+#include "Osi2PackedModel.hpp"
+
+namespace Osi2 {
+
+/*! \brief Implementation class for ScenarioAPI
+
+  The base problem is copied once into a PackedModel and loaded from there
+  into each worker's solver. Each worker also keeps its own copy of the
+  bound and objective vectors. To run a scenario, the worker edits its
+  copies, pushes each edited vector to the solver (ClpSimplexAPI::chgRowLower
+  and friends), installs the base basis with copyinStatus, and calls dual.
+  Afterwards the edited entries are restored in the copies at once, but the
+  solver is brought back to the base values only when the next scenario
+  pushes its vectors; a vector changed by the previous scenario is pushed
+  whether or not the next one changes it.
+
+  Scenarios are held in a single queue; each is small and quick to solve,
+  so there is little to gain from per-worker queues.
+*/
+class ScenarioAPI_Imp : public ScenarioAPI {
+
+public:
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /// Registration constructor
+  ScenarioAPI_Imp (std::string name) ;
+  /// Default constructor
+  ScenarioAPI_Imp () ;
+  /// Destructor; stops the pool
+  ~ScenarioAPI_Imp () ;
+  //@}
+
+  /*! \name Pool control */
+  //@{
+  int start(ControlAPI &ctrl, ClpSimplexAPI &base, int workers = 0,
+	    const RunParamsAPI *params = nullptr) ;
+  void stop() ;
+  int getWorkerCnt() const { return (static_cast<int>(workers_.size())) ; }
+  const Result &getBaseResult() const { return (baseResult_) ; }
+  //@}
+
+  /*! \name Scenarios and results */
+  //@{
+  long submit(const Scenario &scenario) ;
+  bool nextResult(Result &result, bool wait = true) ;
+  long outstanding() const ;
+  //@}
+
+private:
+
+  /// Number of vectors a scenario can change
+  static const int targetCnt = Objective+1 ;
+
+  /// A scenario waiting in the queue
+  struct Task {
+    long scenarioID_ ;
+    Scenario scenario_ ;
+  } ;
+
+  /// A worker: solver, thread, and the entries it has moved off the base
+  struct Worker {
+    API *solverObj_ ;
+    ClpSimplexAPI *solver_ ;
+    std::thread thread_ ;
+    /// Indices changed by the last scenario, indexed by Target
+    std::vector<int> touched_[targetCnt] ;
+  } ;
+
+  /// Body of the thread for worker \p self
+  void work(int self) ;
+  /// Apply, solve, and undo one scenario
+  void runTask(Worker &worker, const Task &task, Result &result) ;
+  /// Set entry \p ndx of vector \p target in the worker's solver
+  void pushElem(Worker &worker, int target, int ndx, double val) ;
+  /// Fill in the result from the state of \p solver
+  void collect(ClpSimplexAPI &solver, bool keepSolution, Result &result) ;
+
+  /// Control object used to create and destroy solver objects
+  ControlAPI *ctrl_ ;
+  /// The workers
+  std::vector<Worker *> workers_ ;
+
+  /// The base problem
+  PackedModel base_ ;
+  /// Base values of the vectors, indexed by Target
+  std::vector<double> baseVecs_[targetCnt] ;
+  /// Optimal basis of the base problem; empty if there isn't one
+  std::vector<unsigned char> baseBasis_ ;
+  /// Result of the base solve
+  Result baseResult_ ;
+
+  /// Guards #queue_ and #stopping_, and #workers_ against #stop
+  std::mutex poolLock_ ;
+  /// Signalled when a scenario is submitted or the pool is stopping
+  std::condition_variable workAvail_ ;
+  /// Scenarios waiting for a worker
+  std::deque<Task> queue_ ;
+  /// True when the pool is stopping
+  bool stopping_ ;
+
+  /// Guards #results_ and #outstanding_
+  mutable std::mutex resultLock_ ;
+  /// Signalled when a result is ready
+  std::condition_variable resultAvail_ ;
+  /// Completed results, in completion order
+  std::deque<Result> results_ ;
+  /// Scenarios submitted whose results have not been retrieved
+  long outstanding_ ;
+
+  /// Next scenario id
+  std::atomic<long> nextScenarioID_ ;
+
+  /// Copying is not supported
+  ScenarioAPI_Imp (const ScenarioAPI_Imp &) ;
+  ScenarioAPI_Imp &operator= (const ScenarioAPI_Imp &) ;
+
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -0,0 +1,373 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for SolveCache.
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "Osi2Config.h"
+
+#include "Osi2SolveCache.hpp"
+
+namespace {
+
+/*
+  Parameters the solver updates as it runs (compare volatileSimplexParams
+  in the ClpLite shim). Their values reflect the last solve rather than the
+  profile, so they're left out of the key.
+*/
+const char *volatileParams[] = { "iter count", "perturbation" } ;
+
+bool isVolatile (const std::string &id)
+{
+  const char **end = volatileParams+
+		       sizeof(volatileParams)/sizeof(volatileParams[0]) ;
+  return (std::find(volatileParams,end,id) != end) ;
+}
+
+/*
+  Tag at the head of each cache file. Change the digit if the layout changes.
+*/
+const char fileMagic[8] = { 'O','S','I','2','R','E','S','1' } ;
+
+/*
+  Bytes between the current position and the end of the file; 0 if the file
+  can't be positioned.
+*/
+size_t bytesLeft (std::FILE *file)
+{
+  long here = std::ftell(file) ;
+  if (here < 0 || std::fseek(file,0,SEEK_END) != 0) return (0) ;
+  long end = std::ftell(file) ;
+  if (std::fseek(file,here,SEEK_SET) != 0 || end < here) return (0) ;
+  return (static_cast<size_t>(end-here)) ;
+}
+
+/*
+  Length-prefixed vector I/O for writeEntry and readEntry. A length that
+  claims more data than the file holds marks a damaged file; it's rejected
+  before any space is allocated.
+*/
+template <class T>
+bool writeVec (std::FILE *file, const std::vector<T> &vec)
+{
+  size_t len = vec.size() ;
+  if (std::fwrite(&len,sizeof(len),1,file) != 1) return (false) ;
+  if (len == 0) return (true) ;
+  return (std::fwrite(vec.data(),sizeof(T),len,file) == len) ;
+}
+
+template <class T>
+bool readVec (std::FILE *file, std::vector<T> &vec)
+{
+  size_t len = 0 ;
+  if (std::fread(&len,sizeof(len),1,file) != 1) return (false) ;
+  if (len > bytesLeft(file)/sizeof(T)) return (false) ;
+  vec.resize(len) ;
+  if (len == 0) return (true) ;
+  return (std::fread(vec.data(),sizeof(T),len,file) == len) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+/*
+  Let the solver fill in a copy of the profile, so that parameters the
+  profile doesn't mention are captured at the values in force. Ids are
+  sorted so that the text doesn't depend on the order of insertion. Void
+  parameters are pointers and can't be compared meaningfully; they're left
+  out, as are the volatile parameters.
+*/
+std::string SolveCache::profileText (ClpSimplexAPI &solver,
+				     const RunParamsAPI &profile)
+{
+  RunParamsAPI *effective = profile.clone() ;
+  solver.exposeParams(*effective) ;
+  std::ostringstream text ;
+  text.precision(17) ;
+  std::vector<std::string> ids = effective->getIntParamIds() ;
+  std::sort(ids.begin(),ids.end()) ;
+  for (int ndx = 0 ; ndx < ids.size() ; ndx++) {
+    if (isVolatile(ids[ndx])) continue ;
+    text << "i " << ids[ndx] << "="
+	 << effective->getIntParam(ids[ndx]) << "\n" ;
+  }
+  ids = effective->getDblParamIds() ;
+  std::sort(ids.begin(),ids.end()) ;
+  for (int ndx = 0 ; ndx < ids.size() ; ndx++) {
+    if (isVolatile(ids[ndx])) continue ;
+    text << "d " << ids[ndx] << "="
+	 << effective->getDblParam(ids[ndx]) << "\n" ;
+  }
+  ids = effective->getStrParamIds() ;
+  std::sort(ids.begin(),ids.end()) ;
+  for (int ndx = 0 ; ndx < ids.size() ; ndx++) {
+    if (isVolatile(ids[ndx])) continue ;
+    text << "s " << ids[ndx] << "="
+	 << effective->getStrParam(ids[ndx]) << "\n" ;
+  }
+  delete effective ;
+  return (text.str()) ;
+}
+
+size_t SolveCache::Entry::size () const
+{
+  return (sizeof(Entry)+model_.size()+profile_.size()+result_.basis_.size()+
+	  sizeof(double)*(result_.colSolution_.size()+
+			  result_.rowPrice_.size())) ;
+}
+
+/*
+  A key match that fails the exact comparison is a collision. It's counted
+  and reported as a miss; the entry will be replaced when the new result is
+  inserted.
+*/
+bool SolveCache::findInMemory (const Key &key, const PackedModel &model,
+			       const std::string &profile, Result &result)
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  std::unordered_map<Key,EntryList::iterator,
+		     ModelFingerprint::DigestHash>::iterator
+    iter = index_.find(key) ;
+  if (iter == index_.end()) return (false) ;
+  EntryList::iterator entry = iter->second ;
+  if (!(entry->profile_ == profile && entry->model_ == model)) {
+    collisions_++ ;
+    return (false) ;
+  }
+  entries_.splice(entries_.begin(),entries_,entry) ;
+  result = entry->result_ ;
+  return (true) ;
+}
+
+/*
+  The caller gives up the contents of entry. The most recent entry always
+  survives, even if it alone exceeds the budget.
+*/
+void SolveCache::insert (Entry &entry)
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  std::unordered_map<Key,EntryList::iterator,
+		     ModelFingerprint::DigestHash>::iterator
+    iter = index_.find(entry.key_) ;
+  if (iter != index_.end()) {
+    used_ -= iter->second->size() ;
+    entries_.erase(iter->second) ;
+    index_.erase(iter) ;
+  }
+  used_ += entry.size() ;
+  entries_.push_front(std::move(entry)) ;
+  index_[entries_.front().key_] = entries_.begin() ;
+  while (used_ > budget_ && entries_.size() > 1) {
+    const Entry &victim = entries_.back() ;
+    used_ -= victim.size() ;
+    index_.erase(victim.key_) ;
+    entries_.pop_back() ;
+  }
+}
+
+std::string SolveCache::entryPath (const Key &key) const
+{
+  return (dir_+"/"+key.toString()+".osi2res") ;
+}
+
+/*
+  Write to a temporary file and rename it into place, so that a reader in
+  another process never sees a partial entry.
+*/
+bool SolveCache::writeEntry (const Entry &entry) const
+{
+  std::string path = entryPath(entry.key_) ;
+  std::ostringstream suffix ;
+  suffix
+    << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id()) ;
+  std::string tmpPath = path+suffix.str() ;
+  std::FILE *file = std::fopen(tmpPath.c_str(),"wb") ;
+  if (file == nullptr) return (false) ;
+
+  const Result &result = entry.result_ ;
+  int ints[4] = { result.retval_, result.status_, result.secondaryStatus_,
+		  result.iterations_ } ;
+  std::vector<char> profile(entry.profile_.begin(),entry.profile_.end()) ;
+  bool ok = std::fwrite(fileMagic,1,sizeof(fileMagic),file) ==
+	      sizeof(fileMagic) &&
+	    std::fwrite(&entry.key_.h1_,sizeof(entry.key_.h1_),1,file) == 1 &&
+	    std::fwrite(&entry.key_.h2_,sizeof(entry.key_.h2_),1,file) == 1 &&
+	    writeVec(file,profile) &&
+	    entry.model_.write(file) &&
+	    std::fwrite(ints,sizeof(int),4,file) == 4 &&
+	    std::fwrite(&result.objective_,sizeof(double),1,file) == 1 &&
+	    writeVec(file,result.colSolution_) &&
+	    writeVec(file,result.rowPrice_) &&
+	    writeVec(file,result.basis_) ;
+  ok = (std::fclose(file) == 0) && ok ;
+  if (ok) ok = (std::rename(tmpPath.c_str(),path.c_str()) == 0) ;
+  if (!ok) std::remove(tmpPath.c_str()) ;
+  return (ok) ;
+}
+
+bool SolveCache::readEntry (const Key &key, Entry &entry) const
+{
+  std::FILE *file = std::fopen(entryPath(key).c_str(),"rb") ;
+  if (file == nullptr) return (false) ;
+
+  Result &result = entry.result_ ;
+  char magic[sizeof(fileMagic)] ;
+  int ints[4] ;
+  std::vector<char> profile ;
+  bool ok = std::fread(magic,1,sizeof(magic),file) == sizeof(magic) &&
+	    std::memcmp(magic,fileMagic,sizeof(magic)) == 0 &&
+	    std::fread(&entry.key_.h1_,sizeof(entry.key_.h1_),1,file) == 1 &&
+	    std::fread(&entry.key_.h2_,sizeof(entry.key_.h2_),1,file) == 1 &&
+	    entry.key_ == key &&
+	    readVec(file,profile) &&
+	    entry.model_.read(file) &&
+	    std::fread(ints,sizeof(int),4,file) == 4 &&
+	    std::fread(&result.objective_,sizeof(double),1,file) == 1 &&
+	    readVec(file,result.colSolution_) &&
+	    readVec(file,result.rowPrice_) &&
+	    readVec(file,result.basis_) ;
+  std::fclose(file) ;
+  if (!ok) return (false) ;
+  entry.profile_.assign(profile.begin(),profile.end()) ;
+  result.retval_ = ints[0] ;
+  result.status_ = ints[1] ;
+  result.secondaryStatus_ = ints[2] ;
+  result.iterations_ = ints[3] ;
+  return (true) ;
+}
+
+/*
+  The key combines the model fingerprint with a hash of the profile text;
+  the comparison against the stored copies settles the question. Packing
+  the model costs a pass over it, cheap next to a solve, and on a miss the
+  copy goes into the new entry.
+*/
+int SolveCache::solve (ClpSimplexAPI &solver, RunParamsAPI &profile,
+		       Result &result, bool *hit)
+{
+  solver.loadParams(profile) ;
+  Entry entry ;
+  entry.profile_ = profileText(solver,profile) ;
+  Key fp = ModelFingerprint::full(solver) ;
+  unsigned long long ph = std::hash<std::string>()(entry.profile_) ;
+  entry.key_.h1_ = fp.h1_^(ph*0x9e3779b97f4a7c15ULL) ;
+  entry.key_.h2_ = fp.h2_+ph ;
+  entry.model_ = PackedModel(solver) ;
+
+  {
+    std::lock_guard<std::mutex> lock(lock_) ;
+    lookups_++ ;
+  }
+  bool found = findInMemory(entry.key_,entry.model_,entry.profile_,result) ;
+  if (!found && !dir_.empty()) {
+    Entry stored ;
+    if (readEntry(entry.key_,stored)) {
+      if (stored.profile_ == entry.profile_ && stored.model_ == entry.model_) {
+	result = stored.result_ ;
+	insert(stored) ;
+	found = true ;
+      } else {
+	std::lock_guard<std::mutex> lock(lock_) ;
+	collisions_++ ;
+      }
+    }
+  }
+  if (hit != nullptr) *hit = found ;
+  if (found) {
+    std::lock_guard<std::mutex> lock(lock_) ;
+    hits_++ ;
+    return (result.retval_) ;
+  }
+
+  result.retval_ = solver.initialSolve() ;
+  result.status_ = solver.status() ;
+  result.secondaryStatus_ = solver.secondaryStatus() ;
+  result.iterations_ = solver.numberIterations() ;
+  result.objective_ = solver.objectiveValue() ;
+  int n = solver.numberColumns() ;
+  int m = solver.numberRows() ;
+  const double *vec = solver.getColSolution() ;
+  result.colSolution_.assign(vec,vec+n) ;
+  vec = solver.getRowPrice() ;
+  result.rowPrice_.assign(vec,vec+m) ;
+  const unsigned char *status = solver.statusArray() ;
+  if (status != nullptr)
+    result.basis_.assign(status,status+n+m) ;
+  else
+    result.basis_.clear() ;
+
+  entry.result_ = result ;
+  if (!dir_.empty()) writeEntry(entry) ;
+  insert(entry) ;
+
+  return (result.retval_) ;
+}
+
+void SolveCache::clear ()
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  entries_.clear() ;
+  index_.clear() ;
+  used_ = 0 ;
+}
+
+long SolveCache::getLookupCnt () const
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  return (lookups_) ;
+}
+
+long SolveCache::getHitCnt () const
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  return (hits_) ;
+}
+
+long SolveCache::getCollisionCnt () const
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  return (collisions_) ;
+}
+
+int SolveCache::getEntryCnt () const
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  return (static_cast<int>(entries_.size())) ;
+}
+
+size_t SolveCache::getMemoryUsed () const
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  return (used_) ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+SolveCache::SolveCache (size_t budget, const std::string &dir)
+  : budget_(budget),
+    dir_(dir),
+    used_(0),
+    lookups_(0),
+    hits_(0),
+    collisions_(0)
+{ }
+
+SolveCache::~SolveCache ()
+{ }
+
+}  // end namespace Osi2
@@ -0,0 +1,181 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2SolveCache.hpp
+
+  Defines SolveCache, a cache of solve results keyed by model and parameter
+  profile.
+*/
+
+#ifndef Osi2SolveCache_HPP
+#define Osi2SolveCache_HPP
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2RunParamsAPI.hpp"
+#include "Osi2ModelFingerprint.hpp"
+#include "Osi2PackedModel.hpp"
+
+namespace Osi2 {
+
+/*! \brief A cache of solve results
+
+  A SolveCache sits in front of ClpSimplexAPI::initialSolve. #solve applies
+  a parameter profile to the solver and looks for a stored result for the
+  pair (model, effective profile). On a hit, the stored result is returned
+  and Clp is not invoked. On a miss, the solver is run and the result
+  stored.
+
+  The key is the full ModelFingerprint of the model combined with a hash of
+  the effective profile: the parameter values the solver reports through
+  exposeParams after the profile has been applied. Each entry keeps a copy
+  of the model and the profile, and a hit is reported only if both match
+  exactly, so a hash collision cannot return the wrong answer.
+
+  Entries are evicted least recently used first when the memory they use
+  would exceed the budget. If a directory is given, each entry is also
+  written there, one file per entry, and a miss in memory is looked for on
+  disk before the solver is run. The files are in native binary format and
+  are meant to be shared only between processes on the same machine.
+
+  All methods may be called concurrently from several threads, each with its
+  own solver.
+*/
+class SolveCache {
+
+public:
+
+  /// A cached result
+  struct Result {
+    /// Return code from initialSolve
+    int retval_ ;
+    /// Problem status (ClpSimplexAPI::status)
+    int status_ ;
+    /// Secondary status (ClpSimplexAPI::secondaryStatus)
+    int secondaryStatus_ ;
+    /// Iteration count
+    int iterations_ ;
+    /// Objective value
+    double objective_ ;
+    /// Primal solution
+    std::vector<double> colSolution_ ;
+    /// Dual solution
+    std::vector<double> rowPrice_ ;
+    /// Basis (ClpSimplexAPI::statusArray)
+    std::vector<unsigned char> basis_ ;
+  } ;
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /*! \brief Constructor
+
+    \p budget is the bound, in bytes, on the memory used by cached entries.
+    If \p dir is not empty, entries are persisted in that directory, which
+    must exist.
+  */
+  SolveCache(size_t budget = 256*1024*1024, const std::string &dir = "") ;
+  /// Destructor
+  ~SolveCache() ;
+  //@}
+
+  /*! \name Solve through the cache */
+  //@{
+  /*! \brief Solve the model held by \p solver under \p profile
+
+    Applies \p profile, then returns the cached result if there is one, or
+    solves and caches the result. \p hit, if supplied, reports which. On a
+    hit, the solver's state is unchanged apart from the profile. Returns the
+    return code from initialSolve.
+  */
+  int solve(ClpSimplexAPI &solver, RunParamsAPI &profile, Result &result,
+	    bool *hit = nullptr) ;
+
+  /// Discard all entries held in memory; statistics are not reset
+  void clear() ;
+  //@}
+
+  /*! \name Statistics */
+  //@{
+  /// Number of lookups
+  long getLookupCnt() const ;
+  /// Number of lookups satisfied from memory or disk
+  long getHitCnt() const ;
+  /// Number of lookups where the key matched but the model or profile didn't
+  long getCollisionCnt() const ;
+  /// Number of entries held in memory
+  int getEntryCnt() const ;
+  /// Memory used by entries held in memory, in bytes
+  size_t getMemoryUsed() const ;
+  //@}
+
+private:
+
+  typedef ModelFingerprint::Digest Key ;
+
+  /// A cache entry
+  struct Entry {
+    Key key_ ;
+    PackedModel model_ ;
+    std::string profile_ ;
+    Result result_ ;
+    /// Bytes charged against the budget
+    size_t size() const ;
+  } ;
+
+  typedef std::list<Entry> EntryList ;
+
+  /// Canonical text form of the effective profile
+  static std::string profileText(ClpSimplexAPI &solver,
+				 const RunParamsAPI &profile) ;
+
+  /// Look up \p key in memory; on an exact match, copy out the result
+  bool findInMemory(const Key &key, const PackedModel &model,
+		    const std::string &profile, Result &result) ;
+
+  /// Add an entry to memory, evicting as necessary
+  void insert(Entry &entry) ;
+
+  /// Path of the file for \p key
+  std::string entryPath(const Key &key) const ;
+  /// Write \p entry to the cache directory
+  bool writeEntry(const Entry &entry) const ;
+  /// Read the entry for \p key from the cache directory
+  bool readEntry(const Key &key, Entry &entry) const ;
+
+  /// Memory budget
+  size_t budget_ ;
+  /// Cache directory; empty if entries are not persisted
+  std::string dir_ ;
+  /// Entries, most recently used first
+  EntryList entries_ ;
+  /// Index from key to entry
+  std::unordered_map<Key,EntryList::iterator,ModelFingerprint::DigestHash>
+    index_ ;
+  /// Memory in use
+  size_t used_ ;
+  /// Statistics
+  long lookups_ ;
+  long hits_ ;
+  long collisions_ ;
+  /// Protects everything above
+  mutable std::mutex lock_ ;
+
+  /// Copying is not supported
+  SolveCache(const SolveCache &) ;
+  SolveCache &operator=(const SolveCache &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -0,0 +1,69 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for SolveCanceller.
+*/
+
+#include "Osi2Config.h"
+
+#include "Osi2SolveCanceller.hpp"
+
+namespace {
+
+/*
+  The canceller active on this thread. The callback has no user argument
+  beyond the clp model, so this is how it finds its state.
+*/
+thread_local Osi2::SolveCanceller *activeCanceller = nullptr ;
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+/*
+  Clp invokes the callback only for messages that pass the log level, so
+  make sure progress messages are generated. With a callback installed,
+  they go to the callback rather than to the output.
+*/
+SolveCanceller::SolveCanceller (ClpSimplexAPI &solver,
+				const std::atomic<bool> &cancel)
+  : solver_(solver),
+    cancel_(cancel),
+    fired_(false),
+    savedMaxIters_(solver.maximumIterations()),
+    savedLogLvl_(solver.logLevel()),
+    prev_(activeCanceller)
+{
+  activeCanceller = this ;
+  if (savedLogLvl_ < 1) solver_.setLogLevel(1) ;
+  solver_.registerCallBack(&SolveCanceller::check) ;
+}
+
+SolveCanceller::~SolveCanceller ()
+{
+  solver_.clearCallBack() ;
+  solver_.setMaximumIterations(savedMaxIters_) ;
+  solver_.setLogLevel(savedLogLvl_) ;
+  activeCanceller = prev_ ;
+}
+
+/*
+  Runs on the solving thread, so it's safe to poke the solver.
+*/
+void SolveCanceller::check (Clp_Simplex *model, int msgno, int ndouble,
+			    const double *dvec, int nint, const int *ivec,
+			    int nchar, char **cvec)
+{
+  SolveCanceller *self = activeCanceller ;
+  if (self == nullptr || self->fired_) return ;
+  if (self->cancel_.load(std::memory_order_relaxed)) {
+    self->solver_.setMaximumIterations(0) ;
+    self->fired_ = true ;
+  }
+}
+
+} // namespace Osi2
@@ -0,0 +1,82 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2SolveCanceller.hpp
+
+  Defines SolveCanceller, which lets another thread stop a solve through the
+  solver's callback hook.
+*/
+
+#ifndef Osi2SolveCanceller_HPP
+#define Osi2SolveCanceller_HPP
+
+#include <atomic>
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+namespace Osi2 {
+
+/*! \brief Cooperative cancellation of a solve
+
+  While a SolveCanceller is in scope, the solver's callback
+  (ClpSimplexAPI::registerCallBack) checks a cancellation flag. When the
+  flag is raised, the check sets the solver's iteration limit to zero; clp
+  stops the next time it checks its limits, which it does at the iteration
+  boundaries where it reports progress. The solve then returns with status
+  3 (limit reached). Barrier does not consult the iteration limit until
+  crossover.
+
+  The callback is invoked on the thread running the solve and finds its
+  state through a thread-local pointer, so the SolveCanceller must be
+  constructed on the thread that runs the solve. SolveCancellers nest, but
+  only the innermost one on a thread is active.
+
+  The destructor removes the callback and restores the iteration limit and
+  log level. Any callback registered by the client is replaced for the
+  duration and is not restored.
+*/
+class SolveCanceller {
+
+public:
+
+  /// Constructor; installs the check on \p solver
+  SolveCanceller(ClpSimplexAPI &solver, const std::atomic<bool> &cancel) ;
+  /// Destructor; removes the check
+  ~SolveCanceller() ;
+
+  /// True if the solve was stopped by the cancellation flag
+  bool cancelled() const { return (fired_) ; }
+
+private:
+
+  /// The callback
+  static void check(Clp_Simplex *model, int msgno, int ndouble,
+		    const double *dvec, int nint, const int *ivec,
+		    int nchar, char **cvec) ;
+
+  /// Solver being watched
+  ClpSimplexAPI &solver_ ;
+  /// Cancellation flag
+  const std::atomic<bool> &cancel_ ;
+  /// True once the solver has been told to stop
+  bool fired_ ;
+  /// Iteration limit in force at construction
+  int savedMaxIters_ ;
+  /// Log level in force at construction
+  int savedLogLvl_ ;
+  /// Canceller active on this thread at construction
+  SolveCanceller *prev_ ;
+
+  /// Copying is not supported
+  SolveCanceller(const SolveCanceller &) ;
+  SolveCanceller &operator=(const SolveCanceller &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -0,0 +1,197 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for SolveFuture and
+  the function solveAsync.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Osi2Config.h"
+
+#include "Osi2SolveFuture.hpp"
+#include "Osi2SolveCanceller.hpp"
+
+namespace Osi2 {
+
+/*
+  The state is shared by the handle and the background thread. The
+  background thread touches only solver_, cancel_, and started_ until it
+  sets done_, under lock_. The handle joins the thread before releasing the
+  state.
+*/
+struct SolveFuture::State {
+  State(ClpSimplexAPI &solver, Method method)
+    : solver_(solver),
+      method_(method),
+      cancel_(false),
+      started_(false),
+      done_(false),
+      retval_(-1),
+      cancelled_(false)
+  { }
+  ClpSimplexAPI &solver_ ;
+  Method method_ ;
+  std::atomic<bool> cancel_ ;
+  std::atomic<bool> started_ ;
+  std::thread thread_ ;
+  mutable std::mutex lock_ ;
+  std::condition_variable finished_ ;
+  bool done_ ;
+  int retval_ ;
+  bool cancelled_ ;
+} ;
+
+/*
+  The canceller must be constructed here, on the thread that runs the solve.
+  If the client cancelled before we got going, don't bother to start.
+*/
+void SolveFuture::run (State *state)
+{
+  ClpSimplexAPI &solver = state->solver_ ;
+  int retval = -1 ;
+  bool cancelled = true ;
+  if (!state->cancel_) {
+    SolveCanceller canceller(solver,state->cancel_) ;
+    state->started_ = true ;
+    switch (state->method_) {
+      case InitialDual: {
+	retval = solver.initialDualSolve() ;
+	break ;
+      }
+      case InitialPrimal: {
+	retval = solver.initialPrimalSolve() ;
+	break ;
+      }
+      case InitialBarrier: {
+	retval = solver.initialBarrierSolve() ;
+	break ;
+      }
+      case Dual: {
+	retval = solver.dual() ;
+	break ;
+      }
+      case Primal: {
+	retval = solver.primal() ;
+	break ;
+      }
+      default: {
+	retval = solver.initialSolve() ;
+	break ;
+      }
+    }
+    cancelled = canceller.cancelled() ;
+  }
+  {
+    std::lock_guard<std::mutex> lock(state->lock_) ;
+    state->retval_ = retval ;
+    state->cancelled_ = cancelled ;
+    state->done_ = true ;
+  }
+  state->finished_.notify_all() ;
+}
+
+SolveFuture solveAsync (ClpSimplexAPI &solver, SolveFuture::Method method)
+{
+  SolveFuture::State *state = new SolveFuture::State(solver,method) ;
+  state->thread_ = std::thread(&SolveFuture::run,state) ;
+  return (SolveFuture(state)) ;
+}
+
+bool SolveFuture::started () const
+{
+  return (state_ != nullptr && state_->started_) ;
+}
+
+bool SolveFuture::poll () const
+{
+  if (state_ == nullptr) return (false) ;
+  std::lock_guard<std::mutex> lock(state_->lock_) ;
+  return (state_->done_) ;
+}
+
+bool SolveFuture::waitFor (double seconds)
+{
+  if (state_ == nullptr) return (false) ;
+  std::unique_lock<std::mutex> lock(state_->lock_) ;
+  std::chrono::duration<double> timeout(seconds) ;
+  return (state_->finished_.wait_for(lock,timeout,
+				     [this] { return (state_->done_) ; })) ;
+}
+
+/*
+  Once the thread has reported, joining it is immediate.
+*/
+int SolveFuture::wait ()
+{
+  if (state_ == nullptr) return (-1) ;
+  {
+    std::unique_lock<std::mutex> lock(state_->lock_) ;
+    while (!state_->done_) state_->finished_.wait(lock) ;
+  }
+  if (state_->thread_.joinable()) state_->thread_.join() ;
+  return (state_->retval_) ;
+}
+
+void SolveFuture::cancel ()
+{
+  if (state_ != nullptr) state_->cancel_ = true ;
+}
+
+bool SolveFuture::cancelled () const
+{
+  if (state_ == nullptr) return (false) ;
+  std::lock_guard<std::mutex> lock(state_->lock_) ;
+  return (state_->cancelled_) ;
+}
+
+void SolveFuture::release ()
+{
+  if (state_ == nullptr) return ;
+  cancel() ;
+  wait() ;
+  delete state_ ;
+  state_ = nullptr ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+SolveFuture::SolveFuture ()
+  : state_(nullptr)
+{ }
+
+SolveFuture::SolveFuture (State *state)
+  : state_(state)
+{ }
+
+SolveFuture::SolveFuture (SolveFuture &&rhs)
+  : state_(rhs.state_)
+{
+  rhs.state_ = nullptr ;
+}
+
+SolveFuture &SolveFuture::operator= (SolveFuture &&rhs)
+{
+  if (this != &rhs) {
+    release() ;
+    state_ = rhs.state_ ;
+    rhs.state_ = nullptr ;
+  }
+  return (*this) ;
+}
+
+SolveFuture::~SolveFuture ()
+{
+  release() ;
+}
+
+}  // end namespace Osi2
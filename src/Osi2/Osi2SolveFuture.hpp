@@ -0,0 +1,133 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2SolveFuture.hpp
+
+  Defines solveAsync, which runs a solve in a background thread, and
+  SolveFuture, the handle used to wait for, poll, or cancel the solve.
+*/
+
+#ifndef Osi2SolveFuture_HPP
+#define Osi2SolveFuture_HPP
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+namespace Osi2 {
+
+/*! \brief Handle for a solve running in a background thread
+
+  A SolveFuture is returned by #solveAsync. It can be moved but not copied.
+  The solver object belongs to the background thread until the solve has
+  finished, as reported by #poll, #waitFor, or #wait; the client must not
+  touch it in the meantime. Once the solve has finished, the results are
+  available from the solver object in the usual way.
+
+  #cancel asks the solver to stop. Cancellation is cooperative, through a
+  SolveCanceller: the solver stops at its next iteration boundary and the
+  solve reports status 3 (limit reached). #cancel does not wait; follow it
+  with #wait. If #cancel gets in before the background thread has started
+  the solve, the solve is never run: #started stays false, #wait returns -1,
+  #cancelled is true, and the solver object is left as it was.
+
+  The destructor cancels a solve that is still running and waits for it to
+  stop.
+*/
+class SolveFuture {
+
+public:
+
+  /// The solve to run
+  enum Method { Initial = 0, InitialDual, InitialPrimal, InitialBarrier,
+		Dual, Primal } ;
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /// Default constructor; the handle is not associated with a solve
+  SolveFuture() ;
+  /// Move constructor; \p rhs is left without a solve
+  SolveFuture(SolveFuture &&rhs) ;
+  /// Move assignment; any solve held by this handle is cancelled first
+  SolveFuture &operator=(SolveFuture &&rhs) ;
+  /// Destructor; cancels the solve if it's still running
+  ~SolveFuture() ;
+  //@}
+
+  /*! \name Methods to monitor and control the solve */
+  //@{
+  /// True if the handle is associated with a solve
+  bool valid() const { return (state_ != nullptr) ; }
+
+  /*! \brief True once the background thread has started the solve
+
+    From this point a #cancel is seen by the solver itself.
+  */
+  bool started() const ;
+
+  /// True if the solve has finished
+  bool poll() const ;
+
+  /*! \brief Wait up to \p seconds for the solve to finish
+
+    Returns true if the solve has finished.
+  */
+  bool waitFor(double seconds) ;
+
+  /*! \brief Wait for the solve to finish
+
+    Returns the return code from the solve, or -1 if the handle is not
+    associated with a solve or the solve was cancelled before it started.
+  */
+  int wait() ;
+
+  /// Ask the solver to stop at its next iteration boundary
+  void cancel() ;
+
+  /*! \brief True if the solve was stopped by #cancel
+
+    Valid only once the solve has finished. A solve that finished before it
+    noticed the cancellation is not reported as cancelled.
+  */
+  bool cancelled() const ;
+  //@}
+
+private:
+
+  friend SolveFuture solveAsync(ClpSimplexAPI &solver, Method method) ;
+
+  /// State shared with the background thread
+  struct State ;
+
+  /// Constructor used by #solveAsync
+  SolveFuture(State *state) ;
+
+  /// Body of the background thread
+  static void run(State *state) ;
+
+  /// Cancel, wait for, and release any solve held by the handle
+  void release() ;
+
+  State *state_ ;
+
+  /// Copying is not supported
+  SolveFuture(const SolveFuture &) ;
+  SolveFuture &operator=(const SolveFuture &) ;
+
+} ;
+
+/*! \brief Start a solve in a background thread
+
+  Runs \p method on \p solver in a new thread and returns a handle to the
+  solve. The problem and parameters must be loaded beforehand. For the
+  duration of the solve, the solver's callback is used for cancellation;
+  any callback registered by the client is removed.
+*/
+SolveFuture solveAsync(ClpSimplexAPI &solver,
+		       SolveFuture::Method method = SolveFuture::Initial) ;
+
+} // namespace Osi2
+
+#endif
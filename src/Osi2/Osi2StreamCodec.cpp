@@ -0,0 +1,326 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for StreamCodec and
+  the gzip codec.
+*/
+
+#include "Osi2Config.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#ifdef OSI2_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#include "Osi2StreamCodec.hpp"
+
+namespace {
+
+using Osi2::InputStream ;
+using Osi2::OutputStream ;
+using Osi2::StreamCodec ;
+
+#ifdef OSI2_HAS_ZLIB
+
+/*
+  Buffer sizes for compressed data.
+*/
+const size_t zBufSize = 1<<18 ;
+
+/*
+  zlib counts in uInt, so requests larger than that are fed to it in
+  pieces.
+*/
+const size_t zMaxChunk = UINT_MAX ;
+
+/*
+  Decoding. A file may hold several gzip members end to end (as produced
+  by cat a.gz b.gz); each is decoded in turn. Running out of input part
+  way through a member means the file is truncated.
+*/
+class GzipInputStream : public InputStream {
+
+public:
+
+  GzipInputStream (std::unique_ptr<InputStream> raw)
+    : raw_(std::move(raw)), in_(zBufSize), inMember_(false), ended_(false),
+      failed_(false)
+  { std::memset(&zs_,0,sizeof(zs_)) ;
+    failed_ = (inflateInit2(&zs_,15+32) != Z_OK) ; }
+  ~GzipInputStream () { inflateEnd(&zs_) ; }
+
+  size_t read (char *buf, size_t len) ;
+  bool failed () const { return (failed_ || raw_->failed()) ; }
+
+private:
+
+  size_t readChunk(char *buf, size_t len) ;
+
+  std::unique_ptr<InputStream> raw_ ;
+  std::vector<char> in_ ;
+  z_stream zs_ ;
+  bool inMember_ ;
+  bool ended_ ;
+  bool failed_ ;
+} ;
+
+size_t GzipInputStream::read (char *buf, size_t len)
+{
+  size_t done = 0 ;
+  while (done < len && !ended_ && !failed_) {
+    size_t chunk = std::min(len-done,zMaxChunk) ;
+    size_t got = readChunk(buf+done,chunk) ;
+    done += got ;
+    if (got < chunk) break ;
+  }
+  return (done) ;
+}
+
+/*
+  Decode at most zMaxChunk bytes into buf.
+*/
+size_t GzipInputStream::readChunk (char *buf, size_t len)
+{
+  zs_.next_out = reinterpret_cast<Bytef *>(buf) ;
+  zs_.avail_out = static_cast<uInt>(len) ;
+  while (zs_.avail_out > 0) {
+    if (zs_.avail_in == 0) {
+      size_t got = raw_->read(&in_[0],in_.size()) ;
+      if (got == 0) {
+	ended_ = true ;
+	failed_ = inMember_ ;
+	break ;
+      }
+      zs_.next_in = reinterpret_cast<Bytef *>(&in_[0]) ;
+      zs_.avail_in = static_cast<uInt>(got) ;
+    }
+    int ret = inflate(&zs_,Z_NO_FLUSH) ;
+    inMember_ = (ret != Z_STREAM_END) ;
+    if (ret == Z_STREAM_END) {
+      inflateReset(&zs_) ;
+    } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+      failed_ = true ;
+      break ;
+    }
+  }
+  return (len-zs_.avail_out) ;
+}
+
+/*
+  Encoding, at zlib's default level.
+*/
+class GzipOutputStream : public OutputStream {
+
+public:
+
+  GzipOutputStream (std::unique_ptr<OutputStream> raw)
+    : raw_(std::move(raw)), out_(zBufSize), ok_(true)
+  { std::memset(&zs_,0,sizeof(zs_)) ;
+    ok_ = (deflateInit2(&zs_,Z_DEFAULT_COMPRESSION,Z_DEFLATED,15+16,8,
+			Z_DEFAULT_STRATEGY) == Z_OK) ; }
+  ~GzipOutputStream () { deflateEnd(&zs_) ; }
+
+  bool write (const char *buf, size_t len) ;
+  bool close () ;
+
+private:
+
+  bool pump (int flush) ;
+
+  std::unique_ptr<OutputStream> raw_ ;
+  std::vector<char> out_ ;
+  z_stream zs_ ;
+  bool ok_ ;
+} ;
+
+/*
+  Run deflate until it has consumed its input (or, when finishing, until it
+  reports the end of the stream), passing the output on as it fills.
+*/
+bool GzipOutputStream::pump (int flush)
+{
+  while (ok_) {
+    zs_.next_out = reinterpret_cast<Bytef *>(&out_[0]) ;
+    zs_.avail_out = static_cast<uInt>(out_.size()) ;
+    int ret = deflate(&zs_,flush) ;
+    if (ret == Z_STREAM_ERROR) {
+      ok_ = false ;
+      break ;
+    }
+    size_t have = out_.size()-zs_.avail_out ;
+    if (have > 0) ok_ = raw_->write(&out_[0],have) ;
+    if (flush == Z_FINISH) {
+      if (ret == Z_STREAM_END) break ;
+    } else if (zs_.avail_in == 0 && zs_.avail_out > 0) {
+      break ;
+    }
+  }
+  return (ok_) ;
+}
+
+bool GzipOutputStream::write (const char *buf, size_t len)
+{
+  while (len > 0 && ok_) {
+    size_t chunk = std::min(len,zMaxChunk) ;
+    zs_.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(buf)) ;
+    zs_.avail_in = static_cast<uInt>(chunk) ;
+    pump(Z_NO_FLUSH) ;
+    buf += chunk ;
+    len -= chunk ;
+  }
+  return (ok_) ;
+}
+
+bool GzipOutputStream::close ()
+{
+  zs_.next_in = nullptr ;
+  zs_.avail_in = 0 ;
+  pump(Z_FINISH) ;
+  ok_ = raw_->close() && ok_ ;
+  return (ok_) ;
+}
+
+class GzipCodec : public StreamCodec {
+
+public:
+
+  const char *name () const { return ("gzip") ; }
+  const char *suffix () const { return (".gz") ; }
+  bool recognise (const unsigned char *head, size_t len) const
+  { return (len >= 2 && head[0] == 0x1f && head[1] == 0x8b) ; }
+  std::unique_ptr<InputStream> decoder (std::unique_ptr<InputStream> raw)
+    const
+  { return (std::unique_ptr<InputStream>
+		(new GzipInputStream(std::move(raw)))) ; }
+  std::unique_ptr<OutputStream> encoder (std::unique_ptr<OutputStream> raw)
+    const
+  { return (std::unique_ptr<OutputStream>
+		(new GzipOutputStream(std::move(raw)))) ; }
+} ;
+
+#endif
+
+/*
+  The registry, constructed on first use with the built-in codecs.
+*/
+struct Registry {
+  std::mutex lock_ ;
+  std::vector<std::unique_ptr<StreamCodec> > codecs_ ;
+  Registry ()
+  {
+#   ifdef OSI2_HAS_ZLIB
+    codecs_.push_back(std::unique_ptr<StreamCodec>(new GzipCodec())) ;
+#   endif
+  }
+} ;
+
+Registry &registry ()
+{
+  static Registry theRegistry ;
+  return (theRegistry) ;
+}
+
+}  // end file-local namespace
+
+
+namespace Osi2 {
+
+/*
+  Codecs are never removed, so the pointers handed out stay valid.
+*/
+void StreamCodec::registerCodec (std::unique_ptr<StreamCodec> codec)
+{
+  Registry &reg = registry() ;
+  std::lock_guard<std::mutex> lock(reg.lock_) ;
+  reg.codecs_.insert(reg.codecs_.begin(),std::move(codec)) ;
+}
+
+const StreamCodec *StreamCodec::forContent (const unsigned char *head,
+					    size_t len)
+{
+  Registry &reg = registry() ;
+  std::lock_guard<std::mutex> lock(reg.lock_) ;
+  for (size_t ndx = 0 ; ndx < reg.codecs_.size() ; ndx++)
+    if (reg.codecs_[ndx]->recognise(head,len))
+      return (reg.codecs_[ndx].get()) ;
+  return (nullptr) ;
+}
+
+const StreamCodec *StreamCodec::forName (const char *filename)
+{
+  size_t nameLen = std::strlen(filename) ;
+  Registry &reg = registry() ;
+  std::lock_guard<std::mutex> lock(reg.lock_) ;
+  for (size_t ndx = 0 ; ndx < reg.codecs_.size() ; ndx++) {
+    const char *sfx = reg.codecs_[ndx]->suffix() ;
+    size_t sfxLen = std::strlen(sfx) ;
+    if (nameLen > sfxLen &&
+	std::strcmp(filename+nameLen-sfxLen,sfx) == 0)
+      return (reg.codecs_[ndx].get()) ;
+  }
+  return (nullptr) ;
+}
+
+/*
+  Sniff the head of the file, then reopen it from the start for the
+  decoder.
+*/
+std::unique_ptr<InputStream> StreamCodec::openInput (const char *filename,
+						     bool pipelined)
+{
+  unsigned char head[headSize] ;
+  size_t len = 0 ;
+  {
+    FileInputStream probe(filename) ;
+    if (!probe.isOpen()) return (std::unique_ptr<InputStream>()) ;
+    len = probe.read(reinterpret_cast<char *>(head),headSize) ;
+  }
+  std::unique_ptr<FileInputStream> file(new FileInputStream(filename)) ;
+  if (!file->isOpen()) return (std::unique_ptr<InputStream>()) ;
+  std::unique_ptr<InputStream> stream(std::move(file)) ;
+  const StreamCodec *codec = forContent(head,len) ;
+  if (codec != nullptr) stream = codec->decoder(std::move(stream)) ;
+  if (pipelined)
+    stream.reset(new PipelinedInputStream(std::move(stream))) ;
+  return (stream) ;
+}
+
+std::unique_ptr<OutputStream> StreamCodec::openOutput (const char *filename,
+						       const char *encodeAs)
+{
+  std::unique_ptr<FileOutputStream> file(new FileOutputStream(filename)) ;
+  if (!file->isOpen()) return (std::unique_ptr<OutputStream>()) ;
+  std::unique_ptr<OutputStream> stream(std::move(file)) ;
+  const StreamCodec *codec =
+    forName((encodeAs != nullptr)?encodeAs:filename) ;
+  if (codec != nullptr) stream = codec->encoder(std::move(stream)) ;
+  return (stream) ;
+}
+
+bool StreamCodec::copyFile (const char *from, const char *to)
+{
+  std::unique_ptr<InputStream> in = openInput(from,false) ;
+  if (!in) return (false) ;
+  std::unique_ptr<OutputStream> out = openOutput(to) ;
+  if (!out) return (false) ;
+  std::vector<char> buf(1<<18) ;
+  bool ok = true ;
+  size_t got ;
+  while (ok && (got = in->read(&buf[0],buf.size())) > 0)
+    ok = out->write(&buf[0],got) ;
+  ok = !in->failed() && out->close() && ok ;
+  out.reset() ;
+  if (!ok) std::remove(to) ;
+  return (ok) ;
+}
+
+}  // end namespace Osi2
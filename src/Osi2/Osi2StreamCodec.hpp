@@ -0,0 +1,104 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2StreamCodec.hpp
+
+  Defines StreamCodec, the interface to compression formats for model
+  files, and the registry used to pick a codec for a file.
+*/
+
+#ifndef Osi2StreamCodec_HPP
+#define Osi2StreamCodec_HPP
+
+#include <cstddef>
+#include <memory>
+
+#include "Osi2ByteStream.hpp"
+
+namespace Osi2 {
+
+/*! \brief A compression format
+
+  A codec recognises its own data by the first few bytes and wraps a raw
+  stream in a decoding or encoding stream. Codecs are held in a
+  process-wide registry. On input, a file is matched against the registered
+  codecs by content, so a compressed file is read correctly whatever its
+  name; on output, the codec is chosen by the suffix of the file name.
+
+  A gzip codec (suffix .gz) is registered when Osi2 is built with zlib.
+  Further codecs can be added with #registerCodec.
+*/
+class StreamCodec {
+
+public:
+
+  /// Destructor
+  virtual ~StreamCodec() { }
+
+  /// Name of the format, e.g., "gzip"
+  virtual const char *name() const = 0 ;
+  /// File name suffix for the format, including the dot
+  virtual const char *suffix() const = 0 ;
+  /// True if \p len bytes at \p head start data in this format
+  virtual bool recognise(const unsigned char *head, size_t len) const = 0 ;
+  /// A stream that decodes \p raw
+  virtual std::unique_ptr<InputStream>
+    decoder(std::unique_ptr<InputStream> raw) const = 0 ;
+  /*! \brief A stream that encodes onto \p raw
+
+    Closing the returned stream finishes the encoding and closes \p raw.
+  */
+  virtual std::unique_ptr<OutputStream>
+    encoder(std::unique_ptr<OutputStream> raw) const = 0 ;
+
+  /*! \name The registry */
+  //@{
+  /// Add \p codec; it is tried before those already registered
+  static void registerCodec(std::unique_ptr<StreamCodec> codec) ;
+  /// The codec that recognises \p head, or null if none does
+  static const StreamCodec *forContent(const unsigned char *head,
+				       size_t len) ;
+  /// The codec whose suffix ends \p filename, or null if none does
+  static const StreamCodec *forName(const char *filename) ;
+  /// Number of bytes needed by forContent
+  static const size_t headSize = 16 ;
+  //@}
+
+  /*! \name Opening files */
+  //@{
+  /*! \brief Open \p filename for reading, decoding it if need be
+
+    If \p pipelined is true, the file is read and decoded on a separate
+    thread (see PipelinedInputStream). Returns null if the file can't be
+    opened.
+  */
+  static std::unique_ptr<InputStream> openInput(const char *filename,
+						bool pipelined = true) ;
+  /*! \brief Create \p filename for writing
+
+    The output is encoded with the codec named by the suffix of
+    \p encodeAs, which defaults to \p filename itself. This allows a file
+    to be written under a temporary name and renamed later. Returns null if
+    the file can't be created.
+  */
+  static std::unique_ptr<OutputStream> openOutput(const char *filename,
+						  const char *encodeAs =
+						    nullptr) ;
+  /*! \brief Copy \p from to \p to
+
+    \p from is decoded if it is compressed and \p to is encoded according
+    to its suffix. This lets a writer that only knows about plain files
+    produce a compressed one. Returns false on any error, in which case
+    \p to is removed.
+  */
+  static bool copyFile(const char *from, const char *to) ;
+  //@}
+
+} ;
+
+} // namespace Osi2
+
+#endif
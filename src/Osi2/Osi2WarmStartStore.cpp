@@ -0,0 +1,209 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for WarmStartStore.
+*/
+
+#include <utility>
+
+#include "Osi2Config.h"
+
+#include "Osi2WarmStartStore.hpp"
+
+namespace Osi2 {
+
+size_t WarmStartStore::Entry::size () const
+{
+  return (sizeof(Entry)+status_.size()+
+	  sizeof(double)*(colSolution_.size()+rowPrice_.size())) ;
+}
+
+/*
+  The caller must hold the lock. A key match with different dimensions is a
+  collision; treat it as a miss.
+*/
+WarmStartStore::EntryList::iterator
+  WarmStartStore::find (const Key &key, int numCols, int numRows)
+{
+  std::unordered_map<Key,EntryList::iterator,
+		     ModelFingerprint::DigestHash>::iterator
+    iter = index_.find(key) ;
+  if (iter == index_.end()) return (entries_.end()) ;
+  EntryList::iterator entry = iter->second ;
+  if (entry->numCols_ != numCols || entry->numRows_ != numRows)
+    return (entries_.end()) ;
+  entries_.splice(entries_.begin(),entries_,entry) ;
+  return (entry) ;
+}
+
+/*
+  The caller must hold the lock. The most recent entry always survives, even
+  if it alone exceeds the budget.
+*/
+void WarmStartStore::trim ()
+{
+  while (used_ > budget_ && entries_.size() > 1) {
+    const Entry &victim = entries_.back() ;
+    used_ -= victim.size() ;
+    index_.erase(victim.key_) ;
+    entries_.pop_back() ;
+  }
+}
+
+/*
+  Build the entry outside the lock; the arrays can be large.
+*/
+bool WarmStartStore::save (ClpSimplexAPI &solver)
+{
+  if (!solver.isProvenOptimal()) return (false) ;
+  const unsigned char *status = solver.statusArray() ;
+  if (status == nullptr) return (false) ;
+
+  Entry entry ;
+  entry.key_ = ModelFingerprint::structure(solver) ;
+  entry.numCols_ = solver.numberColumns() ;
+  entry.numRows_ = solver.numberRows() ;
+  entry.status_.assign(status,status+entry.numCols_+entry.numRows_) ;
+  if (keepValues_) {
+    const double *vec = solver.getColSolution() ;
+    entry.colSolution_.assign(vec,vec+entry.numCols_) ;
+    vec = solver.getRowPrice() ;
+    entry.rowPrice_.assign(vec,vec+entry.numRows_) ;
+  }
+
+  std::lock_guard<std::mutex> lock(lock_) ;
+  std::unordered_map<Key,EntryList::iterator,
+		     ModelFingerprint::DigestHash>::iterator
+    iter = index_.find(entry.key_) ;
+  if (iter != index_.end()) {
+    used_ -= iter->second->size() ;
+    entries_.erase(iter->second) ;
+    index_.erase(iter) ;
+  }
+  used_ += entry.size() ;
+  entries_.push_front(std::move(entry)) ;
+  index_[entries_.front().key_] = entries_.begin() ;
+  trim() ;
+
+  return (true) ;
+}
+
+/*
+  Copy the arrays out under the lock, then load them into the solver
+  without it.
+*/
+bool WarmStartStore::inject (ClpSimplexAPI &solver)
+{
+  Key key = ModelFingerprint::structure(solver) ;
+  int n = solver.numberColumns() ;
+  int m = solver.numberRows() ;
+  std::vector<unsigned char> status ;
+  std::vector<double> colSolution ;
+  {
+    std::lock_guard<std::mutex> lock(lock_) ;
+    lookups_++ ;
+    EntryList::iterator entry = find(key,n,m) ;
+    if (entry == entries_.end()) return (false) ;
+    hits_++ ;
+    status = entry->status_ ;
+    colSolution = entry->colSolution_ ;
+  }
+  solver.copyinStatus(status.data()) ;
+  if (colSolution.size() > 0) solver.setColSolution(colSolution.data()) ;
+
+  return (true) ;
+}
+
+/*
+  With a basis in place, dual simplex picks up where the stored solve left
+  off. initialSolve would run presolve and discard it.
+*/
+int WarmStartStore::solve (ClpSimplexAPI &solver)
+{
+  int retval ;
+  if (inject(solver))
+    retval = solver.dual() ;
+  else
+    retval = solver.initialSolve() ;
+  save(solver) ;
+  return (retval) ;
+}
+
+bool WarmStartStore::getRowPrice (ClpSimplexAPI &solver,
+				  std::vector<double> &rowPrice)
+{
+  Key key = ModelFingerprint::structure(solver) ;
+  int n = solver.numberColumns() ;
+  int m = solver.numberRows() ;
+  std::lock_guard<std::mutex> lock(lock_) ;
+  EntryList::iterator entry = find(key,n,m) ;
+  if (entry == entries_.end() || entry->rowPrice_.size() == 0) return (false) ;
+  rowPrice = entry->rowPrice_ ;
+  return (true) ;
+}
+
+void WarmStartStore::clear ()
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  entries_.clear() ;
+  index_.clear() ;
+  used_ = 0 ;
+}
+
+long WarmStartStore::getLookupCnt () const
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  return (lookups_) ;
+}
+
+long WarmStartStore::getHitCnt () const
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  return (hits_) ;
+}
+
+double WarmStartStore::getHitRate () const
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  if (lookups_ == 0) return (0.0) ;
+  return (static_cast<double>(hits_)/lookups_) ;
+}
+
+int WarmStartStore::getEntryCnt () const
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  return (static_cast<int>(entries_.size())) ;
+}
+
+size_t WarmStartStore::getMemoryUsed () const
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  return (used_) ;
+}
+
+void WarmStartStore::resetStats ()
+{
+  std::lock_guard<std::mutex> lock(lock_) ;
+  lookups_ = 0 ;
+  hits_ = 0 ;
+}
+
+/*
+  Boilerplate: Constructors, destructors, & such like
+*/
+
+WarmStartStore::WarmStartStore (size_t budget, bool keepValues)
+  : budget_(budget),
+    keepValues_(keepValues),
+    used_(0),
+    lookups_(0),
+    hits_(0)
+{ }
+
+WarmStartStore::~WarmStartStore ()
+{ }
+
+}  // end namespace Osi2
@@ -0,0 +1,162 @@
+/*
+  Copyright 2019 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2WarmStartStore.hpp
+
+  Defines WarmStartStore, a cache of optimal bases keyed by the structure of
+  the model.
+*/
+
+#ifndef Osi2WarmStartStore_HPP
+#define Osi2WarmStartStore_HPP
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2ModelFingerprint.hpp"
+
+namespace Osi2 {
+
+/*! \brief A store of warm start bases
+
+  After an optimal solve, #save records the status array (and, optionally,
+  the primal and dual solution) of the solver, keyed by the structural
+  ModelFingerprint of the model: the dimensions and the sparsity pattern of
+  the constraint matrix. Coefficient values, bounds, and objective are not
+  part of the key, so a model with the same structure and different data
+  will find the basis. Before the next solve, #inject looks for a basis for
+  the model held by the solver and loads it with copyinStatus (and, if
+  values were kept, setColSolution). #solve wraps the three steps.
+
+  Entries are evicted least recently used first when the memory used by the
+  stored arrays would exceed the budget given to the constructor. Lookups
+  and hits are counted for #getHitRate.
+
+  All methods may be called concurrently from several threads, each with
+  its own solver.
+*/
+class WarmStartStore {
+
+public:
+
+  /*! \name Constructors and Destructors */
+  //@{
+  /*! \brief Constructor
+
+    \p budget is the bound, in bytes, on the memory used by stored arrays.
+    If \p keepValues is true, the primal and dual solutions are stored along
+    with the status array.
+  */
+  WarmStartStore(size_t budget = 64*1024*1024, bool keepValues = false) ;
+  /// Destructor
+  ~WarmStartStore() ;
+  //@}
+
+  /*! \name Store and retrieve bases */
+  //@{
+  /*! \brief Save the basis held by \p solver
+
+    Does nothing unless the solver holds a proven optimal solution. Returns
+    true if the basis was stored.
+  */
+  bool save(ClpSimplexAPI &solver) ;
+
+  /*! \brief Load a stored basis into \p solver
+
+    Returns true if a basis was found for the model held by the solver.
+  */
+  bool inject(ClpSimplexAPI &solver) ;
+
+  /*! \brief Inject, solve, and save
+
+    Injects a stored basis if there is one, calls initialSolve (dual if a
+    basis was injected), then saves the resulting basis. Returns the return
+    code from the solve.
+  */
+  int solve(ClpSimplexAPI &solver) ;
+
+  /*! \brief Copy out the stored dual solution for \p solver's model
+
+    Only available if the store was constructed to keep values. Returns
+    true if a dual solution was found.
+  */
+  bool getRowPrice(ClpSimplexAPI &solver, std::vector<double> &rowPrice) ;
+
+  /// Discard all stored bases; statistics are not reset
+  void clear() ;
+  //@}
+
+  /*! \name Statistics */
+  //@{
+  /// Number of lookups
+  long getLookupCnt() const ;
+  /// Number of lookups that found a basis
+  long getHitCnt() const ;
+  /// Fraction of lookups that found a basis
+  double getHitRate() const ;
+  /// Number of stored bases
+  int getEntryCnt() const ;
+  /// Memory used by stored arrays, in bytes
+  size_t getMemoryUsed() const ;
+  /// Reset lookup and hit counts
+  void resetStats() ;
+  //@}
+
+private:
+
+  typedef ModelFingerprint::Digest Key ;
+
+  /// A stored basis
+  struct Entry {
+    Key key_ ;
+    int numCols_ ;
+    int numRows_ ;
+    std::vector<unsigned char> status_ ;
+    std::vector<double> colSolution_ ;
+    std::vector<double> rowPrice_ ;
+    /// Bytes charged against the budget
+    size_t size() const ;
+  } ;
+
+  typedef std::list<Entry> EntryList ;
+
+  /// Find the entry for \p key matching the dimensions and make it MRU
+  EntryList::iterator find(const Key &key, int numCols, int numRows) ;
+
+  /// Evict LRU entries until the budget is respected
+  void trim() ;
+
+  /// Memory budget
+  size_t budget_ ;
+  /// Keep primal and dual values?
+  bool keepValues_ ;
+  /// Entries, most recently used first
+  EntryList entries_ ;
+  /// Index from key to entry
+  std::unordered_map<Key,EntryList::iterator,ModelFingerprint::DigestHash>
+    index_ ;
+  /// Memory in use
+  size_t used_ ;
+  /// Statistics
+  long lookups_ ;
+  long hits_ ;
+  /// Protects everything above
+  mutable std::mutex lock_ ;
+
+  /// Copying is not supported
+  WarmStartStore(const WarmStartStore &) ;
+  WarmStartStore &operator=(const WarmStartStore &) ;
+
+} ;
+
+} // namespace Osi2
+
+#endif
@@ -14,6 +14,7 @@
 #include "Osi2ClpLite_Wrap.hpp"
 #include "Osi2ClpSimplexAPI_ClpLite.hpp"
 #include "Osi2ClpSolveParamsAPI_ClpLite.hpp"
+#include "Osi2NameIndexAPI.hpp"
 
 namespace Osi2 {
 
@@ -33,10 +34,13 @@ void ClpLite_Wrap::addClpSimplex (DynamicLibrary *libClp)
 {
 /*
   Install a ClpSimplexAPI object and a ClpSolveParams object and add them to
-  the set of supported APIs.
+  the set of supported APIs. The ClpSimplexAPI object supplies the name
+  index.
 */
   clp_ = new ClpSimplexAPI_ClpLite(libClp) ;
   apiMgr_.addAPIID(ClpSimplexAPI::getAPIIDString(),clp_) ;
+  apiMgr_.addAPIID(NameIndexAPI::getAPIIDString(),
+		   clp_->getAPIPtr(NameIndexAPI::getAPIIDString())) ;
   clpSolve_ = new ClpSolveParamsAPI_ClpLite(libClp) ;
   apiMgr_.addAPIID(ClpSolveParamsAPI::getAPIIDString(),clpSolve_) ;
 }
@@ -13,12 +13,21 @@
 */
 
 #include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 #include "Osi2Config.h"
 #include "Osi2nullptr.hpp"
 
 #include "Osi2DynamicLibrary.hpp"
 #include "Osi2RunParamsAPI.hpp"
+#include "Osi2ModelImage.hpp"
+#include "Osi2ModelCache.hpp"
+#include "Osi2ModelWriter.hpp"
+#include "Osi2StreamCodec.hpp"
+#include "Osi2MpsReader.hpp"
+#include "Osi2MappedNames.hpp"
 
 #include "Osi2ClpSimplexAPI_ClpLite.hpp"
 
@@ -58,6 +67,15 @@ KnownMemberMap doubleSimplexParams = {
   mapEntry3("dual bound","Clp_dualBound","Clp_setDualBound")
 } ;
 
+/*
+  Parameters that clp itself modifies in the course of a solve. The value in
+  a RunParamsAPI object can't be assumed to still be in force just because
+  it hasn't changed since the last load, so these are always pushed.
+*/
+const char *volatileSimplexParams[] = { "iter count", "perturbation" } ;
+const int volatileSimplexParamCnt =
+    sizeof(volatileSimplexParams)/sizeof(volatileSimplexParams[0]) ;
+
 /*
   You'd expect Clp_problemName, Clp_setProblemName here but they don't fit the
   standard model for Clp_C_Interface get / set methods. An empty map is left
@@ -88,6 +106,25 @@ KnownXformMap knownXforms = {
   {std::string("kill small"),std::string("doKillSmall")}
 } ;
 
+/*
+  Clp_Interface methods for the vectors held in the modification journal,
+  indexed by ClpSimplexAPI_ClpLite::JournalVec: the get method, the change
+  method, and the method that returns the length of the vector.
+*/
+struct JournalVecFuncs {
+  const char *getter_ ;
+  const char *setter_ ;
+  const char *length_ ;
+} ;
+
+const JournalVecFuncs journalVecFuncs[] = {
+  { "Clp_rowLower", "Clp_chgRowLower", "Clp_numberRows" },
+  { "Clp_rowUpper", "Clp_chgRowUpper", "Clp_numberRows" },
+  { "Clp_columnLower", "Clp_chgColumnLower", "Clp_numberColumns" },
+  { "Clp_columnUpper", "Clp_chgColumnUpper", "Clp_numberColumns" },
+  { "Clp_objective", "Clp_chgObjCoefficients", "Clp_numberColumns" }
+} ;
+
 }    // end anonymous namespace
 
 
@@ -101,7 +138,13 @@ typedef ClpSimplexAPI_ClpLite CSA_CL ;
 CSA_CL::ClpSimplexAPI_ClpLite (DynamicLibrary *libClp)
     : paramMgr_(ParamBEAPI_Imp<CSA_CL>(this)),
       libClp_(libClp),
-      clpC_(nullptr)
+      clpC_(nullptr),
+      nameIndex_(this),
+      lazyNames_(false),
+      parallelWrite_(false),
+      loadedParams_(nullptr),
+      loadedGen_(0),
+      journalPending_(false)
 {
   std::string errStr ;
 /*
@@ -116,10 +159,11 @@ CSA_CL::ClpSimplexAPI_ClpLite (DynamicLibrary *libClp)
   }
 /*
   Register that we are a ClpSimplex API and that we support parameter
-  management.
+  management and a name index.
 */
   paramMgr_.addAPIID(ClpSimplexAPI::getAPIIDString(),this) ;
   paramMgr_.addAPIID(ParamBEAPI::getAPIIDString(),&paramMgr_) ;
+  paramMgr_.addAPIID(NameIndexAPI::getAPIIDString(),&nameIndex_) ;
 /*
   Register the parameters exposed through parameter management
 */
@@ -218,6 +262,8 @@ void CSA_CL::loadProblem (const int numcols, const int numrows,
 	const double *rowlb, const double *rowub)
 {
   std::string errStr ;
+  forgetLoadedParams() ;
+  clearJournal() ;
 
   typedef void (*ClpLdProbFunc)(Clp_Simplex *,const int, const int,
   	const CoinBigIndex *,const int *,const double *,
@@ -231,6 +277,37 @@ void CSA_CL::loadProblem (const int numcols, const int numrows,
     loadProblem(clpC_,numcols,numrows,start,index,value,
     		collb,colub,obj,rowlb,rowub) ;
   }
+  mappedNames_.reset() ;
+  nameIndex_.invalidate() ;
+}
+
+/*
+  The C interface has no way to hand arrays over to clp, so copy them in and
+  free them straight away.
+*/
+void CSA_CL::assignProblem (const int numcols, const int numrows,
+	CoinBigIndex *&start, int *&index, double *&value,
+	double *&collb, double *&colub, double *&obj,
+	double *&rowlb, double *&rowub)
+{
+  loadProblem(numcols,numrows,start,index,value,
+	      collb,colub,obj,rowlb,rowub) ;
+  delete[] start ;
+  start = nullptr ;
+  delete[] index ;
+  index = nullptr ;
+  delete[] value ;
+  value = nullptr ;
+  delete[] collb ;
+  collb = nullptr ;
+  delete[] colub ;
+  colub = nullptr ;
+  delete[] obj ;
+  obj = nullptr ;
+  delete[] rowlb ;
+  rowlb = nullptr ;
+  delete[] rowub ;
+  rowub = nullptr ;
 }
 
 /*
@@ -240,6 +317,7 @@ void CSA_CL::loadQuadraticObjective (const int numcols,
 	const CoinBigIndex *start, const int *index, const double *value)
 {
   std::string errStr ;
+  syncModel() ;
 
   typedef void (*ClpLdQuadFunc)(Clp_Simplex *,const int,
   	const CoinBigIndex *,const int *,const double *) ;
@@ -276,6 +354,8 @@ void CSA_CL::deleteIntegerInformation ()
 
 void CSA_CL::resize (int newNumberRows, int newNumberColumns)
 {
+  syncModel() ;
+  handOverNames() ;
   simpleSetter<Clp_Simplex,int>(libClp_,clpC_,"Clp_resize",
   				newNumberRows,newNumberColumns) ;
 }
@@ -290,6 +370,8 @@ void CSA_CL::addRows (int number, const double *rowlb, const double *rowub,
 	const CoinBigIndex *rowStart, const int *index, const double *value)
 {
   std::string errStr ;
+  syncModel() ;
+  handOverNames() ;
 
   typedef void (*ClpAddRowFunc)(Clp_Simplex *,
   	const int, const double *,const double *,
@@ -306,30 +388,43 @@ void CSA_CL::addRows (int number, const double *rowlb, const double *rowub,
 
 void CSA_CL::deleteRows (int number, const int *which)
 {
+  syncModel() ;
+  handOverNames() ;
   simpleSetter<Clp_Simplex,int,const int *>
       (libClp_,clpC_,"Clp_deleteRows",number,which) ;
+  nameIndex_.namesDeleted(true,number,which) ;
 }
 
 double *CSA_CL::rowLower () const
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,double *>(libClp_,clpC_,"Clp_rowLower")) ;
 }
 
 void CSA_CL::chgRowLower (const double *rowlb)
 {
-  simpleSetter<Clp_Simplex,const double *>
-      (libClp_,clpC_,"Clp_chgRowLower",rowlb) ;
+  journalVec(JRowLower,rowlb) ;
+}
+
+void CSA_CL::setRowLower (int ndx, double val)
+{
+  journalElem(JRowLower,ndx,val) ;
 }
 
 double *CSA_CL::rowUpper () const
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,double *>(libClp_,clpC_,"Clp_rowUpper")) ;
 }
 
 void CSA_CL::chgRowUpper (const double *rowub)
 {
-  simpleSetter<Clp_Simplex,const double *>
-      (libClp_,clpC_,"Clp_chgRowUpper",rowub) ;
+  journalVec(JRowUpper,rowub) ;
+}
+
+void CSA_CL::setRowUpper (int ndx, double val)
+{
+  journalElem(JRowUpper,ndx,val) ;
 }
 
 
@@ -344,6 +439,8 @@ void CSA_CL::addColumns (int number,
 	const CoinBigIndex *colStart, const int *index, const double *value)
 {
   std::string errStr ;
+  syncModel() ;
+  handOverNames() ;
 
   typedef void (*ClpAddColFunc)(Clp_Simplex *,
   	const int, const double *,const double *, const double *,
@@ -360,92 +457,256 @@ void CSA_CL::addColumns (int number,
 
 void CSA_CL::deleteColumns (int number, const int *which)
 {
+  syncModel() ;
+  handOverNames() ;
   simpleSetter<Clp_Simplex,int,const int *>
       (libClp_,clpC_,"Clp_deleteColumns",number,which) ;
+  nameIndex_.namesDeleted(false,number,which) ;
 }
 
 double *CSA_CL::columnLower () const
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,double *>
   	      (libClp_,clpC_,"Clp_columnLower")) ;
 }
 
 void CSA_CL::chgColumnLower (const double *collb)
 {
-  simpleSetter<Clp_Simplex,const double *>
-      (libClp_,clpC_,"Clp_chgColumnLower",collb) ;
+  journalVec(JColLower,collb) ;
+}
+
+void CSA_CL::setColumnLower (int ndx, double val)
+{
+  journalElem(JColLower,ndx,val) ;
 }
 
 double *CSA_CL::columnUpper () const
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,double *>
   	      (libClp_,clpC_,"Clp_columnUpper")) ;
 }
 
 void CSA_CL::chgColumnUpper (const double *colub)
 {
-  simpleSetter<Clp_Simplex,const double *>
-      (libClp_,clpC_,"Clp_chgColumnUpper",colub) ;
+  journalVec(JColUpper,colub) ;
+}
+
+void CSA_CL::setColumnUpper (int ndx, double val)
+{
+  journalElem(JColUpper,ndx,val) ;
 }
 
 double *CSA_CL::objective () const
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,double *>(libClp_,clpC_,"Clp_objective")) ;
 }
 
 void CSA_CL::chgObjCoefficients (const double *obj)
 {
-  simpleSetter<Clp_Simplex,const double *>
-      (libClp_,clpC_,"Clp_chgObjCoefficients",obj) ;
+  journalVec(JObj,obj) ;
+}
+
+void CSA_CL::setObjectiveCoefficient (int ndx, double val)
+{
+  journalElem(JObj,ndx,val) ;
 }
 
 /*
   Retrieve information about the constraint matrix.
 */
 CoinBigIndex CSA_CL::getNumElements () const
-{ 
+{
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,CoinBigIndex>
 	      (libClp_,clpC_,"Clp_getNumElements")) ;
 }
 
 const CoinBigIndex *CSA_CL::getVectorStarts () const
-{ 
+{
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,const CoinBigIndex *>
 	      (libClp_,clpC_,"Clp_getVectorStarts")) ;
 }
 
 const int *CSA_CL::getVectorLengths () const
-{ 
+{
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,const int *>
 	      (libClp_,clpC_,"Clp_getVectorLengths")) ;
 }
 
 const int *CSA_CL::getIndices () const
-{ 
+{
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,const int *>
 	      (libClp_,clpC_,"Clp_getIndices")) ;
 }
 
 const double *CSA_CL::getElements () const
-{ 
+{
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,const double *>
 	      (libClp_,clpC_,"Clp_getElements")) ;
 }
 
 void CSA_CL::modifyCoefficient (int row, int col, double val, bool keepZero)
+{
+  coeffJournal_[std::make_pair(col,row)] = std::make_pair(val,keepZero) ;
+  journalPending_ = true ;
+}
+
+/*
+  The modification journal. See the class definition for the rationale.
+*/
+void CSA_CL::flush ()
+{
+  syncModel() ;
+}
+
+/*
+  A null vector asks clp for default values. Let clp supply them, right
+  away, and forget any pending changes to the vector.
+*/
+void CSA_CL::journalVec (JournalVec which, const double *value)
+{
+  VecJournal &jrnl = vecJournal_[which] ;
+  jrnl.edits_.clear() ;
+  if (value == nullptr) {
+    jrnl.haveFull_ = false ;
+    simpleSetter<Clp_Simplex,const double *>
+	(libClp_,clpC_,journalVecFuncs[which].setter_,value) ;
+    return ;
+  }
+  int len = simpleGetter<Clp_Simplex,int>
+	        (libClp_,clpC_,journalVecFuncs[which].length_) ;
+  jrnl.full_.assign(value,value+len) ;
+  jrnl.haveFull_ = true ;
+  journalPending_ = true ;
+}
+
+void CSA_CL::journalElem (JournalVec which, int ndx, double value)
+{
+  VecJournal &jrnl = vecJournal_[which] ;
+  if (jrnl.haveFull_) {
+    if (ndx >= 0 && ndx < static_cast<int>(jrnl.full_.size()))
+      jrnl.full_[ndx] = value ;
+  } else {
+    jrnl.edits_.push_back(std::make_pair(ndx,value)) ;
+  }
+  journalPending_ = true ;
+}
+
+/*
+  Element changes without a replacement vector are applied to a copy of
+  clp's current vector. Edits are applied in order of arrival, so the last
+  change to an element wins. Out of range indices are ignored.
+*/
+void CSA_CL::applyVecJournal (JournalVec which) const
+{
+  VecJournal &jrnl = vecJournal_[which] ;
+  if (!jrnl.haveFull_ && jrnl.edits_.empty()) return ;
+
+  const JournalVecFuncs &funcs = journalVecFuncs[which] ;
+  int len = simpleGetter<Clp_Simplex,int>(libClp_,clpC_,funcs.length_) ;
+  if (!jrnl.haveFull_) {
+    const double *current =
+	simpleGetter<Clp_Simplex,double *>(libClp_,clpC_,funcs.getter_) ;
+    if (current != nullptr)
+      jrnl.full_.assign(current,current+len) ;
+    else
+      jrnl.full_.assign(len,0.0) ;
+  }
+  for (size_t k = 0 ; k < jrnl.edits_.size() ; k++) {
+    int ndx = jrnl.edits_[k].first ;
+    if (ndx >= 0 && ndx < len) jrnl.full_[ndx] = jrnl.edits_[k].second ;
+  }
+  if (static_cast<int>(jrnl.full_.size()) == len) {
+    simpleSetter<Clp_Simplex,const double *>
+	(libClp_,clpC_,funcs.setter_,jrnl.full_.data()) ;
+  }
+  jrnl.haveFull_ = false ;
+  jrnl.full_.clear() ;
+  jrnl.edits_.clear() ;
+}
+
+/*
+  Bounds go first, so that clp sees the new bounds when a status change
+  moves a variable to a bound. The C interface functions for coefficients
+  and status are looked up once for the whole pass.
+*/
+void CSA_CL::applyJournal () const
 {
   std::string errStr ;
+  journalPending_ = false ;
+
+  for (int which = 0 ; which < JVecCnt ; which++)
+    applyVecJournal(static_cast<JournalVec>(which)) ;
 
-  typedef void (*ClpModCoeffFunc)(Clp_Simplex *,int,int,double,bool) ;
-  static ClpModCoeffFunc modCoeff = nullptr ;
+  if (!coeffJournal_.empty()) {
+    typedef void (*ClpModCoeffFunc)(Clp_Simplex *,int,int,double,bool) ;
+    static ClpModCoeffFunc modCoeff = nullptr ;
+    if (modCoeff == nullptr) {
+      modCoeff =
+	  libClp_->getFunc<ClpModCoeffFunc>("Clp_modifyCoefficient",errStr) ;
+    }
+    if (modCoeff != nullptr) {
+      std::map<std::pair<int,int>,std::pair<double,bool> >::const_iterator
+	iter ;
+      for (iter = coeffJournal_.begin() ; iter != coeffJournal_.end() ;
+	   iter++) {
+	modCoeff(clpC_,iter->first.second,iter->first.first,
+		 iter->second.first,iter->second.second) ;
+      }
+    }
+    coeffJournal_.clear() ;
+  }
 
-  if (modCoeff == nullptr) {
-    modCoeff =
-        libClp_->getFunc<ClpModCoeffFunc>("Clp_modifyCoefficient",errStr) ;
+  if (!colStatusJournal_.empty() || !rowStatusJournal_.empty()) {
+    typedef void (*ClpSetStatusFunc)(Clp_Simplex *,int,int) ;
+    static ClpSetStatusFunc setColStatus = nullptr ;
+    static ClpSetStatusFunc setRowStatus = nullptr ;
+    if (setColStatus == nullptr) {
+      setColStatus =
+	  libClp_->getFunc<ClpSetStatusFunc>("Clp_setColumnStatus",errStr) ;
+    }
+    if (setRowStatus == nullptr) {
+      setRowStatus =
+	  libClp_->getFunc<ClpSetStatusFunc>("Clp_setRowStatus",errStr) ;
+    }
+    std::map<int,ClpSimplexAPI::Status>::const_iterator iter ;
+    if (setColStatus != nullptr) {
+      for (iter = colStatusJournal_.begin() ;
+	   iter != colStatusJournal_.end() ; iter++)
+	setColStatus(clpC_,iter->first,iter->second) ;
+    }
+    if (setRowStatus != nullptr) {
+      for (iter = rowStatusJournal_.begin() ;
+	   iter != rowStatusJournal_.end() ; iter++)
+	setRowStatus(clpC_,iter->first,iter->second) ;
+    }
+    colStatusJournal_.clear() ;
+    rowStatusJournal_.clear() ;
   }
-  if (modCoeff != nullptr) {
-    modCoeff(clpC_,row,col,val,keepZero) ;
+}
+
+/*
+  Used when the model is replaced; pending changes refer to the old one.
+*/
+void CSA_CL::clearJournal ()
+{
+  for (int which = 0 ; which < JVecCnt ; which++) {
+    VecJournal &jrnl = vecJournal_[which] ;
+    jrnl.haveFull_ = false ;
+    jrnl.full_.clear() ;
+    jrnl.edits_.clear() ;
   }
+  coeffJournal_.clear() ;
+  colStatusJournal_.clear() ;
+  rowStatusJournal_.clear() ;
+  journalPending_ = false ;
 }
 
 /*
@@ -453,75 +714,181 @@ void CSA_CL::modifyCoefficient (int row, int col, double val, bool keepZero)
 */
 bool CSA_CL::statusExists () const
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,bool>(libClp_,clpC_,"Clp_statusExists")) ;
 }
 
 unsigned char *CSA_CL::statusArray () const
-{ 
+{
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,unsigned char *>
 	      (libClp_,clpC_,"Clp_statusArray")) ;
 }
 
+/*
+  A status array replaces all status, so pending status changes are simply
+  dropped.
+*/
 void CSA_CL::copyinStatus (const unsigned char *status)
 {
+  colStatusJournal_.clear() ;
+  rowStatusJournal_.clear() ;
   simpleSetter<Clp_Simplex,const unsigned char *>
       (libClp_,clpC_,"Clp_copyinStatus",status) ;
 }
 
 ClpSimplexAPI::Status CSA_CL::getColumnStatus (int ndx)
-{ 
+{
+  std::map<int,ClpSimplexAPI::Status>::const_iterator iter =
+      colStatusJournal_.find(ndx) ;
+  if (iter != colStatusJournal_.end()) return (iter->second) ;
   return (simpleGetter<Clp_Simplex,ClpSimplexAPI::Status,int>
 	      (libClp_,clpC_,"Clp_getColumnStatus",ndx)) ;
 }
 
 void CSA_CL::setColumnStatus (int ndx, ClpSimplexAPI::Status status)
 {
-  simpleSetter<Clp_Simplex,int,ClpSimplexAPI::Status>
-      (libClp_,clpC_,"Clp_setColumnStatus",ndx,status) ;
+  colStatusJournal_[ndx] = status ;
+  journalPending_ = true ;
 }
 
 ClpSimplexAPI::Status CSA_CL::getRowStatus (int ndx)
-{ 
+{
+  std::map<int,ClpSimplexAPI::Status>::const_iterator iter =
+      rowStatusJournal_.find(ndx) ;
+  if (iter != rowStatusJournal_.end()) return (iter->second) ;
   return (simpleGetter<Clp_Simplex,ClpSimplexAPI::Status,int>
 	      (libClp_,clpC_,"Clp_getRowStatus",ndx)) ;
 }
 
 void CSA_CL::setRowStatus (int ndx, ClpSimplexAPI::Status status)
 {
-  simpleSetter<Clp_Simplex,int,ClpSimplexAPI::Status>
-      (libClp_,clpC_,"Clp_setRowStatus",ndx,status) ;
+  rowStatusJournal_[ndx] = status ;
+  journalPending_ = true ;
+}
+
+/*
+  Bulk status methods. Clp keeps column status first, then row status, in a
+  single array. The getters read it directly; the setters patch a copy and
+  hand it back with copyinStatus, which also creates the array if there
+  isn't one yet.
+*/
+void CSA_CL::getStatusRange (bool rows, int first, int last,
+			     ClpSimplexAPI::Status *status)
+{
+  syncModel() ;
+  int n = numberColumns() ;
+  int m = numberRows() ;
+  int len = (rows)?m:n ;
+  if (first < 0 || last > len || first >= last) return ;
+
+  int base = (rows)?n:0 ;
+  const unsigned char *array =
+      simpleGetter<Clp_Simplex,unsigned char *>
+	  (libClp_,clpC_,"Clp_statusArray") ;
+  for (int ndx = first ; ndx < last ; ndx++) {
+    if (array != nullptr)
+      status[ndx-first] =
+	  static_cast<ClpSimplexAPI::Status>(array[base+ndx]&7) ;
+    else
+      status[ndx-first] = ClpSimplexAPI::isFree ;
+  }
+}
+
+void CSA_CL::setStatusRange (bool rows, int first, int last,
+			     const ClpSimplexAPI::Status *status)
+{
+  syncModel() ;
+  int n = numberColumns() ;
+  int m = numberRows() ;
+  int len = (rows)?m:n ;
+  if (first < 0 || last > len || first >= last) return ;
+
+  int base = (rows)?n:0 ;
+  const unsigned char *current =
+      simpleGetter<Clp_Simplex,unsigned char *>
+	  (libClp_,clpC_,"Clp_statusArray") ;
+  std::vector<unsigned char> array ;
+  if (current != nullptr)
+    array.assign(current,current+n+m) ;
+  else
+    array.assign(n+m,0) ;
+  for (int ndx = first ; ndx < last ; ndx++) {
+    unsigned char &entry = array[base+ndx] ;
+    entry = static_cast<unsigned char>((entry&~7)|status[ndx-first]) ;
+  }
+  simpleSetter<Clp_Simplex,const unsigned char *>
+      (libClp_,clpC_,"Clp_copyinStatus",array.data()) ;
+}
+
+void CSA_CL::getColumnStatus (int first, int last,
+			      ClpSimplexAPI::Status *status)
+{
+  getStatusRange(false,first,last,status) ;
+}
+
+void CSA_CL::setColumnStatus (int first, int last,
+			      const ClpSimplexAPI::Status *status)
+{
+  setStatusRange(false,first,last,status) ;
+}
+
+void CSA_CL::getRowStatus (int first, int last,
+			   ClpSimplexAPI::Status *status)
+{
+  getStatusRange(true,first,last,status) ;
+}
+
+void CSA_CL::setRowStatus (int first, int last,
+			   const ClpSimplexAPI::Status *status)
+{
+  setStatusRange(true,first,last,status) ;
 }
 
 /*
-  Retrieve and modify row and column names.
+  Retrieve and modify row and column names. Lazy names are answered from
+  the file; a change hands them over to clp first.
 */
 int CSA_CL::lengthNames () const
 {
+  if (mappedNames_) return (mappedNames_->maxLength()) ;
   return (simpleGetter<Clp_Simplex,int>(libClp_,clpC_,"Clp_lengthNames")) ;
 }
 
 void CSA_CL::rowName (int ndx, char *buffer) const
 {
+  if (mappedNames_) {
+    mappedNames_->copyName(true,ndx,buffer) ;
+    return ;
+  }
   simpleSetter<Clp_Simplex,int,char *>
       (libClp_,clpC_,"Clp_rowName",ndx,buffer) ;
 }
 
 void CSA_CL::setRowName (int ndx, const char *buffer)
 {
+  handOverNames() ;
   simpleSetter<Clp_Simplex,int,const char *>
       (libClp_,clpC_,"Clp_setRowName",ndx,buffer) ;
+  nameIndex_.namesChanged(true,ndx,ndx+1) ;
 }
 
 void CSA_CL::columnName (int ndx, char *buffer) const
 {
+  if (mappedNames_) {
+    mappedNames_->copyName(false,ndx,buffer) ;
+    return ;
+  }
   simpleSetter<Clp_Simplex,int,char *>
       (libClp_,clpC_,"Clp_columnName",ndx,buffer) ;
 }
 
 void CSA_CL::setColumnName (int ndx, const char *buffer)
 {
+  handOverNames() ;
   simpleSetter<Clp_Simplex,int,const char *>
       (libClp_,clpC_,"Clp_setColumnName",ndx,buffer) ;
+  nameIndex_.namesChanged(false,ndx,ndx+1) ;
 }
 
 void CSA_CL::copyNames (const char *const *rowNames,
@@ -529,19 +896,159 @@ void CSA_CL::copyNames (const char *const *rowNames,
 {
   simpleSetter<Clp_Simplex,const char *const *,const char *const *>
       (libClp_,clpC_,"Clp_copyNames",rowNames,columnNames) ;
+  mappedNames_.reset() ;
+  nameIndex_.invalidate() ;
 }
 
 void CSA_CL::dropNames ()
 {
   simpleSetter<Clp_Simplex>(libClp_,clpC_,"Clp_dropNames") ;
+  mappedNames_.reset() ;
+  nameIndex_.invalidate() ;
+}
+
+/*
+  Clp_copyNames wants an array of pointers for rows and another for
+  columns, and takes all the names in one call.
+*/
+void CSA_CL::handOverNames ()
+{
+  if (!mappedNames_) return ;
+  std::unique_ptr<MappedNames> names(std::move(mappedNames_)) ;
+  std::vector<char> rowArena, colArena ;
+  std::vector<int> rowOffsets, colOffsets ;
+  int m = numberRows() ;
+  int n = numberColumns() ;
+  names->names(true,0,m,rowArena,rowOffsets) ;
+  names->names(false,0,n,colArena,colOffsets) ;
+  std::vector<const char *> rowPtrs(m+1,nullptr) ;
+  std::vector<const char *> colPtrs(n+1,nullptr) ;
+  for (int i = 0 ; i < m ; i++) rowPtrs[i] = &rowArena[rowOffsets[i]] ;
+  for (int j = 0 ; j < n ; j++) colPtrs[j] = &colArena[colOffsets[j]] ;
+  simpleSetter<Clp_Simplex,const char *const *,const char *const *>
+      (libClp_,clpC_,"Clp_copyNames",rowPtrs.data(),colPtrs.data()) ;
+}
+
+/*
+  Bulk name methods. The C interface offers names only one at a time, but
+  we can at least look up the function once for the whole range. Clp_rowName
+  and Clp_columnName don't check that names exist, so if there are none
+  the names are returned empty without asking clp.
+*/
+void CSA_CL::getNameRange (bool rows, int first, int last,
+			   std::vector<char> &arena,
+			   std::vector<int> &offsets) const
+{
+  std::string errStr ;
+  arena.clear() ;
+  offsets.clear() ;
+  int len = simpleGetter<Clp_Simplex,int>
+	        (libClp_,clpC_,(rows)?"Clp_numberRows":"Clp_numberColumns") ;
+  if (first < 0 || last > len || first > last) {
+    offsets.push_back(0) ;
+    return ;
+  }
+  if (mappedNames_) {
+    mappedNames_->names(rows,first,last,arena,offsets) ;
+    return ;
+  }
+  offsets.reserve(last-first+1) ;
+
+  typedef void (*ClpNameFunc)(Clp_Simplex *,int,char *) ;
+  ClpNameFunc getName = nullptr ;
+  int maxLen = lengthNames() ;
+  if (maxLen > 0) {
+    getName = libClp_->getFunc<ClpNameFunc>
+		  ((rows)?"Clp_rowName":"Clp_columnName",errStr) ;
+  }
+  if (getName == nullptr) {
+    for (int ndx = first ; ndx <= last ; ndx++)
+      offsets.push_back(ndx-first) ;
+    arena.assign(last-first,'\0') ;
+    return ;
+  }
+  arena.reserve(static_cast<size_t>(last-first)*(maxLen+1)) ;
+  std::vector<char> buffer(maxLen+1) ;
+  for (int ndx = first ; ndx < last ; ndx++) {
+    offsets.push_back(static_cast<int>(arena.size())) ;
+    buffer[0] = '\0' ;
+    getName(clpC_,ndx,buffer.data()) ;
+    arena.insert(arena.end(),buffer.data(),
+		 buffer.data()+std::strlen(buffer.data())+1) ;
+  }
+  offsets.push_back(static_cast<int>(arena.size())) ;
+}
+
+void CSA_CL::setNameRange (bool rows, int first, int last,
+			   const char *arena, const int *offsets)
+{
+  std::string errStr ;
+  int len = (rows)?numberRows():numberColumns() ;
+  if (first < 0 || last > len || first >= last) return ;
+  handOverNames() ;
+
+  typedef void (*ClpSetNameFunc)(Clp_Simplex *,int,const char *) ;
+  ClpSetNameFunc setName =
+      libClp_->getFunc<ClpSetNameFunc>
+	  ((rows)?"Clp_setRowName":"Clp_setColumnName",errStr) ;
+  if (setName == nullptr) return ;
+  for (int ndx = first ; ndx < last ; ndx++)
+    setName(clpC_,ndx,arena+offsets[ndx-first]) ;
+  nameIndex_.namesChanged(rows,first,last) ;
+}
+
+/*
+  Names for the name index. Names are read in ranges, so the name functions
+  are looked up once per range.
+*/
+int CSA_CL::nameCount (bool rows)
+{
+  return ((rows)?numberRows():numberColumns()) ;
+}
+
+void CSA_CL::nameRange (bool rows, int first, int last,
+			std::vector<char> &arena, std::vector<int> &offsets)
+{
+  getNameRange(rows,first,last,arena,offsets) ;
+}
+
+void CSA_CL::rowNames (int first, int last, std::vector<char> &arena,
+		       std::vector<int> &offsets) const
+{
+  getNameRange(true,first,last,arena,offsets) ;
+}
+
+void CSA_CL::setRowNames (int first, int last, const char *arena,
+			  const int *offsets)
+{
+  setNameRange(true,first,last,arena,offsets) ;
+}
+
+void CSA_CL::columnNames (int first, int last, std::vector<char> &arena,
+			  std::vector<int> &offsets) const
+{
+  getNameRange(false,first,last,arena,offsets) ;
+}
+
+void CSA_CL::setColumnNames (int first, int last, const char *arena,
+			     const int *offsets)
+{
+  setNameRange(false,first,last,arena,offsets) ;
 }
 
 /*
-  Read/write problems from/to a file.
+  Read/write problems from/to a file. readMps goes through the model cache
+  if one is set. A cached image is used only if it opens cleanly, which
+  includes matching the digests recorded when it was written. Otherwise the
+  file is parsed and the image written afresh.
 */
 int CSA_CL::readMps (const char *filename, bool keepNames, bool ignoreErrors)
 {
   std::string errStr ;
+  forgetLoadedParams() ;
+  clearJournal() ;
+  nameIndex_.invalidate() ;
+  if (keepNames && lazyNames_) return (readMpsLazy(filename,ignoreErrors)) ;
 
   typedef int (*ClpReadMpsFunc)(Clp_Simplex *,const char *,int,int) ;
   static ClpReadMpsFunc readMps = nullptr ;
@@ -549,8 +1056,16 @@ int CSA_CL::readMps (const char *filename, bool keepNames, bool ignoreErrors)
   if (readMps == nullptr) {
     readMps = libClp_->getFunc<ClpReadMpsFunc>("Clp_readMps",errStr) ;
   }
+  std::string imagePath ;
+  if (ModelCache::lookup(filename,keepNames,imagePath) &&
+      readModel(imagePath.c_str()) == 0) {
+    std::cout
+	<< "Read " << filename << " from the model cache." << std::endl ;
+    return (0) ;
+  }
   int retval = -1 ;
   if (readMps != nullptr) {
+    mappedNames_.reset() ;
     retval = readMps(clpC_,filename,keepNames,ignoreErrors) ;
     if (retval) {
 	std::cout
@@ -559,15 +1074,69 @@ int CSA_CL::readMps (const char *filename, bool keepNames, bool ignoreErrors)
     } else {
 	std::cout
 	    << "Read " << filename << " without error." << std::endl ;
+	if (!imagePath.empty()) writeModel(imagePath.c_str()) ;
     }
   }
   return (retval) ;
 }
 
+/*
+  A lazy read goes through MpsReader, which can leave the names in the
+  file. The names are taken from the reader before the problem is loaded,
+  so that loadInto doesn't decode them, and installed after, since loading
+  a problem discards lazy names. Errors mean the file isn't loaded unless
+  they're to be ignored, as for Clp_readMps.
+*/
+int CSA_CL::readMpsLazy (const char *filename, bool ignoreErrors)
+{
+  MpsReader reader ;
+  int retval = reader.readMps(filename,true,true) ;
+  if (retval < 0 || (retval > 0 && !ignoreErrors)) {
+    std::cout
+	<< "Failure to read " << filename << ", error " << retval
+	<< "." << std::endl ;
+    return (retval) ;
+  }
+  std::unique_ptr<MappedNames> names = reader.releaseNames() ;
+  reader.loadInto(*this) ;
+  mappedNames_ = std::move(names) ;
+  if (retval == 0) {
+    std::cout
+	<< "Read " << filename << " without error." << std::endl ;
+  }
+  return (retval) ;
+}
+
+/*
+  Clp reads the names from its own arrays, so lazy names must be handed
+  over first. If parallel writing is on, ModelWriter formats the file
+  instead; it lays it out as clp would.
+*/
 int CSA_CL::writeMps (const char *filename, int formatType, int numberAcross,
 		      double objSense)
 {
   std::string errStr ;
+  syncModel() ;
+  handOverNames() ;
+
+  if (parallelWrite_) {
+    ModelImage::Source src ;
+    std::vector<char> rowArena, colArena ;
+    std::vector<int> rowOffsets, colOffsets ;
+    modelSource(src,rowArena,rowOffsets,colArena,colOffsets) ;
+    ModelWriter writer ;
+    writer.setModel(src) ;
+    int retval = writer.writeMps(filename,formatType,numberAcross,objSense) ;
+    if (retval) {
+	std::cout
+	    << "Failure to write " << filename << ", error " << retval
+	    << "." << std::endl ;
+    } else {
+	std::cout
+	    << "Wrote " << filename << " without error." << std::endl ;
+    }
+    return (retval) ;
+  }
 
   typedef int (*ClpWriteMpsFunc)(Clp_Simplex *,const char *,int,int,double) ;
   static ClpWriteMpsFunc writeMps = nullptr ;
@@ -575,9 +1144,24 @@ int CSA_CL::writeMps (const char *filename, int formatType, int numberAcross,
   if (writeMps == nullptr) {
     writeMps = libClp_->getFunc<ClpWriteMpsFunc>("Clp_writeMps",errStr) ;
   }
+/*
+  Clp writes plain text. If the name asks for compression, have Clp write
+  beside the target and compress the result into place.
+*/
+  std::string plainPath ;
+  if (StreamCodec::forName(filename) != nullptr)
+    plainPath = std::string(filename)+".plain" ;
   int retval = -1 ;
   if (writeMps != nullptr) {
-    retval = writeMps(clpC_,filename,formatType,numberAcross,objSense) ;
+    if (plainPath.empty()) {
+      retval = writeMps(clpC_,filename,formatType,numberAcross,objSense) ;
+    } else {
+      retval = writeMps(clpC_,plainPath.c_str(),formatType,numberAcross,
+			objSense) ;
+      if (!retval && !StreamCodec::copyFile(plainPath.c_str(),filename))
+	retval = -2 ;
+      std::remove(plainPath.c_str()) ;
+    }
     if (retval) {
 	std::cout
 	    << "Failure to write " << filename << ", error " << retval
@@ -590,18 +1174,100 @@ int CSA_CL::writeMps (const char *filename, int formatType, int numberAcross,
   return (retval) ;
 }
 
+/*
+  Clp_saveModel writes clp's own names, so lazy names must be handed over
+  first.
+*/
 int CSA_CL::saveModel (const char *fileName)
 {
+  syncModel() ;
+  handOverNames() ;
   return (simpleGetter<Clp_Simplex,int,const char *>
   	      (libClp_,clpC_,"Clp_saveModel",fileName)) ;
 }
 
 int CSA_CL::restoreModel (const char *fileName)
 {
+  forgetLoadedParams() ;
+  clearJournal() ;
+  nameIndex_.invalidate() ;
+  mappedNames_.reset() ;
   return (simpleGetter<Clp_Simplex,int,const char *>
   	      (libClp_,clpC_,"Clp_restoreModel",fileName)) ;
 }
 
+/*
+  Binary model files. The matrix may have gaps; ModelImage::write packs it.
+  Names are written only if there are some. Lazy names are handed over
+  first, so that the image is written from clp's copy and not from a
+  mapped file that may have changed under us; this covers the model cache
+  write in #readMps too.
+*/
+int CSA_CL::writeModel (const char *filename)
+{
+  syncModel() ;
+  handOverNames() ;
+  ModelImage::Source src ;
+  std::vector<char> rowArena, colArena ;
+  std::vector<int> rowOffsets, colOffsets ;
+  modelSource(src,rowArena,rowOffsets,colArena,colOffsets) ;
+  int retval = ModelImage::write(filename,src) ;
+  if (retval) {
+    std::cout
+      << "Failure to write " << filename << ", error " << retval
+      << "." << std::endl ;
+  }
+  return (retval) ;
+}
+
+/*
+  The arrays are clp's own; the caller must have synced the journal.
+*/
+void CSA_CL::modelSource (ModelImage::Source &src,
+			  std::vector<char> &rowArena,
+			  std::vector<int> &rowOffsets,
+			  std::vector<char> &colArena,
+			  std::vector<int> &colOffsets)
+{
+  src.numCols_ = numberColumns() ;
+  src.numRows_ = numberRows() ;
+  src.starts_ = getVectorStarts() ;
+  src.lengths_ = getVectorLengths() ;
+  src.indices_ = getIndices() ;
+  src.elements_ = getElements() ;
+  src.colLower_ = columnLower() ;
+  src.colUpper_ = columnUpper() ;
+  src.obj_ = objective() ;
+  src.rowLower_ = rowLower() ;
+  src.rowUpper_ = rowUpper() ;
+  src.integer_ = integerInformation() ;
+  src.objSense_ = objSense() ;
+  src.objOffset_ = objectiveOffset() ;
+  src.probName_ = problemName() ;
+  if (lengthNames() > 0) {
+    rowNames(0,src.numRows_,rowArena,rowOffsets) ;
+    columnNames(0,src.numCols_,colArena,colOffsets) ;
+    src.rowNames_ = rowArena.data() ;
+    src.rowNameOffsets_ = rowOffsets.data() ;
+    src.colNames_ = colArena.data() ;
+    src.colNameOffsets_ = colOffsets.data() ;
+  }
+}
+
+int CSA_CL::readModel (const char *filename)
+{
+  ModelImage image ;
+  int retval = image.open(filename) ;
+  if (retval) {
+    std::cout
+      << "Failure to read " << filename << ", error " << retval
+      << "." << std::endl ;
+    return (retval) ;
+  }
+  image.loadInto(*this) ;
+  return (0) ;
+}
+
 
 
 /* Individual parameter set / get methods */
@@ -613,6 +1279,7 @@ double CSA_CL::primalTolerance () const
 }
 void CSA_CL::setPrimalTolerance (double val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,double>
       (libClp_,clpC_,"Clp_setPrimalTolerance",val) ;
 }
@@ -624,6 +1291,7 @@ double CSA_CL::dualTolerance () const
 }
 void CSA_CL::setDualTolerance (double val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,double>
       (libClp_,clpC_,"Clp_setDualObjectiveLimit",val) ;
 }
@@ -635,6 +1303,7 @@ double CSA_CL::dualObjectiveLimit () const
 }
 void CSA_CL::setDualObjectiveLimit (double val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,double>
       (libClp_,clpC_,"Clp_setDualTolerance",val) ;
 }
@@ -646,6 +1315,7 @@ double CSA_CL::dualBound () const
 }
 void CSA_CL::setDualBound (double val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,double>
       (libClp_,clpC_,"Clp_setBound",val) ;
 }
@@ -657,6 +1327,7 @@ int CSA_CL::scalingFlag () const
 }
 void CSA_CL::scaling (int val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,int>
       (libClp_,clpC_,"Clp_scaling",val) ;
 }
@@ -668,6 +1339,7 @@ double CSA_CL::objectiveOffset () const
 }
 void CSA_CL::setObjectiveOffset (double val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,double>
       (libClp_,clpC_,"Clp_setObjectiveOffset",val) ;
 }
@@ -679,6 +1351,7 @@ double CSA_CL::objSense () const
 }
 void CSA_CL::setObjSense (double val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,double>
       (libClp_,clpC_,"Clp_setOptimizationDirection",val) ;
 }
@@ -709,6 +1382,7 @@ std::string CSA_CL::problemName () const
 }
 void CSA_CL::setProblemName (std::string name)
 {
+  forgetLoadedParams() ;
   int buflen = name.length() ;
   simpleGetter<Clp_Simplex,int,int,const char *>
       (libClp_,clpC_,"Clp_setProblemName",buflen,name.c_str()) ;
@@ -726,6 +1400,7 @@ void CSA_CL::getProbNameVoid (void *blob) const
 
 void CSA_CL::setProbNameVoid (const void *blob)
 {
+  forgetLoadedParams() ;
   struct ProbNameParam { int buflen_ ; char *buffer_ ; } ;
   const ProbNameParam *param = reinterpret_cast<const ProbNameParam *>(blob) ;
   simpleGetter<Clp_Simplex,int,int,const char *>
@@ -739,6 +1414,7 @@ int CSA_CL::numberIterations () const
 }
 void CSA_CL::setNumberIterations (int val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,int>
       (libClp_,clpC_,"Clp_setNumberIterations",val) ;
 }
@@ -750,6 +1426,7 @@ int CSA_CL::maximumIterations () const
 }
 void CSA_CL::setMaximumIterations (int val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,int>
       (libClp_,clpC_,"Clp_setMaximumIterations",val) ;
 }
@@ -761,6 +1438,7 @@ double CSA_CL::maximumSeconds () const
 }
 void CSA_CL::setMaximumSeconds (double val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,double>
       (libClp_,clpC_,"Clp_setMaximumSeconds",val) ;
 }
@@ -772,6 +1450,7 @@ double CSA_CL::infeasibilityCost () const
 }
 void CSA_CL::setInfeasibilityCost (double val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,double>
       (libClp_,clpC_,"Clp_setInfeasibilityCost",val) ;
 }
@@ -783,6 +1462,7 @@ int CSA_CL::perturbation () const
 }
 void CSA_CL::setPerturbation (int val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,int>
       (libClp_,clpC_,"Clp_setPerturbation",val) ;
 }
@@ -794,6 +1474,7 @@ int CSA_CL::algorithm () const
 }
 void CSA_CL::setAlgorithm (int val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,int>
       (libClp_,clpC_,"Clp_setAlgorithm",val) ;
 }
@@ -805,6 +1486,7 @@ double CSA_CL::getSmallElementValue () const
 }
 void CSA_CL::setSmallElementValue (double val)
 {
+  forgetLoadedParams() ;
   simpleSetter<Clp_Simplex,double>
       (libClp_,clpC_,"Clp_setSmallElementValue",val) ;
 }
@@ -832,16 +1514,19 @@ std::string CSA_CL::getStrParam (std::string name) const
 
 void CSA_CL::setIntParam (std::string name, int val)
 {
+  forgetLoadedParams() ;
   setMember<Clp_Simplex,int>
       (integerSimplexParams,name,libClp_,clpC_,val) ;
 }
 void CSA_CL::setDblParam (std::string name, double val)
 {
+  forgetLoadedParams() ;
   setMember<Clp_Simplex,double>
       (doubleSimplexParams,name,libClp_,clpC_,val) ;
 }
 void CSA_CL::setStrParam (std::string name, std::string val)
 {
+  forgetLoadedParams() ;
   setMember<Clp_Simplex,std::string>
       (stringSimplexParams,name,libClp_,clpC_,val) ;
 }
@@ -887,9 +1572,28 @@ void CSA_CL::exposeParams (RunParamsAPI &runParams) const
   runParams.addStrParam(name,val) ;
 }
 
+/*
+  Load parameters from a RunParamsAPI object. If this is the object we loaded
+  last time, and nothing has disturbed the solver's parameters since, push
+  only the parameters changed since then (plus the volatile parameters that
+  clp modifies on its own). Otherwise push everything.
+*/
 void CSA_CL::loadParams (RunParamsAPI &runParams)
 {
-  std::vector<std::string> paramNames = runParams.getIntParamIds() ;
+  unsigned long since = 0 ;
+  if (loadedParams_ == &runParams) since = loadedGen_ ;
+
+  std::vector<std::string> paramNames = runParams.getIntParamIds(since) ;
+  if (since > 0) {
+    std::vector<std::string> allNames = runParams.getIntParamIds() ;
+    for (int ndx = 0 ; ndx < volatileSimplexParamCnt ; ndx++) {
+      std::string name = volatileSimplexParams[ndx] ;
+      if (std::find(allNames.begin(),allNames.end(),name) != allNames.end() &&
+          std::find(paramNames.begin(),paramNames.end(),name) ==
+							      paramNames.end())
+      { paramNames.push_back(name) ; }
+    }
+  }
   for (std::vector<std::string>::const_iterator iter = paramNames.begin() ;
        iter != paramNames.end() ;
        iter++) {
@@ -898,7 +1602,7 @@ void CSA_CL::loadParams (RunParamsAPI &runParams)
     std::string setFunc = integerSimplexParams[name].setter_ ;
     simpleSetter<Clp_Simplex,int>(libClp_,clpC_,setFunc,val) ;
   }
-  paramNames = runParams.getDblParamIds() ;
+  paramNames = runParams.getDblParamIds(since) ;
   for (std::vector<std::string>::const_iterator iter = paramNames.begin() ;
        iter != paramNames.end() ;
        iter++) {
@@ -907,7 +1611,7 @@ void CSA_CL::loadParams (RunParamsAPI &runParams)
     std::string setFunc = doubleSimplexParams[name].setter_ ;
     simpleSetter<Clp_Simplex,double>(libClp_,clpC_,setFunc,val) ;
   }
-  paramNames = runParams.getStrParamIds() ;
+  paramNames = runParams.getStrParamIds(since) ;
   for (std::vector<std::string>::const_iterator iter = paramNames.begin() ;
        iter != paramNames.end() ;
        iter++) {
@@ -920,6 +1624,12 @@ void CSA_CL::loadParams (RunParamsAPI &runParams)
       setProblemName(val) ;
     }
   }
+/*
+  Record what we've applied. This must come last; setProblemName clears the
+  record.
+*/
+  loadedParams_ = &runParams ;
+  loadedGen_ = runParams.getGeneration() ;
 }
 
 /*
@@ -1075,6 +1785,7 @@ double CSA_CL::sumDualInfeasibilities() const
 
 void CSA_CL::checkSolution()
 {
+  syncModel() ;
   simpleSetter<Clp_Simplex>(libClp_,clpC_,"Clp_checkSolution") ;
 }
 
@@ -1104,7 +1815,7 @@ void CSA_CL::registerCallBack (CallBack userCallBack)
 
 void CSA_CL::clearCallBack ()
 {
-  simpleSetter<Clp_Simplex>(libClp_,clpC_,"Clp_registerCallBack") ;
+  simpleSetter<Clp_Simplex>(libClp_,clpC_,"Clp_clearCallBack") ;
 }
 
 void CSA_CL::setLogLevel (int level)
@@ -1123,46 +1834,54 @@ int CSA_CL::logLevel () const
 */
 int CSA_CL::initialSolve ()
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,int>(libClp_,clpC_,"Clp_initialSolve")) ;
 }
 
 int CSA_CL::initialDualSolve ()
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,int>(libClp_,clpC_,"Clp_initialDualSolve")) ;
 }
 
 int CSA_CL::initialPrimalSolve ()
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,int>
               (libClp_,clpC_,"Clp_initialPrimalSolve")) ;
 }
 
 int CSA_CL::initialBarrierSolve ()
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,int>
               (libClp_,clpC_,"Clp_initialBarrierSolve")) ;
 }
 
 int CSA_CL::initialBarrierNoCrossSolve ()
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,int>
               (libClp_,clpC_,"Clp_initialBarrierNoCrossSolve")) ;
 }
 
 int CSA_CL::dual (int ifValuesPass)
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,int,int>
   	      (libClp_,clpC_,"Clp_dual",ifValuesPass)) ;
 }
 
 int CSA_CL::primal (int ifValuesPass)
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,int,int>
   	      (libClp_,clpC_,"Clp_primal",ifValuesPass)) ;
 }
 
 int CSA_CL::crash (double gap, int pivot)
 {
+  syncModel() ;
   return (simpleGetter<Clp_Simplex,int,double,int>
   	      (libClp_,clpC_,"Clp_primal",gap,pivot)) ;
 }
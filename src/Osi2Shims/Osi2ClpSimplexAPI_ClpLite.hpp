@@ -10,22 +10,35 @@
 #ifndef Osi2ClpSimplexAPI_ClpLite_HPP
 #define Osi2ClpSimplexAPI_ClpLite_HPP
 
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "Osi2API.hpp"
 #define COIN_EXTERN_C
 #include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2ModelImage.hpp"
+#include "Osi2NameIndexAPI_Imp.hpp"
 
 #include "Osi2ParamBEAPI_Imp.hpp"
 
 namespace Osi2 {
 
 class DynamicLibrary ;
+class MappedNames ;
 
 /*! \brief Proof of concept API.
 
   Implementation of the ClpSimplexAPI. Which see for user documentation of the
   methods implemented here.
+
+  The object also supplies a NameIndexAPI object for its problem, through
+  #getAPIPtr. It is the source of names for the index and tells it of
+  changes to names.
 */
-class ClpSimplexAPI_ClpLite : public ClpSimplexAPI {
+class ClpSimplexAPI_ClpLite : public ClpSimplexAPI,
+			      private NameIndexAPI_Imp::NameSource {
 
 public:
 /*! \name Constructors, destructor, and copy */
@@ -46,6 +59,12 @@ public:
       const double *obj,
       const double *rowlb, const double *rowub) ;
 
+  /// Load a problem (column major order), taking ownership of the arrays.
+  void assignProblem(const int numcols, const int numrows,
+      CoinBigIndex *&start, int *&index, double *&value,
+      double *&collb, double *&colub, double *&obj,
+      double *&rowlb, double *&rowub) ;
+
   /// Load a quadratic objective (matrix portion).
   void loadQuadraticObjective (const int numcols,
       const CoinBigIndex *start, const int *index, const double *value) ;
@@ -77,30 +96,43 @@ public:
   /// Delete columns.
   void deleteColumns(int number, const int *which) ;
 
+  /// Apply pending modifications.
+  void flush() ;
+
   /// Get row lower bounds.
   double *rowLower() const ;
   /// Change row lower bounds.
   void chgRowLower(const double *value) ;
+  /// Change the lower bound of one row.
+  void setRowLower(int ndx, double value) ;
 
   /// Get row upper bounds.
   double *rowUpper() const ;
   /// Change row upper bounds.
   void chgRowUpper(const double *value) ;
+  /// Change the upper bound of one row.
+  void setRowUpper(int ndx, double value) ;
 
   /// Get column lower bounds.
   double *columnLower() const ;
   /// Change column lower bounds.
   void chgColumnLower(const double *value) ;
+  /// Change the lower bound of one column.
+  void setColumnLower(int ndx, double value) ;
 
   /// Get column upper bounds.
   double *columnUpper() const ;
   /// Change column upper bounds.
   void chgColumnUpper(const double *value) ;
+  /// Change the upper bound of one column.
+  void setColumnUpper(int ndx, double value) ;
 
   /// Get objective coefficients.
   double *objective() const ;
   /// Change cobjective coefficients.
   void chgObjCoefficients(const double *value) ;
+  /// Change the objective coefficient of one column.
+  void setObjectiveCoefficient(int ndx, double value) ;
 
   /// Get the number of non-zero entries in the matrix.
   CoinBigIndex getNumElements() const ;
@@ -130,6 +162,15 @@ public:
   ClpSimplexAPI::Status getRowStatus(int index) ;
   /// Set status for a row.
   void setRowStatus (int index, ClpSimplexAPI::Status status) ;
+  /// Get status for a range of columns.
+  void getColumnStatus(int first, int last, ClpSimplexAPI::Status *status) ;
+  /// Set status for a range of columns.
+  void setColumnStatus(int first, int last,
+  		       const ClpSimplexAPI::Status *status) ;
+  /// Get status for a range of rows.
+  void getRowStatus(int first, int last, ClpSimplexAPI::Status *status) ;
+  /// Set status for a range of rows.
+  void setRowStatus(int first, int last, const ClpSimplexAPI::Status *status) ;
 
   /// Maximum length of names (0 means no names are available).
   int lengthNames() const ;
@@ -145,6 +186,18 @@ public:
   void copyNames(const char *const *rowNames, const char *const *colNames) ;
   /// Drop names.
   void dropNames() ;
+  /// Get names for a range of rows.
+  void rowNames(int first, int last, std::vector<char> &arena,
+  		std::vector<int> &offsets) const ;
+  /// Set names for a range of rows.
+  void setRowNames(int first, int last, const char *arena,
+  		   const int *offsets) ;
+  /// Get names for a range of columns.
+  void columnNames(int first, int last, std::vector<char> &arena,
+  		   std::vector<int> &offsets) const ;
+  /// Set names for a range of columns.
+  void setColumnNames(int first, int last, const char *arena,
+  		      const int *offsets) ;
 //@}
 
 /*! \name Methods to read or write a problem file */
@@ -152,6 +205,14 @@ public:
   /// Read an mps file from the given filename.
   int readMps(const char *filename, bool keepNames = false,
 	      bool ignoreErrors = false) ;
+  /// Defer decoding names read by #readMps.
+  void setLazyNames(bool lazy) { lazyNames_ = lazy ; }
+  /// True if lazy mode is on.
+  bool lazyNames() const { return (lazyNames_) ; }
+  /// Write mps files with ModelWriter.
+  void setParallelWrite(bool parallel) { parallelWrite_ = parallel ; }
+  /// True if parallel writing is on.
+  bool parallelWrite() const { return (parallelWrite_) ; }
   /// Write an mps file to the given filename.
   int writeMps(const char *filename, int formatType,
   	       int numberAcross, double objSense) ;
@@ -159,6 +220,10 @@ public:
   int saveModel(const char *fileName) ;
   /// Restore the model from a file.
   int restoreModel(const char *fileName) ;
+  /// Write the model in Osi2 binary format.
+  int writeModel(const char *filename) ;
+  /// Read a model in Osi2 binary format.
+  int readModel(const char *filename) ;
 //@}
 
 /*! \name Parameter gets & sets */
@@ -247,7 +312,12 @@ public:
 
   /// Fill a RunParamsAPI object with parameters and current values
   void exposeParams(RunParamsAPI &runParams) const ;
-  /// Load parameters from a RunParamsAPI object
+  /*! \brief Load parameters from a RunParamsAPI object
+
+    If \p runParams is the object most recently loaded, and nothing has
+    touched the solver's parameters since, only the parameters changed since
+    the last load are pushed to clp.
+  */
   void loadParams(RunParamsAPI &runParams) ;
 //@}
 
@@ -371,12 +441,147 @@ private:
     Clp_Simplex *clpC_ ;
   //@}
 
+  /*! \name Name index
+
+    #nameCount and #nameRange supply names to #nameIndex_.
+  */
+  //@{
+    /// Index of row and column names
+    NameIndexAPI_Imp nameIndex_ ;
+    /// Number of rows or columns
+    int nameCount(bool rows) ;
+    /// Names of a range of rows or columns
+    void nameRange(bool rows, int first, int last,
+		   std::vector<char> &arena, std::vector<int> &offsets) ;
+  //@}
+
+  /*! \name Lazy names
+
+    After a lazy #readMps the names stay in the file, held by
+    #mappedNames_, and the name methods answer from there; clp has no
+    names. Loading a problem discards them. Anything that would change the
+    names or the number of rows or columns, or that has clp read the names
+    itself, first calls #handOverNames to give them to clp.
+  */
+  //@{
+    /// True if #readMps should keep names lazily
+    bool lazyNames_ ;
+    /// Names left in the file by the last lazy read
+    std::unique_ptr<MappedNames> mappedNames_ ;
+    /// Decode the names held by #mappedNames_ and give them to clp
+    void handOverNames() ;
+    /// #readMps in lazy mode
+    int readMpsLazy(const char *filename, bool ignoreErrors) ;
+  //@}
+
+  /// True if #writeMps should use ModelWriter
+  bool parallelWrite_ ;
+
+  /*! \name Parameter load tracking
+
+    Remember the RunParamsAPI object most recently applied by #loadParams and
+    its generation at the time. Any other change to solver parameters (an
+    individual set method, reading a new problem) clears the record and the
+    next #loadParams pushes the full parameter set.
+  */
+  //@{
+    /// RunParamsAPI object most recently applied
+    const RunParamsAPI *loadedParams_ ;
+    /// Generation of #loadedParams_ when it was applied
+    unsigned long loadedGen_ ;
+  //@}
+
+  /*! \name Modification journal
+
+    Changes to the bounds, objective, coefficients, and status are held here
+    and passed to clp by #applyJournal, which runs before any method that
+    solves, reads the model, or changes its shape. The journal is mutable
+    because const methods that read the model must apply it first.
+
+    Each bound and objective vector has a journal entry. A whole-vector
+    change (e.g., #chgRowLower) is copied into #VecJournal::full_ and
+    discards earlier element changes. An element change is written into
+    #VecJournal::full_ if there is one, otherwise appended to
+    #VecJournal::edits_. Applying the entry costs one copy of the vector
+    and one call to clp, however many elements changed; the edits are
+    applied in order, so the last change to an element wins.
+
+    Coefficient and status changes have no bulk equivalent in the clp C
+    interface. They're keyed by element, so each element is passed to clp
+    once, and coefficients are ordered by column to follow clp's
+    column-major matrix.
+  */
+  //@{
+    /// Journal indices for the bound and objective vectors
+    enum JournalVec { JRowLower = 0, JRowUpper, JColLower, JColUpper, JObj,
+    		      JVecCnt } ;
+    /// Pending changes to a bound or objective vector
+    struct VecJournal {
+      /// True if #full_ holds a replacement for the entire vector
+      bool haveFull_ ;
+      /// Replacement vector
+      std::vector<double> full_ ;
+      /// Element changes (index, value), in order of arrival
+      std::vector<std::pair<int,double> > edits_ ;
+      VecJournal () : haveFull_(false) { }
+    } ;
+    /// Pending changes to the bound and objective vectors
+    mutable VecJournal vecJournal_[JVecCnt] ;
+    /// Pending coefficient changes, keyed by (column, row)
+    mutable std::map<std::pair<int,int>,std::pair<double,bool> >
+      coeffJournal_ ;
+    /// Pending column status changes
+    mutable std::map<int,ClpSimplexAPI::Status> colStatusJournal_ ;
+    /// Pending row status changes
+    mutable std::map<int,ClpSimplexAPI::Status> rowStatusJournal_ ;
+    /// True if anything is pending
+    mutable bool journalPending_ ;
+
+    /// Pass all pending changes to clp
+    void applyJournal() const ;
+    /// Pass pending changes to vector \p which to clp
+    void applyVecJournal(JournalVec which) const ;
+    /// Record a whole-vector change
+    void journalVec(JournalVec which, const double *value) ;
+    /// Record an element change
+    void journalElem(JournalVec which, int ndx, double value) ;
+    /// Discard all pending changes
+    void clearJournal() ;
+    /// Apply pending changes, if any
+    inline void syncModel () const
+    { if (journalPending_) applyJournal() ; }
+  //@}
+
   /*! \name Auxilliary methods */
   //@{
     /// Get problem name using struct {int,char*}
     void getProbNameVoid(void *blob) const ;
     /// Set problem name using struct {int,char*}
     void setProbNameVoid(const void *blob) ;
+    /// Get status for a range of rows or columns
+    void getStatusRange(bool rows, int first, int last,
+    			ClpSimplexAPI::Status *status) ;
+    /// Set status for a range of rows or columns
+    void setStatusRange(bool rows, int first, int last,
+    			const ClpSimplexAPI::Status *status) ;
+    /// Get names for a range of rows or columns
+    void getNameRange(bool rows, int first, int last,
+    		      std::vector<char> &arena,
+		      std::vector<int> &offsets) const ;
+    /// Set names for a range of rows or columns
+    void setNameRange(bool rows, int first, int last,
+    		      const char *arena, const int *offsets) ;
+    /*! \brief Describe the model for ModelImage or ModelWriter
+
+      Names are loaded into the arenas only if clp has them.
+    */
+    void modelSource(ModelImage::Source &src,
+		     std::vector<char> &rowArena, std::vector<int> &rowOffsets,
+		     std::vector<char> &colArena,
+		     std::vector<int> &colOffsets) ;
+    /// Forget the record of the most recent #loadParams
+    inline void forgetLoadedParams ()
+    { loadedParams_ = nullptr ; loadedGen_ = 0 ; }
   //@}
 } ;
 
@@ -13,6 +13,8 @@
 */
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "ClpConfig.h"
 #include "Osi2ClpHeavyShim.hpp"
@@ -28,12 +30,40 @@
 namespace Osi2 {
 
 /*
-  Constructor. There's nothing to do here; all the work happens in the
-  constructors for the parent classes. The declarations here are just for
-  convenient debugging.
+  Names for the name index. OsiClpSolverInterface hands out names one at a
+  time, as strings.
+*/
+int Osi1API_ClpHeavy::nameCount (bool rows)
+{
+  return ((rows)?getNumRows():getNumCols()) ;
+}
+
+void Osi1API_ClpHeavy::nameRange (bool rows, int first, int last,
+				  std::vector<char> &arena,
+				  std::vector<int> &offsets)
+{
+  arena.clear() ;
+  offsets.clear() ;
+  offsets.reserve(last-first+1) ;
+  for (int ndx = first ; ndx < last ; ndx++) {
+    offsets.push_back(static_cast<int>(arena.size())) ;
+    std::string name = (rows)?getRowName(ndx):getColName(ndx) ;
+    arena.insert(arena.end(),name.c_str(),name.c_str()+name.size()+1) ;
+  }
+  offsets.push_back(static_cast<int>(arena.size())) ;
+}
+
+/*
+  Constructor. Most of the work happens in the constructors for the parent
+  classes; here we register the APIs this object supports. The commented
+  out output is just for convenient debugging.
 */
 Osi1API_ClpHeavy::Osi1API_ClpHeavy ()
+  : nameIndex_(this),
+    deletingNames_(false)
 {
+  apiMgr_.addAPIID(Osi1API::getAPIIDString(),static_cast<Osi1API *>(this)) ;
+  apiMgr_.addAPIID(NameIndexAPI::getAPIIDString(),&nameIndex_) ;
   /*
   std::cout << "Osi1API_ClpHeavy object constructor." << std::endl ;
   */
@@ -44,8 +74,12 @@ Osi1API_ClpHeavy::Osi1API_ClpHeavy ()
 */
 Osi1API_ClpHeavy::Osi1API_ClpHeavy (const Osi1API_ClpHeavy &rhs)
     : Osi1API(rhs),
-      OsiClpSolverInterface(rhs)
+      OsiClpSolverInterface(rhs),
+      nameIndex_(this),
+      deletingNames_(false)
 {
+  apiMgr_.addAPIID(Osi1API::getAPIIDString(),static_cast<Osi1API *>(this)) ;
+  apiMgr_.addAPIID(NameIndexAPI::getAPIIDString(),&nameIndex_) ;
   /*
   std::cout << "Osi1API_ClpHeavy object copy constructor." << std::endl ;
   */
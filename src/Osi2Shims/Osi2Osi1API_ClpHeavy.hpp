@@ -14,6 +14,8 @@
 
 #include "Osi2API.hpp"
 #include "Osi2Osi1API.hpp"
+#include "Osi2APIMgmt_Imp.hpp"
+#include "Osi2NameIndexAPI_Imp.hpp"
 
 #include "OsiClpSolverInterface.hpp"
 
@@ -29,8 +31,12 @@ namespace Osi2 {
   the implementation (with a few exceptions) consists of defining the virtual
   methods of Osi2::Osi1API as calls to the appropriate OsiClpSolverInterface
   methods.
+
+  The object also supplies a NameIndexAPI object, through #getAPIPtr. The
+  methods that change names or load a problem keep it up to date.
 */
-class Osi1API_ClpHeavy : public Osi1API, public OsiClpSolverInterface {
+class Osi1API_ClpHeavy : public Osi1API, public OsiClpSolverInterface,
+			 private NameIndexAPI_Imp::NameSource {
 
 public:
 
@@ -46,7 +52,17 @@ public:
   { return (new Osi1API_ClpHeavy(*this)) ; }
 
   inline void reset()
-  { OsiClpSolverInterface::reset() ; }
+  { nameIndex_.invalidate() ;
+    OsiClpSolverInterface::reset() ; }
+  //@}
+
+  /// \name API management & enquiry
+  //@{
+  inline int getAPIs(const char **&idents)
+  { return (apiMgr_.getAPIs(idents)) ; }
+
+  inline void *getAPIPtr(const char *ident)
+  { return (apiMgr_.getAPIPtr(ident)) ; }
   //@}
 
 
@@ -375,14 +391,18 @@ public:
   { return (OsiClpSolverInterface::getRowNames()) ; }
 
   inline void setRowName(int ndx, std::string name)
-  { OsiClpSolverInterface::setRowName(ndx,name) ; }
+  { OsiClpSolverInterface::setRowName(ndx,name) ;
+    nameIndex_.namesChanged(true,ndx,ndx+1) ; }
 
   inline void setRowNames(OsiSolverInterface::OsiNameVec &names,
   			  int srcStart, int len, int tgtStart)
-  { OsiClpSolverInterface::setRowNames(names,srcStart,len,tgtStart) ; }
+  { OsiClpSolverInterface::setRowNames(names,srcStart,len,tgtStart) ;
+    nameIndex_.namesChanged(true,tgtStart,tgtStart+len) ; }
 
   inline void deleteRowNames(int tgtStart, int len)
-  { OsiClpSolverInterface::deleteRowNames(tgtStart,len) ; }
+  { OsiClpSolverInterface::deleteRowNames(tgtStart,len) ;
+    if (!deletingNames_)
+      nameIndex_.rangeDeleted(true,tgtStart,tgtStart+len) ; }
 
   inline std::string getColName(int ndx,
   				unsigned maxLen = static_cast<unsigned>(std::string::npos)) const
@@ -392,23 +412,30 @@ public:
   { return (OsiClpSolverInterface::getColNames()) ; }
 
   inline void setColName(int ndx, std::string name)
-  { OsiClpSolverInterface::setColName(ndx,name) ; }
+  { OsiClpSolverInterface::setColName(ndx,name) ;
+    nameIndex_.namesChanged(false,ndx,ndx+1) ; }
 
   inline void setColNames(OsiSolverInterface::OsiNameVec &names,
   			  int srcStart, int len, int tgtStart)
-  { OsiClpSolverInterface::setColNames(names,srcStart,len,tgtStart) ; }
+  { OsiClpSolverInterface::setColNames(names,srcStart,len,tgtStart) ;
+    nameIndex_.namesChanged(false,tgtStart,tgtStart+len) ; }
 
   inline void deleteColNames(int tgtStart, int len)
-  { OsiClpSolverInterface::deleteColNames(tgtStart,len) ; }
+  { OsiClpSolverInterface::deleteColNames(tgtStart,len) ;
+    if (!deletingNames_)
+      nameIndex_.rangeDeleted(false,tgtStart,tgtStart+len) ; }
 
   inline void setRowColNames(const CoinMpsIO &mps)
-  { OsiClpSolverInterface::setRowColNames(mps) ; }
+  { nameIndex_.invalidate() ;
+    OsiClpSolverInterface::setRowColNames(mps) ; }
 
   inline void setRowColNames(CoinModel &mod)
-  { OsiClpSolverInterface::setRowColNames(mod) ; }
+  { nameIndex_.invalidate() ;
+    OsiClpSolverInterface::setRowColNames(mod) ; }
 
   inline void setRowColNames(CoinLpIO &mod)
-  { OsiClpSolverInterface::setRowColNames(mod) ; }
+  { nameIndex_.invalidate() ;
+    OsiClpSolverInterface::setRowColNames(mod) ; }
   //@}
 
 
@@ -449,7 +476,10 @@ public:
   { return (OsiSolverInterface::addCols(mod)) ; }
 
   inline void deleteCols(int num, const int *colIndices)
-  { OsiClpSolverInterface::deleteCols(num,colIndices) ; }
+  { deletingNames_ = true ;
+    OsiClpSolverInterface::deleteCols(num,colIndices) ;
+    deletingNames_ = false ;
+    nameIndex_.namesDeleted(false,num,colIndices) ; }
 
   inline void addRow(const CoinPackedVectorBase &ai, double li, double ui)
   { OsiClpSolverInterface::addRow(ai,li,ui) ; }
@@ -491,7 +521,10 @@ public:
   { return (OsiSolverInterface::addRows(mod)) ; }
 
   inline void deleteRows(int num, const int *rowIndices)
-  { OsiClpSolverInterface::deleteRows(num,rowIndices) ; }
+  { deletingNames_ = true ;
+    OsiClpSolverInterface::deleteRows(num,rowIndices) ;
+    deletingNames_ = false ;
+    nameIndex_.namesDeleted(true,num,rowIndices) ; }
 
   inline void replaceMatrixOptional(const CoinPackedMatrix &mtx)
   { OsiClpSolverInterface::replaceMatrixOptional(mtx) ; }
@@ -546,24 +579,28 @@ public:
   			  const double *clbs, const double *cubs,
 			  const double *obj,
 			  const double *rlbs, const double *rubs)
-  { OsiClpSolverInterface::loadProblem(mtx,clbs,cubs,obj,rlbs,rubs) ; }
+  { nameIndex_.invalidate() ;
+    OsiClpSolverInterface::loadProblem(mtx,clbs,cubs,obj,rlbs,rubs) ; }
 
   inline void assignProblem(CoinPackedMatrix *&mtx,
   			    double *&clbs, double *&cubs,
 			    double *&obj, double *&rlbs, double *&rubs)
-  { OsiClpSolverInterface::assignProblem(mtx,clbs,cubs,obj,rlbs,rubs) ; }
+  { nameIndex_.invalidate() ;
+    OsiClpSolverInterface::assignProblem(mtx,clbs,cubs,obj,rlbs,rubs) ; }
 
   inline void loadProblem(const CoinPackedMatrix &mtx,
   			  const double *clbs, const double *cubs,
 			  const double *obj, const char *senses,
 			  const double *rhss, const double *rngs)
-  { OsiClpSolverInterface::loadProblem(mtx,clbs,cubs,obj,senses,rhss,rngs) ; }
+  { nameIndex_.invalidate() ;
+    OsiClpSolverInterface::loadProblem(mtx,clbs,cubs,obj,senses,rhss,rngs) ; }
 
   inline void assignProblem(CoinPackedMatrix *&mtx,
   			    double *&clbs, double *&cubs,
 			    double *&obj, char *&senses,
 			    double *&rhss, double *&rngs)
-  { OsiClpSolverInterface::assignProblem(mtx,clbs,cubs,obj,senses,rhss,rngs) ; }
+  { nameIndex_.invalidate() ;
+    OsiClpSolverInterface::assignProblem(mtx,clbs,cubs,obj,senses,rhss,rngs) ; }
 
   inline void loadProblem(int numCols, int numRows,
   			  const CoinBigIndex *colStarts, const int *rowIndices,
@@ -571,7 +608,8 @@ public:
 			  const double *clbs, const double *cubs,
 			  const double *obj,
 			  const double *rlbs, const double *rubs)
-  { OsiClpSolverInterface::loadProblem(numCols,numRows,
+  { nameIndex_.invalidate() ;
+    OsiClpSolverInterface::loadProblem(numCols,numRows,
   				       colStarts,rowIndices,aijs,
 				       clbs,cubs,obj,rlbs,rubs) ; }
 
@@ -582,23 +620,35 @@ public:
 			  const double *clbs, const double *cubs,
 			  const double *obj, const char *senses,
 			  const double *rhss, const double *rngs)
-  { OsiClpSolverInterface::loadProblem(numCols,numRows,
+  { nameIndex_.invalidate() ;
+    OsiClpSolverInterface::loadProblem(numCols,numRows,
   				       colStarts,rowIndices,aijs,
 				       clbs,cubs,obj,senses,rhss,rngs) ; }
 
   inline int loadFromCoinModel(CoinModel &mod, bool keepSolution = false)
-  { return (OsiClpSolverInterface::loadFromCoinModel(mod,keepSolution)) ; }
+  { nameIndex_.invalidate() ;
+    return (OsiClpSolverInterface::loadFromCoinModel(mod,keepSolution)) ; }
 
 
+  /*! \brief Read an MPS file
+
+    Does not go through ModelCache. OsiSolverInterface::readMps resolves
+    the file from \p fname and \p ext (trying compressed variants), keeps
+    names according to the name discipline, and reads SOS sets, none of
+    which a cached image records.
+  */
   inline int readMps(const char *fname, const char *ext = "mps")
-  { return (OsiClpSolverInterface::readMps(fname,ext)) ; }
+  { nameIndex_.invalidate() ;
+    return (OsiClpSolverInterface::readMps(fname,ext)) ; }
 
   inline int readMps(const char *fname, const char *ext,
   		     int &numSets, CoinSet **&sets)
-  { return (OsiClpSolverInterface::readMps(fname,ext,numSets,sets)) ; }
+  { nameIndex_.invalidate() ;
+    return (OsiClpSolverInterface::readMps(fname,ext,numSets,sets)) ; }
 
   inline int readGMPL(const char *fname, const char *dname = nullptr)
-  { return (OsiClpSolverInterface::readGMPL(fname,dname)) ; }
+  { nameIndex_.invalidate() ;
+    return (OsiClpSolverInterface::readGMPL(fname,dname)) ; }
 
   inline void writeMps(const char *fname, const char *ext = "mps",
   		       double objSense = 0.0) const
@@ -643,10 +693,12 @@ public:
 			      eps,numAcross,decimals,objSense,useRowNames)) ; }
 
   inline int readLp(const char *fname, double eps = 1e-5)
-  { return (OsiSolverInterface::readLp(fname,eps)) ; }
+  { nameIndex_.invalidate() ;
+    return (OsiSolverInterface::readLp(fname,eps)) ; }
 
   inline int readLp(FILE *fp, double eps = 1e-5)
-  { return (OsiSolverInterface::readLp(fp,eps)) ; }
+  { nameIndex_.invalidate() ;
+    return (OsiSolverInterface::readLp(fp,eps)) ; }
   //@}
 
 
@@ -806,6 +858,33 @@ public:
   						   outStatus,t,dx)) ; }
   //@}
 
+private:
+
+  /// API management object
+  APIMgmt_Imp apiMgr_ ;
+
+  /// \name Name index
+  //@{
+  /// Object to implement the NameIndex %API
+  NameIndexAPI_Imp nameIndex_ ;
+
+  /// Number of rows or columns, for #nameIndex_
+  int nameCount(bool rows) ;
+
+  /// Names of rows or columns \p first to \p last-1, for #nameIndex_
+  void nameRange(bool rows, int first, int last,
+		 std::vector<char> &arena, std::vector<int> &offsets) ;
+
+  /*! \brief True while #deleteRows or #deleteCols runs
+
+    OsiClpSolverInterface removes the names of deleted rows and columns
+    through #deleteRowNames and #deleteColNames, one at a time. The
+    deletion updates #nameIndex_ in one step when it's done, so the name
+    overrides must leave the index alone meanwhile.
+  */
+  bool deletingNames_ ;
+  //@}
+
 } ;
 
 }    // end namespace Osi2
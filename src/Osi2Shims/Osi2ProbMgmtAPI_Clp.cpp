@@ -13,6 +13,11 @@
 */
 
 #include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "ClpConfig.h"
 #include "Clp_C_Interface.h"
@@ -24,6 +29,54 @@
 #include "Osi2API.hpp"
 #include "Osi2ProbMgmtAPI.hpp"
 #include "Osi2ProbMgmtAPI_Clp.hpp"
+#include "Osi2ModelImage.hpp"
+#include "Osi2ModelCache.hpp"
+#include "Osi2ModelBuilder.hpp"
+
+namespace {
+
+// Templates for common function signatures
+
+#include "Osi2CFuncTemplates.cpp"
+
+/*
+  Collect cnt row or column names into an arena, in the layout used by
+  ModelImage. The name function is looked up once for the whole set.
+*/
+void getNames (DynamicLibrary *lib, Clp_Simplex *clp, const char *funcName,
+	       int cnt, int maxLen,
+	       std::vector<char> &arena, std::vector<int> &offsets)
+{
+  std::string errStr ;
+  typedef void (*ClpNameFunc)(Clp_Simplex *,int,char *) ;
+  ClpNameFunc getName = lib->getFunc<ClpNameFunc>(funcName,errStr) ;
+  if (getName == nullptr) return ;
+  std::vector<char> buffer(maxLen+1) ;
+  offsets.reserve(cnt) ;
+  for (int ndx = 0 ; ndx < cnt ; ndx++) {
+    offsets.push_back(static_cast<int>(arena.size())) ;
+    buffer[0] = '\0' ;
+    getName(clp,ndx,buffer.data()) ;
+    arena.insert(arena.end(),buffer.data(),
+		 buffer.data()+std::strlen(buffer.data())+1) ;
+  }
+}
+
+/*
+  Name of row or column ndx from a model image. An image may carry names
+  for rows but not columns, or the reverse; the missing side gets clp's
+  default names.
+*/
+std::string imageName (const Osi2::ModelImage &image, bool isRow, int ndx)
+{
+  const char *name = (isRow)?image.rowName(ndx):image.columnName(ndx) ;
+  if (name != nullptr) return (std::string(name)) ;
+  char buffer[16] ;
+  std::sprintf(buffer,"%c%7.7d",(isRow)?'R':'C',ndx) ;
+  return (std::string(buffer)) ;
+}
+
+}  // end file-local namespace
 
 
 namespace Osi2 {
@@ -36,7 +89,8 @@ ProbMgmtAPI_Clp::ProbMgmtAPI_Clp (DynamicLibrary *libClp,
     : libClp_(libClp),
       clpSimplex_(clpSimplex),
       readMps_(nullptr),
-      initialSolve_(nullptr)
+      initialSolve_(nullptr),
+      loadProblem_(nullptr)
 {
 }
 
@@ -54,7 +108,10 @@ ProbMgmtAPI_Clp::~ProbMgmtAPI_Clp ()
 }
 
 /*
-  Read a problem file in mps format.
+  Read a problem file in mps format, through the model cache if one is set.
+  A cached image is used only if it opens cleanly, which includes matching
+  the digests recorded when it was written. Otherwise the file is parsed
+  and the image written afresh.
 */
 int ProbMgmtAPI_Clp::readMps (const char *filename, bool keepNames,
                               bool ignoreErrors)
@@ -66,6 +123,13 @@ int ProbMgmtAPI_Clp::readMps (const char *filename, bool keepNames,
       libClp_->getFunc<ClpReadMpsFunc>("Clp_readMps",errStr) ;
     readMps_ = readMps ;
   }
+  std::string imagePath ;
+  if (ModelCache::lookup(filename,keepNames,imagePath) &&
+      readModel(imagePath.c_str()) == 0) {
+      std::cout
+	  << "Read " << filename << " from the model cache." << std::endl ;
+      return (0) ;
+  }
   int retval = -1 ;
   if (readMps_ != nullptr) {
       retval = readMps_(clpSimplex_, filename, keepNames, ignoreErrors) ;
@@ -76,11 +140,225 @@ int ProbMgmtAPI_Clp::readMps (const char *filename, bool keepNames,
       } else {
 	  std::cout
 	      << "Read " << filename << " without error." << std::endl ;
+	  if (!imagePath.empty()) writeModel(imagePath.c_str()) ;
       }
   }
   return (retval) ;
 }
 
+/*
+  Load a problem. The C interface can only copy the arrays, so the copy is
+  made and the arrays freed at once.
+*/
+void ProbMgmtAPI_Clp::assignProblem (const int numcols, const int numrows,
+	CoinBigIndex *&start, int *&index, double *&value,
+	double *&collb, double *&colub, double *&obj,
+	double *&rowlb, double *&rowub)
+{
+  std::string errStr ;
+
+  if (loadProblem_ == nullptr) {
+    ClpLoadProblemFunc loadProblem =
+      libClp_->getFunc<ClpLoadProblemFunc>("Clp_loadProblem",errStr) ;
+    loadProblem_ = loadProblem ;
+  }
+  if (loadProblem_ != nullptr) {
+    loadProblem_(clpSimplex_,numcols,numrows,start,index,value,
+		 collb,colub,obj,rowlb,rowub) ;
+  }
+  delete[] start ;
+  start = nullptr ;
+  delete[] index ;
+  index = nullptr ;
+  delete[] value ;
+  value = nullptr ;
+  delete[] collb ;
+  collb = nullptr ;
+  delete[] colub ;
+  colub = nullptr ;
+  delete[] obj ;
+  obj = nullptr ;
+  delete[] rowlb ;
+  rowlb = nullptr ;
+  delete[] rowub ;
+  rowub = nullptr ;
+}
+
+/*
+  Binary model files. Each C interface function is used once per file, so
+  they're looked up as needed rather than cached.
+*/
+int ProbMgmtAPI_Clp::writeModel (const char *filename)
+{
+  typedef Clp_Simplex CS ;
+  ModelImage::Source src ;
+  src.numCols_ =
+    simpleGetter<CS,int>(libClp_,clpSimplex_,"Clp_numberColumns") ;
+  src.numRows_ = simpleGetter<CS,int>(libClp_,clpSimplex_,"Clp_numberRows") ;
+  src.starts_ = simpleGetter<CS,const CoinBigIndex *>
+		  (libClp_,clpSimplex_,"Clp_getVectorStarts") ;
+  src.lengths_ = simpleGetter<CS,const int *>
+		   (libClp_,clpSimplex_,"Clp_getVectorLengths") ;
+  src.indices_ =
+    simpleGetter<CS,const int *>(libClp_,clpSimplex_,"Clp_getIndices") ;
+  src.elements_ =
+    simpleGetter<CS,const double *>(libClp_,clpSimplex_,"Clp_getElements") ;
+  src.colLower_ =
+    simpleGetter<CS,const double *>(libClp_,clpSimplex_,"Clp_columnLower") ;
+  src.colUpper_ =
+    simpleGetter<CS,const double *>(libClp_,clpSimplex_,"Clp_columnUpper") ;
+  src.obj_ =
+    simpleGetter<CS,const double *>(libClp_,clpSimplex_,"Clp_objective") ;
+  src.rowLower_ =
+    simpleGetter<CS,const double *>(libClp_,clpSimplex_,"Clp_rowLower") ;
+  src.rowUpper_ =
+    simpleGetter<CS,const double *>(libClp_,clpSimplex_,"Clp_rowUpper") ;
+  src.integer_ = simpleGetter<CS,const char *>
+		   (libClp_,clpSimplex_,"Clp_integerInformation") ;
+  src.objSense_ = simpleGetter<CS,double>
+		    (libClp_,clpSimplex_,"Clp_optimizationDirection") ;
+  src.objOffset_ =
+    simpleGetter<CS,double>(libClp_,clpSimplex_,"Clp_objectiveOffset") ;
+  const int buflen = 256 ;
+  char buffer[buflen] ;
+  buffer[0] = '\0' ;
+  simpleSetter<CS,int,char *>
+      (libClp_,clpSimplex_,"Clp_problemName",buflen,buffer) ;
+  src.probName_ = buffer ;
+  if (src.starts_ == nullptr || src.indices_ == nullptr ||
+      src.elements_ == nullptr || src.colLower_ == nullptr ||
+      src.colUpper_ == nullptr || src.obj_ == nullptr ||
+      src.rowLower_ == nullptr || src.rowUpper_ == nullptr) {
+    std::cout
+      << "Failure to write " << filename << "; no model." << std::endl ;
+    return (-1) ;
+  }
+  std::vector<char> rowArena, colArena ;
+  std::vector<int> rowOffsets, colOffsets ;
+  int maxLen = simpleGetter<CS,int>(libClp_,clpSimplex_,"Clp_lengthNames") ;
+  if (maxLen > 0) {
+    getNames(libClp_,clpSimplex_,"Clp_rowName",src.numRows_,maxLen,
+	     rowArena,rowOffsets) ;
+    getNames(libClp_,clpSimplex_,"Clp_columnName",src.numCols_,maxLen,
+	     colArena,colOffsets) ;
+    if (static_cast<int>(rowOffsets.size()) == src.numRows_ &&
+	static_cast<int>(colOffsets.size()) == src.numCols_) {
+      src.rowNames_ = rowArena.data() ;
+      src.rowNameOffsets_ = rowOffsets.data() ;
+      src.colNames_ = colArena.data() ;
+      src.colNameOffsets_ = colOffsets.data() ;
+    }
+  }
+  int retval = ModelImage::write(filename,src) ;
+  if (retval) {
+      std::cout
+	  << "Failure to write " << filename << ", error " << retval
+	  << "." << std::endl ;
+  } else {
+      std::cout
+	  << "Wrote " << filename << " without error." << std::endl ;
+  }
+  return (retval) ;
+}
+
+/*
+  The arrays go to Clp_loadProblem straight from the mapped file; the rest
+  of the model follows through the C interface.
+*/
+int ProbMgmtAPI_Clp::readModel (const char *filename)
+{
+  typedef Clp_Simplex CS ;
+  std::string errStr ;
+  ModelImage image ;
+  int retval = image.open(filename) ;
+  if (retval) {
+      std::cout
+	  << "Failure to read " << filename << ", error " << retval
+	  << "." << std::endl ;
+      return (retval) ;
+  }
+  if (loadProblem_ == nullptr) {
+    ClpLoadProblemFunc loadProblem =
+      libClp_->getFunc<ClpLoadProblemFunc>("Clp_loadProblem",errStr) ;
+    loadProblem_ = loadProblem ;
+  }
+  if (loadProblem_ == nullptr) return (-1) ;
+  int n = image.getNumCols() ;
+  int m = image.getNumRows() ;
+  loadProblem_(clpSimplex_,n,m,
+	       image.getColStarts(),image.getIndices(),image.getElements(),
+	       image.getColLower(),image.getColUpper(),image.getObjective(),
+	       image.getRowLower(),image.getRowUpper()) ;
+  simpleSetter<CS,double>(libClp_,clpSimplex_,
+			  "Clp_setOptimizationDirection",image.getObjSense()) ;
+  simpleSetter<CS,double>(libClp_,clpSimplex_,
+			  "Clp_setObjectiveOffset",image.getObjOffset()) ;
+  std::string probName = image.getProblemName() ;
+  simpleGetter<CS,int,int,const char *>
+      (libClp_,clpSimplex_,"Clp_setProblemName",
+       static_cast<int>(probName.length()),probName.c_str()) ;
+  if (image.getIntegerInformation() != nullptr)
+    simpleSetter<CS,const char *>(libClp_,clpSimplex_,
+				  "Clp_copyInIntegerInformation",
+				  image.getIntegerInformation()) ;
+  if (image.hasNames()) {
+    std::vector<std::string> rowNames(m), colNames(n) ;
+    std::vector<const char *> rowPtrs(m), colPtrs(n) ;
+    for (int i = 0 ; i < m ; i++) {
+      rowNames[i] = imageName(image,true,i) ;
+      rowPtrs[i] = rowNames[i].c_str() ;
+    }
+    for (int j = 0 ; j < n ; j++) {
+      colNames[j] = imageName(image,false,j) ;
+      colPtrs[j] = colNames[j].c_str() ;
+    }
+    simpleSetter<CS,const char *const *,const char *const *>
+	(libClp_,clpSimplex_,"Clp_copyNames",rowPtrs.data(),colPtrs.data()) ;
+  }
+  std::cout << "Read " << filename << " without error." << std::endl ;
+  return (0) ;
+}
+
+/*
+  Streamed loading. The pieces are copied into a ModelBuilder as they
+  arrive; endModel hands the finished matrix to assignProblem.
+*/
+void ProbMgmtAPI_Clp::beginModel ()
+{
+  ingest_.reset(new ModelBuilder()) ;
+}
+
+void ProbMgmtAPI_Clp::appendRows (int numRows, const CoinBigIndex *starts,
+	const int *indices, const double *elements,
+	const double *rowLower, const double *rowUpper)
+{
+  if (!ingest_) return ;
+  ingest_->addRows(numRows,starts,indices,elements,rowLower,rowUpper) ;
+}
+
+void ProbMgmtAPI_Clp::appendColumns (int numCols,
+	const CoinBigIndex *starts, const int *indices, const double *elements,
+	const double *colLower, const double *colUpper, const double *obj)
+{
+  if (!ingest_) return ;
+  ingest_->addColumns(numCols,starts,indices,elements,
+		      colLower,colUpper,obj) ;
+}
+
+int ProbMgmtAPI_Clp::endModel ()
+{
+  if (!ingest_) return (-1) ;
+  int dropped = ingest_->finalize() ;
+  if (dropped) {
+      std::cout
+	  << "Dropped " << dropped << " coefficients out of range."
+	  << std::endl ;
+  }
+  ingest_->assignTo(*this) ;
+  ingest_.reset() ;
+  return (dropped) ;
+}
+
 /*
   Solve a problem
 */
@@ -10,6 +10,8 @@
 #ifndef Osi2ProbMgmtAPI_Clp_HPP
 #define Osi2ProbMgmtAPI_Clp_HPP
 
+#include <memory>
+
 #include "Osi2DynamicLibrary.hpp"
 
 #include "Osi2API.hpp"
@@ -22,6 +24,8 @@
 
 namespace Osi2 {
 
+class ModelBuilder ;
+
 class ProbMgmtAPI_Clp : public ProbMgmtAPI {
 
 public:
@@ -35,6 +39,34 @@ public:
     int readMps(const char *filename, bool keepNames = false,
                 bool ignoreErrors = false) ;
 
+    /// Load a problem, taking ownership of the arrays
+    void assignProblem(const int numcols, const int numrows,
+      CoinBigIndex *&start, int *&index, double *&value,
+      double *&collb, double *&colub, double *&obj,
+      double *&rowlb, double *&rowub) ;
+
+    /// Write the problem in Osi2 binary format
+    int writeModel(const char *filename) ;
+
+    /// Read a problem in Osi2 binary format
+    int readModel(const char *filename) ;
+
+    /*! \name Streamed loading */
+    //@{
+    /// Start a new problem
+    void beginModel() ;
+    /// Append rows
+    void appendRows(int numRows, const CoinBigIndex *starts,
+      const int *indices, const double *elements,
+      const double *rowLower, const double *rowUpper) ;
+    /// Append columns
+    void appendColumns(int numCols, const CoinBigIndex *starts,
+      const int *indices, const double *elements,
+      const double *colLower, const double *colUpper, const double *obj) ;
+    /// Build the matrix and load the problem
+    int endModel() ;
+    //@}
+
     /*! \brief Solve an lp
 
       See ClpModel::status() for the meaning of the return value.
@@ -60,8 +92,16 @@ private:
     ClpReadMpsFunc readMps_ ;
     typedef  int (*ClpInitialSolveFunc)(Clp_Simplex*) ;
     ClpInitialSolveFunc initialSolve_ ;
+    typedef  void (*ClpLoadProblemFunc)(Clp_Simplex*, const int, const int,
+	const CoinBigIndex*, const int*, const double*,
+	const double*, const double*, const double*,
+	const double*, const double*) ;
+    ClpLoadProblemFunc loadProblem_ ;
   //@}
 
+    /// The problem being streamed in, between beginModel and endModel
+    std::unique_ptr<ModelBuilder> ingest_ ;
+
 } ;
 
 }  // end namespace Osi2
@@ -12,11 +12,16 @@
   libraries and allows direct access to clp objects.
 */
 
+#include <cstdio>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "ClpConfig.h"
 #include "Osi2ClpShim.hpp"
 #include "ClpSimplex.hpp"
+#include "ClpPackedMatrix.hpp"
+#include "CoinPackedMatrix.hpp"
 
 #include "Osi2Config.h"
 #include "Osi2nullptr.hpp"
@@ -24,6 +29,28 @@
 #include "Osi2API.hpp"
 #include "Osi2ProbMgmtAPI.hpp"
 #include "Osi2ProbMgmtAPI_ClpHeavy.hpp"
+#include "Osi2ModelImage.hpp"
+#include "Osi2ModelCache.hpp"
+#include "Osi2ModelBuilder.hpp"
+
+namespace {
+
+/*
+  Name of row or column ndx from a model image. An image may carry names
+  for rows but not columns, or the reverse; the missing side gets clp's
+  default names.
+*/
+std::string imageName (const Osi2::ModelImage &image, bool isRow, int ndx)
+{
+  const char *name = (isRow)?image.rowName(ndx):image.columnName(ndx) ;
+  if (name != nullptr) return (std::string(name)) ;
+  char buffer[16] ;
+  std::sprintf(buffer,"%c%7.7d",(isRow)?'R':'C',ndx) ;
+  return (std::string(buffer)) ;
+}
+
+}  // end file-local namespace
+
 
 namespace Osi2 {
 
@@ -43,11 +70,23 @@ ProbMgmtAPI_ClpHeavy::~ProbMgmtAPI_ClpHeavy ()
 }
 
 /*
-  Read a problem file in mps format.
+  Read a problem file in mps format, through the model cache if one is set.
+  A cached image is used only if it opens cleanly, which includes matching
+  the digests recorded when it was written. Otherwise the file is parsed
+  and the image written afresh.
 */
 int ProbMgmtAPI_ClpHeavy::readMps (const char *filename, bool keepNames,
                               bool ignoreErrors)
 {
+    std::string imagePath ;
+    if (ModelCache::lookup(filename, keepNames, imagePath) &&
+        readModel(imagePath.c_str()) == 0) {
+        std::cout
+                << "Read " << filename << " from the model cache."
+                << std::endl ;
+        return (0) ;
+    }
+
     int retval = clpSimplex_->readMps(filename, keepNames, ignoreErrors) ;
 
     if (retval) {
@@ -57,11 +96,194 @@ int ProbMgmtAPI_ClpHeavy::readMps (const char *filename, bool keepNames,
     } else {
         std::cout
                 << "Read " << filename << " without error." << std::endl ;
+        if (!imagePath.empty()) writeModel(imagePath.c_str()) ;
+    }
+
+    return (retval) ;
+}
+
+/*
+  Load a problem without copying the matrix. ClpModel has no way to adopt
+  the bound and objective vectors, but it will adopt a matrix. Load the rim
+  vectors with an empty matrix of the right shape, then replace the matrix
+  with one built around the caller's arrays. CoinPackedMatrix::assignMatrix
+  takes ownership of the arrays and nulls the pointers; it computes the
+  column lengths when none are given. The rim vectors are small by
+  comparison and are simply copied.
+*/
+void ProbMgmtAPI_ClpHeavy::assignProblem (const int numcols,
+	const int numrows,
+	CoinBigIndex *&start, int *&index, double *&value,
+	double *&collb, double *&colub, double *&obj,
+	double *&rowlb, double *&rowub)
+{
+    std::vector<CoinBigIndex> noStart(numcols+1,0) ;
+    int noIndex[1] ;
+    double noValue[1] ;
+    clpSimplex_->loadProblem(numcols,numrows,&noStart[0],noIndex,noValue,
+			     collb,colub,obj,rowlb,rowub) ;
+
+    CoinBigIndex numels = start[numcols] ;
+    int *length = nullptr ;
+    CoinPackedMatrix *matrix = new CoinPackedMatrix() ;
+    matrix->assignMatrix(true,numrows,numcols,numels,
+			 value,index,start,length) ;
+    clpSimplex_->replaceMatrix(new ClpPackedMatrix(matrix),true) ;
+
+    delete[] collb ;
+    collb = nullptr ;
+    delete[] colub ;
+    colub = nullptr ;
+    delete[] obj ;
+    obj = nullptr ;
+    delete[] rowlb ;
+    rowlb = nullptr ;
+    delete[] rowub ;
+    rowub = nullptr ;
+}
+
+/*
+  Write the problem in Osi2 binary format. Names are collected into arenas
+  only if the model has them.
+*/
+int ProbMgmtAPI_ClpHeavy::writeModel (const char *filename)
+{
+    const CoinPackedMatrix *matrix = clpSimplex_->matrix() ;
+    ModelImage::Source src ;
+    src.numCols_ = clpSimplex_->numberColumns() ;
+    src.numRows_ = clpSimplex_->numberRows() ;
+    src.starts_ = matrix->getVectorStarts() ;
+    src.lengths_ = matrix->getVectorLengths() ;
+    src.indices_ = matrix->getIndices() ;
+    src.elements_ = matrix->getElements() ;
+    src.colLower_ = clpSimplex_->columnLower() ;
+    src.colUpper_ = clpSimplex_->columnUpper() ;
+    src.obj_ = clpSimplex_->objective() ;
+    src.rowLower_ = clpSimplex_->rowLower() ;
+    src.rowUpper_ = clpSimplex_->rowUpper() ;
+    src.integer_ = clpSimplex_->integerInformation() ;
+    src.objSense_ = clpSimplex_->optimizationDirection() ;
+    src.objOffset_ = clpSimplex_->objectiveOffset() ;
+    src.probName_ = clpSimplex_->problemName() ;
+
+    std::vector<char> rowArena, colArena ;
+    std::vector<int> rowOffsets, colOffsets ;
+    if (clpSimplex_->lengthNames() > 0) {
+	for (int i = 0 ; i < src.numRows_ ; i++) {
+	    std::string name = clpSimplex_->rowName(i) ;
+	    rowOffsets.push_back(static_cast<int>(rowArena.size())) ;
+	    rowArena.insert(rowArena.end(),name.c_str(),
+			    name.c_str()+name.length()+1) ;
+	}
+	for (int j = 0 ; j < src.numCols_ ; j++) {
+	    std::string name = clpSimplex_->columnName(j) ;
+	    colOffsets.push_back(static_cast<int>(colArena.size())) ;
+	    colArena.insert(colArena.end(),name.c_str(),
+			    name.c_str()+name.length()+1) ;
+	}
+	src.rowNames_ = rowArena.data() ;
+	src.rowNameOffsets_ = rowOffsets.data() ;
+	src.colNames_ = colArena.data() ;
+	src.colNameOffsets_ = colOffsets.data() ;
+    }
+
+    int retval = ModelImage::write(filename,src) ;
+
+    if (retval) {
+        std::cout
+                << "Failure to write " << filename << ", error " << retval
+                << "." << std::endl ;
+    } else {
+        std::cout
+                << "Wrote " << filename << " without error." << std::endl ;
     }
 
     return (retval) ;
 }
 
+/*
+  Read a problem in Osi2 binary format. The arrays go to loadProblem
+  straight from the mapped file.
+*/
+int ProbMgmtAPI_ClpHeavy::readModel (const char *filename)
+{
+    ModelImage image ;
+    int retval = image.open(filename) ;
+
+    if (retval) {
+        std::cout
+                << "Failure to read " << filename << ", error " << retval
+                << "." << std::endl ;
+        return (retval) ;
+    }
+
+    int n = image.getNumCols() ;
+    int m = image.getNumRows() ;
+    clpSimplex_->loadProblem(n,m,image.getColStarts(),image.getIndices(),
+			     image.getElements(),image.getColLower(),
+			     image.getColUpper(),image.getObjective(),
+			     image.getRowLower(),image.getRowUpper()) ;
+    clpSimplex_->setOptimizationDirection(image.getObjSense()) ;
+    clpSimplex_->setObjectiveOffset(image.getObjOffset()) ;
+    clpSimplex_->setStrParam(ClpProbName,image.getProblemName()) ;
+    if (image.getIntegerInformation() != nullptr)
+      clpSimplex_->copyInIntegerInformation(image.getIntegerInformation()) ;
+    if (image.hasNames()) {
+	std::vector<std::string> rowNames(m), colNames(n) ;
+	for (int i = 0 ; i < m ; i++) rowNames[i] = imageName(image,true,i) ;
+	for (int j = 0 ; j < n ; j++) colNames[j] = imageName(image,false,j) ;
+	clpSimplex_->copyNames(rowNames,colNames) ;
+    }
+
+    std::cout << "Read " << filename << " without error." << std::endl ;
+
+    return (0) ;
+}
+
+/*
+  Streamed loading. The pieces are copied into a ModelBuilder as they
+  arrive; endModel hands the finished matrix to assignProblem, which adopts
+  it without a copy.
+*/
+void ProbMgmtAPI_ClpHeavy::beginModel ()
+{
+    ingest_.reset(new ModelBuilder()) ;
+}
+
+void ProbMgmtAPI_ClpHeavy::appendRows (int numRows,
+	const CoinBigIndex *starts, const int *indices, const double *elements,
+	const double *rowLower, const double *rowUpper)
+{
+    if (!ingest_) return ;
+    ingest_->addRows(numRows,starts,indices,elements,rowLower,rowUpper) ;
+}
+
+void ProbMgmtAPI_ClpHeavy::appendColumns (int numCols,
+	const CoinBigIndex *starts, const int *indices, const double *elements,
+	const double *colLower, const double *colUpper, const double *obj)
+{
+    if (!ingest_) return ;
+    ingest_->addColumns(numCols,starts,indices,elements,
+			colLower,colUpper,obj) ;
+}
+
+int ProbMgmtAPI_ClpHeavy::endModel ()
+{
+    if (!ingest_) return (-1) ;
+
+    int dropped = ingest_->finalize() ;
+
+    if (dropped) {
+        std::cout
+                << "Dropped " << dropped << " coefficients out of range."
+                << std::endl ;
+    }
+    ingest_->assignTo(*this) ;
+    ingest_.reset() ;
+
+    return (dropped) ;
+}
+
 /*
   Solve a problem.
 */
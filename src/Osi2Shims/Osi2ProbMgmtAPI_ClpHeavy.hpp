@@ -11,6 +11,8 @@
 #ifndef Osi2ProbMgmtAPI_ClpHeavy_HPP
 #define Osi2ProbMgmtAPI_ClpHeavy_HPP
 
+#include <memory>
+
 #include "Osi2DynamicLibrary.hpp"
 
 #include "Osi2API.hpp"
@@ -23,6 +25,8 @@
 
 namespace Osi2 {
 
+class ModelBuilder ;
+
 class ProbMgmtAPI_ClpHeavy : public ProbMgmtAPI {
 
 public:
@@ -36,6 +40,38 @@ public:
     int readMps(const char *filename, bool keepNames = false,
                 bool ignoreErrors = false) ;
 
+    /*! \brief Load a problem, taking ownership of the arrays
+
+      The matrix arrays are adopted as they stand; the bound and objective
+      vectors are copied and freed.
+    */
+    void assignProblem(const int numcols, const int numrows,
+      CoinBigIndex *&start, int *&index, double *&value,
+      double *&collb, double *&colub, double *&obj,
+      double *&rowlb, double *&rowub) ;
+
+    /// Write the problem in Osi2 binary format
+    int writeModel(const char *filename) ;
+
+    /// Read a problem in Osi2 binary format
+    int readModel(const char *filename) ;
+
+    /*! \name Streamed loading */
+    //@{
+    /// Start a new problem
+    void beginModel() ;
+    /// Append rows
+    void appendRows(int numRows, const CoinBigIndex *starts,
+      const int *indices, const double *elements,
+      const double *rowLower, const double *rowUpper) ;
+    /// Append columns
+    void appendColumns(int numCols, const CoinBigIndex *starts,
+      const int *indices, const double *elements,
+      const double *colLower, const double *colUpper, const double *obj) ;
+    /// Build the matrix and load the problem
+    int endModel() ;
+    //@}
+
     /*! \brief Solve an lp
 
       See ClpModel::status() for the meaning of the return value.
@@ -49,6 +85,9 @@ private:
     ClpSimplex *clpSimplex_ ;
   //@}
 
+    /// The problem being streamed in, between beginModel and endModel
+    std::unique_ptr<ModelBuilder> ingest_ ;
+
 } ;
 
 }  // end namespace Osi2
@@ -7,6 +7,13 @@
   This file contains the unit test for the OSI2 PluginManager and OSI2 APIs.
 */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+
 #include "CoinHelperFunctions.hpp"
 
 
@@ -23,8 +30,24 @@
 #include "Osi2ClpSimplexAPI.hpp"
 #include "Osi2ClpLite_Wrap.hpp"
 #include "Osi2ClpSolveParamsAPI.hpp"
+#include "Osi2NameIndexAPI.hpp"
 
 #include "Osi2RunParamsAPI.hpp"
+#include "Osi2ParamSweep.hpp"
+#include "Osi2ParamTuner.hpp"
+#include "Osi2AlgorithmRace.hpp"
+#include "Osi2SolveFuture.hpp"
+#include "Osi2WarmStartStore.hpp"
+#include "Osi2ModelFingerprint.hpp"
+#include "Osi2SolveCache.hpp"
+#include "Osi2BatchSolveAPI.hpp"
+#include "Osi2ScenarioAPI.hpp"
+#include "Osi2MpsReader.hpp"
+#include "Osi2ModelImage.hpp"
+#include "Osi2ModelCache.hpp"
+#include "Osi2OsilReader.hpp"
+#include "Osi2ModelWriter.hpp"
+#include "Osi2ModelBuilder.hpp"
 
 #ifndef OSI2UTSAMPLEDIR
 # define SAMPLEDATADIR "/usr/local/share/coin-or-sample"
@@ -36,11 +59,51 @@
 #else
 # define NETLIBDATADIR OSI2UTNETLIBDIR
 #endif
+#ifndef OSI2UTDATADIR
+# define OSI2DATADIR "../data"
+#else
+# define OSI2DATADIR OSI2UTDATADIR
+#endif
 
 using namespace Osi2 ;
 
 namespace {
 
+/*
+  The contents of a file, or an empty string if it can't be read.
+*/
+std::string fileText (const char *path)
+{
+  std::ifstream file(path,std::ios::binary) ;
+  return (std::string(std::istreambuf_iterator<char>(file),
+		      std::istreambuf_iterator<char>())) ;
+}
+
+/*
+  Load the Clp (lite) plugin and create a ClpSimplex object. The object is
+  returned in apiObj, for destruction by the caller. Returns the
+  ClpSimplexAPI interface, or null on failure.
+*/
+ClpSimplexAPI *createClpSimplex (ControlAPI &ctrlAPI, API *&apiObj)
+{
+  std::string shortName = "Clp" ;
+  int retval = ctrlAPI.load(shortName) ;
+  if (retval < 0) {
+    std::cout
+      << "Error " << retval << " loading " << shortName << "." << std::endl ;
+    return (nullptr) ;
+  }
+  apiObj = nullptr ;
+  retval = ctrlAPI.createObject(apiObj,ClpSimplexAPI::getAPIIDString()) ;
+  if (retval != 0) {
+    std::cout
+      << "Error " << retval << " creating ClpSimplexAPI object." << std::endl ;
+    return (nullptr) ;
+  }
+  return (static_cast<ClpSimplexAPI *>
+	    (apiObj->getAPIPtr(ClpSimplexAPI::getAPIIDString()))) ;
+}
+
 /*
   Test the bare PluginManager API:
     * Initialise the PluginManager.
@@ -278,6 +341,80 @@ int testControlAPI (const std::string &shortName,
     std::string exmip1Path = dfltSampleDir+dirSep+"brandy.mps" ;
     clp->readMps(exmip1Path.c_str(),true) ;
     clp->initialSolve() ;
+/*
+  Stream brandy back in: the rows first, with no coefficients, then the
+  columns in two pieces.
+*/
+    MpsReader reader ;
+    if (reader.readMps(exmip1Path.c_str()) == 0) {
+      int n = reader.getNumCols() ;
+      int m = reader.getNumRows() ;
+      const CoinBigIndex *starts = reader.getColStarts() ;
+      std::vector<CoinBigIndex> noStarts(m+1,0) ;
+      int half = n/2 ;
+      clp->beginModel() ;
+      clp->appendRows(m,noStarts.data(),nullptr,nullptr,
+		      reader.getRowLower(),reader.getRowUpper()) ;
+      clp->appendColumns(half,starts,reader.getIndices(),
+			 reader.getElements(),reader.getColLower(),
+			 reader.getColUpper(),reader.getObjective()) ;
+      clp->appendColumns(n-half,starts+half,reader.getIndices(),
+			 reader.getElements(),reader.getColLower()+half,
+			 reader.getColUpper()+half,reader.getObjective()+half) ;
+      if (clp->endModel() != 0 || clp->initialSolve() != 0) {
+	errcnt++ ;
+	std::cout << "Streamed loading failed for brandy." << std::endl ;
+      }
+/*
+  And again, with the coefficients of the second half of the columns given
+  by rows. Three of them refer to columns that never arrive and should be
+  dropped.
+*/
+      const int *colIndices = reader.getIndices() ;
+      const double *colElements = reader.getElements() ;
+      std::vector<std::vector<int> > rowIndices(m) ;
+      std::vector<std::vector<double> > rowElements(m) ;
+      for (int j = half ; j < n ; j++) {
+	for (CoinBigIndex k = starts[j] ; k < starts[j+1] ; k++) {
+	  rowIndices[colIndices[k]].push_back(j) ;
+	  rowElements[colIndices[k]].push_back(colElements[k]) ;
+	}
+      }
+      rowIndices[0].push_back(n) ;
+      rowElements[0].push_back(1.0) ;
+      rowIndices[m/2].push_back(-1) ;
+      rowElements[m/2].push_back(1.0) ;
+      rowIndices[m-1].push_back(n+5) ;
+      rowElements[m-1].push_back(1.0) ;
+      std::vector<CoinBigIndex> rowStarts(1,0) ;
+      std::vector<int> flatIndices ;
+      std::vector<double> flatElements ;
+      for (int i = 0 ; i < m ; i++) {
+	flatIndices.insert(flatIndices.end(),
+			   rowIndices[i].begin(),rowIndices[i].end()) ;
+	flatElements.insert(flatElements.end(),
+			    rowElements[i].begin(),rowElements[i].end()) ;
+	rowStarts.push_back(static_cast<CoinBigIndex>(flatIndices.size())) ;
+      }
+      std::vector<CoinBigIndex> noColStarts(n-half+1,0) ;
+      clp->beginModel() ;
+      clp->appendColumns(half,starts,colIndices,colElements,
+			 reader.getColLower(),reader.getColUpper(),
+			 reader.getObjective()) ;
+      clp->appendRows(m,rowStarts.data(),flatIndices.data(),
+		      flatElements.data(),
+		      reader.getRowLower(),reader.getRowUpper()) ;
+      clp->appendColumns(n-half,noColStarts.data(),nullptr,nullptr,
+			 reader.getColLower()+half,reader.getColUpper()+half,
+			 reader.getObjective()+half) ;
+      int dropped = clp->endModel() ;
+      if (dropped != 3 || clp->initialSolve() != 0) {
+	errcnt++ ;
+	std::cout
+	  << "Streamed loading by rows failed for brandy; dropped "
+	  << dropped << " coefficients, expected 3." << std::endl ;
+      }
+    }
   }
 /*
   Create an Osi1 object and invoke a nontrivial method.  The clone test
@@ -300,6 +437,54 @@ int testControlAPI (const std::string &shortName,
     Osi1API *osi = dynamic_cast<Osi1API *>(apiObj) ;
     std::string exmip1Path = dfltSampleDir+dirSep+"brandy.mps" ;
     osi->readMps(exmip1Path.c_str()) ;
+/*
+  Only the clp shim maintains a name index (glpk has no NameIndexAPI).
+*/
+    bool ok = true ;
+    if (shortName == "clpHeavy") {
+      NameIndexAPI *names = static_cast<NameIndexAPI *>
+	(osi->getAPIPtr(NameIndexAPI::getAPIIDString())) ;
+      ok = (names != nullptr && osi->getNumRows() > 1) ;
+      if (ok) {
+	ok = (names->rowIndex(osi->getRowName(1).c_str()) == 1) &&
+	     (names->columnIndex(osi->getColName(0).c_str()) == 0) ;
+	osi->setIntParam(OsiNameDiscipline,1) ;
+	osi->setRowName(1,"renamed") ;
+	ok = ok && (names->rowIndex("renamed") == 1) ;
+/*
+  With names kept, OsiClpSolverInterface::deleteRows removes each name in
+  turn through deleteRowNames. The index must see the deletion once.
+*/
+	std::string third = osi->getRowName(2) ;
+	int first = 0 ;
+	osi->deleteRows(1,&first) ;
+	ok = ok && (names->rowIndex("renamed") == 0) &&
+	     (names->rowIndex(third.c_str()) == 1) ;
+      }
+      if (!ok) {
+	errcnt++ ;
+	std::cout << "Name index lookup failed for brandy." << std::endl ;
+      }
+    }
+/*
+  OsiClpSolverInterface writes LP files with CoinLpIO. ModelWriter, given
+  the same object and parameters, must write the same file.
+*/
+    if (shortName == "clpHeavy") {
+      const char *lpPaths[2] = { "brandyCoin.lp", "brandyOsi2.lp" } ;
+      osi->writeLp("brandyCoin","lp",1e-5,4,5,0.0,true) ;
+      ModelWriter writer ;
+      writer.setModel(*osi) ;
+      std::string text = fileText(lpPaths[0]) ;
+      ok = (writer.writeLp(lpPaths[1],1e-5,4,5,0.0,true) == 0) &&
+	   !text.empty() && text == fileText(lpPaths[1]) ;
+      for (int ndx = 0 ; ndx < 2 ; ndx++) std::remove(lpPaths[ndx]) ;
+      if (!ok) {
+	errcnt++ ;
+	std::cout
+	  << "ModelWriter and CoinLpIO differ for brandy." << std::endl ;
+      }
+    }
     std::cout << "    cloning ... " << std::endl ;
     Osi1API *o2 = osi->clone() ;
     o2->initialSolve() ;
@@ -489,6 +674,40 @@ int testParamMgmtAPI (std::string sampleDir)
 	<< std::endl ;
     }
   }
+/*
+  Take a snapshot, change the log level, and check that diff sees exactly
+  that change and restore puts the old value back.
+*/
+  {
+    const char *paramID = "log level" ;
+    ParamSnapshot before = mgmtAPI.snapshot(ctrlAPI1ID) ;
+    int blob ;
+    mgmtAPI.get(ctrlAPI1ID,paramID,&blob) ;
+    int oldLvl = blob ;
+    blob = oldLvl+1 ;
+    mgmtAPI.set(ctrlAPI1ID,paramID,&blob) ;
+    ParamSnapshot after = mgmtAPI.snapshot(ctrlAPI1ID) ;
+    std::vector<std::string> changed = mgmtAPI.diff(before,after) ;
+    if (changed.size() != 1 || changed[0] != paramID) {
+      std::cout
+	<< "Snapshot diff for " << ctrlAPI1ID << " reports "
+	<< changed.size() << " changes; expected only " << paramID << "."
+	<< std::endl ;
+      errCnt++ ;
+    }
+    if (!mgmtAPI.restore(ctrlAPI1ID,before,changed)) {
+      std::cout
+	<< "Failed to restore snapshot of " << ctrlAPI1ID << "." << std::endl ;
+      errCnt++ ;
+    }
+    mgmtAPI.get(ctrlAPI1ID,paramID,&blob) ;
+    if (blob != oldLvl) {
+      std::cout
+	<< "After restore, " << ctrlAPI1ID << ":" << paramID << " is "
+	<< blob << "; expected " << oldLvl << "." << std::endl ;
+      errCnt++ ;
+    }
+  }
 /*
   Use the ControlAPI object to load the Clp(Lite) plugin.
 */
@@ -662,13 +881,220 @@ int testRunParamsAPI (std::string netlibDir)
     << "Solve took " << clpObj->numberIterations() << " iterations."
     << std::endl ;
   std::cout << "Flipping objective sense to maximisation." << std::endl ;
+  unsigned long loadedGen = rpObj->getGeneration() ;
   rpObj->setDblParam("obj sense",-1.0) ;
+/*
+  Only the objective sense should be reported as changed since the last load.
+  Setting a parameter to its current value is not a change.
+*/
+  rpObj->setDblParam("obj sense",-1.0) ;
+  paramNames = rpObj->getDblParamIds(loadedGen) ;
+  if (paramNames.size() != 1 || paramNames[0] != "obj sense" ||
+      rpObj->getIntParamIds(loadedGen).size() != 0) {
+    std::cout
+      << "Expected only \"obj sense\" to change since generation "
+      << loadedGen << "." << std::endl ;
+    errCnt++ ;
+  }
+/*
+  Clone the parameter set and change the clone. The original should be
+  unaffected. The clone starts from a fresh generation, so every parameter
+  counts as changed since the original's latest generation, and ids come
+  back in alphabetical order.
+*/
+  RunParamsAPI *rpClone = rpObj->clone() ;
+  std::vector<std::string> allIds = rpObj->getDblParamIds() ;
+  if (rpClone->getDblParamIds(rpObj->getGeneration()) != allIds ||
+      !std::is_sorted(allIds.begin(),allIds.end())) {
+    std::cout
+      << "Cloned RunParams object has stale generations or ids are not in"
+      << " alphabetical order." << std::endl ;
+    errCnt++ ;
+  }
+  rpClone->setDblParam("obj sense",1.0) ;
+  if (rpObj->getDblParam("obj sense") != -1.0 ||
+      rpClone->getDblParam("obj sense") != 1.0) {
+    std::cout
+      << "Change to a cloned RunParams object leaked into the original."
+      << std::endl ;
+    errCnt++ ;
+  }
+  delete rpClone ;
   clpObj->readMps(probPath.c_str()) ;
   clpObj->loadParams(*rpObj) ;
   clpObj->initialSolve() ;
   std::cout
     << "Solve took " << clpObj->numberIterations() << " iterations."
     << std::endl ;
+/*
+  Sweep over two perturbation settings and two scaling modes. Every profile
+  should reach the same optimum.
+*/
+  {
+    ParamSweep sweep(ctrlAPI,*clpObj) ;
+    std::vector<int> perturb ;
+    perturb.push_back(50) ;
+    perturb.push_back(100) ;
+    std::vector<int> scale ;
+    scale.push_back(0) ;
+    scale.push_back(3) ;
+    sweep.addIntAxis("perturbation",perturb) ;
+    sweep.addIntAxis("scaling",scale) ;
+    sweep.buildGrid(*rpObj) ;
+    int failures = sweep.run(2) ;
+    const std::vector<ParamSweep::Result> &results = sweep.getResults() ;
+    for (int ndx = 0 ; ndx < results.size() ; ndx++) {
+      const ParamSweep::Result &result = results[ndx] ;
+      std::cout
+	<< "  profile " << ndx << ": status " << result.status_
+	<< ", " << result.iterations_ << " iterations, objective "
+	<< result.objective_ << ", " << result.seconds_ << " sec."
+	<< std::endl ;
+      if (std::fabs(result.objective_-results[0].objective_) >
+	  1.0e-6*(1.0+std::fabs(results[0].objective_))) failures++ ;
+    }
+    if (results.size() != 4 || failures != 0) {
+      std::cout
+	<< "Parameter sweep over " << results.size() << " profiles had "
+	<< failures << " failures." << std::endl ;
+      errCnt++ ;
+    }
+  }
+/*
+  Race dual, primal, and barrier on pilot. Someone should win, with the
+  optimum found above, and the losers should have been told to stop. Each
+  loser must either report that it was cancelled or have finished on its
+  own; a loser that can't stop promptly (barrier, before crossover) is
+  reported as cancelled and waited for by settle. Run the race twice so
+  that the second run reaps any loser left over from the first.
+*/
+  for (int pass = 0 ; pass < 2 ; pass++) {
+    AlgorithmRace race(ctrlAPI,*clpObj) ;
+    race.addEntrant(AlgorithmRace::Dual) ;
+    race.addEntrant(AlgorithmRace::Primal) ;
+    race.addEntrant(AlgorithmRace::Barrier,rpObj) ;
+    AlgorithmRace::Result winner ;
+    std::vector<AlgorithmRace::Result> all ;
+    bool won = race.run(winner,&all) ;
+    if (pass == 1) won = race.run(winner,&all) && won ;
+    int unsignalled = 0 ;
+    for (int ndx = 0 ; ndx < all.size() ; ndx++) {
+      const AlgorithmRace::Result &result = all[ndx] ;
+      std::cout
+	<< "  entrant " << ndx << ": status " << result.status_
+	<< ", " << result.iterations_ << " iterations, "
+	<< result.seconds_ << " sec."
+	<< ((result.cancelled_)?" (cancelled)":"") << std::endl ;
+      if (won && ndx != winner.entrant_ &&
+	  !result.cancelled_ && result.retval_ < 0) unsignalled++ ;
+    }
+    double optimum = clpObj->objectiveValue() ;
+    if (!won || winner.status_ != 0 ||
+	winner.colSolution_.size() !=
+	  static_cast<size_t>(clpObj->numberColumns()) ||
+	std::fabs(winner.objective_-optimum) >
+	  1.0e-6*(1.0+std::fabs(optimum))) {
+      std::cout << "Algorithm race on pilot failed to produce a winner."
+		<< std::endl ;
+      errCnt++ ;
+    }
+    if (won && (!race.stopRequested() || winner.cancelled_ ||
+		unsignalled != 0)) {
+      std::cout
+	<< "Algorithm race on pilot did not stop its losers; "
+	<< unsignalled << " neither cancelled nor finished." << std::endl ;
+      errCnt++ ;
+    }
+    race.settle() ;
+  }
+/*
+  Start a solve of pilot in the background and cancel it as soon as it has
+  started. The solver should stop early (or, if it was quick, finish). A
+  solve cancelled before it gets going must not run at all and must leave
+  the solver alone. A second solve should then carry on to the optimum.
+*/
+  {
+    double optimum = clpObj->objectiveValue() ;
+    clpObj->readMps(probPath.c_str()) ;
+    clpObj->loadParams(*rpObj) ;
+    SolveFuture solve = solveAsync(*clpObj) ;
+    while (!solve.started() && !solve.waitFor(0.001)) ;
+    solve.cancel() ;
+    solve.wait() ;
+    bool ok = solve.started() &&
+	      ((solve.cancelled() && clpObj->status() == 3) ||
+	       (!solve.cancelled() && clpObj->status() == 0)) ;
+    int iters = clpObj->numberIterations() ;
+    std::cout
+      << "Cancelled solve stopped with status " << clpObj->status()
+      << " after " << iters << " iterations." << std::endl ;
+    SolveFuture early = solveAsync(*clpObj) ;
+    early.cancel() ;
+    int retval = early.wait() ;
+    if (!early.started()) {
+      ok = ok && retval == -1 && early.cancelled() &&
+	   clpObj->numberIterations() == iters ;
+    }
+    solve = solveAsync(*clpObj,SolveFuture::Primal) ;
+    while (!solve.waitFor(0.1)) ;
+    solve.wait() ;
+    if (!ok || solve.cancelled() || clpObj->status() != 0 ||
+	std::fabs(clpObj->objectiveValue()-optimum) >
+	  1.0e-6*(1.0+std::fabs(optimum))) {
+      std::cout << "Asynchronous solve of pilot failed." << std::endl ;
+      errCnt++ ;
+    }
+  }
+/*
+  Tune the scaling mode for pilot with a single halving round, then check
+  that the winning profile survives a save and load and is found again for
+  the same model. Apply it to an empty parameter set: the winning scaling
+  mode must be added there and must reach the solver.
+*/
+  {
+    apiObj = nullptr ;
+    retval = ctrlAPI.createObject(apiObj,RunParamsAPI::getAPIIDString()) ;
+    if (retval != 0) {
+      std::cout
+	<< "Error " << retval << " creating RunParamsAPI object."
+	<< std::endl ;
+      errCnt++ ;
+      return (errCnt) ;
+    }
+    extantObjs["RunParams #2"] = apiObj ;
+    RunParamsAPI *tunedObj = dynamic_cast<RunParamsAPI *>(apiObj) ;
+    clpObj->scaling(1) ;
+    ParamTuner tuner(ctrlAPI) ;
+    std::vector<int> scale ;
+    scale.push_back(0) ;
+    scale.push_back(3) ;
+    tuner.addIntAxis("scaling",scale) ;
+    tuner.setBudget(0,1) ;
+    std::vector<ClpSimplexAPI *> family(1,clpObj) ;
+    std::string profPath = "pilot.osi2tune" ;
+    ParamTuner reloaded(ctrlAPI) ;
+    if (!tuner.tune(family,*rpObj) || !tuner.save(profPath) ||
+	!reloaded.load(profPath) || reloaded.getProfileCnt() != 1 ||
+	!reloaded.apply(*clpObj,*tunedObj,0.0)) {
+      std::cout
+	<< "Failed to tune, save, reload, and apply a profile for pilot."
+	<< std::endl ;
+      errCnt++ ;
+    } else {
+      std::vector<std::string> tunedIds = tunedObj->getIntParamIds() ;
+      int tunedScale = tunedObj->getIntParam("scaling") ;
+      if (tunedIds.size() != 1 || tunedIds[0] != "scaling" ||
+	  (tunedScale != 0 && tunedScale != 3) ||
+	  clpObj->scalingFlag() != tunedScale) {
+	std::cout
+	  << "Tuned scaling mode " << tunedScale << " was not applied; "
+	  << "the solver has scaling mode " << clpObj->scalingFlag() << "."
+	  << std::endl ;
+	errCnt++ ;
+      }
+    }
+    std::remove(profPath.c_str()) ;
+  }
 /*
   Destroy the objects we've created.
 */
@@ -696,43 +1122,1330 @@ int testRunParamsAPI (std::string netlibDir)
   return errCnt ;
 }
 
-} // end unnamed file-local namespace
-
+/*
+  Test the BatchSolve API. Solve a handful of copies of afiro, some read
+  from the MPS file and some loaded from arrays, and check that every job
+  comes back with the same optimal objective.
+*/
+int testBatchSolveAPI (std::string netlibDir)
 
-int main(int argC,char* argV[])
-{
+{ int errCnt = 0 ;
+  int retval = 0 ;
 
-  std::cout << "START UNIT TEST" << std::endl ;
+  ControlAPI_Imp ctrlAPI ;
+  std::string noDir = "" ;
+  std::string shortName = "RunParams" ;
+  ctrlAPI.load(shortName,shortName,&noDir) ;
+  shortName = "BatchSolve" ;
+  retval = ctrlAPI.load(shortName,shortName,&noDir) ;
+  if (retval < 0) {
+    std::cout
+      << "Error " << retval << " loading BatchSolve plugin." << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  shortName = "Clp" ;
+  retval = ctrlAPI.load(shortName) ;
+  if (retval < 0) {
+    std::cout
+      << "Error " << retval << " loading " << shortName << "." << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
 /*
-  Test the bare PluginManager. There's no sense proceeding to the API
-  tests if the PluginManager isn't working.
+  Create a solver to hold afiro, so that we have arrays to hand to the batch
+  solver.
 */
-  std::cout << "Testing bare PluginManager." << std::endl ;
-  int retval = testPluginManager() ;
-  std::cout
-    << "End test of bare PluginManager, " << retval << " errors."
-    << std::endl << std::endl ;
+  API *clpAPIObj = nullptr ;
+  retval = ctrlAPI.createObject(clpAPIObj,ClpSimplexAPI::getAPIIDString()) ;
+  if (retval != 0) {
+    std::cout
+      << "Error " << retval << " creating ClpSimplexAPI object." << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  ClpSimplexAPI *clpObj = static_cast<ClpSimplexAPI *>
+    (clpAPIObj->getAPIPtr(ClpSimplexAPI::getAPIIDString())) ;
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"afiro.mps" ;
+  clpObj->readMps(probPath.c_str()) ;
+
+  API *apiObj = nullptr ;
+  retval = ctrlAPI.createObject(apiObj,BatchSolveAPI::getAPIIDString()) ;
   if (retval != 0) {
+    std::cout
+      << "Error " << retval << " creating BatchSolveAPI object." << std::endl ;
+    errCnt++ ;
+    ctrlAPI.destroyObject(clpAPIObj) ;
+    return (errCnt) ;
+  }
+  BatchSolveAPI *batch = dynamic_cast<BatchSolveAPI *>(apiObj) ;
+  if (batch->start(ctrlAPI,2) != 0) {
+    std::cout << "Failed to start the BatchSolve worker pool." << std::endl ;
+    errCnt++ ;
+  } else {
+    const int jobCnt = 8 ;
+    for (int ndx = 0 ; ndx < jobCnt ; ndx++) {
+      BatchSolveAPI::Job job ;
+      if (ndx%2 == 0) {
+	job.path_ = probPath ;
+      } else {
+	job.numCols_ = clpObj->numberColumns() ;
+	job.numRows_ = clpObj->numberRows() ;
+	job.start_ = clpObj->getVectorStarts() ;
+	job.index_ = clpObj->getIndices() ;
+	job.value_ = clpObj->getElements() ;
+	job.colLower_ = clpObj->columnLower() ;
+	job.colUpper_ = clpObj->columnUpper() ;
+	job.obj_ = clpObj->objective() ;
+	job.rowLower_ = clpObj->rowLower() ;
+	job.rowUpper_ = clpObj->rowUpper() ;
+      }
+      batch->submit(job) ;
+    }
+    int resultCnt = 0 ;
+    double firstObj = 0.0 ;
+    BatchSolveAPI::Result result ;
+    while (batch->nextResult(result)) {
       std::cout
-	<< "Aborting unitTest; errors in PluginManager." << std::endl ;
-      return (retval) ;
+	<< "  job " << result.jobID_ << ": status " << result.status_
+	<< ", objective " << result.objective_ << "." << std::endl ;
+      if (resultCnt == 0) firstObj = result.objective_ ;
+      if (result.status_ != 0 ||
+	  std::fabs(result.objective_-firstObj) >
+	    1.0e-6*(1.0+std::fabs(firstObj))) {
+	errCnt++ ;
+      }
+      resultCnt++ ;
+    }
+    if (resultCnt != jobCnt) {
+      std::cout
+	<< "Expected " << jobCnt << " batch results, got " << resultCnt
+	<< "." << std::endl ;
+      errCnt++ ;
+    }
+    batch->stop() ;
   }
+  ctrlAPI.destroyObject(apiObj) ;
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
 /*
-  Construct the location of installed data files.
+  Test the Scenario API. Use afiro as the base problem. Alternate scenarios
+  that change the row bounds with scenarios that change nothing; the latter
+  must reproduce the base objective, which checks that the workers undo
+  each scenario. One scenario refers to a column that doesn't exist and
+  must be rejected.
 */
-  std::string sampleDir = SAMPLEDATADIR ;
-  std::string netlibDir = NETLIBDATADIR ;
-  std::cout << "coin-or-sample is at " << sampleDir << std::endl ;
-  std::cout << "coin-or-netlib is at " << netlibDir << std::endl << std::endl ;
+int testScenarioAPI (std::string netlibDir)
+
+{ int errCnt = 0 ;
+  int retval = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  std::string noDir = "" ;
+  std::string shortName = "Scenario" ;
+  retval = ctrlAPI.load(shortName,shortName,&noDir) ;
+  if (retval < 0) {
+    std::cout
+      << "Error " << retval << " loading Scenario plugin." << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  shortName = "Clp" ;
+  retval = ctrlAPI.load(shortName) ;
+  if (retval < 0) {
+    std::cout
+      << "Error " << retval << " loading " << shortName << "." << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  API *clpAPIObj = nullptr ;
+  retval = ctrlAPI.createObject(clpAPIObj,ClpSimplexAPI::getAPIIDString()) ;
+  if (retval != 0) {
+    std::cout
+      << "Error " << retval << " creating ClpSimplexAPI object." << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  ClpSimplexAPI *clpObj = static_cast<ClpSimplexAPI *>
+    (clpAPIObj->getAPIPtr(ClpSimplexAPI::getAPIIDString())) ;
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"afiro.mps" ;
+  clpObj->readMps(probPath.c_str()) ;
+
+  API *apiObj = nullptr ;
+  retval = ctrlAPI.createObject(apiObj,ScenarioAPI::getAPIIDString()) ;
+  if (retval != 0) {
+    std::cout
+      << "Error " << retval << " creating ScenarioAPI object." << std::endl ;
+    errCnt++ ;
+    ctrlAPI.destroyObject(clpAPIObj) ;
+    return (errCnt) ;
+  }
+  ScenarioAPI *scenarios = dynamic_cast<ScenarioAPI *>(apiObj) ;
+  if (scenarios->start(ctrlAPI,*clpObj,2) != 0) {
+    std::cout << "Failed to start the Scenario worker pool." << std::endl ;
+    errCnt++ ;
+  } else {
+    const ScenarioAPI::Result &base = scenarios->getBaseResult() ;
+    double baseObj = base.objective_ ;
+    std::cout
+      << "  base: status " << base.status_ << ", objective " << baseObj
+      << "." << std::endl ;
+    if (base.status_ != 0) errCnt++ ;
+    const int scenarioCnt = 16 ;
+    int m = clpObj->numberRows() ;
+    const double *rowLower = clpObj->rowLower() ;
+    const double *rowUpper = clpObj->rowUpper() ;
+    for (int ndx = 0 ; ndx < scenarioCnt ; ndx++) {
+      ScenarioAPI::Scenario scenario ;
+      if (ndx%2 == 1) {
+	int i = ndx%m ;
+	scenario.chgRowLower(i,rowLower[i]-1.0) ;
+	scenario.chgRowUpper(i,rowUpper[i]+1.0) ;
+      }
+      scenarios->submit(scenario) ;
+    }
+    ScenarioAPI::Scenario bogus ;
+    bogus.chgColUpper(clpObj->numberColumns(),1.0) ;
+    long bogusID = scenarios->submit(bogus) ;
+
+    int resultCnt = 0 ;
+    ScenarioAPI::Result result ;
+    while (scenarios->nextResult(result)) {
+      resultCnt++ ;
+      if (result.scenarioID_ == bogusID) {
+	if (result.retval_ != -1) {
+	  std::cout
+	    << "  scenario " << result.scenarioID_
+	    << " should have been rejected." << std::endl ;
+	  errCnt++ ;
+	}
+	continue ;
+      }
+      std::cout
+	<< "  scenario " << result.scenarioID_ << ": status "
+	<< result.status_ << ", " << result.iterations_
+	<< " iterations, objective " << result.objective_ << "." << std::endl ;
+      if (result.status_ != 0) errCnt++ ;
+      if (result.scenarioID_%2 == 0 &&
+	  std::fabs(result.objective_-baseObj) >
+	    1.0e-6*(1.0+std::fabs(baseObj))) {
+	errCnt++ ;
+      }
+    }
+    if (resultCnt != scenarioCnt+1) {
+      std::cout
+	<< "Expected " << scenarioCnt+1 << " scenario results, got "
+	<< resultCnt << "." << std::endl ;
+      errCnt++ ;
+    }
+    scenarios->stop() ;
+  }
+  ctrlAPI.destroyObject(apiObj) ;
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
 /*
-  Grab the plugin manager instance.
+  Test WarmStartStore. Solve pilot through a store, then reload it and
+  solve again. The second solve should find the stored basis and need next
+  to no iterations.
 */
-  PluginManager &plugMgr = PluginManager::getInstance() ;
+int testWarmStartStore (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+
+  WarmStartStore store ;
+  clpObj->readMps(probPath.c_str()) ;
+  store.solve(*clpObj) ;
+  int coldIters = clpObj->numberIterations() ;
+  clpObj->readMps(probPath.c_str()) ;
+  store.solve(*clpObj) ;
+  int warmIters = clpObj->numberIterations() ;
+  std::cout
+    << "Warm start store: " << coldIters << " iterations cold, "
+    << warmIters << " warm, hit rate " << store.getHitRate() << "."
+    << std::endl ;
+  if (store.getHitCnt() != 1 || !clpObj->isProvenOptimal() ||
+      warmIters >= coldIters) {
+    std::cout << "Warm start store failed for pilot." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
 /*
-  Construct a vector of shims for testing, then open a loop to test each shim.
+  Test ModelFingerprint. Fingerprint pilot, change a row bound, and check
+  that the incremental update agrees with a fresh fingerprint. The
+  structural fingerprint should not notice.
 */
-  int totalErrs = 0 ;
-  typedef std::pair<std::string,int> TestVec ;
+int testModelFingerprint (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+  clpObj->readMps(probPath.c_str()) ;
+
+  ModelFingerprint fullFP(ModelFingerprint::Full) ;
+  fullFP.compute(*clpObj) ;
+  ModelFingerprint::Digest structFP = ModelFingerprint::structure(*clpObj) ;
+  ModelFingerprint::Digest before = fullFP.getDigest() ;
+  int m = clpObj->numberRows() ;
+  std::vector<double> rowLower(clpObj->rowLower(),clpObj->rowLower()+m) ;
+  double oldVal = rowLower[0] ;
+  rowLower[0] = oldVal-1.0 ;
+  clpObj->chgRowLower(rowLower.data()) ;
+  fullFP.chgRowLower(0,oldVal,rowLower[0]) ;
+  bool ok = (fullFP.getDigest() != before) &&
+	    (fullFP.getDigest() == ModelFingerprint::full(*clpObj)) &&
+	    (structFP == ModelFingerprint::structure(*clpObj)) ;
+  rowLower[0] = oldVal ;
+  clpObj->chgRowLower(rowLower.data()) ;
+  ok = ok && (ModelFingerprint::full(*clpObj) == before) ;
+  std::cout
+    << "Fingerprint of pilot: " << before.toString() << "." << std::endl ;
+  if (!ok) {
+    std::cout << "Incremental fingerprint update failed." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test SolveCache. Solve pilot twice through a result cache. The second
+  request should be a hit with the same answer. A third request straight
+  after, without reloading, must also hit: the iteration count left behind
+  by the solve is not part of the key.
+*/
+int testSolveCache (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  std::string noDir = "" ;
+  std::string rpShortName = "RunParams" ;
+  ctrlAPI.load(rpShortName,rpShortName,&noDir) ;
+  API *rpAPIObj = nullptr ;
+  int retval =
+    ctrlAPI.createObject(rpAPIObj,RunParamsAPI::getAPIIDString()) ;
+  if (retval != 0) {
+    std::cout
+      << "Error " << retval << " creating RunParamsAPI object."
+      << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  RunParamsAPI *rpObj = dynamic_cast<RunParamsAPI *>(rpAPIObj) ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    ctrlAPI.destroyObject(rpAPIObj) ;
+    return (errCnt) ;
+  }
+  clpObj->exposeParams(*rpObj) ;
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+
+  SolveCache cache ;
+  SolveCache::Result first ;
+  SolveCache::Result second ;
+  SolveCache::Result third ;
+  bool firstHit = true ;
+  bool secondHit = false ;
+  bool thirdHit = false ;
+  clpObj->readMps(probPath.c_str()) ;
+  cache.solve(*clpObj,*rpObj,first,&firstHit) ;
+  clpObj->readMps(probPath.c_str()) ;
+  cache.solve(*clpObj,*rpObj,second,&secondHit) ;
+  clpObj->initialSolve() ;
+  cache.solve(*clpObj,*rpObj,third,&thirdHit) ;
+  if (firstHit || !secondHit || !thirdHit || second.status_ != 0 ||
+      second.objective_ != first.objective_ ||
+      second.colSolution_ != first.colSolution_) {
+    std::cout << "Result cache failed for pilot." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(rpAPIObj) ;
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test the modification journal of the Clp (lite) shim. Make many
+  single-element edits to pilot's row bounds, then read them back. The
+  edits are held until the read, and the last edit to each row must win.
+  Undo them, flush, and check the bounds are back.
+*/
+int testEditJournal (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+  clpObj->readMps(probPath.c_str()) ;
+
+  int m = clpObj->numberRows() ;
+  std::vector<double> orig(clpObj->rowUpper(),clpObj->rowUpper()+m) ;
+  for (int pass = 0 ; pass < 3 ; pass++) {
+    for (int i = 0 ; i < m ; i++)
+      clpObj->setRowUpper(i,orig[i]+pass+1.0) ;
+  }
+  const double *rowUpper = clpObj->rowUpper() ;
+  bool ok = true ;
+  for (int i = 0 ; i < m && ok ; i++)
+    ok = (rowUpper[i] == orig[i]+3.0) ;
+  for (int i = 0 ; i < m ; i++)
+    clpObj->setRowUpper(i,orig[i]) ;
+  clpObj->flush() ;
+  ok = ok && std::equal(orig.begin(),orig.end(),clpObj->rowUpper()) ;
+  if (!ok) {
+    std::cout
+      << "Journalled row bound edits failed for pilot." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test the bulk status and name accessors. Solve pilot, fetch the basis
+  and the row names in bulk, and check them against the single-element
+  methods. Then put the basis back in bulk and check that clp agrees it's
+  still optimal.
+*/
+int testBulkAccess (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+
+  clpObj->readMps(probPath.c_str(),true) ;
+  clpObj->initialSolve() ;
+  int n = clpObj->numberColumns() ;
+  int m = clpObj->numberRows() ;
+  std::vector<ClpSimplexAPI::Status> colStatus(n) ;
+  std::vector<ClpSimplexAPI::Status> rowStatus(m) ;
+  clpObj->getColumnStatus(0,n,colStatus.data()) ;
+  clpObj->getRowStatus(0,m,rowStatus.data()) ;
+  bool ok = true ;
+  for (int j = 0 ; j < n && ok ; j++)
+    ok = (colStatus[j] == clpObj->getColumnStatus(j)) ;
+  for (int i = 0 ; i < m && ok ; i++)
+    ok = (rowStatus[i] == clpObj->getRowStatus(i)) ;
+  std::vector<char> arena ;
+  std::vector<int> offsets ;
+  clpObj->rowNames(0,m,arena,offsets) ;
+  std::vector<char> name(clpObj->lengthNames()+1) ;
+  ok = ok && (offsets.size() == static_cast<size_t>(m+1)) ;
+  for (int i = 0 ; i < m && ok ; i++) {
+    clpObj->rowName(i,name.data()) ;
+    ok = (std::string(name.data()) == &arena[offsets[i]]) ;
+  }
+  clpObj->setColumnStatus(0,n,colStatus.data()) ;
+  clpObj->setRowStatus(0,m,rowStatus.data()) ;
+  clpObj->dual() ;
+  ok = ok && clpObj->isProvenOptimal() &&
+       (clpObj->numberIterations() == 0) ;
+  if (!ok) {
+    std::cout
+      << "Bulk status or name access failed for pilot." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test assignProblem. Copy pilot into arrays allocated with new[], hand
+  them over, and check that the solve gives the same objective.
+*/
+int testAssignProblem (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+
+  clpObj->readMps(probPath.c_str()) ;
+  clpObj->initialSolve() ;
+  double origObj = clpObj->objectiveValue() ;
+  int n = clpObj->numberColumns() ;
+  int m = clpObj->numberRows() ;
+  const CoinBigIndex *origStart = clpObj->getVectorStarts() ;
+  const int *origLen = clpObj->getVectorLengths() ;
+  CoinBigIndex *start = new CoinBigIndex[n+1] ;
+  int *index = new int[clpObj->getNumElements()] ;
+  double *value = new double[clpObj->getNumElements()] ;
+  start[0] = 0 ;
+  for (int j = 0 ; j < n ; j++) {
+    CoinCopyN(clpObj->getIndices()+origStart[j],origLen[j],
+	      index+start[j]) ;
+    CoinCopyN(clpObj->getElements()+origStart[j],origLen[j],
+	      value+start[j]) ;
+    start[j+1] = start[j]+origLen[j] ;
+  }
+  double *collb = CoinCopyOfArray(clpObj->columnLower(),n) ;
+  double *colub = CoinCopyOfArray(clpObj->columnUpper(),n) ;
+  double *obj = CoinCopyOfArray(clpObj->objective(),n) ;
+  double *rowlb = CoinCopyOfArray(clpObj->rowLower(),m) ;
+  double *rowub = CoinCopyOfArray(clpObj->rowUpper(),m) ;
+  clpObj->assignProblem(n,m,start,index,value,
+			collb,colub,obj,rowlb,rowub) ;
+  clpObj->initialSolve() ;
+  if (start != nullptr || value != nullptr || rowub != nullptr ||
+      !clpObj->isProvenOptimal() ||
+      std::fabs(clpObj->objectiveValue()-origObj) >
+	1.0e-6*(1.0+std::fabs(origObj))) {
+    std::cout << "assignProblem failed for pilot." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test MpsReader. Read pilot using several threads, and check that it
+  loads and solves to the same objective as Clp's own reader. The block
+  size is cut down so that each section is split between the threads, and
+  the bounds, objective, matrix, and names are compared with those read by
+  Clp, so that the stitching of blocks is checked.
+*/
+int testMpsReader (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+
+  clpObj->readMps(probPath.c_str(),true) ;
+  MpsReader reader(4) ;
+  reader.setMinBlockSize(4096) ;
+  int readErrs = reader.readMps(probPath.c_str(),true) ;
+  int n = clpObj->numberColumns() ;
+  int m = clpObj->numberRows() ;
+  bool same = (readErrs == 0 && reader.getNumCols() == n &&
+	       reader.getNumRows() == m &&
+	       reader.getNumElements() == clpObj->getNumElements()) ;
+  same = same &&
+	 std::equal(reader.getColLower(),reader.getColLower()+n,
+		    clpObj->columnLower()) &&
+	 std::equal(reader.getColUpper(),reader.getColUpper()+n,
+		    clpObj->columnUpper()) &&
+	 std::equal(reader.getObjective(),reader.getObjective()+n,
+		    clpObj->objective()) &&
+	 std::equal(reader.getRowLower(),reader.getRowLower()+m,
+		    clpObj->rowLower()) &&
+	 std::equal(reader.getRowUpper(),reader.getRowUpper()+m,
+		    clpObj->rowUpper()) ;
+  const CoinBigIndex *clpStarts = clpObj->getVectorStarts() ;
+  const int *clpLens = clpObj->getVectorLengths() ;
+  const int *clpIndices = clpObj->getIndices() ;
+  const double *clpElems = clpObj->getElements() ;
+  const CoinBigIndex *starts = reader.getColStarts() ;
+  for (int j = 0 ; j < n && same ; j++) {
+    CoinBigIndex len = starts[j+1]-starts[j] ;
+    same = (len == clpLens[j]) &&
+	   std::equal(reader.getIndices()+starts[j],
+		      reader.getIndices()+starts[j+1],
+		      clpIndices+clpStarts[j]) &&
+	   std::equal(reader.getElements()+starts[j],
+		      reader.getElements()+starts[j+1],
+		      clpElems+clpStarts[j]) ;
+  }
+  std::vector<char> arena ;
+  std::vector<int> offsets ;
+  clpObj->rowNames(0,m,arena,offsets) ;
+  for (int i = 0 ; i < m && same ; i++)
+    same = (reader.rowName(i) == &arena[offsets[i]]) ;
+  clpObj->columnNames(0,n,arena,offsets) ;
+  for (int j = 0 ; j < n && same ; j++)
+    same = (reader.columnName(j) == &arena[offsets[j]]) ;
+  if (!same) {
+    std::cout
+      << "MpsReader and Clp's reader disagree about pilot." << std::endl ;
+    errCnt++ ;
+  }
+  clpObj->initialSolve() ;
+  double origObj = clpObj->objectiveValue() ;
+  int origElems = clpObj->getNumElements() ;
+  if (readErrs == 0) {
+    reader.loadInto(*clpObj) ;
+    clpObj->initialSolve() ;
+  }
+  if (readErrs != 0 || clpObj->getNumElements() != origElems ||
+      !clpObj->isProvenOptimal() ||
+      std::fabs(clpObj->objectiveValue()-origObj) >
+	1.0e-6*(1.0+std::fabs(origObj))) {
+    std::cout << "MpsReader failed for pilot." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test ModelImage and the binary model format.
+*/
+int testModelImage (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+/*
+  Write pilot in binary format, check that the recorded fingerprint matches
+  the model, then read it back and check that it solves to the same
+  objective.
+*/
+  {
+    clpObj->readMps(probPath.c_str()) ;
+    clpObj->initialSolve() ;
+    double origObj = clpObj->objectiveValue() ;
+    int origElems = clpObj->getNumElements() ;
+    std::string imgPath = "pilot.osi2mdl" ;
+    bool ok = (clpObj->writeModel(imgPath.c_str()) == 0) ;
+    if (ok) {
+      ModelImage image ;
+      ok = (image.open(imgPath.c_str()) == 0) &&
+	   (image.getDigest() == ModelFingerprint::full(*clpObj)) ;
+    }
+    ok = ok && (clpObj->readModel(imgPath.c_str()) == 0) ;
+    if (ok) clpObj->initialSolve() ;
+    std::remove(imgPath.c_str()) ;
+    if (!ok || clpObj->getNumElements() != origElems ||
+	!clpObj->isProvenOptimal() ||
+	std::fabs(clpObj->objectiveValue()-origObj) >
+	  1.0e-6*(1.0+std::fabs(origObj))) {
+      std::cout << "Binary model round trip failed for pilot." << std::endl ;
+      errCnt++ ;
+    }
+  }
+/*
+  A damaged image must be refused. Write a two-column model with a row
+  index out of range, then a good one whose column upper bound is altered
+  in the file afterwards; neither should open.
+*/
+  {
+    const CoinBigIndex starts[3] = { 0, 2, 3 } ;
+    int indices[3] = { 0, 1, 2 } ;
+    const double elements[3] = { 1.0, 2.0, 3.0 } ;
+    const double colLower[2] = { 0.0, 0.0 } ;
+    const double colUpper[2] = { 12345.678, 1.0 } ;
+    const double obj[2] = { 1.0, 1.0 } ;
+    const double rowLower[2] = { 0.0, 0.0 } ;
+    const double rowUpper[2] = { 10.0, 10.0 } ;
+    ModelImage::Source src ;
+    src.numCols_ = 2 ;
+    src.numRows_ = 2 ;
+    src.starts_ = starts ;
+    src.indices_ = indices ;
+    src.elements_ = elements ;
+    src.colLower_ = colLower ;
+    src.colUpper_ = colUpper ;
+    src.obj_ = obj ;
+    src.rowLower_ = rowLower ;
+    src.rowUpper_ = rowUpper ;
+    const char *imgPath = "damaged.osi2mdl" ;
+    ModelImage image ;
+    bool ok = (ModelImage::write(imgPath,src) == 0) &&
+	      (image.open(imgPath) == -2) ;
+    indices[2] = 1 ;
+    ok = ok && (ModelImage::write(imgPath,src) == 0) &&
+	 (image.open(imgPath) == 0) ;
+    image.close() ;
+    std::string bytes ;
+    if (ok) {
+      std::ifstream file(imgPath,std::ios::binary) ;
+      bytes.assign(std::istreambuf_iterator<char>(file),
+		   std::istreambuf_iterator<char>()) ;
+      std::string bound(reinterpret_cast<const char *>(&colUpper[0]),
+			sizeof(double)) ;
+      size_t pos = bytes.find(bound) ;
+      ok = (pos != std::string::npos) ;
+      if (ok) {
+	double altered = 12345.0 ;
+	bytes.replace(pos,sizeof(double),
+		      reinterpret_cast<const char *>(&altered),
+		      sizeof(double)) ;
+      }
+    }
+    if (ok) {
+      std::ofstream file(imgPath,std::ios::binary|std::ios::trunc) ;
+      file.write(bytes.data(),bytes.size()) ;
+      ok = file.good() ;
+    }
+    ok = ok && (image.open(imgPath) == -2) ;
+    std::remove(imgPath) ;
+    if (!ok) {
+      std::cout << "Damaged model image was not refused." << std::endl ;
+      errCnt++ ;
+    }
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test ModelCache. Read pilot twice with the model cache in the current
+  directory. The first read should parse and store an image, the second
+  load the image without hashing the file again, and both should solve to
+  the same objective. Then damage the stored image: the next read should
+  notice, parse the file instead, and store a good image in its place.
+*/
+int testModelCache (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+
+  ModelCache::setDirectory(".") ;
+  ModelCache::forget(probPath.c_str()) ;
+  ModelCache::resetStatistics() ;
+  clpObj->readMps(probPath.c_str()) ;
+  clpObj->initialSolve() ;
+  double origObj = clpObj->objectiveValue() ;
+  bool ok = (clpObj->readMps(probPath.c_str()) == 0) ;
+  if (ok) clpObj->initialSolve() ;
+  ok = ok && (ModelCache::getMissCnt() == 1) &&
+       (ModelCache::getHitCnt() == 1) && (ModelCache::getHashCnt() == 1) ;
+  std::string imagePath ;
+  ok = ok && ModelCache::lookup(probPath.c_str(),false,imagePath) ;
+  if (ok) {
+    std::fstream file(imagePath.c_str(),
+		      std::ios::binary|std::ios::in|std::ios::out) ;
+    file.seekg(0,std::ios::end) ;
+    std::streamoff size = file.tellg() ;
+    file.seekp(size/2) ;
+    std::string junk(64,'\x7f') ;
+    file.write(junk.data(),junk.size()) ;
+    ok = file.good() ;
+  }
+  ok = ok && (clpObj->readMps(probPath.c_str()) == 0) ;
+  if (ok) clpObj->initialSolve() ;
+  ModelImage image ;
+  ok = ok && ModelCache::lookup(probPath.c_str(),false,imagePath) &&
+       (image.open(imagePath.c_str()) == 0) ;
+  image.close() ;
+  ModelCache::forget(probPath.c_str()) ;
+  ModelCache::setDirectory("") ;
+  if (!ok || !clpObj->isProvenOptimal() ||
+      std::fabs(clpObj->objectiveValue()-origObj) >
+	1.0e-6*(1.0+std::fabs(origObj))) {
+    std::cout << "Model cache failed for pilot." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test OsilReader on two encodings of the Par Inc. problem.
+*/
+int testOsilReader (std::string dataDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+/*
+  Read the Par Inc. problem from OSiL, with the matrix given row-major and
+  compressed with mult and incr, and check the optimum.
+*/
+  {
+    const char *osil =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<osil xmlns=\"os.optimizationservices.org\">\n"
+      "<instanceHeader><name>parinc</name></instanceHeader>\n"
+      "<instanceData>\n"
+      "<variables numberOfVariables=\"2\">\n"
+      "  <var name=\"x0\" ub=\"1000\" mult=\"2\"/>\n"
+      "</variables>\n"
+      "<objectives numberOfObjectives=\"1\">\n"
+      "  <obj maxOrMin=\"max\" numberOfObjCoef=\"2\">\n"
+      "    <coef idx=\"0\">10</coef><coef idx=\"1\">9</coef>\n"
+      "  </obj>\n"
+      "</objectives>\n"
+      "<constraints numberOfConstraints=\"4\">\n"
+      "  <con lb=\"10\" ub=\"630\"/><con lb=\"10\" ub=\"600\"/>\n"
+      "  <con lb=\"10\" ub=\"708\"/><con lb=\"10\" ub=\"135\"/>\n"
+      "</constraints>\n"
+      "<linearConstraintCoefficients numberOfValues=\"8\">\n"
+      "  <start><el mult=\"5\" incr=\"2\">0</el></start>\n"
+      "  <colIdx><el mult=\"2\" incr=\"1\">0</el>"
+      "<el mult=\"2\" incr=\"1\">0</el>\n"
+      "    <el mult=\"2\" incr=\"1\">0</el>"
+      "<el mult=\"2\" incr=\"1\">0</el></colIdx>\n"
+      "  <value><el>.7</el><el>1</el><el>.5</el><el>.8333</el>\n"
+      "    <el>1</el><el>.6667</el><el>.1</el><el>.25</el></value>\n"
+      "</linearConstraintCoefficients>\n"
+      "</instanceData>\n"
+      "</osil>\n" ;
+    std::string osilPath = "parinc.osil" ;
+    std::FILE *file = std::fopen(osilPath.c_str(),"w") ;
+    if (file != nullptr) {
+      std::fputs(osil,file) ;
+      std::fclose(file) ;
+    }
+    OsilReader reader ;
+    int readErrs = reader.readOsil(osilPath.c_str(),true) ;
+    std::remove(osilPath.c_str()) ;
+    if (readErrs == 0) {
+      reader.loadInto(*clpObj) ;
+      clpObj->initialSolve() ;
+    }
+    if (readErrs != 0 || reader.getNumElements() != 8 ||
+	!clpObj->isProvenOptimal() ||
+	std::fabs(clpObj->objectiveValue()-7667.9417) > 1.0e-3) {
+      std::cout << "OsilReader failed for parinc." << std::endl ;
+      errCnt++ ;
+    }
+  }
+/*
+  Read the copy of Par Inc. shipped in the data directory, column-major
+  with names on three of the four rows. The unnamed row gets the default
+  name.
+*/
+  {
+    std::string osilPath = dataDir+dirSep+"parincLinear.osil" ;
+    OsilReader reader ;
+    int readErrs = reader.readOsil(osilPath.c_str(),true) ;
+    if (readErrs == 0) {
+      reader.loadInto(*clpObj) ;
+      clpObj->initialSolve() ;
+    }
+    if (readErrs != 0 || reader.getNumRows() != 4 ||
+	reader.getNumElements() != 8 || reader.getObjSense() != -1.0 ||
+	reader.rowName(1) != "sewing" || reader.rowName(3) != "R0000003" ||
+	reader.columnName(1) != "x1" ||
+	!clpObj->isProvenOptimal() ||
+	std::fabs(clpObj->objectiveValue()-7667.9417) > 1.0e-3) {
+      std::cout
+	<< "OsilReader failed for " << osilPath << "." << std::endl ;
+      errCnt++ ;
+    }
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+# ifdef OSI2_HAS_ZLIB
+/*
+  Test the compressed model streams. Write pilot compressed as MPS and in
+  binary format. Read both back and check that they solve to the same
+  objective.
+*/
+int testCodecs (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+
+  clpObj->readMps(probPath.c_str()) ;
+  clpObj->initialSolve() ;
+  double origObj = clpObj->objectiveValue() ;
+  int origElems = clpObj->getNumElements() ;
+  std::string mpsPath = "pilot.mps.gz" ;
+  std::string imgPath = "pilot.osi2mdl.gz" ;
+  bool ok = (clpObj->writeMps(mpsPath.c_str(),0,1,1.0) == 0) &&
+	    (clpObj->writeModel(imgPath.c_str()) == 0) ;
+  MpsReader reader(4) ;
+  ok = ok && (reader.readMps(mpsPath.c_str(),true) == 0) ;
+  if (ok) {
+    reader.loadInto(*clpObj) ;
+    clpObj->initialSolve() ;
+    ok = (clpObj->getNumElements() == origElems) &&
+	 clpObj->isProvenOptimal() &&
+	 std::fabs(clpObj->objectiveValue()-origObj) <=
+	   1.0e-6*(1.0+std::fabs(origObj)) ;
+  }
+  ok = ok && (clpObj->readModel(imgPath.c_str()) == 0) ;
+  if (ok) {
+    clpObj->initialSolve() ;
+    ok = (clpObj->getNumElements() == origElems) &&
+	 clpObj->isProvenOptimal() &&
+	 std::fabs(clpObj->objectiveValue()-origObj) <=
+	   1.0e-6*(1.0+std::fabs(origObj)) ;
+  }
+  std::remove(mpsPath.c_str()) ;
+  std::remove(imgPath.c_str()) ;
+  if (!ok) {
+    std::cout
+      << "Compressed model round trip failed for pilot." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+# endif
+
+/*
+  Test ModelWriter. It's opt-in. Write pilot with clp's writer and with
+  ModelWriter at each format type and number across; the files must be
+  identical. Then write pilot with ModelWriter on one thread and on four,
+  as MPS and as LP; those must be identical too.
+*/
+int testModelWriter (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+
+  clpObj->readMps(probPath.c_str(),true) ;
+  const char *paths[2] = { "pilotClp.mps", "pilotOsi2.mps" } ;
+  bool ok = !clpObj->parallelWrite() ;
+  for (int fmt = 0 ; fmt < 3 && ok ; fmt++) {
+    for (int across = 1 ; across <= 2 && ok ; across++) {
+      for (int k = 0 ; k < 2 && ok ; k++) {
+	clpObj->setParallelWrite(k == 1) ;
+	ok = (clpObj->writeMps(paths[k],fmt,across,1.0) == 0) ;
+      }
+      std::string text = fileText(paths[0]) ;
+      ok = ok && !text.empty() && text == fileText(paths[1]) ;
+      if (!ok) {
+	std::cout
+	  << "ModelWriter and clp differ for pilot, format type " << fmt
+	  << ", number across " << across << "." << std::endl ;
+      }
+    }
+  }
+  clpObj->setParallelWrite(false) ;
+  for (int ndx = 0 ; ndx < 2 ; ndx++) std::remove(paths[ndx]) ;
+  if (!ok) errCnt++ ;
+
+  MpsReader orig(4) ;
+  ok = (orig.readMps(probPath.c_str(),true) == 0) ;
+  ModelImage::Source src ;
+  src.numCols_ = orig.getNumCols() ;
+  src.numRows_ = orig.getNumRows() ;
+  src.starts_ = orig.getColStarts() ;
+  src.indices_ = orig.getIndices() ;
+  src.elements_ = orig.getElements() ;
+  src.colLower_ = orig.getColLower() ;
+  src.colUpper_ = orig.getColUpper() ;
+  src.obj_ = orig.getObjective() ;
+  src.rowLower_ = orig.getRowLower() ;
+  src.rowUpper_ = orig.getRowUpper() ;
+  src.integer_ = orig.getIntegerInformation() ;
+  src.objSense_ = orig.getObjSense() ;
+  src.objOffset_ = orig.getObjOffset() ;
+  src.probName_ = orig.getProblemName() ;
+  const char *threadPaths[4] = { "pilot1.mps", "pilot4.mps",
+				 "pilot1.lp", "pilot4.lp" } ;
+  for (int ndx = 0 ; ndx < 2 && ok ; ndx++) {
+    ModelWriter writer((ndx == 0)?1:4) ;
+    writer.setModel(src) ;
+    ok = (writer.writeMps(threadPaths[ndx],1) == 0) &&
+	 (writer.writeLp(threadPaths[ndx+2]) == 0) ;
+  }
+  for (int ndx = 0 ; ndx < 4 && ok ; ndx += 2) {
+    std::string text = fileText(threadPaths[ndx]) ;
+    ok = !text.empty() && text == fileText(threadPaths[ndx+1]) ;
+  }
+  MpsReader copy(4) ;
+  ok = ok && (copy.readMps(threadPaths[1],true) == 0) &&
+       copy.getNumCols() == orig.getNumCols() &&
+       copy.getNumRows() == orig.getNumRows() &&
+       copy.getNumElements() == orig.getNumElements() ;
+  for (int ndx = 0 ; ndx < 4 ; ndx++) std::remove(threadPaths[ndx]) ;
+  if (!ok) {
+    std::cout << "ModelWriter failed for pilot." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test ModelBuilder on a small model, built a row at a time and solved,
+  and on a large random one built on several threads.
+*/
+int testModelBuilder ()
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+/*
+  Build parinc a row at a time with ModelBuilder, hand it to clp, and check
+  the optimum.
+*/
+  {
+    ModelBuilder builder(2) ;
+    const char *colNames[2] = { "x0", "x1" } ;
+    const double obj[2] = { 10.0, 9.0 } ;
+    const double colUpper[2] = { 1000.0, 1000.0 } ;
+    for (int j = 0 ; j < 2 ; j++)
+      builder.addColumn(0,nullptr,nullptr,0.0,colUpper[j],obj[j],colNames[j]) ;
+    const CoinBigIndex starts[5] = { 0, 2, 4, 6, 8 } ;
+    const int indices[8] = { 0, 1, 0, 1, 0, 1, 0, 1 } ;
+    const double elements[8] = { .7, 1, .5, .8333, 1, .6667, .1, .25 } ;
+    const double rowLower[4] = { 10.0, 10.0, 10.0, 10.0 } ;
+    const double rowUpper[4] = { 630.0, 600.0, 708.0, 135.0 } ;
+    const char *rowNames[4] = { "c0", "c1", "c2", "c3" } ;
+    builder.addRows(4,starts,indices,elements,rowLower,rowUpper,rowNames) ;
+    builder.setObjSense(-1.0) ;
+    bool ok = (builder.finalize() == 0) &&
+	      (builder.getNumElements() == 8) &&
+	      (builder.rowIndex("c2") == 2) &&
+	      (builder.columnIndex("x1") == 1) ;
+    if (ok) {
+      builder.assignTo(*clpObj) ;
+      clpObj->initialSolve() ;
+      ok = clpObj->isProvenOptimal() &&
+	   std::fabs(clpObj->objectiveValue()-7667.9417) <= 1.0e-3 ;
+    }
+    if (!ok) {
+      std::cout << "ModelBuilder failed for parinc." << std::endl ;
+      errCnt++ ;
+    }
+  }
+/*
+  Build a random model with ModelBuilder on one, four, and seven threads.
+  Columns are added first and refer to rows yet to come; some indices of
+  both are out of range. The matrix must match a serial transpose, and the
+  dropped coefficients must be counted.
+*/
+  {
+    const int n = 300 ;
+    const int m = 30000 ;
+    std::mt19937 rng(4711) ;
+    std::vector<std::vector<int> > colNdx(n), rowNdx(m) ;
+    std::vector<std::vector<double> > colElem(n), rowElem(m) ;
+    int expectDropped = 0 ;
+    for (int j = 0 ; j < n ; j++) {
+      int len = static_cast<int>(rng()%4) ;
+      for (int t = 0 ; t < len ; t++) {
+	colNdx[j].push_back(static_cast<int>(rng()%(m+2))) ;
+	colElem[j].push_back(static_cast<double>(rng()%1000)/8.0-60.0) ;
+	if (colNdx[j].back() >= m) expectDropped++ ;
+      }
+    }
+    for (int i = 0 ; i < m ; i++) {
+      int len = static_cast<int>(rng()%8) ;
+      for (int t = 0 ; t < len ; t++) {
+	rowNdx[i].push_back(static_cast<int>(rng()%(n+3))) ;
+	rowElem[i].push_back(static_cast<double>(rng()%1000)/8.0-60.0) ;
+	if (rowNdx[i].back() >= n) expectDropped++ ;
+      }
+    }
+    std::vector<CoinBigIndex> refStarts(n+1,0) ;
+    std::vector<std::vector<int> > refNdx(n) ;
+    std::vector<std::vector<double> > refElem(n) ;
+    for (int j = 0 ; j < n ; j++) {
+      for (size_t t = 0 ; t < colNdx[j].size() ; t++) {
+	if (colNdx[j][t] >= m) continue ;
+	refNdx[j].push_back(colNdx[j][t]) ;
+	refElem[j].push_back(colElem[j][t]) ;
+      }
+    }
+    for (int i = 0 ; i < m ; i++) {
+      for (size_t t = 0 ; t < rowNdx[i].size() ; t++) {
+	int j = rowNdx[i][t] ;
+	if (j >= n) continue ;
+	refNdx[j].push_back(i) ;
+	refElem[j].push_back(rowElem[i][t]) ;
+      }
+    }
+    for (int j = 0 ; j < n ; j++)
+      refStarts[j+1] = refStarts[j]+
+		       static_cast<CoinBigIndex>(refNdx[j].size()) ;
+    const int threads[3] = { 1, 4, 7 } ;
+    bool ok = true ;
+    for (int k = 0 ; k < 3 && ok ; k++) {
+      ModelBuilder builder(threads[k]) ;
+      for (int j = 0 ; j < n ; j++) {
+	int len = static_cast<int>(colNdx[j].size()) ;
+	builder.addColumn(len,colNdx[j].data(),colElem[j].data(),
+			  0.0,10.0,1.0) ;
+      }
+      for (int i = 0 ; i < m ; i++) {
+	int len = static_cast<int>(rowNdx[i].size()) ;
+	builder.addRow(len,rowNdx[i].data(),rowElem[i].data(),-1.0,1.0) ;
+      }
+      ok = (builder.finalize() == expectDropped) &&
+	   builder.getNumCols() == n && builder.getNumRows() == m &&
+	   builder.getNumElements() == refStarts[n] &&
+	   std::equal(refStarts.begin(),refStarts.end(),
+		      builder.getColStarts()) ;
+      for (int j = 0 ; j < n && ok ; j++) {
+	const CoinBigIndex start = refStarts[j] ;
+	ok = std::equal(refNdx[j].begin(),refNdx[j].end(),
+			builder.getIndices()+start) &&
+	     std::equal(refElem[j].begin(),refElem[j].end(),
+			builder.getElements()+start) ;
+      }
+    }
+    if (!ok) {
+      std::cout
+	<< "ModelBuilder failed for a random model." << std::endl ;
+      errCnt++ ;
+    }
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test NameIndexAPI for the Clp (lite) shim. Look up pilot's rows and
+  columns by name, then check that the index follows a rename and a
+  deletion.
+*/
+int testNameIndex (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+
+  clpObj->readMps(probPath.c_str(),true) ;
+  NameIndexAPI *names = static_cast<NameIndexAPI *>
+    (clpAPIObj->getAPIPtr(NameIndexAPI::getAPIIDString())) ;
+  int n = clpObj->numberColumns() ;
+  int m = clpObj->numberRows() ;
+  std::vector<char> name(clpObj->lengthNames()+1) ;
+  bool ok = (names != nullptr) ;
+  for (int i = 0 ; i < m && ok ; i++) {
+    clpObj->rowName(i,name.data()) ;
+    ok = (names->rowIndex(name.data()) == i) ;
+  }
+  for (int j = 0 ; j < n && ok ; j++) {
+    clpObj->columnName(j,name.data()) ;
+    ok = (names->columnIndex(name.data()) == j) ;
+  }
+  if (ok) {
+    clpObj->rowName(0,name.data()) ;
+    std::string first = name.data() ;
+    clpObj->rowName(m-1,name.data()) ;
+    std::string last = name.data() ;
+    clpObj->setRowName(m-1,"renamed") ;
+    ok = (names->rowIndex("renamed") == m-1) &&
+	 (names->rowIndex(last.c_str()) < 0) ;
+    int which = 0 ;
+    clpObj->deleteRows(1,&which) ;
+    ok = ok && (names->rowIndex("renamed") == m-2) &&
+	 (names->rowIndex(first.c_str()) < 0) ;
+  }
+  if (!ok) {
+    std::cout
+      << "Name index lookup failed for pilot." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test lazy name loading. Read pilot with lazy names and check the names
+  against a normal read, then check that a rename hands the rest over to
+  clp intact.
+*/
+int testLazyNames (std::string netlibDir)
+
+{ int errCnt = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  API *clpAPIObj = nullptr ;
+  ClpSimplexAPI *clpObj = createClpSimplex(ctrlAPI,clpAPIObj) ;
+  if (clpObj == nullptr) {
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+
+  clpObj->readMps(probPath.c_str(),true) ;
+  int n = clpObj->numberColumns() ;
+  int m = clpObj->numberRows() ;
+  std::vector<char> rowArena, colArena ;
+  std::vector<int> rowOffsets, colOffsets ;
+  clpObj->rowNames(0,m,rowArena,rowOffsets) ;
+  clpObj->columnNames(0,n,colArena,colOffsets) ;
+  clpObj->setLazyNames(true) ;
+  clpObj->readMps(probPath.c_str(),true) ;
+  std::vector<char> arena ;
+  std::vector<int> offsets ;
+  clpObj->columnNames(0,n,arena,offsets) ;
+  bool ok = (clpObj->numberRows() == m) && (arena == colArena) &&
+	    (offsets == colOffsets) ;
+  std::vector<char> name(clpObj->lengthNames()+1) ;
+  for (int i = 0 ; i < m && ok ; i++) {
+    clpObj->rowName(i,name.data()) ;
+    ok = (std::string(name.data()) == &rowArena[rowOffsets[i]]) ;
+  }
+  if (ok && m > 1) {
+    clpObj->setRowName(0,"renamed") ;
+    clpObj->rowNames(0,m,arena,offsets) ;
+    ok = (std::string(&arena[offsets[0]]) == "renamed") &&
+	 (std::string(&arena[offsets[1]]) == &rowArena[rowOffsets[1]]) ;
+  }
+  clpObj->setLazyNames(false) ;
+  if (!ok) {
+    std::cout
+      << "Lazy names failed for pilot." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.destroyObject(clpAPIObj) ;
+
+  return (errCnt) ;
+}
+
+} // end unnamed file-local namespace
+
+
+int main(int argC,char* argV[])
+{
+
+  std::cout << "START UNIT TEST" << std::endl ;
+/*
+  Test the bare PluginManager. There's no sense proceeding to the API
+  tests if the PluginManager isn't working.
+*/
+  std::cout << "Testing bare PluginManager." << std::endl ;
+  int retval = testPluginManager() ;
+  std::cout
+    << "End test of bare PluginManager, " << retval << " errors."
+    << std::endl << std::endl ;
+  if (retval != 0) {
+      std::cout
+	<< "Aborting unitTest; errors in PluginManager." << std::endl ;
+      return (retval) ;
+  }
+/*
+  Construct the location of installed data files.
+*/
+  std::string sampleDir = SAMPLEDATADIR ;
+  std::string netlibDir = NETLIBDATADIR ;
+  std::string dataDir = OSI2DATADIR ;
+  std::cout << "coin-or-sample is at " << sampleDir << std::endl ;
+  std::cout << "coin-or-netlib is at " << netlibDir << std::endl ;
+  std::cout << "Osi2 data is at " << dataDir << std::endl << std::endl ;
+/*
+  Grab the plugin manager instance.
+*/
+  PluginManager &plugMgr = PluginManager::getInstance() ;
+/*
+  Construct a vector of shims for testing, then open a loop to test each shim.
+*/
+  int totalErrs = 0 ;
+  typedef std::pair<std::string,int> TestVec ;
   std::vector<TestVec> solvers ;
   solvers.push_back(TestVec("clp",3)) ;
 # ifdef OSI2_HAS_OSICLP
@@ -780,6 +2493,178 @@ int main(int argC,char* argV[])
   std::cout
     << "End test of RunParamsAPI, " << errCnt << " errors, expected "
     << expectedErrs << "." << std::endl ;
+/*
+  Test the BatchSolve API.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing BatchSolveAPI." << std::endl ;
+  errCnt = testBatchSolveAPI(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of BatchSolveAPI, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test the Scenario API.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing ScenarioAPI." << std::endl ;
+  errCnt = testScenarioAPI(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of ScenarioAPI, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test WarmStartStore.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing WarmStartStore." << std::endl ;
+  errCnt = testWarmStartStore(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of WarmStartStore, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test ModelFingerprint.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing ModelFingerprint." << std::endl ;
+  errCnt = testModelFingerprint(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of ModelFingerprint, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test SolveCache.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing SolveCache." << std::endl ;
+  errCnt = testSolveCache(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of SolveCache, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test the modification journal.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing the modification journal." << std::endl ;
+  errCnt = testEditJournal(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of the modification journal, " << errCnt << " errors,"
+    << " expected " << expectedErrs << "." << std::endl ;
+/*
+  Test the bulk accessors.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing the bulk accessors." << std::endl ;
+  errCnt = testBulkAccess(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of the bulk accessors, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test assignProblem.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing assignProblem." << std::endl ;
+  errCnt = testAssignProblem(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of assignProblem, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test MpsReader.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing MpsReader." << std::endl ;
+  errCnt = testMpsReader(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of MpsReader, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test ModelImage.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing ModelImage." << std::endl ;
+  errCnt = testModelImage(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of ModelImage, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test ModelCache.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing ModelCache." << std::endl ;
+  errCnt = testModelCache(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of ModelCache, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test OsilReader.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing OsilReader." << std::endl ;
+  errCnt = testOsilReader(dataDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of OsilReader, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+# ifdef OSI2_HAS_ZLIB
+/*
+  Test the compressed model streams.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing compressed model streams." << std::endl ;
+  errCnt = testCodecs(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of compressed model streams, " << errCnt << " errors,"
+    << " expected " << expectedErrs << "." << std::endl ;
+# endif
+/*
+  Test ModelWriter.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing ModelWriter." << std::endl ;
+  errCnt = testModelWriter(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of ModelWriter, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test ModelBuilder.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing ModelBuilder." << std::endl ;
+  errCnt = testModelBuilder() ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of ModelBuilder, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test NameIndexAPI.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing NameIndexAPI." << std::endl ;
+  errCnt = testNameIndex(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of NameIndexAPI, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+/*
+  Test lazy names.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing lazy names." << std::endl ;
+  errCnt = testLazyNames(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of lazy names, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
 /*
   Shut down the plugin manager. This will call the plugin library exit
   functions and unload the libraries.